@@ -0,0 +1,70 @@
+#pragma once
+/** @file  AllocationGuard.hpp
+ *  @brief Debug/CI check that nothing allocates from the global heap while a run is RUNNING.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @class AllocationGuard
+ * @brief Process-wide hook on global `operator new` (built with `-DMILO_ALLOC_GUARD=ON`).
+ *
+ *  * SystemCoordinator arms it on entering RUNNING and disarms it on leaving.
+ *  * `Count` records every allocation by call site (a short backtrace); `Abort` prints the
+ *    offending stack to stderr and aborts — the CI setting.
+ *  * Threads that may legitimately allocate during a run (the logger’s disk path, cold
+ *    error paths) hold an `Exempt` for that scope.
+ *  * Without the build flag every call is a no-op and `kCompiledIn` is false.
+ */
+    class AllocationGuard {
+    public:
+      enum class Mode { Off, Count, Abort };
+
+      static constexpr std::size_t kFrames = 6;   ///< stack depth kept per site
+      static constexpr std::size_t kMaxSites = 64;
+
+#ifdef MILO_ALLOC_GUARD
+      static constexpr bool kCompiledIn = true;
+#else
+      static constexpr bool kCompiledIn = false;
+#endif
+
+      struct Site {
+        std::array<void*, kFrames> frames{};
+        std::size_t depth{ 0 };
+        std::uint64_t count{ 0 };
+        std::uint64_t bytes{ 0 };
+      };
+
+      /// Clears previous statistics and starts watching every non-exempt thread.
+      static void arm(Mode mode);
+      static void disarm();
+      static Mode mode();
+
+      static std::uint64_t count(); ///< allocations seen since arm()
+      static std::uint64_t bytes();
+      static std::vector<Site> sites();
+      /// Human-readable, symbolised list of sites (empty when nothing was caught).
+      static std::string report();
+
+      /// RAII: allocations on this thread are not policed while an Exempt is alive.
+      class Exempt {
+      public:
+        Exempt();
+        ~Exempt();
+        Exempt(const Exempt&) = delete;
+        Exempt& operator=(const Exempt&) = delete;
+      };
+    };
+
+  } // namespace core
+} // namespace milo
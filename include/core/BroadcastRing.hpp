@@ -0,0 +1,245 @@
+#pragma once
+/** @file  BroadcastRing.hpp
+ *  @brief Lock-free single-writer / multi-reader broadcast ring (every reader sees every item).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @class BroadcastRing
+ * @brief Disruptor-style event ring: one writer, up to kMaxSubscribers independent readers.
+ *
+ *  * Each subscriber owns a cursor; nobody gates the writer. `publish()` is a handful of
+ *    stores and never waits, whatever the readers are doing.
+ *  * A reader more than `capacity()` items behind is lapped: it resumes at the oldest item
+ *    still in the ring and the skipped items are added to its `lost` count. Slots are
+ *    seqlocked, so an item overwritten while being copied is detected and counted too.
+ *  * Per-subscriber lag/lost are readable from any thread (`stats()`), for telemetry.
+ *  * Readers either poll their cursor from a loop they already run, or block on
+ *    `signal()`/`waitFor()` (see BroadcastListener).
+ *  * `subscribe()` at setup, before the writer starts.
+ */
+    template <typename T> class BroadcastRing {
+      static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+      static constexpr std::size_t kMaxSubscribers = 8;
+      static constexpr std::size_t kNameLen = 16;
+
+      struct Stats {
+        char name[kNameLen]{};
+        std::uint64_t lag{ 0 };  ///< published but not yet read
+        std::uint64_t lost{ 0 }; ///< overwritten before this reader got to them
+      };
+
+      /// A subscriber’s read position; owned by exactly one reading thread.
+      class Cursor {
+      public:
+        Cursor() = default;
+
+        /// Next item in publish order; false when caught up.
+        bool poll(T& out) { return ring_->read(index_, out); }
+        /// Drop everything published so far (e.g. events from before a run started).
+        void skipToHead() {
+          ring_->subs_[index_].cursor.store(ring_->head_.load(std::memory_order_acquire),
+                                            std::memory_order_release);
+        }
+        std::uint64_t lost() const {
+          return ring_->subs_[index_].lost.load(std::memory_order_relaxed);
+        }
+        bool valid() const { return ring_ != nullptr; }
+
+      private:
+        friend class BroadcastRing;
+        Cursor(BroadcastRing* ring, std::size_t index) : ring_(ring), index_(index) {}
+
+        BroadcastRing* ring_{ nullptr };
+        std::size_t index_{ 0 };
+      };
+
+      explicit BroadcastRing(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity)
+          cap <<= 1;
+        slots_ = std::make_unique<Slot[]>(cap);
+        mask_ = cap - 1;
+      }
+
+      // ---- writer side ---------------------------------------------------------
+      void publish(const T& item) {
+        const auto n = head_.load(std::memory_order_relaxed);
+        auto& slot = slots_[n & mask_];
+        slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot.data, &item, sizeof(T));
+        slot.seq.store(2 * n + 2, std::memory_order_release);
+        head_.store(n + 1, std::memory_order_release);
+
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_all(); // no syscall unless a listener is actually asleep
+      }
+
+      std::uint64_t published() const { return head_.load(std::memory_order_acquire); }
+
+      // ---- subscribers ---------------------------------------------------------
+      /// Starts at the next item published. @throws std::logic_error when the table is full.
+      Cursor subscribe(std::string_view name) {
+        const auto i = count_.load(std::memory_order_relaxed);
+        if (i >= kMaxSubscribers)
+          throw std::logic_error("[BroadcastRing] subscriber table full");
+        auto& sub = subs_[i];
+        const auto n = std::min(name.size(), kNameLen - 1);
+        std::memcpy(sub.name, name.data(), n);
+        sub.name[n] = '\0';
+        sub.cursor.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        count_.store(i + 1, std::memory_order_release);
+        return Cursor(this, i);
+      }
+
+      std::size_t subscribers() const { return count_.load(std::memory_order_acquire); }
+
+      Stats stats(std::size_t i) const {
+        Stats s;
+        const auto& sub = subs_[i];
+        std::memcpy(s.name, sub.name, kNameLen);
+        const auto head = head_.load(std::memory_order_acquire);
+        const auto cursor = sub.cursor.load(std::memory_order_acquire);
+        s.lag = head > cursor ? head - cursor : 0;
+        s.lost = sub.lost.load(std::memory_order_relaxed);
+        return s;
+      }
+
+      std::size_t capacity() const { return mask_ + 1; }
+
+      // ---- blocking wait strategy ----------------------------------------------
+      /// Read before polling; pass to `waitFor()` once the cursor came up empty.
+      std::uint32_t signal() const { return signal_.load(std::memory_order_acquire); }
+      /// Sleep until something is published (or `interrupt()`) after \p seen was read.
+      void waitFor(std::uint32_t seen) const { signal_.wait(seen, std::memory_order_acquire); }
+      /// Wake every waiting reader without publishing (shutdown).
+      void interrupt() {
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_all();
+      }
+
+      BroadcastRing(const BroadcastRing&) = delete;
+      BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    private:
+      struct alignas(64) Slot {
+        std::atomic<std::uint64_t> seq{ 0 }; ///< 2n+1 while item n is written, 2n+2 once done
+        T data{};
+      };
+
+      struct alignas(64) Subscriber {
+        std::atomic<std::uint64_t> cursor{ 0 }; ///< next item to read (reader-owned)
+        std::atomic<std::uint64_t> lost{ 0 };   ///< reader-owned
+        char name[kNameLen]{};
+      };
+
+      bool read(std::size_t index, T& out) {
+        auto& sub = subs_[index];
+        auto next = sub.cursor.load(std::memory_order_relaxed);
+        std::uint64_t lost = 0;
+        bool got = false;
+        for (;;) {
+          const auto head = head_.load(std::memory_order_acquire);
+          if (next == head)
+            break;
+          if (head - next > capacity()) { // lapped: resume at the oldest surviving item
+            lost += head - next - capacity();
+            next = head - capacity();
+          }
+          const auto& slot = slots_[next & mask_];
+          const auto seq = slot.seq.load(std::memory_order_acquire);
+          if (seq == 2 * next + 2) {
+            std::memcpy(&out, &slot.data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == seq) {
+              ++next;
+              got = true;
+              break;
+            }
+          }
+          ++lost; // the writer is already re-using this slot: item `next` is gone
+          ++next;
+        }
+        if (lost)
+          sub.lost.store(sub.lost.load(std::memory_order_relaxed) + lost, std::memory_order_relaxed);
+        sub.cursor.store(next, std::memory_order_release);
+        return got;
+      }
+
+      std::unique_ptr<Slot[]> slots_;
+      std::size_t mask_{ 0 };
+      std::array<Subscriber, kMaxSubscribers> subs_{};
+      std::atomic<std::size_t> count_{ 0 };
+      alignas(64) std::atomic<std::uint64_t> head_{ 0 }; ///< next item number (writer-owned)
+      alignas(64) std::atomic<std::uint32_t> signal_{ 0 };
+    };
+
+    /**
+ * @class BroadcastListener
+ * @brief A subscriber with its own thread: sleeps until something is published, then runs
+ *        \p handler for every item in order. A slow handler only delays (or laps) itself.
+ */
+    template <typename T> class BroadcastListener {
+    public:
+      BroadcastListener(BroadcastRing<T>& ring, std::string_view name,
+                        std::function<void(const T&)> handler)
+          : ring_(ring), cursor_(ring.subscribe(name)), handler_(std::move(handler)) {
+        thread_ = std::thread([this] { loop(); });
+      }
+      ~BroadcastListener() { stop(); }
+
+      /// Delivers what is already published, then joins the thread.
+      void stop() {
+        if (stopping_.exchange(true))
+          return;
+        ring_.interrupt();
+        if (thread_.joinable())
+          thread_.join();
+      }
+
+      std::uint64_t lost() const { return cursor_.lost(); }
+
+      BroadcastListener(const BroadcastListener&) = delete;
+      BroadcastListener& operator=(const BroadcastListener&) = delete;
+
+    private:
+      void loop() {
+        T item;
+        for (;;) {
+          const auto seen = ring_.signal();
+          while (cursor_.poll(item))
+            handler_(item);
+          if (stopping_.load(std::memory_order_acquire))
+            return;
+          ring_.waitFor(seen);
+        }
+      }
+
+      BroadcastRing<T>& ring_;
+      typename BroadcastRing<T>::Cursor cursor_;
+      std::function<void(const T&)> handler_;
+      std::atomic<bool> stopping_{ false };
+      std::thread thread_;
+    };
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,60 @@
+#pragma once
+/** @file  ChannelKey.hpp
+ *  @brief The fixed-size `DEVICE.CHANNEL` name RunStats and SampleStreams claim channels by.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// MILO headers
+#include "core/DeviceRegistry.hpp"
+#include "core/StreamView.hpp"
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @struct ChannelKey
+ * @brief `DEVICE.CHANNEL` in a NUL-terminated array the size of StreamView::key, plus the
+ *        device it belongs to; building and matching one never allocates.
+ *
+ *  Over-long names are truncated, the device name first: it keeps at most kDeviceLen
+ *  characters so every channel keeps at least kMinChannelLen of its own. Channels that
+ *  differ only beyond what fits still share a key.
+ */
+    struct ChannelKey {
+      static constexpr std::size_t kLen = StreamView::kKeyLen;
+      static constexpr std::size_t kMinChannelLen = 8;
+      static constexpr std::size_t kDeviceLen = kLen - 1 - kMinChannelLen;
+
+      Device device{};
+      std::uint8_t channelAt{ 0 }; ///< where the channel name starts in `text`
+      char text[kLen + 1]{};
+
+      ChannelKey() = default;
+      ChannelKey(Device dev, std::string_view deviceName, std::string_view channel)
+          : device(dev) {
+        const auto d = std::min(deviceName.size(), kDeviceLen);
+        std::copy_n(deviceName.data(), d, text);
+        text[d] = '.';
+        channelAt = static_cast<std::uint8_t>(d + 1);
+        const auto c = std::min(channel.size(), kLen - channelAt);
+        std::copy_n(channel.data(), c, text + channelAt);
+        text[channelAt + c] = '\0';
+      }
+
+      /// Whether this is the key of \p channel of \p dev (compared as it was truncated).
+      bool matches(Device dev, std::string_view channel) const {
+        return dev == device &&
+               std::string_view(text + channelAt) == channel.substr(0, kLen - channelAt);
+      }
+      std::string_view view() const { return text; }
+    };
+
+  } // namespace core
+} // namespace milo
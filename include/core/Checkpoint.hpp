@@ -0,0 +1,136 @@
+#pragma once
+/** @file  Checkpoint.hpp
+ *  @brief Where a run has got to, persisted while it runs so a reset can resume it.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+
+// MILO headers
+#include "core/Clock.hpp"
+#include "core/ParameterStore.hpp"
+#include "core/TripleBuffer.hpp"
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @struct Checkpoint
+ * @brief The last safe point of a run: enough to restart its sweep there after a reset.
+ *
+ *  Fixed-size, so filling and saving it while RUNNING never touches the heap.
+ */
+    struct Checkpoint {
+      static constexpr std::size_t kNameLen = 63;
+
+      char run[kNameLen + 1]{};      ///< run log file name; empty between sweep runs
+      char protocol[kNameLen + 1]{}; ///< ProtocolFactory name
+      std::uint32_t sweepRun{ 0 };   ///< index into the SweepPlan
+      std::uint32_t sweepTotal{ 1 }; ///< SweepPlan::size(), to recognise the plan again
+      std::uint32_t step{ 0 };       ///< first step not known to be done: resume here
+      std::chrono::milliseconds elapsed{ 0 }; ///< run time up to here, across resumes
+      std::array<float, std::size(kParameters)> params{}; ///< in kParameters order
+    };
+
+    /**
+ * @class CheckpointStore
+ * @brief `<dir>/checkpoint` — a few hundred bytes of `key=value` lines ending in a CRC.
+ *
+ *  * `save()` writes a temp file, fdatasync()s it, renames it over the old one and fsync()s
+ *    the directory, so a reset leaves either the previous checkpoint or the new one, never
+ *    half of each. Blocking I/O: Checkpointer calls it from its own writer thread.
+ *  * `load()` returns nothing for a missing, truncated or corrupt file.
+ *  * The file exists exactly while a sweep is in progress: a file found at boot means
+ *    the sweep was interrupted.
+ */
+    class CheckpointStore {
+    public:
+      static constexpr const char* kFileName = "checkpoint";
+
+      explicit CheckpointStore(std::string dir);
+
+      bool save(const Checkpoint& cp);
+      std::optional<Checkpoint> load() const;
+      void clear();
+
+      const std::string& path() const { return path_; }
+
+    private:
+      std::string dir_;
+      std::string path_;
+      std::string tmp_;
+    };
+
+    /**
+ * @class Checkpointer
+ * @brief What a protocol sees of checkpointing (ExperimentProtocol::useCheckpoints()).
+ *
+ *  * `firstStep()`: where this run starts — 0, or the saved step of a resumed run.
+ *  * `reached(n)`: steps before `n` are done. Called at the protocol's safe points (as
+ *    often as it likes); at most once per period it copies the checkpoint into a
+ *    TripleBuffer for the writer thread, so the protocol thread never waits on the disk.
+ *  * Resuming is at-least-once: steps reported after the last save reached the disk are
+ *    run again after a reset, so a checkpointing protocol's steps must be safe to repeat.
+ *  * SystemCoordinator `begin()`s it for every run and `end()`s it after the sweep; both
+ *    wait for the writer (they run outside RUNNING). Protocol thread only.
+ */
+    class Checkpointer {
+    public:
+      Checkpointer(CheckpointStore& store, Clock& clock, Clock::Duration period);
+      ~Checkpointer();
+
+      std::uint32_t firstStep() const { return first_; }
+      void reached(std::uint32_t next);
+
+      /// Start tracking the run described by \p cp (resuming at `cp.step`), or between
+      /// sweep runs the position of the next one; on disk when this returns.
+      void begin(const Checkpoint& cp);
+      /// The sweep is over: nothing to resume.
+      void end();
+      /// Wait until every checkpoint handed to the writer so far has been saved.
+      void flush();
+
+      const Checkpoint& current() const { return cp_; }
+      /// Checkpoints the writer saved; hand-overs it had not got to yet are coalesced.
+      std::uint64_t saves() const { return saves_.load(std::memory_order_acquire); }
+
+      Checkpointer(const Checkpointer&) = delete;
+      Checkpointer& operator=(const Checkpointer&) = delete;
+
+    private:
+      struct Pending {
+        Checkpoint cp;
+        std::uint64_t seq{ 0 };
+      };
+
+      void persist();
+      void writerLoop();
+
+      CheckpointStore& store_;
+      Clock* clock_;
+      Clock::Duration period_;
+      Checkpoint cp_{};
+      std::uint32_t first_{ 0 };
+      Clock::Duration started_{ 0 }; ///< clock time the run's elapsed time counts from
+      Clock::Duration savedAt_{ 0 };
+
+      TripleBuffer<Pending> pending_;
+      std::uint64_t handedOver_{ 0 };           ///< protocol thread
+      std::atomic<std::uint64_t> written_{ 0 }; ///< seq of the last checkpoint the writer took
+      std::atomic<std::uint32_t> signal_{ 0 };  ///< bumped on every hand-over (atomic wait)
+      std::atomic<bool> stop_{ false };
+      std::atomic<std::uint64_t> saves_{ 0 };
+      std::thread writer_; ///< last: started once everything above exists
+    };
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,75 @@
+#pragma once
+/** @file  Clock.hpp
+ *  @brief Injectable monotonic time source: the real steady clock, or virtual time for simulation.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <atomic>
+#include <chrono>
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @class Clock
+ * @brief What timeouts, delays and step timing ask for “now” and wait on.
+ *
+ *  * Time is nanoseconds since the CLOCK_MONOTONIC epoch — the same scale as TimerWheel,
+ *    LogEvent and the kernel’s GPIO edge timestamps.
+ *  * `sleepUntil()` blocks on the real clock; a VirtualClock jumps there instead, so code
+ *    that only waits through its clock runs as fast as the CPU allows.
+ *  * `Clock::steady()` is the process-wide default every component starts with.
+ */
+    class Clock {
+    public:
+      using Duration = std::chrono::nanoseconds;
+
+      virtual ~Clock() = default;
+
+      virtual Duration now() const = 0;
+      /// Wait until \p t (returns at once if it has passed).
+      virtual void sleepUntil(Duration t) = 0;
+      void sleepFor(Duration d) { sleepUntil(now() + d); }
+      /// True when waiting costs no real time (simulation).
+      virtual bool isVirtual() const { return false; }
+
+      static Clock& steady();
+    };
+
+    class SteadyClock final : public Clock {
+    public:
+      Duration now() const override {
+        return std::chrono::steady_clock::now().time_since_epoch();
+      }
+      void sleepUntil(Duration t) override;
+    };
+
+    /**
+ * @class VirtualClock
+ * @brief Simulation time: stands still until someone waits, then jumps to the deadline.
+ *
+ *  * Deterministic: the same sequence of waits always yields the same timestamps.
+ *  * Never goes backwards; readable from any thread, advanced by the simulated thread.
+ */
+    class VirtualClock final : public Clock {
+    public:
+      explicit VirtualClock(Duration start = Duration{ 0 }) : now_(start.count()) {}
+
+      Duration now() const override { return Duration{ now_.load(std::memory_order_acquire) }; }
+      void sleepUntil(Duration t) override {
+        auto cur = now_.load(std::memory_order_relaxed);
+        while (t.count() > cur &&
+               !now_.compare_exchange_weak(cur, t.count(), std::memory_order_acq_rel))
+          ;
+      }
+      bool isVirtual() const override { return true; }
+
+      void advance(Duration d) { sleepUntil(now() + d); }
+
+    private:
+      std::atomic<Duration::rep> now_;
+    };
+
+  } // namespace core
+} // namespace milo
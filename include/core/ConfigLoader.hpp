@@ -5,21 +5,27 @@
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
+#include <optional>
 #include <string>
 
-namespace nlohmann {
-  class json;
-} // namespace nlohmann
+#include <nlohmann/json_fwd.hpp>
+
+#include "core/DeviceRegistry.hpp"
+#include "core/Logger.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/Sweep.hpp"
 
 namespace milo::core {
 
   /**
  * @class ConfigLoader
- * @brief Thin helper that reads a JSON file, validates a checksum, and hands
- *        the parsed object to the caller.
+ * @brief Thin helper that reads a JSON file and hands the parsed object to the caller.
  *
  *  * No caching — every call to `load()` re-reads the file (cheap, tiny file).
- *  * All schema validation lives in the calling layer (SystemCoordinator).
+ *  * All schema validation lives in the calling layer (SystemCoordinator), or in a
+ *    block's own mapping below.
+ *  * Built only when nlohmann_json is found (`MILO_HAVE_CONFIG`); without it the daemon
+ *    runs on the compiled-in defaults.
  */
   class ConfigLoader {
   public:
@@ -33,4 +39,26 @@ namespace milo::core {
     std::string path_;
   };
 
+  /// The `"runtime"` block of \p config; anything missing keeps its RuntimeConfig default.
+  /// @throws std::runtime_error on a wrongly typed value or an unknown policy name.
+  RuntimeConfig runtimeConfig(const nlohmann::json& config);
+
+  /// The `"sweep"` block of \p config (schema in SweepPlan), or nullopt if there is none.
+  /// @throws std::runtime_error on a missing protocol, an unknown parameter, an axis with
+  ///         neither `values` nor `from`/`to`/`step`, a zero step or `repeats` < 1.
+  std::optional<SweepPlan> sweepPlan(const nlohmann::json& config);
+
+  /// The `"logging"` block of \p config; anything missing keeps its LogRetention default.
+  /// @throws std::runtime_error on a wrongly typed value or a quota that is not positive.
+  LogRetention logRetention(const nlohmann::json& config);
+
+  /// The `"devices"` block of \p config (schema in DeviceRegistry), or
+  /// `DeviceRegistry::defaults()` if there is none. `path` may be left out (a channel attached
+  /// by hand); `codec` and each `serial` key (`baud`, `lowLatency`, `vmin`, `vtime`) keep their
+  /// DeviceSpec defaults when missing.
+  /// @throws std::runtime_error on a wrongly typed value, a baud rate or codec name the
+  ///         parsers reject, `vmin`/`vtime` above 255, an empty or duplicate name, or more
+  ///         than kMaxDevices entries.
+  DeviceRegistry deviceRegistry(const nlohmann::json& config);
+
 } // namespace milo::core
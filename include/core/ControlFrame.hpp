@@ -0,0 +1,207 @@
+#pragma once
+/** @file  ControlFrame.hpp
+ *  @brief Wire format of the control socket: length-prefixed binary frames (LLD §3.11).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace milo {
+  namespace core {
+    namespace control {
+
+      /**
+ * Frame = u32 length (little-endian, counts the type byte and the body) · u8 type · body.
+ * Numbers in bodies are little-endian; text runs to the end of the body (no terminator).
+ *
+ *  | type           | body                                      | reply / meaning         |
+ *  |----------------|-------------------------------------------|-------------------------|
+ *  | Ping           | –                                         | Ok                      |
+ *  | SetParam       | u8 parameter · f32 value                  | Ok                      |
+ *  | GetParam       | u8 parameter                              | Ok · f32 value          |
+ *  | SelectProtocol | name                                      | Ok                      |
+ *  | Start, Abort   | –                                         | Ok                      |
+ *  | Resume         | –                                         | Ok (interrupted sweep)  |
+ *  | Discard        | –                                         | Ok (interrupted sweep)  |
+ *  | Subscribe      | u8 topics (kEvents | kMeasurements, 0=off)| Ok                      |
+ *  | Error          | message                                   | any request failed      |
+ *  | StateChanged   | i64 ns · u8 from · u8 to                  | stream (kEvents)        |
+ *  | Fault          | i64 ns · u8 state · reason                | stream (kEvents)        |
+ *  | Measurement    | i64 ns · u8 LogEvent::Type · f64 · key    | stream (kMeasurements)  |
+ *  | Lost           | u32 count                                 | stream frames dropped   |
+ */
+      enum class MsgType : std::uint8_t {
+        Ping = 0x01,
+        SetParam = 0x02,
+        GetParam = 0x03,
+        SelectProtocol = 0x04,
+        Start = 0x05,
+        Abort = 0x06,
+        Subscribe = 0x07,
+        Resume = 0x08,
+        Discard = 0x09,
+
+        Ok = 0x80,
+        Error = 0x81,
+
+        StateChanged = 0x90,
+        Fault = 0x91,
+        Measurement = 0x92,
+        Lost = 0x93,
+      };
+
+      inline constexpr std::uint8_t kEvents = 0x01;       ///< state changes and faults
+      inline constexpr std::uint8_t kMeasurements = 0x02; ///< everything the protocol logs
+
+      inline constexpr std::size_t kLengthBytes = 4;
+      inline constexpr std::size_t kMaxBody = 255;
+      inline constexpr std::size_t kMaxFrame = kLengthBytes + 1 + kMaxBody;
+
+      /**
+ * @class Frame
+ * @brief One message with a fixed-capacity body; put*() past kMaxBody is truncated and
+ *        flagged, get*() past the end returns nullopt — no heap either way.
+ */
+      class Frame {
+      public:
+        Frame() = default;
+        explicit Frame(MsgType type) : type_(type) {}
+
+        MsgType type() const { return type_; }
+        std::span<const std::byte> body() const { return { body_.data(), size_ }; }
+        bool truncated() const { return truncated_; }
+
+        // ---- writing -----------------------------------------------------------
+        Frame& putU8(std::uint8_t v) { return putRaw(&v, 1); }
+        Frame& putU32(std::uint32_t v) { return putLe(v); }
+        Frame& putI64(std::int64_t v) { return putLe(static_cast<std::uint64_t>(v)); }
+        Frame& putF32(float v) {
+          std::uint32_t bits;
+          std::memcpy(&bits, &v, sizeof(bits));
+          return putLe(bits);
+        }
+        Frame& putF64(double v) {
+          std::uint64_t bits;
+          std::memcpy(&bits, &v, sizeof(bits));
+          return putLe(bits);
+        }
+        Frame& putText(std::string_view s) { return putRaw(s.data(), s.size()); }
+
+        // ---- reading (sequential from the start of the body) -------------------
+        std::optional<std::uint8_t> getU8() {
+          std::uint8_t v;
+          return getRaw(&v, 1) ? std::optional(v) : std::nullopt;
+        }
+        std::optional<std::uint32_t> getU32() { return getLe<std::uint32_t>(); }
+        std::optional<std::int64_t> getI64() {
+          const auto v = getLe<std::uint64_t>();
+          return v ? std::optional(static_cast<std::int64_t>(*v)) : std::nullopt;
+        }
+        std::optional<float> getF32() {
+          const auto bits = getLe<std::uint32_t>();
+          if (!bits)
+            return std::nullopt;
+          float v;
+          std::memcpy(&v, &*bits, sizeof(v));
+          return v;
+        }
+        std::optional<double> getF64() {
+          const auto bits = getLe<std::uint64_t>();
+          if (!bits)
+            return std::nullopt;
+          double v;
+          std::memcpy(&v, &*bits, sizeof(v));
+          return v;
+        }
+        /// The rest of the body.
+        std::string_view getText() {
+          std::string_view s(reinterpret_cast<const char*>(body_.data()) + read_, size_ - read_);
+          read_ = size_;
+          return s;
+        }
+
+        // ---- wire --------------------------------------------------------------
+        std::size_t encodedSize() const { return kLengthBytes + 1 + size_; }
+
+        /// Write the frame to \p out; returns the bytes used, 0 if \p out is too small.
+        std::size_t encode(std::span<std::byte> out) const {
+          const auto n = encodedSize();
+          if (out.size() < n)
+            return 0;
+          const auto len = static_cast<std::uint32_t>(1 + size_);
+          for (std::size_t i = 0; i < kLengthBytes; ++i)
+            out[i] = static_cast<std::byte>(len >> (8 * i));
+          out[kLengthBytes] = static_cast<std::byte>(type_);
+          std::memcpy(out.data() + kLengthBytes + 1, body_.data(), size_);
+          return n;
+        }
+
+        /// Length field of a frame starting at \p in (which must hold kLengthBytes).
+        static std::uint32_t peekLength(std::span<const std::byte> in) {
+          std::uint32_t len = 0;
+          for (std::size_t i = 0; i < kLengthBytes; ++i)
+            len |= std::to_integer<std::uint32_t>(in[i]) << (8 * i);
+          return len;
+        }
+
+        /// Parse one complete frame of \p len bytes (type + body, as announced by its length).
+        static std::optional<Frame> decode(std::span<const std::byte> typeAndBody) {
+          if (typeAndBody.empty() || typeAndBody.size() > 1 + kMaxBody)
+            return std::nullopt;
+          Frame f(static_cast<MsgType>(typeAndBody[0]));
+          f.size_ = typeAndBody.size() - 1;
+          std::memcpy(f.body_.data(), typeAndBody.data() + 1, f.size_);
+          return f;
+        }
+
+      private:
+        Frame& putRaw(const void* p, std::size_t n) {
+          const auto room = kMaxBody - size_;
+          if (n > room) {
+            truncated_ = true;
+            n = room;
+          }
+          std::memcpy(body_.data() + size_, p, n);
+          size_ += n;
+          return *this;
+        }
+        template <typename U> Frame& putLe(U v) {
+          std::array<std::byte, sizeof(U)> b;
+          for (std::size_t i = 0; i < sizeof(U); ++i)
+            b[i] = static_cast<std::byte>(v >> (8 * i));
+          return putRaw(b.data(), b.size());
+        }
+        bool getRaw(void* p, std::size_t n) {
+          if (size_ - read_ < n)
+            return false;
+          std::memcpy(p, body_.data() + read_, n);
+          read_ += n;
+          return true;
+        }
+        template <typename U> std::optional<U> getLe() {
+          std::array<std::byte, sizeof(U)> b;
+          if (!getRaw(b.data(), b.size()))
+            return std::nullopt;
+          U v = 0;
+          for (std::size_t i = 0; i < sizeof(U); ++i)
+            v = static_cast<U>(v | (std::to_integer<U>(b[i]) << (8 * i)));
+          return v;
+        }
+
+        MsgType type_{ MsgType::Ping };
+        std::size_t size_{ 0 };
+        std::size_t read_{ 0 };
+        bool truncated_{ false };
+        std::array<std::byte, kMaxBody> body_{};
+      };
+
+    } // namespace control
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,132 @@
+#pragma once
+/** @file  ControlServer.hpp
+ *  @brief Local control and event-streaming API on a Unix domain socket (LLD §3.11).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/ControlFrame.hpp"
+#include "core/LogEvent.hpp"
+#include "core/SystemEvent.hpp"
+
+namespace milo {
+  namespace core {
+
+    class ParameterStore;
+
+    /**
+ * @class ControlServer
+ * @brief Lets scripts do what the front panel does: set parameters, pick a protocol,
+ *        start/abort, resume or discard an interrupted sweep, and follow state changes and
+ *        measurements live.
+ *
+ *  * Frames are ControlFrame.hpp’s; every request gets exactly one Ok/Error reply, in order.
+ *  * Served from the caller’s event loop: `fd()` (an epoll set of the listening socket and
+ *    every client) turns readable when there is work, `service()` does it without blocking.
+ *    No thread per client, no thread at all.
+ *  * Every client has fixed input/output buffers (one frame in, kOutBytes out). A client
+ *    that does not read loses stream frames — counted, and reported in a `Lost` frame once
+ *    it catches up — and its further requests are not read until its replies fit again.
+ *    A malformed length prefix closes the connection. Nothing a client does reaches the
+ *    protocol thread: events and measurements come off broadcast rings it never waits on.
+ *  * Actions run on the serving thread; they must return promptly (hand a run off, do not
+ *    perform it). An action left empty answers its request with an Error.
+ *  * Local trust only: the socket file is created kSocketMode (owner and group), and a peer
+ *    that is neither root, the daemon's user nor in the daemon's group (SO_PEERCRED) is
+ *    disconnected on accept — counted in `refused()`.
+ */
+    class ControlServer {
+    public:
+      static constexpr std::size_t kMaxClients = 8;
+      static constexpr std::size_t kOutBytes = 16 * 1024;
+      static constexpr const char* kDefaultPath = "/run/milo/control.sock";
+      static constexpr unsigned kSocketMode = 0660;
+
+      /// What requests other than parameter access do; a throw becomes the Error reply.
+      struct Actions {
+        std::function<void(const std::string&)> selectProtocol;
+        std::function<void()> start;
+        std::function<void()> abort;
+        std::function<void()> resume;  ///< carry on with the sweep a reset interrupted
+        std::function<void()> discard; ///< decline it and delete its checkpoint
+      };
+
+      /// Bind \p path (a stale socket file is replaced) with kSocketMode. nullptr if the socket
+      /// is unavailable.
+      static std::unique_ptr<ControlServer> create(const std::string& path, ParameterStore& params,
+                                                   Actions actions);
+      ~ControlServer(); ///< closes every client and removes the socket file
+
+      /// Stream the coordinator’s transitions and errors to kEvents subscribers (setup).
+      void attachEventBus(EventBus& bus) { events_ = bus.subscribe("control"); }
+      /// Stream everything the protocol logs to kMeasurements subscribers (setup).
+      void attachMeasurementBus(MeasurementBus& bus) { measurements_ = bus.subscribe("control"); }
+
+      /// Readable when a connection, a request or buffer space is waiting (poll/epoll it).
+      int fd() const { return epfd_; }
+
+      /**
+       * @brief Accept, answer requests, flush output and fan out whatever the buses carry.
+       *        Never blocks. Call when `fd()` is readable and periodically (for the streams).
+       * @return requests handled.
+       */
+      std::size_t service();
+
+      std::size_t clients() const;
+      /// Stream frames dropped because a client’s output buffer was full (all clients).
+      std::uint64_t dropped() const { return dropped_; }
+      /// Connections closed at accept because the peer's credentials are not trusted.
+      std::uint64_t refused() const { return refused_; }
+      const std::string& path() const { return path_; }
+
+      ControlServer(const ControlServer&) = delete;
+      ControlServer& operator=(const ControlServer&) = delete;
+
+    private:
+      struct Client {
+        int fd{ -1 };
+        std::uint8_t topics{ 0 };
+        std::uint32_t interest{ 0 }; ///< epoll events currently registered
+        std::uint32_t lost{ 0 }; ///< stream frames dropped since the last Lost frame
+        std::size_t inLen{ 0 };
+        std::size_t outLen{ 0 };
+        std::array<std::byte, control::kMaxFrame> in{};
+        std::array<std::byte, kOutBytes> out{};
+      };
+
+      ControlServer(std::string path, int listenFd, int epfd, ParameterStore& params,
+                    Actions actions);
+
+      void accept();
+      void receive(Client& c);
+      std::size_t handleInput(Client& c);
+      control::Frame handle(Client& c, control::Frame& req);
+      /// Queue \p f; false if it does not fit.
+      bool enqueue(Client& c, const control::Frame& f);
+      void stream(std::uint8_t topic, const control::Frame& f);
+      void flush(Client& c);
+      void drop(Client& c);
+      void drainBuses();
+
+      std::string path_;
+      int listenFd_;
+      int epfd_;
+      ParameterStore& params_;
+      Actions actions_;
+      std::vector<Client> clients_; ///< kMaxClients slots, allocated once; fd −1 = free
+      EventBus::Cursor events_{};
+      MeasurementBus::Cursor measurements_{};
+      std::uint64_t dropped_{ 0 };
+      std::uint64_t refused_{ 0 };
+    };
+
+  } // namespace core
+} // namespace milo
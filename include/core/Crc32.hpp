@@ -0,0 +1,39 @@
+#pragma once
+/** @file  Crc32.hpp
+ *  @brief CRC-32 (IEEE 802.3, as used by zlib/gzip) for on-disk integrity checks.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace milo {
+  namespace core {
+
+    namespace detail {
+      constexpr std::array<std::uint32_t, 256> makeCrc32Table() {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+          std::uint32_t c = i;
+          for (int k = 0; k < 8; ++k)
+            c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+          t[i] = c;
+        }
+        return t;
+      }
+      inline constexpr auto kCrc32Table = makeCrc32Table();
+    } // namespace detail
+
+    /// CRC of \p n bytes; pass a previous result as \p crc to continue a running checksum.
+    inline std::uint32_t crc32(const void* data, std::size_t n, std::uint32_t crc = 0) {
+      const auto* p = static_cast<const unsigned char*>(data);
+      std::uint32_t c = ~crc;
+      for (std::size_t i = 0; i < n; ++i)
+        c = detail::kCrc32Table[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
+      return ~c;
+    }
+
+  } // namespace core
+} // namespace milo
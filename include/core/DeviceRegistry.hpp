@@ -0,0 +1,97 @@
+#pragma once
+/** @file  DeviceRegistry.hpp
+ *  @brief Runtime table of the rig's serial devices, addressed by dense index.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MILO headers
+#include "io/SerialSettings.hpp"
+
+namespace milo {
+  namespace core {
+
+    /** Handle of a registered device: its index in the DeviceRegistry (0 … size()-1). */
+    struct Device {
+      std::uint8_t index{ 0 };
+
+      friend constexpr bool operator==(Device, Device) = default;
+    };
+
+    /** Line framing a device speaks; both directions use the same terminator. */
+    enum class Codec : std::uint8_t { AsciiCrlf, AsciiLf };
+
+    constexpr std::string_view terminator(Codec c) { return c == Codec::AsciiLf ? "\n" : "\r\n"; }
+
+    struct DeviceSpec {
+      std::string name; ///< unique; used in logs, telemetry and capture channel names
+      std::string path; ///< tty (udev symlink); empty for channels attached by hand
+      io::SerialSettings serial{}; ///< baud, low-latency mode, read threshold
+      Codec codec{ Codec::AsciiCrlf };
+    };
+
+    /**
+ * @class DeviceRegistry
+ * @brief The `"devices"` block of config.json, resolved once to dense indices.
+ *
+ *  ```json
+ *  "devices": [
+ *    { "name": "PG",    "path": "/dev/pg1",   "serial": { "baud": 115200 } },
+ *    { "name": "PSU",   "path": "/dev/psu1",
+ *      "serial": { "baud": 1000000, "lowLatency": true, "vmin": 4, "vtime": 0 } },
+ *    { "name": "Pump1", "path": "/dev/pump1", "serial": { "baud": 57600 } },
+ *    { "name": "Pump2", "path": "/dev/pump2", "serial": { "baud": 250000 }, "codec": "ascii-lf" }
+ *  ]
+ *  ```
+ *  Names are looked up once at configuration time (`at()`); everything on the run path then
+ *  carries a `Device` and indexes flat per-device vectors. `deviceRegistry()` (ConfigLoader.hpp)
+ *  reads the block, mapping baud and codec names with `parseBaud()` / `parseCodec()`; each
+ *  `"serial"` key left out keeps its SerialSettings default.
+ *  Immutable once handed to RPCManager.
+ */
+    class DeviceRegistry {
+    public:
+      /// Fits one telemetry slot per device and a uint8_t capture channel id.
+      static constexpr std::size_t kMaxDevices = 16;
+
+      DeviceRegistry() = default;
+      /// @throws std::invalid_argument on an empty/duplicate name or more than kMaxDevices.
+      explicit DeviceRegistry(std::vector<DeviceSpec> specs);
+
+      /// The bench rig: PG, PSU and Pump on their udev symlinks at 115200 8N1.
+      static DeviceRegistry defaults();
+
+      /// @throws std::invalid_argument like the constructor.
+      Device add(DeviceSpec spec);
+
+      std::optional<Device> find(std::string_view name) const;
+      /// @throws std::invalid_argument if \p name is not registered.
+      Device at(std::string_view name) const;
+
+      bool contains(Device d) const { return d.index < specs_.size(); }
+      const DeviceSpec& spec(Device d) const { return specs_[d.index]; }
+      const std::string& name(Device d) const { return specs_[d.index].name; }
+      std::size_t size() const { return specs_.size(); }
+      bool empty() const { return specs_.empty(); }
+
+      /// Every registered device, in index order.
+      std::vector<Device> all() const;
+
+      /// Any rate in SerialSettings::kMinBaud … kMaxBaud (non-standard ones included).
+      static std::optional<std::uint32_t> parseBaud(unsigned long baud);
+      /// "ascii-crlf" | "ascii-lf".
+      static std::optional<Codec> parseCodec(std::string_view name);
+
+    private:
+      std::vector<DeviceSpec> specs_;
+    };
+
+  } // namespace core
+} // namespace milo
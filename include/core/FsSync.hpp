@@ -0,0 +1,37 @@
+#pragma once
+/** @file  FsSync.hpp
+ *  @brief The fsync()s that make a write-temp-then-rename update survive a power cut.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace milo {
+  namespace core {
+
+    /// fdatasync() the file at \p path: its data is on disk before it is renamed into place.
+    inline bool syncFile(const std::string& path) {
+      const int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+      if (fd < 0)
+        return false;
+      const bool ok = ::fdatasync(fd) == 0;
+      ::close(fd);
+      return ok;
+    }
+
+    /// fsync() the directory \p dir: a rename, create or unlink in it is on disk.
+    inline bool syncDirectory(const std::string& dir) {
+      const int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+      if (fd < 0)
+        return false;
+      const bool ok = ::fsync(fd) == 0;
+      ::close(fd);
+      return ok;
+    }
+
+  } // namespace core
+} // namespace milo
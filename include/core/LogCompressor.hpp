@@ -0,0 +1,82 @@
+#pragma once
+/** @file  LogCompressor.hpp
+ *  @brief Idle-priority background compression of finished run logs (`.mlz` files).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @class LogCompressor
+ * @brief One SCHED_IDLE worker that turns `run.csv` into `run.csv.mlz`, a file at a time.
+ *
+ *  `.mlz` layout: `"MLZ1"`, then blocks of `u32 raw  u32 packed  u32 crc32(raw)  payload`
+ *  (packed == raw: stored uncompressed), ended by a block with raw == 0. 64 KiB blocks keep
+ *  memory small and make `pause()` take effect within one block.
+ *
+ *  * SCHED_IDLE: only runs on an otherwise idle CPU, and is paused outright while a run
+ *    is being recorded, so it never competes with the real-time threads.
+ *  * The source is left alone; `done` decides what to keep (Logger deletes the CSV and
+ *    updates the manifest). A job interrupted by shutdown leaves no partial output.
+ */
+    class LogCompressor {
+    public:
+      static constexpr std::size_t kBlock = 64 * 1024;
+      static constexpr const char* kSuffix = ".mlz";
+
+      /// Called on the worker thread after each job; \p ok false leaves no `.mlz` behind.
+      using Done = std::function<void(const std::string& src, std::uint64_t rawBytes,
+                                      std::uint64_t packedBytes, bool ok)>;
+
+      explicit LogCompressor(Done done);
+      ~LogCompressor(); ///< abandons queued work; the current file is dropped, not half-written
+
+      void enqueue(const std::string& path); ///< no-op if already queued
+      void pause();                          ///< returns at once; stops at the next block
+      void resume();
+      bool paused() const;
+      std::size_t pending() const; ///< queued + in progress
+      void waitIdle();             ///< blocks until nothing is pending (or paused with work)
+
+      /// Compress \p src into \p dst; \p keepGoing is polled between blocks (false aborts).
+      /// True only once \p dst and its directory entry are on disk: \p src may then go.
+      static bool compressFile(const std::string& src, const std::string& dst,
+                               const std::function<bool()>& keepGoing = {});
+      /// Contents of a run log, whether plain or `.mlz`; nullopt if missing or corrupt.
+      static std::optional<std::string> readFile(const std::string& path);
+      /// \p length bytes at raw offset \p offset (fewer at the end); for `.mlz` only the
+      /// blocks overlapping the range are decompressed.
+      static std::optional<std::string> readRange(const std::string& path, std::uint64_t offset,
+                                                  std::uint64_t length);
+
+      LogCompressor(const LogCompressor&) = delete;
+      LogCompressor& operator=(const LogCompressor&) = delete;
+
+    private:
+      void workerLoop();
+      bool waitWhilePaused(); ///< false when stopping
+
+      Done done_;
+      mutable std::mutex mtx_;
+      std::condition_variable cv_;
+      std::condition_variable idleCv_;
+      std::deque<std::string> queue_;
+      std::string current_;
+      bool paused_{ false };
+      bool stop_{ false };
+      std::thread worker_; ///< started with the first job
+    };
+
+  } // namespace core
+} // namespace milo
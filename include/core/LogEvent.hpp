@@ -0,0 +1,80 @@
+#pragma once
+/** @file  LogEvent.hpp
+ *  @brief Fixed-size record passed from the protocol thread to the Logger.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "core/BroadcastRing.hpp"
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @struct LogEvent
+ * @brief timestamp, type, key/value (LLD §3.7) — trivially copyable so it travels through
+ *        the SPSC ring without touching the heap.
+ */
+    struct LogEvent {
+      enum class Type : std::uint8_t { Sample, Command, Response, State, Error };
+      static constexpr std::size_t kTypeCount = 5;
+
+      static constexpr std::size_t kKeyLen = 23;
+
+      std::chrono::nanoseconds timestamp{ 0 }; ///< steady_clock since epoch
+      Type type{ Type::Sample };
+      char key[kKeyLen + 1]{}; ///< e.g. "PSU.V"; truncated, always NUL-terminated
+      double value{ 0.0 };
+
+      /// Builds an event stamped with steady_clock::now().
+      static LogEvent make(Type type, std::string_view key, double value) {
+        LogEvent e;
+        e.timestamp = std::chrono::steady_clock::now().time_since_epoch();
+        e.type = type;
+        const auto n = std::min(key.size(), kKeyLen);
+        std::copy_n(key.data(), n, e.key);
+        e.value = value;
+        return e;
+      }
+    };
+
+    /**
+ * @struct SampleBlock
+ * @brief Up to `kSamples` consecutive samples of one streamed channel, columns side by side
+ *        (SampleStreams → Logger): one queue slot per block instead of per sample.
+ */
+    struct SampleBlock {
+      static constexpr std::size_t kSamples = 64;
+
+      char key[LogEvent::kKeyLen + 1]{}; ///< "DEVICE.CHANNEL"
+      std::uint32_t count{ 0 };
+      std::int64_t t[kSamples]{}; ///< ns, same clock as LogEvent::timestamp
+      float v[kSamples]{};
+    };
+
+    /// Optional live copy of everything logged (written by the protocol thread only).
+    using MeasurementBus = BroadcastRing<LogEvent>;
+
+    constexpr const char* toString(LogEvent::Type t) {
+      switch (t) {
+      case LogEvent::Type::Sample:
+        return "sample";
+      case LogEvent::Type::Command:
+        return "command";
+      case LogEvent::Type::Response:
+        return "response";
+      case LogEvent::Type::State:
+        return "state";
+      case LogEvent::Type::Error:
+        return "error";
+      }
+      return "unknown";
+    }
+
+  } // namespace core
+} // namespace milo
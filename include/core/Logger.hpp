@@ -6,32 +6,161 @@
  */
 
 #include <atomic>
-#include <fstream>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/LogCompressor.hpp"
+#include "core/LogEvent.hpp"
+#include "core/RunIndex.hpp"
+#include "core/RunManifest.hpp"
+#include "core/SystemEvent.hpp"
+#include "io/FileLogger.hpp"
 
 namespace milo {
   namespace core {
 
-    struct LogEvent;                        // defined later in src
     template <typename T> class RingBuffer; // forward decl to avoid heavy include
+    struct ChannelSummary;
+    class RuntimeProfile;
+    class TelemetryPublisher;
+
+    /**
+ * @struct LogRetention
+ * @brief The `"logging"` block of config.json: SD-card quota and archival of finished runs.
+ *
+ *  ```json
+ *  "logging": { "quotaMiB": 512, "compress": true }
+ *  ```
+ *  Read by `logRetention()` (ConfigLoader.hpp); anything missing keeps its default.
+ */
+    struct LogRetention {
+      std::uint64_t quotaBytes{ 512ull * 1024 * 1024 }; ///< on-disk (compressed) bytes of all runs
+      bool compress{ true }; ///< archive finished runs as `.mlz` (the newest stays plain CSV)
+    };
 
+    /**
+ * @class Logger
+ * @brief One CSV file per run (`<dir>/<UTC stamp>_runNNN.csv`), written by a worker thread.
+ *
+ *  * `log()` is the protocol thread’s wait-free path: one SPSC push, drop-and-count when full.
+ *    Streamed channels arrive as `logBlock()`s on a second SPSC queue (one push per 64
+ *    samples) and are written as ordinary `sample` lines.
+ *  * Run headers (`# key: value` lines) are written at the top of every run — this is where
+ *    the conditions a run was recorded under (e.g. timer jitter) end up.
+ *  * `note()` adds a `#` line mid-run from any thread (rare, mutex-guarded).
+ *  * Every run is listed in `<dir>/manifest` (RunManifest). Finished runs other than the
+ *    newest are compressed by an idle-priority LogCompressor, paused while a run is open;
+ *    before each run the oldest runs are deleted until the on-disk total fits the quota.
+ *  * Crash-consistent: run logs are written through a journal committed once per flush
+ *    period. Runs a reset left open are repaired from their journals when the Logger is
+ *    constructed, marked with an `# interrupted:` line and listed as interrupted.
+ *  * Each run gets a sparse time index (`<run>.csv.idx`, RunIndex) named in the manifest.
+ *  * With an event bus attached, the worker also records the coordinator’s state changes
+ *    (`state` lines) and errors (`error` lines) of the open run at its own pace.
+ */
     class Logger {
 
     public:
-      Logger() = default;
-      ~Logger() = default;
+      static constexpr std::size_t kDefaultQueue = 4096;
+      static constexpr std::size_t kBlockQueue = 64; ///< SampleBlocks (≈ 50 KiB)
+
+      explicit Logger(std::string logDir = "/mnt/sdcard/logs",
+                      std::size_t queueCapacity = kDefaultQueue);
+      ~Logger(); ///< finishRun()
 
       // --- public API ---
-      void startNewRun();              ///< open file + launch worker thread
+      void startNewRun();              ///< open file + launch worker thread; throws on I/O error
       void log(const LogEvent& event); ///< enqueue event (non-blocking)
+      /// Enqueue a block of streamed samples (non-blocking; a full queue drops the block and
+      /// counts its samples). Not mirrored into the measurement bus — live views decimate.
+      void logBlock(const SampleBlock& block);
       void finishRun();                ///< flush + join worker thread
 
+      /// Header line for this and every following run; replaces an existing \p key.
+      void setRunHeader(const std::string& key, std::string value);
+      void clearRunHeader(const std::string& key);
+      /// Comment line in the current run (dropped when no run is open).
+      void note(const std::string& key, const std::string& text);
+      /// The run’s statistics: one `# stats:` line per channel, and the manifest record's
+      /// `stats` field once the run is finished. Call before finishRun().
+      void recordStats(std::span<const ChannelSummary> stats);
+
+      /// Quota and compression; also queues finished runs left uncompressed by a previous boot.
+      void setRetention(const LogRetention& retention);
+      const RunManifest& manifest() const { return manifest_; }
+      /// Runs repaired at construction (left open by a crash or watchdog reset).
+      const std::vector<std::string>& recoveredRuns() const { return recovered_; }
+      /// Block until queued compression is done (tests, orderly shutdown).
+      void waitForCompression() { compressor_.waitIdle(); }
+
+      /// Scheduling for the worker thread (applied as ThreadRole::Logger).
+      void setRuntimeProfile(std::shared_ptr<const RuntimeProfile> profile) {
+        profile_ = std::move(profile);
+      }
+
+      /// Publish queue backlog/drops and a worker heartbeat; call before startNewRun().
+      void attachTelemetry(TelemetryPublisher& telemetry);
+
+      /// Subscribe the worker to \p bus (setup, before startNewRun()).
+      void attachEventBus(EventBus& bus) { busCursor_ = bus.subscribe("logger"); }
+
+      /// Also publish every logged event into \p bus (live streaming); `log()` stays wait-free.
+      void attachMeasurementBus(MeasurementBus& bus) { measurements_ = &bus; }
+
+      const std::string& currentRunPath() const { return runPath_; }
+      std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+      Logger(const Logger&) = delete;
+      Logger& operator=(const Logger&) = delete;
+
     private:
-      std::ofstream csvFile_;
+      void workerLoop();
+      void writeEvent(const LogEvent& e);
+      void writeBlock(const SampleBlock& b);
+      void drainEventBus();
+      void drainNotes();
+      std::string nextRunPath() const;
+      void recoverInterruptedRuns();
+      void enforceQuota();
+      void scheduleCompression();
+      void onCompressed(const std::string& src, std::uint64_t raw, std::uint64_t packed, bool ok);
+
+      std::string logDir_;
+      std::string runPath_;
+      io::FileLogger file_; ///< worker thread only while a run is open
+      RunIndexWriter index_; ///< same
+      std::string line_;    ///< reused formatting buffer (worker thread)
+
       std::unique_ptr<RingBuffer<LogEvent>> buffer_;
+      std::unique_ptr<RingBuffer<SampleBlock>> blocks_;
+      SampleBlock block_{}; ///< worker thread: popped block
       std::thread worker_;
       std::atomic<bool> running_{ false };
+      std::atomic<std::uint64_t> dropped_{ 0 };
+      EventBus::Cursor busCursor_; ///< worker thread only while a run is open
+      MeasurementBus* measurements_{ nullptr };
+
+      std::mutex notesMtx_;
+      std::vector<std::pair<std::string, std::string>> headers_;
+      std::vector<std::string> notes_;
+      std::string stats_; ///< manifest form of recordStats(), applied by finishRun()
+
+      std::shared_ptr<const RuntimeProfile> profile_;
+
+      TelemetryPublisher* telemetry_{ nullptr };
+      int queueSlot_{ -1 };
+      int threadSlot_{ -1 };
+
+      LogRetention retention_{};
+      RunManifest manifest_;
+      std::vector<std::string> recovered_;
+      LogCompressor compressor_; ///< last: its worker is joined before the rest goes away
     };
 
   } // namespace core
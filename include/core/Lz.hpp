@@ -0,0 +1,33 @@
+#pragma once
+/** @file  Lz.hpp
+ *  @brief Small self-contained LZ77 block codec (LZ4-style sequences) for run-log archival.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+namespace milo {
+  namespace core {
+    namespace lz {
+
+      /**
+       *  A block is a run of sequences `token [literal-length+] literals offset16 [match-length+]`;
+       *  the token’s high nibble is the literal count, the low nibble match length − 4
+       *  (15 = continued in 255-saturating bytes). The last sequence has literals only.
+       *  64 KiB window, 4 KiB-entry hash table on the stack: no heap, no dependency.
+       *  Run-log CSV typically shrinks 3–5×.
+       */
+      constexpr std::size_t maxCompressedSize(std::size_t n) { return n + n / 255 + 16; }
+
+      /// Compress \p in into \p out (at least maxCompressedSize(in.size())); @returns bytes used.
+      std::size_t compress(std::span<const char> in, std::span<char> out);
+
+      /// @returns the decoded size, or nullopt if \p in is malformed or does not fit \p out.
+      std::optional<std::size_t> decompress(std::span<const char> in, std::span<char> out);
+
+    } // namespace lz
+  } // namespace core
+} // namespace milo
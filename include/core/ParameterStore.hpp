@@ -5,6 +5,8 @@
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <unordered_map>
 
@@ -24,6 +26,23 @@ namespace milo {
       // …
     };
 
+    /// Every Parameter, in declaration order (snapshots, name lookup).
+    inline constexpr Parameter kParameters[] = { Parameter::Temp, Parameter::FlowRate,
+                                                 Parameter::Voltage };
+
+    inline const char* toString(Parameter p) {
+      switch (p) {
+      case Parameter::Temp:
+        return "Temp";
+      case Parameter::FlowRate:
+        return "FlowRate";
+      case Parameter::Voltage:
+        return "Voltage";
+      default:
+        return "Unknown";
+      }
+    }
+
     /** @class ParameterStore
  *  @brief Lock-protected map of <Parameter → float>.
  *
@@ -42,8 +61,12 @@ namespace milo {
       /// Thread-safe getter; returns 0 f if key missing.
       float get(Parameter p) const;
 
+      /// Bumped by every set(); lets a poller skip the lock until something was written.
+      std::uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
     private:
       mutable std::mutex mtx_;
+      std::atomic<std::uint64_t> version_{ 0 };
       std::unordered_map<Parameter, float>
           values_; // just for today use float primitive (strong types added on day 6)
     };
@@ -0,0 +1,299 @@
+#pragma once
+/** @file  ProtocolExecutor.hpp
+ *  @brief Single-threaded executor for coroutine protocols: replies, delays and parameter
+ *         changes are awaited instead of blocked on.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+// MILO headers
+#include "core/Clock.hpp"
+#include "core/DeviceRegistry.hpp"
+#include "core/ParameterStore.hpp"
+#include "core/RPCManager.hpp"
+#include "core/Task.hpp"
+#include "core/TimerWheel.hpp"
+#include "protocols/Response.hpp"
+
+namespace milo {
+  namespace core {
+
+    namespace detail {
+      /// A suspended wait the executor re-checks every loop (reply not in yet, parameter).
+      class Poller {
+      public:
+        /// true → the waiter can resume (result or error stored in the awaiter).
+        virtual bool poll() = 0;
+
+        void link(Poller*& head) {
+          head_ = &head;
+          next_ = head;
+          if (next_)
+            next_->prev_ = this;
+          head = this;
+        }
+        void unlink() {
+          if (!head_)
+            return;
+          (prev_ ? prev_->next_ : *head_) = next_;
+          if (next_)
+            next_->prev_ = prev_;
+          head_ = nullptr;
+          prev_ = next_ = nullptr;
+        }
+        Poller* next() const { return next_; }
+
+        std::coroutine_handle<> waiter{};
+
+      protected:
+        Poller() = default;
+        ~Poller() { unlink(); } // a destroyed frame must not stay on the list
+        Poller(const Poller&) = delete;
+        Poller& operator=(const Poller&) = delete;
+
+      private:
+        Poller** head_{ nullptr };
+        Poller* prev_{ nullptr };
+        Poller* next_{ nullptr };
+      };
+    } // namespace detail
+
+    /**
+ * @class ProtocolExecutor
+ * @brief Runs one protocol’s coroutines on the calling (protocol) thread.
+ *
+ *  * `run(task)` resumes the task and everything it `co_await`s until it finishes, then
+ *    returns its result or rethrows its exception — a blocking call from the outside.
+ *  * Awaitables: `sleepFor()` (TimerWheel), `response()` / `reply<Cmd>()` (RPCManager,
+ *    non-blocking polls under a per-wait deadline), `changed()` (ParameterStore).
+ *  * `whenAll(tasks…)` runs per-device sub-sequences concurrently: while one waits for its
+ *    instrument the others proceed, on the same thread, with no context switches.
+ *  * Nothing is ready → sleep until the earliest timer, or one poll period while replies or
+ *    parameters are awaited. All of it goes through \p clock: on a VirtualClock the sleep is
+ *    a jump, so a half-hour protocol against simulated devices finishes in milliseconds.
+ *  * With `attachStreams()`, idle waits are cut into \p period slices and stream lines are
+ *    drained between them, so a device streaming measurements is read during a long sleep.
+ *  * Coroutine frames and the ready queue live in the caller’s \p frames buffer (a protocol
+ *    member, i.e. in the run arena), so a run never reaches the heap unless it overflows.
+ */
+    class ProtocolExecutor {
+    public:
+      using Duration = Clock::Duration;
+      static constexpr std::chrono::microseconds kDefaultPollPeriod{ 200 };
+
+      explicit ProtocolExecutor(std::span<std::byte> frames, Clock& clock = Clock::steady(),
+                                std::chrono::microseconds pollPeriod = kDefaultPollPeriod);
+      ~ProtocolExecutor();
+
+      /// Drive \p main to completion; returns its value or rethrows its exception.
+      /// @throws std::logic_error if every task waits and nothing could wake one.
+      template <typename T> T run(Task<T> main) {
+        drive(main.handle());
+        return main.result();
+      }
+
+      // ---- awaitables ----------------------------------------------------------
+      class SleepAwaiter {
+      public:
+        SleepAwaiter(ProtocolExecutor& ex, Duration d)
+            : ex_(ex), delay_(d), timer_([this] { ex_.schedule(waiter_); }) {}
+        bool await_ready() const { return delay_.count() <= 0; }
+        void await_suspend(std::coroutine_handle<> h) {
+          waiter_ = h;
+          ex_.armIn(timer_, delay_);
+        }
+        void await_resume() const noexcept {}
+
+      private:
+        ProtocolExecutor& ex_;
+        Duration delay_;
+        std::coroutine_handle<> waiter_{};
+        Timer timer_;
+      };
+
+      /// Reply of \p dev under a deadline; \p PollFn returns optional<Value> without blocking.
+      template <typename Value, auto PollFn> class ReplyAwaiter : detail::Poller {
+      public:
+        ReplyAwaiter(ProtocolExecutor& ex, RPCManager& rpc, Device dev,
+                     std::chrono::milliseconds timeout)
+            : ex_(ex), rpc_(rpc), dev_(dev), timeout_(timeout), deadline_([this] {
+                unlink();
+                timedOut_ = true;
+                ex_.schedule(waiter);
+              }) {}
+
+        bool await_ready() { return poll(); } // the reply may already be buffered
+        void await_suspend(std::coroutine_handle<> h) {
+          waiter = h;
+          ex_.addPoller(*this);
+          ex_.armIn(deadline_, timeout_);
+        }
+        Value await_resume() {
+          if (error_)
+            std::rethrow_exception(error_);
+          if (timedOut_)
+            rpc_.replyTimedOut(dev_);
+          return std::move(*value_);
+        }
+
+        bool poll() override {
+          try {
+            value_ = PollFn(rpc_, dev_);
+          } catch (...) {
+            error_ = std::current_exception();
+          }
+          if (!value_ && !error_)
+            return false;
+          deadline_.cancel();
+          return true;
+        }
+
+      private:
+        ProtocolExecutor& ex_;
+        RPCManager& rpc_;
+        Device dev_;
+        std::chrono::milliseconds timeout_;
+        Timer deadline_;
+        std::optional<Value> value_{};
+        std::exception_ptr error_{};
+        bool timedOut_{ false };
+      };
+
+      /// Resumes with the new value once \p p differs from its value at the time of the await.
+      class ChangeAwaiter : detail::Poller {
+      public:
+        ChangeAwaiter(ProtocolExecutor& ex, const ParameterStore& store, Parameter p)
+            : ex_(ex), store_(store), param_(p), seen_(store.version()), initial_(store.get(p)),
+              value_(initial_) {}
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+          waiter = h;
+          ex_.addPoller(*this);
+        }
+        float await_resume() const noexcept { return value_; }
+
+        bool poll() override {
+          const auto v = store_.version();
+          if (v == seen_)
+            return false; // nothing written since the last look: no lock taken
+          seen_ = v;
+          value_ = store_.get(param_);
+          return value_ != initial_;
+        }
+
+      private:
+        ProtocolExecutor& ex_;
+        const ParameterStore& store_;
+        Parameter param_;
+        std::uint64_t seen_;
+        float initial_;
+        float value_;
+      };
+
+      SleepAwaiter sleepFor(Duration d) { return SleepAwaiter(*this, d); }
+
+      auto response(RPCManager& rpc, Device dev, std::chrono::milliseconds timeout) {
+        return ReplyAwaiter<protocols::Response, pollResponse>(*this, rpc, dev, timeout);
+      }
+
+      /// Typed reply to a schema command (see CommandSchema.hpp); throws like awaitReply<Cmd>().
+      template <typename Cmd>
+      auto reply(RPCManager& rpc, Device dev, std::chrono::milliseconds timeout) {
+        return ReplyAwaiter<typename Cmd::Reply::Value, pollReply<Cmd>>(*this, rpc, dev, timeout);
+      }
+
+      ChangeAwaiter changed(const ParameterStore& store, Parameter p) {
+        return ChangeAwaiter(*this, store, p);
+      }
+
+      /**
+       * @brief Start every task at once and resume when the last has finished. Results are
+       *        discarded; the first exception (in argument order) is rethrown after all ended.
+       */
+      template <typename... Ts> Task<void> whenAll(Task<Ts>... tasks) {
+        detail::JoinGroup group;
+        group.pending = sizeof...(Ts);
+        (start(tasks.handle(), group), ...);
+        co_await JoinAwaiter{ group };
+        std::exception_ptr first;
+        ((first = first ? first : tasks.handle().promise().error), ...);
+        if (first)
+          std::rethrow_exception(first);
+      }
+
+      /// whenAll() over a runtime-sized set, e.g. one sub-sequence per registered device.
+      Task<void> whenAll(std::span<Task<void>> tasks);
+
+      /// Drain \p rpc's stream lines (RPCManager::pumpStreams()) at least every \p period.
+      void attachStreams(RPCManager& rpc, Duration period = std::chrono::milliseconds{ 5 }) {
+        streams_ = &rpc;
+        streamPeriod_ = period;
+      }
+
+      // ---- scheduling ----------------------------------------------------------
+      Duration now() const { return clock_.now(); }
+      Clock& clock() const { return clock_; }
+      /// Queue \p h to be resumed on the next loop iteration.
+      void schedule(std::coroutine_handle<> h);
+      /// Arm \p t to fire \p delay from now on the executor’s wheel.
+      void armIn(Timer& t, Duration delay);
+      void addPoller(detail::Poller& p) { p.link(pollers_); }
+
+      std::uint64_t resumptions() const { return resumptions_; }
+
+      ProtocolExecutor(const ProtocolExecutor&) = delete;
+      ProtocolExecutor& operator=(const ProtocolExecutor&) = delete;
+
+    private:
+      struct JoinAwaiter {
+        detail::JoinGroup& group;
+        bool await_ready() const noexcept { return group.pending == 0; }
+        void await_suspend(std::coroutine_handle<> h) noexcept { group.waiter = h; }
+        void await_resume() const noexcept {}
+      };
+
+      static std::optional<protocols::Response> pollResponse(RPCManager& rpc, Device dev) {
+        return rpc.pollResponse(dev);
+      }
+      template <typename Cmd>
+      static std::optional<typename Cmd::Reply::Value> pollReply(RPCManager& rpc, Device dev) {
+        return rpc.pollReply<Cmd>(dev);
+      }
+
+      template <typename P> void start(std::coroutine_handle<P> h, detail::JoinGroup& group) {
+        h.promise().group = &group;
+        schedule(h);
+      }
+
+      void drive(std::coroutine_handle<> main);
+      bool pollAll();
+      void idle();
+
+      std::pmr::monotonic_buffer_resource buffer_;
+      std::pmr::unsynchronized_pool_resource frames_;
+      std::pmr::memory_resource* previous_;
+      Clock& clock_;
+      std::chrono::microseconds pollPeriod_;
+      TimerWheel wheel_;
+      std::pmr::vector<std::coroutine_handle<>> ready_;
+      std::pmr::vector<std::coroutine_handle<>> running_;
+      detail::Poller* pollers_{ nullptr };
+      std::uint64_t resumptions_{ 0 };
+      RPCManager* streams_{ nullptr };
+      Duration streamPeriod_{ 0 };
+    };
+
+  } // namespace core
+} // namespace milo
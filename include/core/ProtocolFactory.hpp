@@ -10,6 +10,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "core/RunArena.hpp"
+
 namespace milo::protocols {
   class ExperimentProtocol;
 }
@@ -21,17 +23,26 @@ namespace milo::core {
  * @brief Register & instantiate protocol objects by string key.
  *
  *  * Keeps SystemCoordinator decoupled from concrete protocols.
- *  * Creators are lambdas returning `unique_ptr<ExperimentProtocol>`.
+ *  * Creators build the instance in the run arena (`arena.make<MyProtocol>(…)`), so starting
+ *    a run never touches the heap; `creatorFor<T>()` covers default-constructible protocols.
  */
   class ProtocolFactory {
   public:
-    using Creator = std::function<std::unique_ptr<protocols::ExperimentProtocol>()>;
+    using Creator = std::function<ArenaPtr<protocols::ExperimentProtocol>(RunArena &)>;
+
+    template <typename T> static Creator creatorFor() {
+      return [](RunArena &arena) -> ArenaPtr<protocols::ExperimentProtocol> {
+        return arena.make<T>();
+      };
+    }
 
     /// Register a protocol under \p name.  Returns false on duplicate.
     bool registerProtocol(const std::string &name, Creator maker);
 
-    /// Create a fresh instance or throw `std::out_of_range` if unknown.
-    std::unique_ptr<protocols::ExperimentProtocol> create(const std::string &name) const;
+    bool contains(const std::string &name) const { return creators_.count(name) != 0; }
+
+    /// Create a fresh instance in \p arena or throw `std::out_of_range` if unknown.
+    ArenaPtr<protocols::ExperimentProtocol> create(const std::string &name, RunArena &arena) const;
 
   private:
     std::unordered_map<std::string, Creator> creators_;
@@ -10,11 +10,21 @@
 #include <chrono>
 #include <cstddef>
 #include <memory>
-#include <unordered_map>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 // MILO headers
+#include "core/Clock.hpp"
+#include "core/DeviceRegistry.hpp"
 #include "core/ErrorMonitor.hpp" // RPCManager will be a client to the error monitor
+#include "core/Telemetry.hpp"
+#include "core/TimerWheel.hpp"
 #include "io/SerialChannel.hpp" // RPCManager will own SerialChannels and requires full type knowledge
 #include "protocols/Command.hpp"  // TODO: impl for the command header stub
 #include "protocols/Response.hpp" // TODO: impl for the resonse header stub
@@ -24,44 +34,230 @@ namespace milo {
   namespace test {
     class RPCManagerTest;
   }
+  namespace core {
+    class RunStats;
+    class SampleStreams;
+  } // namespace core
 } // namespace milo
 
 namespace milo {
   namespace core {
 
-    enum class Device : std::uint8_t { PG, PSU, Pump, Count };
-    static_assert(static_cast<std::uint8_t>(Device::Count) == 3,
-                  "Device count changed please update code that depends on it");
-    inline const char* toString(Device d) {
-      switch (d) {
-      case Device::PG:
-        return "PG";
-      case Device::PSU:
-        return "PSU";
-      case Device::Pump:
-        return "Pump";
-      default:
-        return "Unknown";
+    /// One leg of a scatter/gather batch: a command addressed to a single device.
+    struct BatchRequest {
+      Device dev;
+      protocols::Command cmd;
+    };
+
+    /// Per-device outcome of a batch; `response` is empty on write failure or timeout.
+    struct BatchResult {
+      Device dev;
+      bool sent{ false };
+      std::optional<protocols::Response> response{};
+      std::chrono::microseconds elapsed{ 0 }; ///< write → reply (upper bound on RTT)
+    };
+
+    struct BatchReport {
+      std::pmr::vector<BatchResult> results;    ///< same order as the request batch
+      std::chrono::microseconds writeSkew{ 0 }; ///< first → last write completion
+      bool skewExceeded{ false };               ///< only set when a skew window was requested
+
+      bool allOk() const {
+        for (const auto& r : results)
+          if (!r.response)
+            return false;
+        return !skewExceeded;
       }
-    }
+    };
 
     class RPCManager {
     public:
-      explicit RPCManager(std::shared_ptr<ErrorMonitor> errMonitor);
+      explicit RPCManager(std::shared_ptr<ErrorMonitor> errMonitor,
+                          DeviceRegistry devices = DeviceRegistry::defaults());
       ~RPCManager() = default;
       //---public APIs------------------------------------------------------
-      void connect(); ///<- opens all SerialChannel objects
+      void connect(); ///<- opens a SerialChannel per registered device
+
+      /// Use \p channel for \p dev instead of the tty (replay harnesses, benchmarks).
+      /// @throws std::invalid_argument if \p dev is not registered or \p channel is null.
+      void attachChannel(Device dev, std::unique_ptr<io::SerialChannel> channel);
+
+      /// Time source for timeouts, batch deadlines and RTTs; handed to every channel.
+      void setClock(Clock& clock);
+      Clock& clock() const { return *clock_; }
+
+      /// Resolve device names once at setup; the run path then only carries `Device`s.
+      const DeviceRegistry& devices() const { return devices_; }
+
+      /**
+       * @brief Record all traffic of the connected channels into one capture file
+       *        (channel names are the device names). @returns false if it cannot be created.
+       *        Replay it with io::ReplaySerialChannel; `stopCapture()` flushes and closes it.
+       */
+      bool startCapture(const std::string& path);
+      void stopCapture();
+
+      /**
+       * @brief Track every sent command with a wheel timer; a reply not collected within
+       *        \p deadline is escalated even if nobody is blocked in awaitResponse().
+       *        The wheel must be serviced on the same (protocol) thread.
+       */
+      void attachTimers(TimerWheel& wheel, std::chrono::milliseconds deadline);
+
+      /// Publish per-device command/reply counts, RTT and errors (protocol thread writes).
+      void attachTelemetry(TelemetryPublisher& telemetry);
+
+      /**
+       * @brief Keep the lines devices send on their own (`#CHANNEL value`, see stream::parse())
+       *        in \p streams. They never reach a reply reader either way: without streams
+       *        attached they are only counted in `streamLines()` (and in RunStats, if attached).
+       */
+      void attachStreams(SampleStreams& streams) { streams_ = &streams; }
+      bool streaming() const { return streams_ != nullptr; }
+
+      /**
+       * @brief Non-blocking: route every stream line already queued on any channel. Call it
+       *        while the protocol waits (ProtocolExecutor::attachStreams() does), so a long
+       *        step never lets a device streaming at hundreds of Hz overrun the tty buffer.
+       *        A reply met on the way is held for the next await/poll of that device.
+       */
+      void pumpStreams();
+      /// pumpStreams(), then hand the streams' partly filled blocks to the Logger (run end).
+      void flushStreams();
+      /// Stream lines seen so far (malformed ones included; those are dropped).
+      std::uint64_t streamLines() const { return streamLines_; }
+
+      /**
+       * @brief Feed \p stats with every streamed sample and every numeric `Reading` reply
+       *        (channel `VOLT` for `VOLT?`), as they are parsed.
+       */
+      void attachStats(RunStats& stats) { stats_ = &stats; }
+      RunStats* stats() const { return stats_; }
+      /**
+       * @brief PING every registered device (all writes first, then the replies), e.g. before
+       *        resuming an interrupted run: costs one round trip, not one per device.
+       * @throws std::runtime_error (reported) if a device does not answer OK within \p timeout.
+       */
+      void handshake(std::chrono::milliseconds timeout);
+
       void sendCommand(Device dev, const protocols::Command& cmd);
+      /// Pre-encoded line, e.g. a `schema::CommandDef::Encoded`; the channel adds the terminator.
+      void sendCommand(Device dev, std::string_view wire);
       protocols::Response awaitResponse(Device dev, std::chrono::milliseconds timeout);
 
+      /**
+       * @brief Read the reply to a schema command and parse it with the command’s reply shape.
+       * @throws std::runtime_error on timeout or a reply of the wrong shape (ERR …), after
+       *         reporting it to ErrorMonitor — same contract as awaitResponse().
+       */
+      template <typename Cmd>
+      typename Cmd::Reply::Value awaitReply(Device dev, std::chrono::milliseconds timeout) {
+        const auto line = awaitLine(dev, timeout);
+        auto value = Cmd::Reply::parse(line);
+        if (!value)
+          rejectReply(dev, Cmd::kName, line);
+        noteReply(dev);
+        noteReading<Cmd>(dev, *value);
+        return *value;
+      }
+
+      /**
+       * @brief Non-blocking awaitResponse(): nullopt while nothing has arrived yet.
+       *        For callers that multiplex many waits on one thread (ProtocolExecutor).
+       * @throws std::runtime_error on a malformed reply (reported like awaitResponse()).
+       */
+      std::optional<protocols::Response> pollResponse(Device dev);
+
+      /// Non-blocking awaitReply<Cmd>(); throws on a reply of the wrong shape.
+      template <typename Cmd>
+      std::optional<typename Cmd::Reply::Value> pollReply(Device dev) {
+        const auto line = pollLine(dev);
+        if (!line)
+          return std::nullopt;
+        auto value = Cmd::Reply::parse(*line);
+        if (!value)
+          rejectReply(dev, Cmd::kName, *line);
+        noteReply(dev);
+        noteReading<Cmd>(dev, *value);
+        return value;
+      }
+
+      /// The caller’s own deadline for \p dev passed: report it and throw, as a timed-out
+      /// awaitResponse() would.
+      [[noreturn]] void replyTimedOut(Device dev);
+
+      /**
+       * @brief Scatter every command immediately, then gather all replies under one deadline.
+       *
+       *  * Wire strings are encoded up-front so the writes go out back-to-back.
+       *  * Replies queue in each channel while we wait on the others, so the batch costs
+       *    roughly the slowest round trip instead of the sum of them.
+       *  * Per-device failures are reported in the result (and to ErrorMonitor), not thrown.
+       *
+       * @param maxSkew  optional synchronized-start window; if the writes span more than this
+       *                 the report is flagged and ErrorMonitor is notified.
+       * @param mr       where the report’s results live (the run arena while RUNNING); the
+       *                 encode/timing scratch stays on the stack.
+       */
+      BatchReport scatterGather(std::span<const BatchRequest> batch,
+                                std::chrono::milliseconds timeout,
+                                std::optional<std::chrono::microseconds> maxSkew = std::nullopt,
+                                std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
     private:
-      static constexpr speed_t kDefaultBaud = B115200;
       std::shared_ptr<ErrorMonitor> errorMonitor_;
-      std::unordered_map<Device, std::unique_ptr<io::SerialChannel>> channels_;
-      static constexpr std::array<std::pair<Device, const char*>, 3> symlinks_{
-        { { Device::PSU, "/dev/psu1" }, { Device::PG, "/dev/pg1" }, { Device::Pump, "/dev/pump1" } }
-      };
+      DeviceRegistry devices_;
+      Clock* clock_{ &Clock::steady() };
+      // per-device state below is indexed by Device::index (sized to the registry)
+      std::vector<std::unique_ptr<io::SerialChannel>> channels_; ///< null until connected/attached
       bool connected_{ false };
+      std::shared_ptr<io::CaptureWriter> capture_;
+
+      /// Channel of \p dev, or nullptr if unregistered / not connected.
+      io::SerialChannel* channel(Device dev) const {
+        return dev.index < channels_.size() ? channels_[dev.index].get() : nullptr;
+      }
+
+      std::string awaitLine(Device dev, std::chrono::milliseconds timeout);
+      std::optional<std::string> pollLine(Device dev);
+      /// Next line of \p dev that is not a stream line (held reply first), within \p timeout.
+      std::optional<std::string> readReply(Device dev, io::SerialChannel& ch,
+                                           std::chrono::milliseconds timeout);
+      /// true if \p line was a stream line (and has been routed).
+      bool routeStream(Device dev, const std::string& line);
+      protocols::Response parseResponse(Device dev, const std::string& line);
+
+      template <typename Cmd, typename Value> void noteReading(Device dev, const Value& value) {
+        if constexpr (std::is_arithmetic_v<Value> && !std::is_same_v<Value, bool>)
+          if (stats_)
+            noteValue(dev, Cmd::kName, static_cast<double>(value));
+      }
+      /// Add a reading of \p command (its trailing `?` dropped) to the run statistics.
+      void noteValue(Device dev, std::string_view command, double value);
+      [[noreturn]] void rejectReply(Device dev, std::string_view command, const std::string& line);
+
+      void markInFlight(Device dev);
+      void clearInFlight(Device dev);
+
+      struct DeviceTelemetry {
+        int slot{ -1 };
+        Clock::Duration sentAt{};
+      };
+      void noteSent(Device dev);
+      void noteReply(Device dev);
+      void noteError(Device dev);
+
+      TelemetryPublisher* telemetry_{ nullptr };
+      std::vector<DeviceTelemetry> deviceTelemetry_;
+
+      TimerWheel* timers_{ nullptr };
+      std::chrono::milliseconds inFlightDeadline_{ 0 };
+      std::vector<std::unique_ptr<Timer>> inFlight_; ///< Timer is immovable: one node each
+
+      SampleStreams* streams_{ nullptr };
+      std::vector<std::optional<std::string>> held_; ///< reply read by pumpStreams(), per device
+      std::uint64_t streamLines_{ 0 };
+      RunStats* stats_{ nullptr };
 
       friend class milo::test::RPCManagerTest;
     };
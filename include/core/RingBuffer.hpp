@@ -0,0 +1,69 @@
+#pragma once
+/** @file  RingBuffer.hpp
+ *  @brief Fixed-capacity lock-free single-producer / single-consumer queue.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @class RingBuffer
+ * @brief The SPSC hand-off from LLD §6.3: one thread pushes, one thread pops.
+ *
+ *  * Storage is allocated once in the ctor (capacity rounded up to a power of two);
+ *    push/pop never allocate, lock or block.
+ *  * `push()` fails when full — the producer decides whether to drop or coalesce.
+ */
+    template <typename T> class RingBuffer {
+    public:
+      explicit RingBuffer(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity)
+          cap <<= 1;
+        slots_ = std::make_unique<T[]>(cap);
+        mask_ = cap - 1;
+      }
+
+      /// Producer side. Returns false (and leaves the queue untouched) when full.
+      bool push(const T& item) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) > mask_)
+          return false;
+        slots_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// Consumer side. Returns false when empty.
+      bool pop(T& out) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+          return false;
+        out = slots_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// Approximate when called concurrently; exact from either side when the other is idle.
+      std::size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+      }
+      bool empty() const { return size() == 0; }
+      std::size_t capacity() const { return mask_ + 1; }
+
+    private:
+      std::unique_ptr<T[]> slots_;
+      std::size_t mask_{ 0 };
+      alignas(64) std::atomic<std::size_t> head_{ 0 }; ///< next write (producer-owned)
+      alignas(64) std::atomic<std::size_t> tail_{ 0 }; ///< next read (consumer-owned)
+    };
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,108 @@
+#pragma once
+/** @file  RunArena.hpp
+ *  @brief Per-run memory arena: everything a run allocates comes from one pre-sized block.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace milo {
+  namespace core {
+
+    /** Destroys an arena object in place; its memory goes back to the arena’s pools. */
+    struct ArenaDeleter {
+      std::pmr::memory_resource* mr{ nullptr };
+      std::size_t size{ 0 };
+      std::size_t align{ alignof(std::max_align_t) };
+
+      template <typename T> void operator()(T* p) const {
+        p->~T();
+        mr->deallocate(const_cast<void*>(static_cast<const void*>(p)), size, align);
+      }
+    };
+
+    /// Owning pointer into a RunArena; converts Derived → Base like unique_ptr does.
+    template <typename T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+    /**
+ * @class RunArena
+ * @brief pool → monotonic → fixed buffer, reset whenever a run leaves RUNNING.
+ *
+ *  * The buffer is allocated (and prefaulted) once, before RUNNING. SystemCoordinator builds
+ *    each run's protocol here and hands it `resource()` (ExperimentProtocol::useMemory())
+ *    for command payloads and batch reports. Log staging needs none: the Logger's queue
+ *    is a fixed ring of fixed-size LogEvents.
+ *  * Freed blocks are recycled by the pool within a run; `reset()` drops everything at once.
+ *  * Overflow spills to the heap and is counted — with the AllocationGuard armed a spill is
+ *    reported like any other RUNNING allocation.
+ *  * Single-threaded (protocol thread), like the protocol it serves.
+ */
+    class RunArena {
+    public:
+      static constexpr std::size_t kDefaultCapacity = 256 * 1024;
+
+      explicit RunArena(std::size_t capacity = kDefaultCapacity);
+
+      std::pmr::memory_resource* resource() { return &pool_; }
+
+      /// Construct a T in the arena (allocator-aware types should take `resource()`).
+      template <typename T, typename... Args> ArenaPtr<T> make(Args&&... args) {
+        void* p = pool_.allocate(sizeof(T), alignof(T));
+        try {
+          return ArenaPtr<T>(::new (p) T(std::forward<Args>(args)...),
+                             ArenaDeleter{ &pool_, sizeof(T), alignof(T) });
+        } catch (...) {
+          pool_.deallocate(p, sizeof(T), alignof(T));
+          throw;
+        }
+      }
+
+      /// Release every allocation of this run. Arena objects must already be destroyed.
+      void reset();
+
+      std::size_t capacity() const { return capacity_; }
+      std::size_t used() const { return meter_.bytes; }     ///< taken from the buffer this run
+      std::size_t peak() const { return meter_.peak; }      ///< high-water mark across runs
+      std::size_t spills() const { return spill_.count; }   ///< allocations that hit the heap
+
+      RunArena(const RunArena&) = delete;
+      RunArena& operator=(const RunArena&) = delete;
+
+    private:
+      /// Counts what the pool takes from the monotonic buffer.
+      struct Meter : std::pmr::memory_resource {
+        explicit Meter(std::pmr::memory_resource* up) : upstream(up) {}
+
+        std::pmr::memory_resource* upstream;
+        std::size_t bytes{ 0 };
+        std::size_t peak{ 0 };
+
+        void* do_allocate(std::size_t n, std::size_t a) override;
+        void do_deallocate(void* p, std::size_t n, std::size_t a) override;
+        bool do_is_equal(const memory_resource& o) const noexcept override { return this == &o; }
+      };
+
+      /// Heap fallback behind the buffer; counts every spill.
+      struct Spill : std::pmr::memory_resource {
+        std::size_t count{ 0 };
+
+        void* do_allocate(std::size_t n, std::size_t a) override;
+        void do_deallocate(void* p, std::size_t n, std::size_t a) override;
+        bool do_is_equal(const memory_resource& o) const noexcept override { return this == &o; }
+      };
+
+      std::size_t capacity_;
+      std::unique_ptr<std::byte[]> storage_;
+      Spill spill_;
+      std::pmr::monotonic_buffer_resource mono_;
+      Meter meter_{ &mono_ };
+      std::pmr::unsynchronized_pool_resource pool_;
+    };
+
+  } // namespace core
+} // namespace milo
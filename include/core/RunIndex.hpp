@@ -0,0 +1,97 @@
+#pragma once
+/** @file  RunIndex.hpp
+ *  @brief Sparse time → byte-offset index written next to each run log, and queries over it.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/LogEvent.hpp"
+#include "core/RunManifest.hpp"
+
+namespace milo {
+  namespace core {
+
+    /** One indexed block of consecutive event lines in the run log. */
+    struct IndexEntry {
+      std::int64_t firstNs{ 0 }; ///< timestamp of the block’s first event
+      std::int64_t lastNs{ 0 };  ///< timestamp of its last event
+      std::uint64_t offset{ 0 }; ///< byte offset of the first line in the raw CSV
+      std::uint32_t length{ 0 }; ///< through the last event’s line (notes in between included)
+      std::array<std::uint32_t, LogEvent::kTypeCount> counts{}; ///< events per LogEvent::Type
+    };
+
+    /**
+ * @class RunIndexWriter
+ * @brief Closes a block every `kEveryRecords` events or `kEveryPeriod` of event time and
+ *        appends its entry to `<run>.csv.idx` (≈ 0.5 % of the log). Logger worker thread only.
+ *
+ *  Offsets are into the raw CSV, so the index stays valid once the log is archived as
+ *  `.mlz`. A block still open at a crash is simply unindexed; queries scan that tail.
+ */
+    class RunIndexWriter {
+    public:
+      static constexpr std::size_t kEveryRecords = 256;
+      static constexpr std::chrono::milliseconds kEveryPeriod{ 1000 };
+
+      ~RunIndexWriter() { close(); }
+
+      bool open(const std::string& path);
+      /// The event at \p offset (its line \p length bytes long) is about to be written.
+      void add(std::chrono::nanoseconds timestamp, LogEvent::Type type, std::uint64_t offset,
+               std::size_t length);
+      void flush();
+      void close(); ///< writes the last block’s entry
+
+    private:
+      void emit();
+
+      std::FILE* fp_{ nullptr };
+      IndexEntry block_{};
+      std::size_t records_{ 0 };
+    };
+
+    /**
+ * @class RunIndex
+ * @brief A loaded index; extracts a time window or all events of one type from a run log
+ *        (plain CSV or `.mlz`) reading only the blocks that can contain them — one pass
+ *        over the in-memory entries, then reads proportional to the result.
+ *
+ *  Timestamps are not strictly in log order: streamed samples reach the log a block late,
+ *  so neighbouring blocks' [firstNs, lastNs] ranges overlap. Every block whose range meets
+ *  the window is read, not just a sorted run of them.
+ */
+    class RunIndex {
+    public:
+      static constexpr const char* kSuffix = ".idx";
+
+      /// nullopt if \p path is missing or not an index.
+      static std::optional<RunIndex> load(const std::string& path);
+      /// The index a manifest entry refers to; query it with `logDir / run.stored`.
+      static std::optional<RunIndex> forRun(const std::string& logDir, const RunRecord& run);
+
+      const std::vector<IndexEntry>& entries() const { return entries_; }
+      /// End of the indexed part of the log; bytes beyond are scanned.
+      std::uint64_t indexedBytes() const {
+        return entries_.empty() ? 0 : entries_.back().offset + entries_.back().length;
+      }
+
+      /// Event lines with \p from ≤ timestamp ≤ \p to, in log order.
+      std::vector<std::string> window(const std::string& logPath, std::chrono::nanoseconds from,
+                                      std::chrono::nanoseconds to) const;
+      /// Every event line of \p type, in log order.
+      std::vector<std::string> ofType(const std::string& logPath, LogEvent::Type type) const;
+
+    private:
+      std::vector<IndexEntry> entries_;
+    };
+
+  } // namespace core
+} // namespace milo
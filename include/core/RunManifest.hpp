@@ -0,0 +1,85 @@
+#pragma once
+/** @file  RunManifest.hpp
+ *  @brief Index of the runs in a log directory: state, raw and on-disk sizes, stored file.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace milo {
+  namespace core {
+
+    /** One run as the manifest knows it; `name` is the run’s CSV file name and its key. */
+    struct RunRecord {
+      /// Interrupted: left open by a crash/reset, repaired from its journal on the next boot.
+      enum class Status { Open, Closed, Interrupted };
+
+      std::string name;
+      Status status{ Status::Open };
+      std::uint64_t rawBytes{ 0 };    ///< CSV size as written
+      std::uint64_t storedBytes{ 0 }; ///< size on disk (== raw until compressed)
+      std::string stored;             ///< file on disk: `name`, or `name + ".mlz"`
+      std::string index;              ///< sparse time index (RunIndex), empty if none
+      /// Per-channel statistics (RunStats), `KEY n=… mean=… …` entries separated by `;`.
+      std::string stats;
+
+      bool compressed() const { return stored != name; }
+      bool finished() const { return status != Status::Open; }
+    };
+
+    const char* toString(RunRecord::Status s);
+
+    /**
+ * @class RunManifest
+ * @brief `<logDir>/manifest` — one line per run, oldest first, `key=value` fields.
+ *
+ *  * Every change rewrites the file to a temp name, fdatasync()s it, renames it over the
+ *    old one and fsync()s the directory, so even after a power cut the manifest is either
+ *    the old or the new version (it is a few kB).
+ *  * Unknown keys are ignored on load, so newer fields do not break older readers.
+ *  * Thread-safe: the logger worker and the compressor both update it.
+ */
+    class RunManifest {
+    public:
+      static constexpr const char* kFileName = "manifest";
+
+      explicit RunManifest(std::string logDir); ///< loads an existing manifest, if any
+
+      /// Insert or replace the record called `rec.name`, then persist.
+      void put(const RunRecord& rec);
+      /// Apply \p fn to the record called \p name and persist; false if there is none.
+      template <typename Fn> bool update(const std::string& name, Fn&& fn) {
+        std::lock_guard lock(mtx_);
+        for (auto& r : runs_)
+          if (r.name == name) {
+            fn(r);
+            saveLocked();
+            return true;
+          }
+        return false;
+      }
+      bool erase(const std::string& name);
+
+      std::optional<RunRecord> find(const std::string& name) const;
+      std::vector<RunRecord> runs() const; ///< snapshot, oldest first
+      std::uint64_t storedBytes() const;   ///< quota accounting: what the runs occupy on disk
+
+      const std::string& path() const { return path_; }
+
+    private:
+      void load();
+      void saveLocked() const;
+
+      std::string dir_;
+      std::string path_;
+      mutable std::mutex mtx_;
+      std::vector<RunRecord> runs_;
+    };
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,142 @@
+#pragma once
+/** @file  RunStats.hpp
+ *  @brief Streaming per-channel statistics of a run: Welford mean/variance, min/max and a
+ *         fixed-size quantile sketch, summarised at FINISHED without re-reading the log.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MILO headers
+#include "core/ChannelKey.hpp"
+#include "core/DeviceRegistry.hpp"
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @class RunningStats
+ * @brief Count, mean and variance by Welford’s update (numerically stable in one pass),
+ *        plus min/max. O(1) per value, no storage.
+ */
+    class RunningStats {
+    public:
+      void add(double v) {
+        ++n_;
+        const double d = v - mean_;
+        mean_ += d / static_cast<double>(n_);
+        m2_ += d * (v - mean_);
+        min_ = n_ == 1 || v < min_ ? v : min_;
+        max_ = n_ == 1 || v > max_ ? v : max_;
+      }
+
+      std::uint64_t count() const { return n_; }
+      double mean() const { return mean_; }
+      /// Sample variance (n − 1); 0 below two values.
+      double variance() const { return n_ > 1 ? m2_ / static_cast<double>(n_ - 1) : 0.0; }
+      double stddev() const;
+      double min() const { return min_; }
+      double max() const { return max_; }
+
+    private:
+      std::uint64_t n_{ 0 };
+      double mean_{ 0.0 };
+      double m2_{ 0.0 };
+      double min_{ 0.0 };
+      double max_{ 0.0 };
+    };
+
+    /**
+ * @class QuantileSketch
+ * @brief Any quantile to within ±1 % of the true value, in a fixed 8 KiB.
+ *
+ *  * Log-spaced buckets (ratio γ = 1.01/0.99) per sign: `add()` is one log() and one
+ *    increment, memory does not grow with the run, and the answer is a bucket’s midpoint.
+ *  * Magnitudes below kMinMagnitude count as zero; above the top bucket (≈ 8·10⁵) they
+ *    saturate, so quantiles should be clamped to the exact min/max (ChannelSummary is).
+ */
+    class QuantileSketch {
+    public:
+      static constexpr double kRelativeError = 0.01;
+      static constexpr std::size_t kBuckets = 1024; ///< per sign
+      static constexpr double kMinMagnitude = 1e-3;
+
+      void add(double v);
+      /// Value at rank \p q ∈ [0, 1]; 0 when empty.
+      double quantile(double q) const;
+      std::uint64_t count() const { return count_; }
+
+    private:
+      std::array<std::uint32_t, kBuckets> positive_{};
+      std::array<std::uint32_t, kBuckets> negative_{};
+      std::uint64_t zero_{ 0 };
+      std::uint64_t count_{ 0 };
+    };
+
+    /** What a run’s summary, manifest and FINISHED screen show for one channel. */
+    struct ChannelSummary {
+      std::string key; ///< "DEVICE.CHANNEL"
+      std::uint64_t count{ 0 };
+      double mean{ 0.0 }, stddev{ 0.0 }, min{ 0.0 }, max{ 0.0 };
+      double p50{ 0.0 }, p95{ 0.0 }, p99{ 0.0 };
+
+      /// `n=200 mean=12.01 sd=0.0213 min=11.9 max=12.1 p50=12 p95=12.1 p99=12.1`
+      std::string toString() const;
+    };
+
+    /**
+ * @class RunStats
+ * @brief RunningStats + QuantileSketch per `DEVICE.CHANNEL`, fed by RPCManager
+ *        (attachStats()) with every streamed sample and every `Reading` reply.
+ *
+ *  * Channels are claimed on first use from kMaxChannels preallocated slots; the rest
+ *    are counted in `dropped()`. Nothing allocates while RUNNING.
+ *  * A claimed channel is a small integer; `add(index, v)` is O(1), and `add(dev, …)`
+ *    finds it with a scan of the (few) channels already claimed.
+ *  * Protocol thread only; SystemCoordinator resets it before a run and reads the summary
+ *    once the run has FINISHED, on the same thread.
+ */
+    class RunStats {
+    public:
+      static constexpr std::size_t kMaxChannels = 32;
+
+      RunStats();
+
+      /// Slot of \p channel of \p dev (claimed if new); -1 when the table is full.
+      int channel(Device dev, std::string_view deviceName, std::string_view channel);
+      void add(int channel, double value);
+      /// channel() + add(); @returns false if the value was dropped.
+      bool add(Device dev, std::string_view deviceName, std::string_view channel, double value);
+
+      /// Forget every channel (start of a run).
+      void reset();
+
+      std::size_t channels() const { return used_; }
+      std::uint64_t dropped() const { return dropped_; }
+      const RunningStats& stats(std::size_t i) const { return channels_[i].stats; }
+      const QuantileSketch& sketch(std::size_t i) const { return channels_[i].sketch; }
+
+      /// One entry per channel with data, in the order they were first seen.
+      std::vector<ChannelSummary> summary() const;
+
+    private:
+      struct Channel {
+        ChannelKey key;
+        RunningStats stats;
+        QuantileSketch sketch;
+      };
+
+      std::vector<Channel> channels_; ///< kMaxChannels, built in the ctor
+      std::size_t used_{ 0 };
+      std::uint64_t dropped_{ 0 };
+    };
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,144 @@
+#pragma once
+/** @file  RuntimeProfile.hpp
+ *  @brief Real-time runtime setup: per-thread scheduling/affinity, memory locking, jitter check.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <sched.h>
+
+namespace milo {
+  namespace core {
+
+    /** Threads that get their own scheduling entry, highest priority first. */
+    enum class ThreadRole { Protocol, Serial, UI, Logger, Control };
+
+    constexpr const char* toString(ThreadRole r) {
+      switch (r) {
+      case ThreadRole::Protocol:
+        return "protocol";
+      case ThreadRole::Serial:
+        return "serial";
+      case ThreadRole::UI:
+        return "ui";
+      case ThreadRole::Logger:
+        return "logger";
+      case ThreadRole::Control:
+        return "control";
+      }
+      return "unknown";
+    }
+
+    inline constexpr ThreadRole kThreadRoles[] = { ThreadRole::Protocol, ThreadRole::Serial,
+                                                   ThreadRole::UI, ThreadRole::Logger,
+                                                   ThreadRole::Control };
+
+    struct ThreadPolicy {
+      int policy{ SCHED_OTHER }; ///< SCHED_OTHER / SCHED_FIFO / SCHED_RR / SCHED_IDLE
+      int priority{ 0 };         ///< 1..99 for FIFO/RR, ignored otherwise
+      int cpu{ -1 };             ///< pin to this CPU; -1 leaves the affinity alone
+    };
+
+    /**
+ * @struct RuntimeConfig
+ * @brief The `"runtime"` block of config.json; defaults match REQUIREMENTS
+ *        (dual Cortex-A7: CPU 1 for the app, CPU 0 for the system).
+ *
+ *  ```json
+ *  "runtime": {
+ *    "realtime": true, "lockMemory": true, "stackPrefaultKiB": 256,
+ *    "threads": { "protocol": { "policy": "fifo", "priority": 80, "cpu": 1 }, ... },
+ *    "jitter":  { "periodUs": 1000, "samples": 2000 }
+ *  }
+ *  ```
+ *  Policy names are mapped with `RuntimeProfile::parsePolicy()`.
+ */
+    struct RuntimeConfig {
+      bool realtime{ true };   ///< false: leave every thread SCHED_OTHER (host/dev builds)
+      bool lockMemory{ true }; ///< mlockall + no heap trimming
+      std::size_t stackPrefault{ 256 * 1024 };
+
+      std::array<ThreadPolicy, std::size(kThreadRoles)> threads{ {
+          { SCHED_FIFO, 80, 1 }, // protocol
+          { SCHED_FIFO, 70, 1 }, // serial
+          { SCHED_FIFO, 50, 0 }, // ui, on the system core
+          { SCHED_OTHER, 0, 0 }, // logger: disk I/O never competes with the above
+          { SCHED_OTHER, 0, 0 }, // control: the daemon's socket loop, off the app core
+      } };
+
+      std::chrono::microseconds jitterPeriod{ 1000 };
+      std::size_t jitterSamples{ 2000 };
+
+      ThreadPolicy& operator[](ThreadRole r) { return threads[static_cast<std::size_t>(r)]; }
+      const ThreadPolicy& operator[](ThreadRole r) const {
+        return threads[static_cast<std::size_t>(r)];
+      }
+    };
+
+    /** Wake-up latency of a periodic absolute-time sleep (cyclictest-style). */
+    struct JitterReport {
+      std::chrono::microseconds period{ 0 };
+      std::size_t samples{ 0 };
+      std::chrono::nanoseconds min{ 0 };
+      std::chrono::nanoseconds mean{ 0 };
+      std::chrono::nanoseconds p99{ 0 };
+      std::chrono::nanoseconds max{ 0 };
+      std::size_t overruns{ 0 }; ///< wake-ups later than a whole period
+      std::string role;          ///< thread profile the measurement ran under
+
+      /// One line for the run-log header, e.g. `period=1000us n=2000 min=4us ... overruns=0`.
+      std::string toString() const;
+    };
+
+    /**
+ * @class RuntimeProfile
+ * @brief Applies a RuntimeConfig to the process and its threads.
+ *
+ *  * `lockMemory()` once at startup; each thread calls `apply(role)` first thing in its body.
+ *  * Failures (no CAP_SYS_NICE, single-core host…) are reported by return value and leave
+ *    the thread as it was — a dev box still runs, just without real-time guarantees.
+ *  * `measureJitter()` runs the self-check on a helper thread under the protocol profile;
+ *    call it at startup and on demand and put the result in the run log.
+ */
+    class RuntimeProfile {
+    public:
+      explicit RuntimeProfile(RuntimeConfig cfg = {}) : cfg_(cfg) {}
+
+      /// "fifo" | "rr" | "other" | "idle" → SCHED_*.
+      static std::optional<int> parsePolicy(std::string_view name);
+
+      /// mlockall(MCL_CURRENT | MCL_FUTURE) and keep freed heap mapped. @returns false on failure.
+      bool lockMemory() const;
+
+      /// Scheduling, affinity and stack prefault for the calling thread.
+      bool apply(ThreadRole role) const;
+
+      /// Touch \p bytes of the calling thread’s stack so later growth never page-faults.
+      static void prefaultStack(std::size_t bytes);
+      /// Touch every page of \p buffer.
+      static void prefault(std::span<std::byte> buffer);
+
+      /// Self-check with the configured period/samples on a thread running \p role.
+      JitterReport measureJitter(ThreadRole role = ThreadRole::Protocol) const;
+      /// Self-check on the calling thread, whatever its scheduling.
+      static JitterReport measureJitterHere(std::chrono::microseconds period, std::size_t samples);
+
+      /// `protocol=fifo/80@cpu1 serial=…` for logs.
+      std::string describe() const;
+
+      const RuntimeConfig& config() const { return cfg_; }
+
+    private:
+      RuntimeConfig cfg_;
+    };
+
+  } // namespace core
+} // namespace milo
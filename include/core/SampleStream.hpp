@@ -0,0 +1,197 @@
+#pragma once
+/** @file  SampleStream.hpp
+ *  @brief Unsolicited measurement lines: columnar per-channel rings, block hand-off to the
+ *         Logger and a rate-independent min/max view for the OLED and telemetry.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MILO headers
+#include "core/ChannelKey.hpp"
+#include "core/Clock.hpp"
+#include "core/DeviceRegistry.hpp"
+#include "core/LogEvent.hpp"
+#include "core/StreamView.hpp"
+
+namespace milo {
+  namespace core {
+
+    class Logger;
+    class TelemetryPublisher;
+
+    namespace stream {
+      /// First character of a streamed line; replies (`OK …`, `ERR …`) never start with it.
+      constexpr char kMarker = '#';
+
+      struct Line {
+        std::string_view channel;
+        float value{ 0.0f };
+      };
+
+      /// `#FLOW 2.51` → { "FLOW", 2.51 }; nullopt for anything that is not a stream line.
+      std::optional<Line> parse(std::string_view line);
+    } // namespace stream
+
+    /**
+ * @class SampleColumns
+ * @brief Ring of one channel’s samples as two columns: timestamps and values, each contiguous.
+ *
+ *  * Capacity is fixed at construction (rounded up to a power of two, at least one
+ *    SampleBlock); `push()` overwrites the oldest sample and never allocates.
+ *  * `times()` / `values()` hand out contiguous slices, so a block is two memcpys and a
+ *    scan over values never touches the timestamps.
+ */
+    class SampleColumns {
+    public:
+      explicit SampleColumns(std::size_t capacity);
+
+      void push(std::int64_t tNs, float value) {
+        const auto i = static_cast<std::size_t>(written_) & mask_;
+        t_[i] = tNs;
+        v_[i] = value;
+        ++written_;
+      }
+
+      std::uint64_t written() const { return written_; } ///< samples ever pushed
+      std::size_t size() const {
+        return written_ < capacity() ? static_cast<std::size_t>(written_) : capacity();
+      }
+      std::size_t capacity() const { return mask_ + 1; }
+      /// Sequence number of the oldest sample still held.
+      std::uint64_t oldest() const { return written_ - size(); }
+
+      /// Up to \p max samples from sequence number \p seq on, cut short where the storage
+      /// wraps (ask again from `seq + n`). \p seq must be in [oldest(), written()].
+      std::span<const std::int64_t> times(std::uint64_t seq, std::size_t max) const {
+        return { &t_[index(seq)], run(seq, max) };
+      }
+      std::span<const float> values(std::uint64_t seq, std::size_t max) const {
+        return { &v_[index(seq)], run(seq, max) };
+      }
+
+    private:
+      std::size_t index(std::uint64_t seq) const { return static_cast<std::size_t>(seq) & mask_; }
+      std::size_t run(std::uint64_t seq, std::size_t max) const;
+
+      std::unique_ptr<std::int64_t[]> t_;
+      std::unique_ptr<float[]> v_;
+      std::size_t mask_{ 0 };
+      std::uint64_t written_{ 0 };
+    };
+
+    /**
+ * @class MinMaxView
+ * @brief Min/max per fixed time bucket over the last StreamView::kBuckets buckets.
+ *
+ *  Adding a sample is O(1); a new bucket opens once per bucket period however fast samples
+ *  arrive, so whoever redraws on `add() == true` does so at a constant rate.
+ */
+    class MinMaxView {
+    public:
+      explicit MinMaxView(Clock::Duration bucket);
+
+      /// @returns true if \p tNs opened a new bucket (the previous one is complete).
+      bool add(std::int64_t tNs, float value);
+      /// Buckets oldest first; key and sample count are left to the caller.
+      void copyTo(StreamView& out) const;
+
+    private:
+      std::int64_t bucketNs_;
+      std::int64_t current_{ 0 }; ///< bucket number (t / bucketNs) of ring_[head_]
+      std::size_t head_{ 0 };
+      std::uint32_t filled_{ 0 };
+      float last_{ 0.0f };
+      std::array<MinMax, StreamView::kBuckets> ring_{};
+    };
+
+    /**
+ * @class SampleStreams
+ * @brief Where RPCManager routes the lines a device sends on its own (attachStreams()).
+ *
+ *  * One channel per `DEVICE.CHANNEL` key, claimed on its first sample; all kMaxChannels
+ *    rings are allocated up front, so a new channel mid-run never reaches the heap.
+ *    Samples of channels beyond that are counted in `dropped()`.
+ *  * Full rate goes to the Logger in SampleBlocks (every SampleBlock::kSamples samples,
+ *    and the rest on `flush()` at the end of a run).
+ *  * Each completed view bucket is published to telemetry (a `streams` record) and, for the
+ *    display channel, to the display callback (UIController::showStream).
+ *  * Protocol thread only: `add()`, `flush()` and the callbacks all run on it.
+ */
+    class SampleStreams {
+    public:
+      static constexpr std::size_t kMaxChannels = 16;
+
+      struct Options {
+        std::size_t samplesPerChannel{ 4096 };
+        Clock::Duration bucket{ std::chrono::milliseconds{ 100 } }; ///< 128 buckets → 12.8 s
+        std::string display{}; ///< key shown on the OLED; empty = the first channel seen
+      };
+
+      SampleStreams();
+      explicit SampleStreams(Options options);
+      ~SampleStreams();
+
+      /// One sample of \p channel from \p dev (named \p deviceName), stamped \p t.
+      /// @returns false if it was dropped (channel table full).
+      bool add(Device dev, std::string_view deviceName, std::string_view channel,
+               Clock::Duration t, float value);
+      /// Hand every sample not yet logged to the Logger (end of run).
+      void flush();
+
+      void attachLogger(Logger& log) { logger_ = &log; }
+      void attachTelemetry(TelemetryPublisher& telemetry) { telemetry_ = &telemetry; }
+      void onDisplay(std::function<void(const StreamView&)> show) { display_ = std::move(show); }
+
+      std::size_t channels() const { return used_; }
+      std::string_view key(std::size_t i) const { return channels_[i].key.view(); }
+      const SampleColumns& columns(std::size_t i) const { return channels_[i].columns; }
+      std::optional<std::size_t> find(std::string_view key) const;
+      /// Current view of channel \p i.
+      void view(std::size_t i, StreamView& out) const;
+      std::uint64_t dropped() const { return dropped_; }
+
+      SampleStreams(const SampleStreams&) = delete;
+      SampleStreams& operator=(const SampleStreams&) = delete;
+
+    private:
+      struct Channel {
+        Channel(std::size_t capacity, Clock::Duration bucket) : columns(capacity), view(bucket) {}
+
+        ChannelKey key;
+        SampleColumns columns;
+        MinMaxView view;
+        std::uint64_t logged{ 0 }; ///< samples handed to the Logger so far
+        int slot{ -1 };            ///< telemetry stream record
+      };
+
+      Channel* claim(Device dev, std::string_view deviceName, std::string_view channel);
+      void logBlocks(Channel& ch, std::size_t minimum);
+      void publish(std::size_t i);
+
+      Options options_;
+      std::vector<Channel> channels_; ///< kMaxChannels, built in the ctor
+      std::size_t used_{ 0 };
+      std::optional<std::size_t> displayed_;
+      std::uint64_t dropped_{ 0 };
+
+      Logger* logger_{ nullptr };
+      TelemetryPublisher* telemetry_{ nullptr };
+      std::function<void(const StreamView&)> display_;
+      SampleBlock block_{}; ///< reused for every hand-off
+      StreamView scratch_{}; ///< reused for every publish
+    };
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,48 @@
+#pragma once
+/** @file  StreamView.hpp
+ *  @brief Fixed-size min/max picture of one streamed channel (OLED trace, telemetry).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace milo {
+  namespace core {
+
+    /// Range of the samples that fell into one time bucket; `empty()` if none did.
+    struct MinMax {
+      float min{ std::numeric_limits<float>::infinity() };
+      float max{ -std::numeric_limits<float>::infinity() };
+
+      bool empty() const { return min > max; }
+      void add(float v) {
+        min = v < min ? v : min;
+        max = v > max ? v : max;
+      }
+    };
+
+    /**
+ * @struct StreamView
+ * @brief The last `kBuckets` time buckets of a channel, oldest first — one per OLED column.
+ *
+ *  Trivially copyable and the same size whatever the sample rate: at 10 Hz or 1 kHz a reader
+ *  copies and draws 128 min/max pairs.
+ */
+    struct StreamView {
+      static constexpr std::size_t kBuckets = 128;
+      static constexpr std::size_t kKeyLen = 23;
+
+      char key[kKeyLen + 1]{}; ///< "DEVICE.CHANNEL", e.g. "PUMP.FLOW"
+      std::int64_t bucketNs{ 0 }; ///< width of one bucket
+      std::int64_t endNs{ 0 };    ///< end of the newest bucket (Clock time)
+      std::uint64_t samples{ 0 }; ///< total seen on the channel
+      float last{ 0.0f };
+      std::uint32_t filled{ 0 }; ///< buckets in use (≤ kBuckets); newest: `buckets[filled-1]`
+      MinMax buckets[kBuckets]{};
+    };
+
+  } // namespace core
+} // namespace milo
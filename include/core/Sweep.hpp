@@ -0,0 +1,86 @@
+#pragma once
+/** @file  Sweep.hpp
+ *  @brief Parameter-sweep definition and results for unattended batch runs.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/ParameterStore.hpp"
+#include "core/RunStats.hpp"
+
+namespace milo {
+  namespace core {
+
+    /** One swept parameter and the setpoints it takes, in order. */
+    struct SweepAxis {
+      Parameter param{ Parameter::Temp };
+      std::vector<float> values;
+
+      /// \p from … \p to inclusive in steps of \p step (sign taken from the direction).
+      static SweepAxis range(Parameter p, float from, float to, float step);
+      static SweepAxis list(Parameter p, std::vector<float> values) { return { p, std::move(values) }; }
+    };
+
+    using SweepPoint = std::vector<std::pair<Parameter, float>>;
+
+    /**
+ * @struct SweepPlan
+ * @brief The `"sweep"` block of config.json: one protocol × the cartesian product of its axes.
+ *
+ *  ```json
+ *  "sweep": {
+ *    "protocol": "lysis", "repeats": 1, "settleMs": 2000, "stopOnError": false,
+ *    "axes": [ { "param": "Voltage", "from": 10, "to": 20, "step": 2.5 },
+ *              { "param": "Temp", "values": [ 30, 37 ] } ]
+ *  }
+ *  ```
+ *  The last axis varies fastest. Parameter names are mapped with `parseParameter()`;
+ *  `sweepPlan()` (ConfigLoader.hpp) reads the block.
+ */
+    struct SweepPlan {
+      std::string protocol;
+      std::vector<SweepAxis> axes;
+      std::size_t repeats{ 1 };                      ///< every point is run this many times
+      std::chrono::milliseconds settle{ 0 };         ///< hardware rest between runs
+      bool stopOnError{ false };                     ///< false: record the failure, go on
+
+      /// Number of runs (points × repeats); 0 if any axis is empty.
+      std::size_t size() const;
+      /// Setpoints of run \p index (0 ≤ index < size()).
+      SweepPoint point(std::size_t index) const;
+      /// "Voltage=12.5 Temp=37" — goes into the run header and the summary.
+      static std::string label(const SweepPoint& point);
+    };
+
+    std::optional<Parameter> parseParameter(std::string_view name);
+
+    /** Outcome of one run of a sweep. */
+    struct SweepRun {
+      std::size_t index{ 0 };
+      SweepPoint point;
+      std::string logPath;
+      bool ok{ false };
+      std::string error; ///< empty when ok
+      std::chrono::milliseconds duration{ 0 };
+      std::vector<ChannelSummary> stats; ///< empty unless the RPCManager has RunStats attached
+    };
+
+    struct SweepSummary {
+      std::string path; ///< `<first run log>_sweep.csv`, one row per run
+      std::vector<SweepRun> runs;
+      std::size_t failed{ 0 };
+      bool aborted{ false }; ///< stopped by handleAbort() or by the first error (stopOnError)
+
+      bool allOk() const { return failed == 0 && !aborted; }
+    };
+
+  } // namespace core
+} // namespace milo
@@ -6,12 +6,34 @@
  *  © 2025 Milo Medical — licensed under MIT.
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 
+#include "core/AllocationGuard.hpp"
+#include "core/Checkpoint.hpp"
+#include "core/Clock.hpp"
+#include "core/RunArena.hpp"
+#include "core/Sweep.hpp"
+#include "core/SystemEvent.hpp"
+#include "core/SystemState.hpp"
+
 namespace milo {
   namespace core {
 
+    class Logger;
+    class ParameterStore;
+    class ProtocolFactory;
+    class RPCManager;
+    class RuntimeProfile;
+    class TelemetryPublisher;
+    struct JitterReport;
+
     class SystemCoordinator {
 
     public:
@@ -22,15 +44,133 @@ namespace milo {
       void initialize();  ///< Mount SD, load config, init subsystems
       void run();         ///< Main FSM loop
       void handleStart(); ///< User pressed “Start”
-      void handleAbort(); ///< Emergency stop
+      void handleAbort(); ///< Emergency stop (in a sweep: no further runs are started)
       void handleError(const std::string &reason);
 
+      SystemState state() const { return currentState_; }
+
+      /// Protocol the next Start runs (front panel or control socket).
+      /// @throws std::invalid_argument if the attached ProtocolFactory does not know \p name.
+      void selectProtocol(const std::string &name);
+      const std::string &selectedProtocol() const { return selected_; }
+
+      /// Subsystems a run needs; they must outlive the coordinator’s use of them.
+      void attachRunContext(RPCManager &rpc, Logger &log, ParameterStore &params,
+                            const ProtocolFactory &protocols);
+
+      /// Timing conditions every run log records in its header (`# jitter:`, `# runtime:`):
+      /// the startup self-check and the thread profile. Handed to the Logger of
+      /// attachRunContext(), whichever of the two is called first.
+      void setRunConditions(const RuntimeProfile &profile, const JitterReport &jitter);
+
+      /**
+       * @brief Unattended batch mode: run every point of \p plan back to back, no Start press.
+       *
+       *  * Each run gets a fresh protocol built in the run arena (useMemory() hands it the
+       *    arena too); serial channels stay open and the logger reuses its queue.
+       *  * Each run is a normal RUNNING → FINISHED cycle with its own run log, whose header
+       *    records the sweep point; `plan.settle` is waited between runs.
+       *  * A summary CSV (one row per run) is written next to the first run log as it goes.
+       *  * Ends in IDLE, or in ERROR when `plan.stopOnError` and a run failed.
+       *  Requires IDLE/FINISHED and attachRunContext(); throws std::logic_error otherwise.
+       */
+      SweepSummary runSweep(const SweepPlan &plan);
+
+      /**
+       * @brief Persist a Checkpoint of every sweep run in \p store: at the start of each run,
+       *        between runs, and at most every \p period while the protocol reports steps.
+       *        Set before initialize(), which looks for a sweep a reset interrupted.
+       */
+      void attachCheckpoints(CheckpointStore &store,
+                             Clock::Duration period = std::chrono::seconds{ 1 }) {
+        checkpoints_ = &store;
+        checkpointPeriod_ = period;
+      }
+      /// What initialize() found of a sweep that never finished (crash, watchdog reset).
+      const std::optional<Checkpoint> &interruptedRun() const { return interrupted_; }
+
+      /**
+       * @brief Carry on with the interrupted sweep: re-handshake the MCUs, restore the
+       *        parameter snapshot and run \p plan from the checkpointed run, whose protocol
+       *        starts at the saved step. Otherwise like runSweep(); the resumed run gets a
+       *        fresh log whose `resumed_from` header names the interrupted one.
+       * @throws std::logic_error if there is nothing to resume, std::invalid_argument if
+       *         \p plan is not the interrupted sweep's (protocol, number of runs), and
+       *         std::runtime_error if a device does not answer the handshake.
+       */
+      SweepSummary resumeSweep(const SweepPlan &plan);
+      /// Decline the offer: forget the interrupted sweep and delete its checkpoint.
+      void discardInterruptedRun();
+      /// resumeSweep() call → RUNNING, handshake included (wall time).
+      std::chrono::microseconds lastResumeLatency() const { return resumeLatency_; }
+
+      /// Time source for run durations, sweep settling and the protocol’s step timing.
+      /// With a VirtualClock (and simulated devices) a sweep runs as fast as the CPU allows.
+      void setClock(Clock &clock) { clock_ = &clock; }
+
+      /// Every transition is published to the live telemetry segment. Not together with
+      /// a TelemetryPublisher that follows the event bus (one writer per record).
+      void attachTelemetry(TelemetryPublisher &telemetry);
+
+      /**
+       * @brief Broadcast every transition and error into \p bus (this thread is its only
+       *        writer). Publishing never waits on the subscribers — UI, Logger and telemetry
+       *        each consume at their own pace, and one that falls behind only loses events.
+       */
+      void attachEventBus(EventBus &bus) { bus_ = &bus; }
+
+      /// Called with each run’s statistics once it has FINISHED (UIController::showRunStats);
+      /// runs on the protocol thread. Needs RunStats attached to the RPCManager.
+      void onRunStats(std::function<void(std::span<const ChannelSummary>)> show) {
+        showStats_ = std::move(show);
+      }
+
+      /// Memory for everything a run creates; reset when the run leaves RUNNING (FINISHED or
+      /// ERROR), so a failed run leaves nothing behind for the next one.
+      RunArena &runArena() { return arena_; }
+
+      /// What the AllocationGuard does while RUNNING (CI: Abort). No-op without the build flag.
+      void setAllocationPolicy(AllocationGuard::Mode mode) { allocPolicy_ = mode; }
+      /// Sites of heap allocations seen during the last run (empty when clean).
+      const std::string &lastAllocationReport() const { return allocReport_; }
+
     private:
-      enum class State { BOOT, INIT, IDLE, RUNNING, FINISHED, ERROR };
+      using State = SystemState;
 
       void transitionTo(State next);
+      void requireRunnable(const SweepPlan &plan) const;
+      SweepSummary sweep(const SweepPlan &plan, const Checkpoint *resume);
 
       State currentState_{ State::BOOT };
+
+      RunArena arena_{};
+      AllocationGuard::Mode allocPolicy_{ AllocationGuard::kCompiledIn ? AllocationGuard::Mode::Count
+                                                                       : AllocationGuard::Mode::Off };
+      std::string allocReport_;
+
+      TelemetryPublisher *telemetry_{ nullptr };
+      EventBus *bus_{ nullptr };
+      Clock *clock_{ &Clock::steady() };
+      std::function<void(std::span<const ChannelSummary>)> showStats_;
+
+      RPCManager *rpc_{ nullptr };
+      Logger *log_{ nullptr };
+      ParameterStore *params_{ nullptr };
+      const ProtocolFactory *protocols_{ nullptr };
+      std::string selected_;
+      std::string runtime_, jitter_; ///< run-header lines; empty until setRunConditions()
+
+      CheckpointStore *checkpoints_{ nullptr };
+      Clock::Duration checkpointPeriod_{ std::chrono::seconds{ 1 } };
+      std::optional<Checkpoint> interrupted_;
+      std::chrono::steady_clock::time_point resumeRequested_{};
+      std::chrono::microseconds resumeLatency_{ 0 };
+
+      // sweep control: handleAbort() may come from the UI thread
+      std::atomic<bool> sweeping_{ false };
+      std::atomic<bool> abortRequested_{ false };
+      std::mutex abortMtx_;
+      std::condition_variable abortCv_;
     };
 
   } // namespace core
@@ -0,0 +1,57 @@
+#pragma once
+/** @file  SystemEvent.hpp
+ *  @brief Fixed-size system event broadcast by SystemCoordinator (state changes, errors).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "core/BroadcastRing.hpp"
+#include "core/SystemState.hpp"
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @struct SystemEvent
+ * @brief One entry of the coordinator’s event bus — trivially copyable, no heap.
+ */
+    struct SystemEvent {
+      enum class Kind : std::uint8_t { StateChanged, Error };
+
+      static constexpr std::size_t kTextLen = 47;
+
+      Kind kind{ Kind::StateChanged };
+      SystemState from{ SystemState::BOOT };
+      SystemState to{ SystemState::BOOT };
+      std::chrono::nanoseconds timestamp{ 0 }; ///< steady_clock since epoch
+      char text[kTextLen + 1]{};                ///< error reason; truncated, NUL-terminated
+
+      static SystemEvent stateChanged(SystemState from, SystemState to) {
+        SystemEvent e;
+        e.kind = Kind::StateChanged;
+        e.from = from;
+        e.to = to;
+        e.timestamp = std::chrono::steady_clock::now().time_since_epoch();
+        return e;
+      }
+
+      static SystemEvent error(SystemState state, std::string_view reason) {
+        SystemEvent e;
+        e.kind = Kind::Error;
+        e.from = e.to = state;
+        e.timestamp = std::chrono::steady_clock::now().time_since_epoch();
+        std::copy_n(reason.data(), std::min(reason.size(), kTextLen), e.text);
+        return e;
+      }
+    };
+
+    /// Written by SystemCoordinator only; UI, Logger and telemetry each read at their own pace.
+    using EventBus = BroadcastRing<SystemEvent>;
+
+  } // namespace core
+} // namespace milo
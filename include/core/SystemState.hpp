@@ -0,0 +1,34 @@
+#pragma once
+/** @file  SystemState.hpp
+ *  @brief Top-level lifecycle states of the SystemCoordinator FSM.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+namespace milo {
+  namespace core {
+
+    /// Kept in its own header so UI / logging can name states without pulling in the coordinator.
+    enum class SystemState { BOOT, INIT, IDLE, RUNNING, FINISHED, ERROR };
+
+    inline const char* toString(SystemState s) {
+      switch (s) {
+      case SystemState::BOOT:
+        return "BOOT";
+      case SystemState::INIT:
+        return "INIT";
+      case SystemState::IDLE:
+        return "IDLE";
+      case SystemState::RUNNING:
+        return "RUNNING";
+      case SystemState::FINISHED:
+        return "FINISHED";
+      case SystemState::ERROR:
+        return "ERROR";
+      default:
+        return "Unknown";
+      }
+    }
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,204 @@
+#pragma once
+/** @file  Task.hpp
+ *  @brief Lazy C++20 coroutine type for protocol code (`co_await` replies, delays, other tasks).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+
+namespace milo {
+  namespace core {
+
+    namespace detail {
+      /// Where new coroutine frames come from; ProtocolExecutor points it at its frame pool.
+      inline thread_local std::pmr::memory_resource* frameResource = nullptr;
+
+      struct JoinGroup;
+
+      /// Frame allocation and the bookkeeping every Task promise shares.
+      struct PromiseBase {
+        static constexpr std::size_t kHeader = alignof(std::max_align_t); ///< holds the resource
+
+        static void* operator new(std::size_t n) {
+          auto* mr = frameResource ? frameResource : std::pmr::new_delete_resource();
+          auto* p = static_cast<std::byte*>(mr->allocate(n + kHeader, kHeader));
+          std::memcpy(p, &mr, sizeof(mr));
+          return p + kHeader;
+        }
+        static void operator delete(void* frame, std::size_t n) {
+          auto* p = static_cast<std::byte*>(frame) - kHeader;
+          std::pmr::memory_resource* mr;
+          std::memcpy(&mr, p, sizeof(mr));
+          mr->deallocate(p, n + kHeader, kHeader);
+        }
+
+        struct FinalAwaiter {
+          bool await_ready() const noexcept { return false; }
+          template <typename P>
+          std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept;
+          void await_resume() const noexcept {}
+        };
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+
+        std::coroutine_handle<> continuation{}; ///< whoever co_awaits this task
+        JoinGroup* group{ nullptr };            ///< set instead when run by `whenAll`
+        std::exception_ptr error{};
+      };
+
+      /// Children started together; the awaiting task resumes when the last one finishes.
+      struct JoinGroup {
+        std::size_t pending{ 0 };
+        std::coroutine_handle<> waiter{};
+      };
+
+      template <typename P>
+      std::coroutine_handle<> PromiseBase::FinalAwaiter::await_suspend(
+          std::coroutine_handle<P> h) noexcept {
+        auto& p = h.promise();
+        if (p.group)
+          return --p.group->pending == 0 && p.group->waiter ? p.group->waiter
+                                                             : std::noop_coroutine();
+        return p.continuation ? p.continuation : std::noop_coroutine();
+      }
+    } // namespace detail
+
+    /**
+ * @class Task
+ * @brief Owning handle of a lazily started coroutine returning \p T.
+ *
+ *  * Nothing runs until the task is `co_await`ed (or handed to ProtocolExecutor::run());
+ *    completion resumes the awaiting coroutine directly (symmetric transfer, no queue hop).
+ *  * Exceptions propagate to the awaiter exactly like a plain call would.
+ *  * Frames come from the executor’s pre-sized frame pool, so a run does not touch the heap.
+ *  * Move-only; destroying a Task destroys its frame (never do that while it is suspended
+ *    inside an executor wait).
+ *  * GCC 12 mis-compiles a `co_await` inside an `if` condition (the coroutine body never
+ *    runs): bind the awaited value to a local first.
+ */
+    template <typename T = void> class [[nodiscard]] Task {
+    public:
+      struct promise_type : detail::PromiseBase {
+        std::optional<T> value{};
+
+        Task get_return_object() {
+          return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        template <typename U> void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+      };
+
+      Task(Task&& o) noexcept : handle_(std::exchange(o.handle_, {})) {}
+      Task& operator=(Task&& o) noexcept {
+        if (this != &o) {
+          reset();
+          handle_ = std::exchange(o.handle_, {});
+        }
+        return *this;
+      }
+      ~Task() { reset(); }
+
+      bool done() const { return !handle_ || handle_.done(); }
+
+      auto operator co_await() && noexcept {
+        struct Awaiter {
+          std::coroutine_handle<promise_type> h;
+          bool await_ready() const noexcept { return h.done(); }
+          std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            h.promise().continuation = caller;
+            return h;
+          }
+          T await_resume() {
+            if (h.promise().error)
+              std::rethrow_exception(h.promise().error);
+            return std::move(*h.promise().value);
+          }
+        };
+        return Awaiter{ handle_ };
+      }
+
+      /// Result of a finished task (rethrows its exception).
+      T result() {
+        if (handle_.promise().error)
+          std::rethrow_exception(handle_.promise().error);
+        return std::move(*handle_.promise().value);
+      }
+
+      std::coroutine_handle<promise_type> handle() const { return handle_; }
+
+    private:
+      explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+      void reset() {
+        if (handle_)
+          handle_.destroy();
+        handle_ = {};
+      }
+
+      std::coroutine_handle<promise_type> handle_{};
+    };
+
+    template <> class [[nodiscard]] Task<void> {
+    public:
+      struct promise_type : detail::PromiseBase {
+        Task get_return_object() {
+          return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        void return_void() const noexcept {}
+      };
+
+      Task(Task&& o) noexcept : handle_(std::exchange(o.handle_, {})) {}
+      Task& operator=(Task&& o) noexcept {
+        if (this != &o) {
+          reset();
+          handle_ = std::exchange(o.handle_, {});
+        }
+        return *this;
+      }
+      ~Task() { reset(); }
+
+      bool done() const { return !handle_ || handle_.done(); }
+
+      auto operator co_await() && noexcept {
+        struct Awaiter {
+          std::coroutine_handle<promise_type> h;
+          bool await_ready() const noexcept { return h.done(); }
+          std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            h.promise().continuation = caller;
+            return h;
+          }
+          void await_resume() {
+            if (h.promise().error)
+              std::rethrow_exception(h.promise().error);
+          }
+        };
+        return Awaiter{ handle_ };
+      }
+
+      void result() {
+        if (handle_.promise().error)
+          std::rethrow_exception(handle_.promise().error);
+      }
+
+      std::coroutine_handle<promise_type> handle() const { return handle_; }
+
+    private:
+      explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+      void reset() {
+        if (handle_)
+          handle_.destroy();
+        handle_ = {};
+      }
+
+      std::coroutine_handle<promise_type> handle_{};
+    };
+
+  } // namespace core
+} // namespace milo
@@ -0,0 +1,231 @@
+#pragma once
+/** @file  Telemetry.hpp
+ *  @brief Live counters in a POSIX shared-memory segment (seqlock records, fixed layout).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "core/StreamView.hpp"
+#include "core/SystemState.hpp"
+
+namespace milo {
+  namespace core {
+
+    struct SystemEvent;
+    template <typename T> class BroadcastRing;
+    template <typename T> class BroadcastListener;
+
+    /**
+ * @struct Seqlocked
+ * @brief One writer, any number of readers (other processes included), no locks.
+ *
+ *  Odd sequence = write in progress. Readers copy the payload and retry if the sequence moved;
+ *  the writer never waits and never enters the kernel.
+ */
+    template <typename T> struct alignas(64) Seqlocked {
+      static_assert(std::is_trivially_copyable_v<T>);
+
+      std::atomic<std::uint32_t> seq{ 0 };
+      T data{};
+
+      /// Writer side: \p f mutates `data` in place (only the owning thread writes a record).
+      template <typename F> void update(F&& f) {
+        const auto s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        f(data);
+        seq.store(s + 2, std::memory_order_release);
+      }
+
+      /// Reader side: consistent copy, or false if the writer kept it busy for every attempt.
+      bool read(T& out, int attempts = 64) const {
+        while (attempts-- > 0) {
+          const auto s1 = seq.load(std::memory_order_acquire);
+          if (s1 & 1u)
+            continue;
+          std::memcpy(&out, &data, sizeof(T));
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (seq.load(std::memory_order_relaxed) == s1)
+            return true;
+        }
+        return false;
+      }
+    };
+
+    namespace telemetry {
+      constexpr std::uint32_t kMagic = 0x4d494c4f; // "MILO"
+      constexpr std::uint16_t kVersion = 2;
+      constexpr std::size_t kMaxDevices = 16;
+      constexpr std::size_t kMaxQueues = 8;
+      constexpr std::size_t kMaxThreads = 8;
+      constexpr std::size_t kMaxStreams = 8;
+      constexpr std::size_t kNameLen = 16;
+      constexpr const char* kDefaultName = "/milo-telemetry";
+
+      struct Fsm {
+        SystemState state{ SystemState::BOOT };
+        std::uint32_t transitions{ 0 };
+        std::int64_t sinceNs{ 0 }; ///< steady_clock time of the last transition
+      };
+
+      struct Device {
+        char name[kNameLen]{};
+        std::uint64_t commands{ 0 };
+        std::uint64_t replies{ 0 };
+        std::uint64_t errors{ 0 };
+        std::uint32_t lastRttUs{ 0 };
+        std::uint32_t minRttUs{ UINT32_MAX };
+        std::uint32_t maxRttUs{ 0 };
+        std::uint32_t avgRttUs{ 0 }; ///< EWMA, α = 1/8
+      };
+
+      struct Queue {
+        char name[kNameLen]{};
+        std::uint32_t fill{ 0 };
+        std::uint32_t capacity{ 0 };
+        std::uint32_t peak{ 0 };
+        std::uint64_t dropped{ 0 };
+      };
+
+      struct Heartbeat {
+        char name[kNameLen]{};
+        std::int64_t lastNs{ 0 }; ///< steady_clock
+        std::uint64_t beats{ 0 };
+      };
+
+      /** The whole segment. Slots are claimed at setup; `*Count` only ever grows. */
+      struct Segment {
+        std::atomic<std::uint32_t> magic{ 0 }; ///< written last, once the layout is valid
+        std::uint16_t version{ kVersion };
+        std::uint16_t reserved{ 0 };
+        std::uint32_t size{ 0 };
+        std::int32_t pid{ 0 };
+        std::atomic<std::uint32_t> deviceCount{ 0 };
+        std::atomic<std::uint32_t> queueCount{ 0 };
+        std::atomic<std::uint32_t> threadCount{ 0 };
+        std::atomic<std::uint32_t> streamCount{ 0 };
+
+        Seqlocked<Fsm> fsm;
+        Seqlocked<Device> devices[kMaxDevices];
+        Seqlocked<Queue> queues[kMaxQueues];
+        Seqlocked<Heartbeat> threads[kMaxThreads];
+        Seqlocked<StreamView> streams[kMaxStreams]; ///< decimated streamed channels
+      };
+
+      inline std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+      }
+
+      inline void setName(char (&dst)[kNameLen], std::string_view name) {
+        const auto n = std::min(name.size(), kNameLen - 1);
+        std::memcpy(dst, name.data(), n);
+        dst[n] = '\0';
+      }
+    } // namespace telemetry
+
+    /**
+ * @class TelemetryPublisher
+ * @brief Daemon side: owns the segment; every update is a handful of plain stores.
+ *
+ *  * `add*()` claim slots during setup (returns -1 when the table is full); updates to an
+ *    invalid slot are ignored so unobserved builds need no special-casing.
+ *  * Each record has exactly one writing thread (the device’s protocol thread, the queue’s
+ *    consumer, the heartbeat’s own thread).
+ */
+    class TelemetryPublisher {
+    public:
+      /// shm_open + mmap; @returns nullptr if the segment cannot be created.
+      static std::unique_ptr<TelemetryPublisher> create(const std::string& name = telemetry::kDefaultName);
+      ~TelemetryPublisher(); ///< unmaps and unlinks the segment
+
+      void publishState(SystemState s);
+
+      int addDevice(std::string_view name);
+      void commandSent(int slot);
+      void replyReceived(int slot, std::chrono::microseconds rtt);
+      void deviceError(int slot);
+
+      int addQueue(std::string_view name, std::size_t capacity);
+      void queueLevel(int slot, std::size_t fill, std::uint64_t dropped);
+
+      int addThread(std::string_view name);
+      void heartbeat(int slot);
+
+      /// Streamed channel (SampleStreams): claimed on its first sample, by the protocol thread.
+      int addStream(std::string_view key);
+      /// Once per completed view bucket — a constant rate, whatever the sample rate.
+      void publishStream(int slot, const StreamView& view);
+
+      /**
+       * @brief Follow \p bus on a listener thread: the FSM record tracks its state changes, and
+       *        every subscriber registered so far (attach this last) gets a queue record
+       *        `bus:<name>` with its lag as fill and its lost events as drops.
+       *        Use instead of SystemCoordinator::attachTelemetry(), not with it.
+       */
+      void attachEventBus(BroadcastRing<SystemEvent>& bus);
+
+      const telemetry::Segment& segment() const { return *seg_; }
+
+      TelemetryPublisher(const TelemetryPublisher&) = delete;
+      TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    private:
+      TelemetryPublisher(std::string name, telemetry::Segment* seg);
+
+      std::string name_;
+      telemetry::Segment* seg_;
+      std::vector<int> busSlots_; ///< queue slot per bus subscriber (listener thread writes)
+      std::unique_ptr<BroadcastListener<SystemEvent>> busListener_;
+    };
+
+    /** Copy of every live record, taken by TelemetryReader::snapshot(). */
+    struct TelemetrySnapshot {
+      std::int32_t pid{ 0 };
+      telemetry::Fsm fsm{};
+      std::uint32_t deviceCount{ 0 }, queueCount{ 0 }, threadCount{ 0 }, streamCount{ 0 };
+      telemetry::Device devices[telemetry::kMaxDevices]{};
+      telemetry::Queue queues[telemetry::kMaxQueues]{};
+      telemetry::Heartbeat threads[telemetry::kMaxThreads]{};
+      StreamView streams[telemetry::kMaxStreams]{};
+    };
+
+    /**
+ * @class TelemetryReader
+ * @brief Observer side (milo-top): read-only mapping, never writes, never blocks the daemon.
+ */
+    class TelemetryReader {
+    public:
+      /// @returns nullptr if the segment does not exist or its layout does not match.
+      static std::unique_ptr<TelemetryReader> open(const std::string& name = telemetry::kDefaultName);
+      ~TelemetryReader();
+
+      /// False once the publisher has shut down (the mapping stays valid).
+      bool alive() const;
+
+      /// False if a record stayed mid-update for every retry (try again next refresh).
+      bool snapshot(TelemetrySnapshot& out) const;
+
+      TelemetryReader(const TelemetryReader&) = delete;
+      TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    private:
+      explicit TelemetryReader(const telemetry::Segment* seg) : seg_(seg) {}
+
+      const telemetry::Segment* seg_;
+    };
+
+  } // namespace core
+} // namespace milo
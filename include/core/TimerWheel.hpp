@@ -0,0 +1,130 @@
+#pragma once
+/** @file  TimerWheel.hpp
+ *  @brief Hierarchical timer wheel: the single timeout/delay service, driven by one timerfd.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#include "core/Clock.hpp"
+
+namespace milo {
+  namespace core {
+
+    class TimerWheel;
+
+    /**
+ * @class Timer
+ * @brief Intrusive timer node, embedded in (or owned by) the object that needs the timeout.
+ *
+ *  * The wheel links nodes, it never allocates; arm/cancel are O(1).
+ *  * Set the callback once (a `[this]` lambda fits std::function’s small buffer).
+ *  * Non-copyable, non-movable (the wheel holds pointers to it); destroying an armed
+ *    timer cancels it.
+ */
+    class Timer {
+    public:
+      using Callback = std::function<void()>;
+
+      Timer() = default;
+      explicit Timer(Callback cb) : cb_(std::move(cb)) {}
+      ~Timer();
+
+      void setCallback(Callback cb) { cb_ = std::move(cb); }
+      bool armed() const { return wheel_ != nullptr; }
+      void cancel();
+
+      Timer(const Timer&) = delete;
+      Timer& operator=(const Timer&) = delete;
+
+    private:
+      friend class TimerWheel;
+
+      Callback cb_{};
+      TimerWheel* wheel_{ nullptr };
+      Timer* prev_{ nullptr };
+      Timer* next_{ nullptr };
+      std::uint64_t expiry_{ 0 }; ///< absolute tick
+      std::uint8_t level_{ 0 };
+      std::uint8_t slot_{ 0 };
+    };
+
+    /**
+ * @class TimerWheel
+ * @brief 4 levels × 64 slots of `resolution` ticks (≈ 4.6 h span at 1 ms), cascading.
+ *
+ *  * Time is steady_clock (== CLOCK_MONOTONIC, == GPIO kernel timestamps) since epoch.
+ *  * `advance(now)` jumps straight from one occupied slot to the next, so idle gaps cost
+ *    nothing and a virtual clock can skip hours in one call.
+ *  * `fd()` is a timerfd kept programmed for the earliest deadline: add it to the owner’s
+ *    epoll set and call `service()` when readable. Single-threaded by design (owner thread).
+ */
+    class TimerWheel {
+    public:
+      using Duration = std::chrono::nanoseconds;
+
+      /// \p start defaults to steady_clock::now(); virtual-time users pass their own epoch.
+      explicit TimerWheel(std::chrono::microseconds resolution = std::chrono::milliseconds{ 1 },
+                          bool useTimerFd = true, std::optional<Duration> start = std::nullopt);
+      ~TimerWheel();
+
+      // ---- public API ----------------------------------------------------------
+      /// Arm (or re-arm) \p t to fire at absolute time \p deadline.
+      void arm(Timer& t, Duration deadline);
+      /// Arm relative to the wheel’s current time.
+      void armAfter(Timer& t, Duration delay) { arm(t, now() + delay); }
+      void cancel(Timer& t);
+
+      /// Fire every timer due at or before \p now; returns how many fired.
+      std::size_t advance(Duration now);
+      /// Earliest time something needs the wheel (an expiry or a cascade point).
+      std::optional<Duration> nextDeadline() const;
+
+      /// Time of the last advance (tick-aligned).
+      Duration now() const { return current_ * resolution_; }
+      std::size_t size() const { return armed_; }
+
+      /// timerfd for epoll (-1 if disabled).
+      int fd() const { return tfd_; }
+      /// Drain the timerfd, advance to the clock’s now, re-program the timerfd.
+      std::size_t service();
+
+      /// Time source of `service()` (default: the steady clock). Simulations pass a
+      /// VirtualClock and drive the wheel with `serviceNext()` instead of the timerfd.
+      void setClock(Clock& clock) { clock_ = &clock; }
+      /// Wait on the clock for the earliest deadline (a jump on a VirtualClock), then service.
+      /// Returns 0 at once when nothing is armed.
+      std::size_t serviceNext();
+
+      TimerWheel(const TimerWheel&) = delete;
+      TimerWheel& operator=(const TimerWheel&) = delete;
+
+    private:
+      static constexpr unsigned kLevels = 4;
+      static constexpr unsigned kBits = 6;
+      static constexpr unsigned kSlots = 1u << kBits;
+
+      void insert(Timer& t);
+      void unlink(Timer& t);
+      std::optional<std::uint64_t> nextEventTick() const;
+      void programFd();
+
+      Duration resolution_;
+      std::uint64_t current_{ 0 }; ///< ticks
+      std::size_t armed_{ 0 };
+
+      std::array<std::array<Timer*, kSlots>, kLevels> slots_{};
+      std::array<std::uint64_t, kLevels> occupied_{}; ///< bit per non-empty slot
+
+      Clock* clock_{ &Clock::steady() };
+      int tfd_{ -1 };
+      std::uint64_t programmed_{ UINT64_MAX }; ///< tick the timerfd is set for
+    };
+
+  } // namespace core
+} // namespace milo
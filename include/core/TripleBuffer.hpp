@@ -0,0 +1,63 @@
+#pragma once
+/** @file  TripleBuffer.hpp
+ *  @brief Lock-free single-writer / single-reader "latest value" hand-off.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace milo {
+  namespace core {
+
+    /**
+ * @class TripleBuffer
+ * @brief Writer always has a private back slot, reader a private front slot; the middle
+ *        slot is swapped atomically. Neither side ever waits, and intermediate values the
+ *        reader did not get to are simply overwritten (coalesced).
+ */
+    template <typename T> class TripleBuffer {
+    public:
+      TripleBuffer() = default;
+
+      // ---- writer side ---------------------------------------------------------
+      /// Slot the writer may fill before calling `publish()`.
+      T& back() { return slots_[back_]; }
+
+      void publish() {
+        back_ = middle_.exchange(static_cast<std::uint8_t>(back_ | kFresh),
+                                 std::memory_order_acq_rel) &
+                kIndex;
+      }
+
+      void publish(const T& value) {
+        back() = value;
+        publish();
+      }
+
+      // ---- reader side ---------------------------------------------------------
+      /// Swaps in the newest published value if there is one; returns false if nothing new.
+      bool consume() {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0)
+          return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+        return true;
+      }
+
+      /// Latest value swapped in by `consume()`.
+      const T& front() const { return slots_[front_]; }
+
+    private:
+      static constexpr std::uint8_t kIndex = 0x3;
+      static constexpr std::uint8_t kFresh = 0x4;
+
+      std::array<T, 3> slots_{};
+      std::uint8_t back_{ 0 };                ///< writer-owned
+      std::atomic<std::uint8_t> middle_{ 1 }; ///< shared (index | fresh bit)
+      std::uint8_t front_{ 2 };               ///< reader-owned
+    };
+
+  } // namespace core
+} // namespace milo
@@ -17,9 +17,11 @@ namespace milo {
 	 * @class ButtonGPIO
 	 * @brief Concrete GPIOInput that classifies press types.
 	 *
-	 *  * Emits `ShortPress` after ≥ 50 ms but < 1 s.
-	 *  * Emits `LongPress`  after ≥ 1 s hold.
-	 *  * No copy, move-enabled (inherits fd_ ownership).
+	 *  * Emits `ShortPress` on release after a debounced press held < 1 s.
+	 *  * Emits `LongPress` once a ≥ 1 s hold is seen — by a wheel timer when one is
+	 *    attached, else by `poll()`, else on release — never twice for one press.
+	 *  * Hold time is measured between kernel edge timestamps.
+	 *  * No copy, move-enabled (inherits line ownership).
 	 */
 
     class ButtonGPIO : public GPIOInput {
@@ -34,10 +36,15 @@ namespace milo {
 
       void registerCallback(Callback cb) { cbButton_ = std::move(cb); }
 
-      /** Called by owner loop (e.g., UI thread) every ~10 ms. */
+      /** Only needed while the button is held, to report a long press before release. */
       void poll(std::chrono::milliseconds now) override;
 
+    protected:
+      void onEdge(Edge e, std::chrono::nanoseconds timestamp) override;
+
     private:
+      void onHoldTimeout();
+
       void emitPress(Event e) {
         if (cbButton_) {
           if (cbButton_)
@@ -48,8 +55,10 @@ namespace milo {
       Callback cbButton_{};
 
       std::chrono::milliseconds longThreshold_{ 1000 };
-      bool presed_{ false };
-      std::uint32_t pressTick_{ 0 };
+      bool pressed_{ false };
+      bool longEmitted_{ false };
+      std::chrono::nanoseconds pressTs_{ 0 }; ///< kernel timestamp of the debounced press
+      std::unique_ptr<core::Timer> holdTimer_;
     };
 
   } // namespace io
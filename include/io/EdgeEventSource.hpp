@@ -0,0 +1,82 @@
+#pragma once
+/** @file  EdgeEventSource.hpp
+ *  @brief Source of kernel-timestamped GPIO edge events (GPIO character device v2 uAPI).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace milo {
+  namespace io {
+
+    /** One edge as reported by the kernel; `timestamp` is CLOCK_MONOTONIC (== steady_clock). */
+    struct EdgeEvent {
+      enum class Kind : std::uint8_t { Rising, Falling };
+
+      unsigned int line{ 0 }; ///< chip line offset
+      Kind kind{ Kind::Rising };
+      std::chrono::nanoseconds timestamp{ 0 };
+      std::uint32_t seqno{ 0 }; ///< per-request sequence; gaps mean the kernel FIFO overflowed
+    };
+
+    /**
+ * @class EdgeEventSource
+ * @brief Abstract edge producer so GPIO consumers can be driven by a scripted fake.
+ *
+ *  * `fd()` becomes readable when events are pending — register it with epoll.
+ *  * `read()` never blocks; it drains up to `out.size()` events.
+ */
+    class EdgeEventSource {
+    public:
+      virtual ~EdgeEventSource() = default;
+
+      virtual int fd() const = 0;
+      virtual std::size_t read(std::span<EdgeEvent> out) = 0;
+      /** Current (active-low corrected) level of \p line; false if unknown. */
+      virtual bool level(unsigned int line) const = 0;
+    };
+
+    /**
+ * @class GpioCdevEventSource
+ * @brief Requests one or more lines of a /dev/gpiochipN with both-edge detection.
+ *
+ *  * One request fd for all lines, so A/B encoder edges arrive in one ordered stream.
+ *  * Optional in-kernel debounce (GPIO_V2_LINE_ATTR_ID_DEBOUNCE) where the driver supports it.
+ *  * No copy, move-enabled (sole owner of the request fd).
+ */
+    class GpioCdevEventSource : public EdgeEventSource {
+    public:
+      static constexpr std::size_t kMaxLines = 4;
+
+      /** @returns nullptr if the chip cannot be opened or the lines cannot be requested. */
+      static std::unique_ptr<GpioCdevEventSource>
+      open(const std::string& chip, std::span<const unsigned int> lines, bool activeLow = false,
+           std::chrono::microseconds kernelDebounce = std::chrono::microseconds{ 0 });
+
+      ~GpioCdevEventSource() override;
+
+      int fd() const override { return fd_; }
+      std::size_t read(std::span<EdgeEvent> out) override;
+      bool level(unsigned int line) const override;
+
+      GpioCdevEventSource(const GpioCdevEventSource&) = delete;
+      GpioCdevEventSource& operator=(const GpioCdevEventSource&) = delete;
+      /// The moved-from source gives up the fd (reads nothing, closes nothing).
+      GpioCdevEventSource(GpioCdevEventSource&& o) noexcept;
+      GpioCdevEventSource& operator=(GpioCdevEventSource&& o) noexcept;
+
+    private:
+      GpioCdevEventSource() = default;
+
+      int fd_{ -1 };
+      unsigned int lines_[kMaxLines]{};
+      std::size_t numLines_{ 0 };
+    };
+
+  } // namespace io
+} // namespace milo
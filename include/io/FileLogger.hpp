@@ -5,6 +5,8 @@
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
+#include <cstdio>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,16 +18,23 @@ namespace milo {
  * @brief RAII wrapper that opens a file, buffers writes, and flushes on demand.
  *
  *  * Intended for large run logs (10 kB – 1 MB).
- *  * Uses `std::fwrite` in 4 kB chunks (impl TBD).
+ *  * Uses `std::fwrite` in 4 kB chunks; `write()` only copies into the buffer.
+ *  * Journaled mode: each chunk goes to `<path>.jnl` (LogJournal) before the file, `sync()`
+ *    makes it durable, and a clean `close()` removes the journal — a leftover journal
+ *    means the run was cut short and `LogJournal::recover()` can repair the file.
  */
+    class LogJournal;
+
     class FileLogger {
     public:
+      static constexpr std::size_t kChunk = 4096;
+
       FileLogger() = default;
       ~FileLogger(); ///< flush + fclose
 
       //---public API------------------------------------------------------
       /** @returns false if path cannot be opened writable. */
-      bool open(const std::string& path);
+      bool open(const std::string& path, bool journaled = false);
 
       /** Queues one CSV line (caller includes trailing '\n'). */
       void write(const std::string& csv);
@@ -33,17 +42,30 @@ namespace milo {
       /** Force-flush buffer to disk; returns true on success. */
       bool flush();
 
+      /** Durability point: flush, then commit the journal (fdatasync); checkpoints the file
+       *  once the journal has grown past LogJournal::kCheckpointBytes. Plain flush when not
+       *  journaled. */
+      bool sync();
+
+      static std::string journalPath(const std::string& path) { return path + ".jnl"; }
+
       void close();
 
+      bool isOpen() const { return fp_ != nullptr; }
+      /** Bytes accepted since open() (buffered + written). */
+      std::size_t bytesWritten() const { return bytes_; }
+
       //---non-copyable, move-enabled---------------------------------------
       FileLogger(const FileLogger&) = delete;
       FileLogger& operator=(const FileLogger&) = delete;
-      FileLogger(FileLogger&&) = default;
-      FileLogger& operator=(FileLogger&&) = default;
+      FileLogger(FileLogger&& other) noexcept;
+      FileLogger& operator=(FileLogger&& other) noexcept;
 
     private:
       FILE* fp_{ nullptr };
       std::vector<char> buffer_;
+      std::size_t bytes_{ 0 };
+      std::unique_ptr<LogJournal> journal_; ///< null unless journaled
     };
 
   } // namespace io
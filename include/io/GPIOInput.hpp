@@ -1,14 +1,18 @@
 #pragma once
 /** @file  GPIOInput.hpp
- *  @brief Abstract, debounced edge-input wrapper for a single GPIO line.
+ *  @brief Debounced edge-input wrapper for a single GPIO line (kernel edge events).
  *
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <string>
 
+#include "core/TimerWheel.hpp"
+#include "io/EdgeEventSource.hpp"
+
 namespace milo {
   namespace io {
 
@@ -17,15 +21,23 @@ namespace milo {
  * @brief Base-class that owns one Linux GPIO line, debounces its state,
  *        and invokes a user-supplied callback on rising/falling edges.
  *
- *  * Non-blocking: `poll()` is called periodically by the owner thread.
- *  * No copy, move-enabled (sole owner of the line handle).
+ *  * Interrupt-driven: the line is requested with both-edge detection; register `fd()` with
+ *    epoll and call `service()` when it is readable. No periodic wake-ups.
+ *  * Debounce runs on the kernel event timestamps, so it is exact regardless of how late
+ *    the owner thread gets scheduled.
+ *  * With a TimerWheel attached, every time-driven action (bounce settling, long-press)
+ *    is a wheel timer and `poll()` is never needed.
+ *  * Non-copyable, non-movable: sole owner of the line handle, and its wheel timers call
+ *    back into `this`.
  */
     class GPIOInput {
     public:
-      enum class Edge { Rising, Falling };
+      using Edge = EdgeEvent::Kind;
 
       using Callback = std::function<void(Edge)>;
 
+      static constexpr std::chrono::milliseconds kDefaultDebounce{ 20 }; ///< REQUIREMENTS: ≥20 ms
+
       GPIOInput() = default;
       virtual ~GPIOInput(); ///< auto-release line
 
@@ -34,33 +46,60 @@ namespace milo {
                 unsigned int line,       ///< pin number
                 bool activeLow = false);
 
-      /** Polls the line and emits debounced edge events.  To be called from the
-      owner’s loop (UI thread or epoll mux). */
-      virtual void poll(std::chrono::milliseconds now) = 0;
+      /** Use an already-requested source (tests inject a scripted fake here). */
+      void attach(std::unique_ptr<EdgeEventSource> source, unsigned int line);
+
+      /** Pollable fd for the owner’s epoll set; -1 when closed. */
+      int fd() const { return source_ ? source_->fd() : -1; }
+
+      /** Drains pending kernel events and emits debounced edges. Call when `fd()` is readable. */
+      void service();
+
+      /** Time-driven housekeeping: settles a bounce that ended without a further edge, and lets
+       *  derived classes act on hold times. \p now is steady_clock time since epoch.
+       *  Only needed when no TimerWheel is attached. */
+      virtual void poll(std::chrono::milliseconds now);
+
+      /** Register time-driven work with the shared timer service instead of `poll()`. */
+      void attachTimers(core::TimerWheel& wheel) { timers_ = &wheel; }
 
       void registerCallback(Callback cb) { cb_ = std::move(cb); }
+      void setDebounce(std::chrono::nanoseconds window) { debounce_ = window; }
 
       void close();
 
-      // ─── non-copyable, move-enabled ───────────────────────────────────────────
+      // ─── non-copyable, non-movable (timers capture `this`) ────────────────────
       GPIOInput(const GPIOInput&) = delete;
       GPIOInput& operator=(const GPIOInput&) = delete;
-      GPIOInput(GPIOInput&&) = default;
-      GPIOInput& operator=(GPIOInput&&) = default;
+      GPIOInput(GPIOInput&&) = delete;
+      GPIOInput& operator=(GPIOInput&&) = delete;
 
     protected:
+      /** Called once per debounced edge with its kernel timestamp; default forwards to the callback. */
+      virtual void onEdge(Edge e, std::chrono::nanoseconds timestamp);
+
+      /** Reports the raw level as the debounced one if it has been stable for a window. */
+      void settle(std::chrono::nanoseconds now);
+
       /** Derived classes call this when they detect a debounced edge. */
       void emit(Edge e) {
         if (cb_)
           cb_(e);
       }
 
-      int fd_{ -1 }; ///< gpiod line FD (-1 = closed)
+      std::unique_ptr<EdgeEventSource> source_; ///< kernel line request (or a fake)
+      unsigned int line_{ 0 };
       Callback cb_{};
 
-      // simple debounce helpers
-      bool lastState_{ false };
-      uint32_t lastTick_{ 0 }; ///< msec timestamp of last change
+      // debounce state, all in kernel (CLOCK_MONOTONIC) time
+      std::chrono::nanoseconds debounce_{ kDefaultDebounce };
+      bool lastState_{ false };  ///< debounced level
+      bool rawState_{ false };   ///< level after the most recent raw edge
+      std::chrono::nanoseconds lastEdgeTs_{ 0 }; ///< last accepted edge
+      std::chrono::nanoseconds lastRawTs_{ 0 };  ///< last raw edge, accepted or not
+
+      core::TimerWheel* timers_{ nullptr };      ///< optional shared timer service
+      std::unique_ptr<core::Timer> settleTimer_; ///< created on first bounce
     };
 
   } // namespace io
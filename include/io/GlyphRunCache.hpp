@@ -0,0 +1,56 @@
+#pragma once
+/** @file  GlyphRunCache.hpp
+ *  @brief Small LRU cache of pre-rasterized text labels (column bytes).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace milo {
+  namespace io {
+
+    /**
+ * @class GlyphRunCache
+ * @brief Static labels ("Voltage", "FlowRate", state names) are rasterized once and
+ *        afterwards blitted as a single run of column bytes.
+ *
+ *  * Fixed storage: no allocation on hit or miss; least-recently-used slot is recycled.
+ *  * Labels longer than `kMaxChars` are not cacheable — callers render them per glyph.
+ */
+    class GlyphRunCache {
+    public:
+      static constexpr std::size_t kSlots = 16;
+      static constexpr std::size_t kMaxChars = 21; ///< one full 128 px line at 6 px advance
+
+      struct Run {
+        const std::uint8_t* columns{ nullptr };
+        int width{ 0 };
+      };
+
+      /** Returns the cached run for \p text, rasterizing it on a miss. Empty run if too long. */
+      Run lookup(std::string_view text);
+
+      std::size_t hits() const { return hits_; }
+      std::size_t misses() const { return misses_; }
+
+    private:
+      struct Slot {
+        std::uint64_t hash{ 0 };
+        std::uint64_t lastUse{ 0 }; ///< 0 = empty
+        std::uint8_t len{ 0 };
+        std::array<char, kMaxChars> key{};
+        std::array<std::uint8_t, kMaxChars * 6> columns{};
+      };
+
+      std::array<Slot, kSlots> slots_{};
+      std::uint64_t tick_{ 0 };
+      std::size_t hits_{ 0 };
+      std::size_t misses_{ 0 };
+    };
+
+  } // namespace io
+} // namespace milo
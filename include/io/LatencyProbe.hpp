@@ -0,0 +1,69 @@
+#pragma once
+/** @file  LatencyProbe.hpp
+ *  @brief Measures command → reply round trips per serial setting, to pick the fastest one.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// MILO headers
+#include "io/SerialSettings.hpp"
+
+namespace milo {
+  namespace io {
+
+    class SerialChannel;
+
+    /** Round-trip statistics of one setting (times are wall-clock, write → complete line). */
+    struct LatencyReport {
+      SerialSettings requested{};
+      SerialSettings effective{}; ///< as the driver accepted it (see SerialChannel::settings())
+      bool opened{ false };
+      std::size_t rounds{ 0 };
+      std::size_t replies{ 0 };
+      std::size_t timeouts{ 0 };
+      std::chrono::microseconds min{ 0 };
+      std::chrono::microseconds p50{ 0 };
+      std::chrono::microseconds p99{ 0 };
+      std::chrono::microseconds max{ 0 };
+
+      /// Opened, and every command got its reply in time.
+      bool stable() const { return opened && rounds > 0 && timeouts == 0; }
+    };
+
+    /**
+ * @class LatencyProbe
+ * @brief Sends a harmless query (\p command) over and over and times each reply.
+ *
+ *  * `measure()` works on any open channel; `sweep()` re-opens the device once per
+ *    candidate setting, so baud, low-latency mode and VMIN can be compared on the real rig.
+ *  * `fastest()` picks the lowest p99 among the stable settings (ties: lower max) — a fast
+ *    setting that drops replies is no use to a 10 ms step budget.
+ *  * Used by `milo-latency`; not on any run path.
+ */
+    class LatencyProbe {
+    public:
+      struct Options {
+        std::string command{ "*IDN?" };
+        std::size_t rounds{ 200 };
+        std::chrono::milliseconds timeout{ 50 };
+      };
+
+      static LatencyReport measure(SerialChannel& channel, const Options& options);
+
+      static std::vector<LatencyReport> sweep(const std::string& device,
+                                              std::span<const SerialSettings> candidates,
+                                              const Options& options);
+
+      /// Index of the best stable report; nullopt if none is stable.
+      static std::optional<std::size_t> fastest(std::span<const LatencyReport> reports);
+    };
+
+  } // namespace io
+} // namespace milo
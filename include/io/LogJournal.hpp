@@ -0,0 +1,72 @@
+#pragma once
+/** @file  LogJournal.hpp
+ *  @brief Append-only write-ahead journal that makes a run log crash-consistent.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace milo {
+  namespace io {
+
+    /**
+ * @class LogJournal
+ * @brief Every chunk bound for the run log is appended here first, as a checksummed block.
+ *
+ *  Block: `u32 magic  u64 seq  u64 offset  u32 len  u32 crc32(seq‥len, data)  data`, where
+ *  `offset` is the chunk’s position in the run log. A block with len 0 is a checkpoint:
+ *  the run log is durable up to `offset`.
+ *
+ *  * `commit()` is the only fdatasync on the hot side — a group commit, called once per
+ *    flush period, not per event. Everything committed survives a watchdog reset.
+ *  * `checkpoint()` syncs the run log and restarts the journal, so it stays small and
+ *    recovery reads only the journal, never the (large) run log.
+ *  * `recover()` replays the intact prefix of blocks into the run log and truncates the
+ *    torn tail; replaying is idempotent, so a crash during recovery is harmless.
+ */
+    class LogJournal {
+    public:
+      static constexpr std::size_t kCheckpointBytes = 256 * 1024;
+
+      struct Recovery {
+        std::size_t blocks{ 0 };        ///< intact data blocks replayed
+        std::uint64_t logBytes{ 0 };    ///< run-log size after repair
+        std::uint64_t discarded{ 0 };   ///< torn journal bytes ignored
+      };
+
+      LogJournal() = default;
+      ~LogJournal(); ///< closes; the file stays for recovery unless close(true) was called
+
+      /// Create (truncate) \p path, starting with a checkpoint at \p durableBytes.
+      bool open(const std::string& path, std::uint64_t durableBytes = 0);
+      bool append(std::uint64_t offset, std::string_view data);
+      bool commit();
+      /// fdatasync \p logFd (the run log, \p logBytes long) and restart the journal.
+      bool checkpoint(int logFd, std::uint64_t logBytes);
+      void close(bool remove);
+
+      std::uint64_t size() const { return size_; }
+      bool isOpen() const { return fd_ >= 0; }
+
+      /// Repair \p logPath from \p journalPath and delete the journal; nullopt if there is none.
+      static std::optional<Recovery> recover(const std::string& logPath,
+                                             const std::string& journalPath);
+
+      LogJournal(const LogJournal&) = delete;
+      LogJournal& operator=(const LogJournal&) = delete;
+
+    private:
+      bool writeBlock(std::uint64_t offset, std::string_view data);
+
+      int fd_{ -1 };
+      std::string path_;
+      std::uint64_t seq_{ 0 };
+      std::uint64_t size_{ 0 };
+    };
+
+  } // namespace io
+} // namespace milo
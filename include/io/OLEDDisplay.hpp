@@ -1,53 +1,108 @@
 #pragma once
 /** @file  OLEDDisplay.hpp
- *  @brief Tiny-I²C 128×64 monochrome OLED wrapper.
+ *  @brief Tiny-SPI 128×64 monochrome OLED wrapper (SSD1306 / SH1106).
  *
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "io/GlyphRunCache.hpp"
+
+struct spi_ioc_transfer; // <linux/spi/spidev.h>, kept out of the public header
+
 namespace milo {
   namespace io {
 
     /**
  * @class OLEDDisplay
- * @brief Convenience API for text + bitmap blitting; hides low-level I²C.
+ * @brief Convenience API for text + bitmap blitting; hides low-level SPI.
  *
- *  * Owns the file-descriptor to /dev/i2c-*.
- *  * Keeps an off-screen frame-buffer; `flush()` pushes deltas.
+ *  * Owns the file-descriptor to /dev/spidev*.
+ *  * Keeps an off-screen frame-buffer plus a shadow of the last frame sent to the panel;
+ *    `flush()` diffs the two per page and pushes only changed column ranges.
+ *  * Panel is strapped for 3-wire SPI: D/C rides as bit 8 of each 9-bit word, so every
+ *    changed region (address commands + data) goes out in a single SPI_IOC_MESSAGE.
  */
     class OLEDDisplay {
     public:
+      enum class Controller { SSD1306, SH1106 };
+
+      static constexpr int kWidth = 128;
+      static constexpr int kHeight = 64;
+      static constexpr int kPages = kHeight / 8;
+
+      /// What the last `flush()` cost; lets us confirm the UI thread's time in SPI.
+      struct FlushStats {
+        std::size_t regions{ 0 }; ///< page/column runs sent
+        std::size_t words{ 0 };   ///< 9-bit SPI words (commands + data) clocked out
+        std::chrono::microseconds duration{ 0 };
+      };
+
       OLEDDisplay() = default;
-      ~OLEDDisplay(); ///< auto-closes fd
+      virtual ~OLEDDisplay(); ///< auto-closes fd
 
       //---public API---------------------------------------------------------
       bool init(const std::string& devPath = "/dev/spidev0.0",
-                uint8_t dcPin = 24); // data/command GPIO for 4-wire SPI
+                Controller ctrl = Controller::SSD1306, std::uint32_t speedHz = 8'000'000);
 
       /* Text helpers --------------------------------------------------------- */
       void clear();
+      /** Renders a label in the 5×7 font (cell overwritten, y may be unaligned); static labels
+       *  are served from the glyph-run cache. Non-ASCII renders as '?'. */
       void drawText(int x, int y, const std::string& utf8);
+      /** Renders \p value with \p decimals straight into the frame-buffer (no allocation).
+       *  @returns x just past the last glyph, for laying out a unit suffix. */
+      int drawNumber(int x, int y, float value, int decimals = 1);
+      static constexpr int textWidth(std::string_view s) { return static_cast<int>(s.size()) * 6; }
 
-      /* Bitmap helper -------------------------------------------------------- */
+      /* Bitmap helpers ------------------------------------------------------- */
+      void setPixel(int x, int y, bool on);
+      bool pixel(int x, int y) const;
+      /** \p monoBits is page-major like the panel GRAM: byte (row/8)*w + col, bit = row%8. */
       void drawBitmap(int x, int y, int w, int h, const std::vector<uint8_t>& monoBits);
 
-      void flush(); ///< push buffer to panel
+      /** Push changed regions to the panel; false if the SPI transfer failed. */
+      bool flush();
       void close();
 
-      /* non-copyable, move-enabled ------------------------------------------ */
+      /** Forget what the panel shows so the next flush resends the full frame. */
+      void invalidate();
+
+      const GlyphRunCache& glyphCache() const { return runCache_; }
+      const FlushStats& lastFlush() const { return lastFlush_; }
+      std::uint64_t totalWordsSent() const { return totalWords_; }
+
+      /* non-copyable, non-movable: owns fd_ and is used through a pointer (virtual submit) */
       OLEDDisplay(const OLEDDisplay&) = delete;
       OLEDDisplay& operator=(const OLEDDisplay&) = delete;
-      OLEDDisplay(OLEDDisplay&&) = default;
-      OLEDDisplay& operator=(OLEDDisplay&&) = default;
+      OLEDDisplay(OLEDDisplay&&) = delete;
+      OLEDDisplay& operator=(OLEDDisplay&&) = delete;
+
+    protected:
+      /** Issues one SPI_IOC_MESSAGE; overridden by tests to capture the transfers. */
+      virtual bool submit(const spi_ioc_transfer* xfers, std::size_t count);
 
     private:
+      /** Overwrites \p n 8-row columns at (x, y); \p mask selects the rows that belong to the cell. */
+      int blitColumns(int x, int y, const std::uint8_t* cols, int n, std::uint8_t mask = 0xFF);
+      bool sendCommands(const std::uint8_t* cmds, std::size_t n);
+
       int fd_{ -1 }; ///< SPI device fd
-      bool dirty_{ false };
-      uint8_t buffer_[1024]{}; ///< 128×64 / 8 bits per byte
+      bool dirty_{ true };           ///< panel contents unknown until first flush
+      std::uint8_t colOffset_{ 0 };    ///< SH1106 maps 128 px into a 132-column RAM
+      uint8_t buffer_[1024]{};         ///< 128×64 / 8 bits per byte
+      uint8_t shadow_[1024]{};         ///< last frame the panel acknowledged
+      bool shadowValid_{ false };      ///< false → next flush sends everything
+      std::vector<std::uint16_t> tx_;  ///< 9-bit words, reused between flushes
+      GlyphRunCache runCache_{};
+      FlushStats lastFlush_{};
+      std::uint64_t totalWords_{ 0 };
     };
 
   } // namespace io
@@ -0,0 +1,73 @@
+#pragma once
+/** @file  ReplaySerialChannel.hpp
+ *  @brief SerialChannel that plays one device's side of a capture back to the host code.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "io/SerialCapture.hpp"
+#include "io/SerialChannel.hpp"
+
+namespace milo {
+  namespace io {
+
+    /**
+ * @class ReplaySerialChannel
+ * @brief Feeds recorded device traffic to RPCManager/protocols; no tty involved.
+ *
+ *  * `writeLine()` consumes the next recorded Tx of this channel and compares it with what
+ *    the host sends now — differences are counted in `divergences()`.
+ *  * `readLine()` delivers the recorded Rx bytes that followed, exactly as they were chunked.
+ *  * Lines end in the channel's `terminator()`: the one recorded for it in the capture, or
+ *    whatever the owner (RPCManager, from the device's codec) sets.
+ *  * `Pacing::Recorded` reproduces the device’s timing relative to the last command (so a
+ *    field timeout times out again); `Pacing::AsFastAsPossible` never sleeps — for parse and
+ *    dispatch throughput benchmarks. Recorded pacing waits on the channel's clock, so on a
+ *    VirtualClock a replay keeps its timing without taking the time.
+ */
+    class ReplaySerialChannel : public SerialChannel {
+    public:
+      enum class Pacing { Recorded, AsFastAsPossible };
+
+      ReplaySerialChannel(std::shared_ptr<const Capture> capture, std::uint8_t channel,
+                          Pacing pacing = Pacing::Recorded);
+
+      /// @returns nullptr if the capture has no channel called \p name.
+      static std::unique_ptr<ReplaySerialChannel> forChannel(std::shared_ptr<const Capture> capture,
+                                                             std::string_view name,
+                                                             Pacing pacing = Pacing::Recorded);
+
+      /// Rewinds; always succeeds.
+      bool open(const std::string& dev, const SerialSettings& settings) override;
+      bool writeLine(std::string_view line) override;
+      std::optional<std::string> readLine(std::chrono::milliseconds timeout) override;
+
+      std::size_t divergences() const { return divergences_; }
+      /// Every record of this channel has been replayed.
+      bool finished() const { return next() == nullptr && rx_.empty(); }
+
+    private:
+      const Capture::Record* next() const; ///< next record of our channel at/after cursor_
+      void consume(const Capture::Record* r);
+
+      std::shared_ptr<const Capture> cap_;
+      std::uint8_t channel_;
+      Pacing pacing_;
+
+      std::size_t cursor_{ 0 };
+      std::string rx_; ///< delivered but not yet returned as a line
+      std::size_t divergences_{ 0 };
+
+      // recorded time ↔ clock() time of the last command (or of the first read)
+      std::chrono::nanoseconds anchorRecorded_{ 0 };
+      std::optional<core::Clock::Duration> anchorNow_;
+    };
+
+  } // namespace io
+} // namespace milo
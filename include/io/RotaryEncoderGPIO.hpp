@@ -5,26 +5,46 @@
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
-#include "io/GPIOInput.hpp" // base class (poll loop & edge helpers)
+#include "core/RingBuffer.hpp"
+#include "io/EdgeEventSource.hpp"
 
-#include <functional>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string>
 
 namespace milo {
   namespace io {
 
     /**
  * @class RotaryEncoderGPIO
- * @brief Uses two GPIOInput channels (A & B) to detect detents and direction.
+ * @brief Decodes A/B edge events (one kernel request for both lines) into detents.
  *
- *  * Non-copyable, move-enabled (owns both line FDs).
- *  * Simple state-machine: 2-bit Gray code → Direction event.
+ *  * Non-copyable, move-enabled (owns the line request).
+ *  * Branch-free 16-entry transition table. Edges sharing a kernel timestamp are applied
+ *    together, so an A/B double flip (skipped state) is caught and counted as bounce.
+ *  * Detent rate drives an acceleration curve, so one fast flick sweeps a whole range.
+ *  * Events are handed to the UI through a lock-free SPSC queue: `service()` runs on the
+ *    input thread, `nextEvent()` on the consumer.
  */
     class RotaryEncoderGPIO {
     public:
       enum class Direction { CW, CCW };
 
-      using Callback = std::function<void(Direction)>;
+      struct Event {
+        Direction dir{ Direction::CW };
+        std::int32_t steps{ 1 }; ///< detents after acceleration (≥ 1)
+        std::chrono::nanoseconds timestamp{ 0 };
+      };
+
+      /// gain = 1 + (reference / detent interval)², capped at maxGain.
+      struct Acceleration {
+        std::chrono::milliseconds reference{ 40 };
+        std::int32_t maxGain{ 50 };
+      };
+
+      static constexpr std::size_t kQueueDepth = 64;
 
       RotaryEncoderGPIO() = default;
       ~RotaryEncoderGPIO() = default;
@@ -33,10 +53,24 @@ namespace milo {
       bool open(const std::string& chip, unsigned int lineA, unsigned int lineB,
                 bool activeLow = false);
 
-      /** Poll both lines; call regularly (e.g., every 5–10 ms). */
-      void poll(std::chrono::milliseconds now);
+      /** Use an already-requested source carrying both lines (tests inject a fake). */
+      void attach(std::unique_ptr<EdgeEventSource> source, unsigned int lineA,
+                  unsigned int lineB);
+
+      /** Pollable fd for the input thread’s epoll set; -1 when closed. */
+      int fd() const { return source_ ? source_->fd() : -1; }
+
+      /** Drain pending A/B edges, decode and enqueue detent events. */
+      void service();
 
-      void registerCallback(Callback cb) { cb_ = std::move(cb); }
+      /** Consumer side (UI): pops the next detent event, false if none. */
+      bool nextEvent(Event& out) { return events_->pop(out); }
+
+      void setAcceleration(Acceleration a) { accel_ = a; }
+      void setStepsPerDetent(int n) { stepsPerDetent_ = n; }
+
+      std::uint32_t bounceCount() const { return bounces_; }
+      std::uint32_t droppedEvents() const { return dropped_; }
 
       void close();
 
@@ -47,16 +81,26 @@ namespace milo {
       RotaryEncoderGPIO& operator=(RotaryEncoderGPIO&&) = default;
 
     private:
-      void emit(Direction d) {
-        if (cb_)
-          cb_(d);
-      }
+      void step(std::uint8_t gray, std::chrono::nanoseconds ts);
+      void onDetent(int sign, std::chrono::nanoseconds ts);
+
+      std::unique_ptr<EdgeEventSource> source_; ///< request holding both lines
+      unsigned int lineA_{ 0 };
+      unsigned int lineB_{ 0 };
+
+      std::uint8_t lastGray_{ 0 }; ///< last 2-bit state (A << 1 | B)
+      int steps_{ 0 };             ///< quarter-steps since the last detent
+      int stepsPerDetent_{ 4 };
+      std::uint32_t bounces_{ 0 };
+      std::uint32_t dropped_{ 0 };
+      std::uint32_t lastSeq_{ 0 }; ///< kernel event seqno, to spot FIFO overflow
 
-      std::unique_ptr<GPIOInput> chanA_; ///< owns line A
-      std::unique_ptr<GPIOInput> chanB_; ///< owns line B
-      Callback cb_{};                    ///< user’s event sink
+      Acceleration accel_{};
+      int lastSign_{ 0 };
+      std::chrono::nanoseconds lastDetentTs_{ 0 };
 
-      uint8_t lastGray_{ 0 }; ///< last 2-bit state for detent detection
+      std::unique_ptr<core::RingBuffer<Event>> events_ =
+          std::make_unique<core::RingBuffer<Event>>(kQueueDepth);
     };
 
   } // namespace io
@@ -0,0 +1,98 @@
+#pragma once
+/** @file  SerialCapture.hpp
+ *  @brief Compact timestamped record of serial traffic (every byte in and out).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/DeviceRegistry.hpp"
+
+namespace milo {
+  namespace io {
+
+    /**
+ * @struct Capture
+ * @brief A capture file loaded into memory.
+ *
+ *  File layout (little-endian, varints are LEB128):
+ *  ```
+ *  "MILOCAP" u8 version   u64 origin_ns (steady_clock)
+ *  { 0xFF  varint id  varint len  name  varint len  eol }   channel declaration
+ *  { u8 (id << 1 | dir)  varint Δt_ns  varint len  bytes }   traffic, dir 0 = tx, 1 = rx
+ *  ```
+ *  Version 1 files have no `eol` (every channel was CRLF); they still load.
+ */
+    struct Capture {
+      enum class Direction : std::uint8_t { Tx = 0, Rx = 1 };
+
+      struct Record {
+        std::chrono::nanoseconds t{ 0 }; ///< since capture origin
+        std::uint8_t channel{ 0 };
+        Direction dir{ Direction::Tx };
+        std::string bytes;
+      };
+
+      std::chrono::nanoseconds origin{ 0 };
+      std::vector<std::string> channels;    ///< index = channel id
+      std::vector<std::string> terminators; ///< line terminator of each channel, same index
+      std::vector<Record> records;          ///< in capture order
+
+      /// @returns nullopt if the file is missing, not a capture or names a channel id ≥
+      /// DeviceRegistry::kMaxDevices; a truncated tail is dropped.
+      static std::optional<Capture> load(const std::string& path);
+      std::optional<std::uint8_t> channelId(std::string_view name) const;
+    };
+
+    /**
+ * @class CaptureWriter
+ * @brief Appends records for any number of channels to one file (shared by all channels,
+ *        so cross-device ordering survives).
+ *
+ *  * stdio-buffered (64 kB): a record is a memcpy on the I/O path, the disk write happens
+ *    once per buffer. A diagnostic mode — not meant to stay on for every production run.
+ */
+    class CaptureWriter {
+    public:
+      /// One channel per registered device; Capture::load() rejects ids beyond this.
+      static constexpr std::size_t kMaxChannels = core::DeviceRegistry::kMaxDevices;
+
+      /// @returns nullptr if \p path cannot be created.
+      static std::shared_ptr<CaptureWriter> create(const std::string& path);
+      ~CaptureWriter(); ///< flush + fclose
+
+      /// Declare a channel (e.g. "PSU") and the terminator its lines end with; @returns its
+      /// id, or nullopt past kMaxChannels.
+      std::optional<std::uint8_t> addChannel(std::string_view name, std::string_view eol = "\r\n");
+
+      /// One record of \p data followed by \p tail (lets a line and its terminator stay one record).
+      void record(std::uint8_t channel, Capture::Direction dir, std::string_view data,
+                  std::string_view tail = {});
+      void flush();
+
+      CaptureWriter(const CaptureWriter&) = delete;
+      CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    private:
+      explicit CaptureWriter(FILE* fp);
+
+      void putVarint(std::uint64_t v);
+
+      std::mutex mtx_;
+      FILE* fp_;
+      std::vector<char> buf_;
+      std::uint8_t channels_{ 0 };
+      std::chrono::nanoseconds last_{ 0 };
+    };
+
+  } // namespace io
+} // namespace milo
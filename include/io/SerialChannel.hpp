@@ -6,20 +6,32 @@
  */
 
 #include <chrono>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
-// Linux header
-#include <termios.h> // for speed_t types e.g., B115200
+// MILO headers
+#include "core/Clock.hpp"
+#include "io/SerialSettings.hpp"
 
 namespace milo {
   namespace io {
 
+    class CaptureWriter;
+
     /**
  * @class SerialChannel
  * @brief RAII wrapper around a single /dev/tty* file descriptor.
  *
- *  * Frames I/O as ASCII lines (`\r\n`), CRC placeholder for now.
+ *  * Line settings per device (SerialSettings): any baud rate, FTDI low-latency mode and
+ *    the read wake-up threshold; `settings()` reports what the driver actually accepted.
+ *  * Frames I/O as ASCII lines (`\r\n` unless `setTerminator()`), CRC placeholder for now.
+ *  * Optional capture: every byte written and every chunk read is recorded with its
+ *    steady_clock time (see SerialCapture.hpp, ReplaySerialChannel).
+ *  * Read timeouts are measured on an injectable core::Clock; on a virtual clock a read
+ *    that finds nothing jumps time to its deadline instead of sleeping.
  *  * *Non-copyable*, but move-constructible.
  */
 
@@ -31,11 +43,28 @@ namespace milo {
       virtual ~SerialChannel(); // close the /dev/tty fs at destruction
 
       //---public API-------------------------------------------
-      virtual bool open(const std::string& dev, speed_t baud);
-      virtual bool writeLine(const std::string& line); // returns false on EIO
+      virtual bool open(const std::string& dev, const SerialSettings& settings);
+      virtual bool writeLine(std::string_view line); // returns false on EIO
       virtual std::optional<std::string> readLine(std::chrono::milliseconds timeout);
       void close();
 
+      /// Record all traffic of this channel into \p writer as channel \p id (nullptr stops).
+      void attachCapture(std::shared_ptr<CaptureWriter> writer, std::uint8_t id) {
+        capture_ = std::move(writer);
+        captureId_ = id;
+      }
+
+      /// Line terminator for both directions; \p eol must outlive the channel (a literal).
+      void setTerminator(std::string_view eol) { eol_ = eol; }
+      std::string_view terminator() const { return eol_; }
+
+      /// Effective line settings after open(): the baud the driver reports, and whether the
+      /// low-latency flag actually took (false where the driver has no TIOCSSERIAL).
+      const SerialSettings& settings() const { return settings_; }
+
+      /// Time source for read timeouts (RPCManager hands down its own).
+      void setClock(core::Clock& clock) { clock_ = &clock; }
+
       //---non-copyable-----------------------------------------
       SerialChannel(const SerialChannel&) = delete;
       SerialChannel& operator=(const SerialChannel&) = delete;
@@ -44,9 +73,18 @@ namespace milo {
       SerialChannel(SerialChannel&&) = default;
       SerialChannel& operator=(SerialChannel&&) = default;
 
+    protected:
+      core::Clock& clock() const { return *clock_; }
+
     private:
       int fd_{ -1 };            ///< POSIX fs (-1==closed)
       std::string rx_buffer_{}; ///< buffer to store readLine content
+      std::string_view eol_{ "\r\n" };
+      SerialSettings settings_{};
+      core::Clock* clock_{ &core::Clock::steady() };
+
+      std::shared_ptr<CaptureWriter> capture_; ///< null unless capturing
+      std::uint8_t captureId_{ 0 };
     };
   } // namespace io
 } // namespace milo
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+/** @file  SerialSettings.hpp
+ *  @brief Per-device UART line settings: baud, driver latency mode and read thresholds.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <cstdint>
+
+namespace milo {
+  namespace io {
+
+    /**
+ * @struct SerialSettings
+ * @brief What SerialChannel::open() programs into the tty (always 8N1, raw, no flow control).
+ *
+ *  * `baud` is any rate in bits/s, standard or not (250000, 3000000, …): every rate is set
+ *    as a number through termios2/BOTHER, and takes if the UART driver can divide it down.
+ *  * `lowLatency` sets ASYNC_LOW_LATENCY (TIOCSSERIAL). On FTDI bridges it drops the 16 ms
+ *    latency timer to 1 ms; drivers without TIOCSSERIAL (CDC-ACM, pty) just ignore it.
+ *  * `vmin`/`vtime` are the termios read thresholds. SerialChannel reads non-blocking, so
+ *    with `vtime == 0` `vmin` is how many bytes must be queued before poll() wakes it — set
+ *    it to the shortest reply a device sends to save wake-ups. `vtime > 0` (deciseconds)
+ *    makes the driver wake on the first byte again.
+ *    Never set `vmin` above the shortest reply (count the terminator): poll() does not wake
+ *    until that many bytes are queued, so a shorter reply sits unread and the read times out.
+ */
+    struct SerialSettings {
+      static constexpr std::uint32_t kMinBaud = 50;
+      static constexpr std::uint32_t kMaxBaud = 12'000'000;
+
+      std::uint32_t baud{ 115200 };
+      bool lowLatency{ true };
+      std::uint8_t vmin{ 1 };
+      std::uint8_t vtime{ 0 };
+
+      friend bool operator==(const SerialSettings&, const SerialSettings&) = default;
+    };
+
+  } // namespace io
+} // namespace milo
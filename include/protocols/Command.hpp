@@ -6,13 +6,26 @@
  */
 
 // STL headers
+#include <cstddef>
+#include <memory_resource>
 #include <string>
 
 namespace milo {
   namespace protocols {
+    /// Longest line the MCU firmware accepts, terminator included.
+    constexpr std::size_t kMaxCommandBytes = 256;
+
+    /// Payload lives in whatever resource built it — the run arena while RUNNING.
     struct Command {
-      std::string payload;
-      std::string toWire() const { return payload + "\r\n"; }
+      std::pmr::string payload;
+
+      /// Wire form in \p mr (default: the payload’s own resource).
+      std::pmr::string toWire(std::pmr::memory_resource* mr = nullptr) const {
+        std::pmr::string wire(mr ? mr : payload.get_allocator().resource());
+        wire.reserve(payload.size() + 2);
+        wire.append(payload).append("\r\n");
+        return wire;
+      }
     };
 
   } // namespace protocols
@@ -0,0 +1,190 @@
+#pragma once
+/** @file  CommandSchema.hpp
+ *  @brief Compile-time command schema: typed builders that encode straight into a fixed buffer.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <variant>
+
+// MILO headers
+#include "protocols/Command.hpp"
+
+namespace milo {
+  namespace protocols {
+    namespace schema {
+
+      /// String literal usable as a template argument (command names, field prefixes).
+      template <std::size_t N> struct Literal {
+        char chars[N]{};
+        constexpr Literal(const char (&s)[N]) { std::copy_n(s, N, chars); }
+        static constexpr std::size_t size() { return N - 1; }
+        constexpr std::string_view view() const { return { chars, N - 1 }; }
+      };
+
+      /// Encoded command without terminator (the channel appends its codec’s), no heap.
+      template <std::size_t N> struct Wire {
+        std::array<char, N> buf{};
+        std::size_t len{ 0 };
+
+        std::string_view view() const { return { buf.data(), len }; }
+        operator std::string_view() const { return view(); }
+      };
+
+      constexpr std::size_t decimalDigits(std::uint64_t v) {
+        std::size_t n = 1;
+        while (v >= 10) {
+          v /= 10;
+          ++n;
+        }
+        return n;
+      }
+
+      // ─── argument types ─────────────────────────────────────────────────────
+
+      /// Integer in [Min, Max], printed in decimal.
+      template <std::integral T, T Min, T Max> struct Int {
+        static_assert(Min <= Max);
+        using Value = T;
+        static constexpr std::size_t chars(T v) {
+          return v < 0 ? 1 + decimalDigits(0ull - static_cast<std::uint64_t>(v))
+                       : decimalDigits(static_cast<std::uint64_t>(v));
+        }
+        static constexpr std::size_t kMaxChars = std::max(chars(Min), chars(Max));
+
+        static constexpr bool valid(T v) { return v >= Min && v <= Max; }
+        static char* put(char* first, char* last, T v) { return std::to_chars(first, last, v).ptr; }
+      };
+
+      /// Fixed-point decimal in [Min, Max] with exactly \p Decimals places ("12.500").
+      template <double Min, double Max, int Decimals> struct Fixed {
+        static_assert(Min <= Max && Decimals >= 0 && Decimals <= 6);
+        using Value = double;
+        // +1 on the magnitude: rounding to Decimals may carry into a new digit
+        static constexpr double kMagnitude = std::max(Min < 0 ? -Min : Min, Max < 0 ? -Max : Max);
+        static constexpr std::size_t kMaxChars =
+            (Min < 0 ? 1 : 0) + decimalDigits(static_cast<std::uint64_t>(kMagnitude) + 1) +
+            (Decimals > 0 ? 1 + static_cast<std::size_t>(Decimals) : 0);
+
+        static constexpr bool valid(double v) { return v >= Min && v <= Max; } // false for NaN
+        static char* put(char* first, char* last, double v) {
+          return std::to_chars(first, last, v, std::chars_format::fixed, Decimals).ptr;
+        }
+      };
+
+      /// On/off switch sent as "1"/"0".
+      struct Flag {
+        using Value = bool;
+        static constexpr std::size_t kMaxChars = 1;
+
+        static constexpr bool valid(bool) { return true; }
+        static char* put(char* first, char*, bool v) {
+          *first = v ? '1' : '0';
+          return first + 1;
+        }
+      };
+
+      /// One argument: literal \p Prefix (separator and keyword, e.g. " RAMP ") then the value.
+      template <Literal Prefix, typename Type> struct Field {
+        using Value = typename Type::Value;
+        static constexpr std::size_t kMaxChars = Prefix.size() + Type::kMaxChars;
+
+        static constexpr bool valid(Value v) { return Type::valid(v); }
+        static char* put(char* first, char* last, Value v) {
+          std::memcpy(first, Prefix.chars, Prefix.size());
+          return Type::put(first + Prefix.size(), last, v);
+        }
+      };
+
+      // ─── reply shapes ───────────────────────────────────────────────────────
+
+      /// "OK" or "OK <anything>"; everything else (ERR …) is a failed command.
+      struct Ack {
+        using Value = std::monostate;
+
+        static std::optional<Value> parse(std::string_view line) {
+          if (line == "OK" || line.starts_with("OK "))
+            return Value{};
+          return std::nullopt;
+        }
+      };
+
+      /// "OK <number>": a measurement or a read-back setpoint.
+      template <typename T> struct Reading {
+        using Value = T;
+
+        static std::optional<Value> parse(std::string_view line) {
+          if (!line.starts_with("OK "))
+            return std::nullopt;
+          line.remove_prefix(3);
+          T v{};
+          const auto [end, ec] = std::from_chars(line.data(), line.data() + line.size(), v);
+          if (ec != std::errc{} || end != line.data() + line.size())
+            return std::nullopt;
+          return v;
+        }
+      };
+
+      // ─── command ────────────────────────────────────────────────────────────
+
+      /**
+ * @struct CommandDef
+ * @brief One device command: mnemonic, typed/ranged arguments and the reply it expects.
+ *
+ *  * `encode(args…)` range-checks every argument and writes the wire form with
+ *    `std::to_chars` into a `Wire` sized for the worst case; nullopt if anything is out of
+ *    range, so an invalid setpoint never costs a round trip.
+ *  * `make<args…>()` does the same for constants entirely at compile time.
+ *  * The worst-case length (plus CRLF) is `static_assert`ed against kMaxCommandBytes.
+ *  * Send with `RPCManager::sendCommand(dev, wire)`, read with `awaitReply<Cmd>()`.
+ */
+      template <Literal Name, typename ReplyShape, typename... Fields> struct CommandDef {
+        using Reply = ReplyShape;
+        static constexpr std::string_view kName = Name.view();
+        static constexpr std::size_t kMaxWire =
+            Name.size() + (std::size_t{ 0 } + ... + Fields::kMaxChars);
+        static_assert(kMaxWire + 2 <= kMaxCommandBytes,
+                      "command can exceed the 256-byte wire limit (CRLF included)");
+
+        using Encoded = Wire<kMaxWire>;
+
+        static constexpr bool valid(typename Fields::Value... args) {
+          return (Fields::valid(args) && ...);
+        }
+
+        static std::optional<Encoded> encode(typename Fields::Value... args) {
+          if (!valid(args...))
+            return std::nullopt;
+          Encoded w;
+          char* p = w.buf.data();
+          [[maybe_unused]] char* const end = p + w.buf.size();
+          std::memcpy(p, Name.chars, Name.size());
+          p += Name.size();
+          ((p = Fields::put(p, end, args)), ...);
+          w.len = static_cast<std::size_t>(p - w.buf.data());
+          return w;
+        }
+
+        /// Compile-time-constant arguments: out-of-range values do not compile.
+        template <auto... Args> static Encoded make() {
+          static_assert(sizeof...(Args) == sizeof...(Fields), "wrong number of arguments");
+          static_assert(valid(static_cast<typename Fields::Value>(Args)...),
+                        "argument out of the command's schema range");
+          return *encode(static_cast<typename Fields::Value>(Args)...);
+        }
+      };
+
+    } // namespace schema
+  } // namespace protocols
+} // namespace milo
@@ -0,0 +1,59 @@
+#pragma once
+/** @file  CoroutineProtocol.hpp
+ *  @brief ExperimentProtocol whose flow is a coroutine run by a ProtocolExecutor.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <array>
+#include <cstddef>
+
+#include "core/ProtocolExecutor.hpp"
+#include "core/Task.hpp"
+#include "protocols/ExperimentProtocol.hpp"
+
+namespace milo::protocols {
+
+  /**
+ * @class CoroutineProtocol
+ * @brief Adapter: the blocking `run()` SystemCoordinator calls drives `execute()` to the end.
+ *
+ *  * Implement `execute()` with `co_await exec.reply<Cmd>(…)`, `exec.sleepFor(…)`,
+ *    `exec.whenAll(…)` instead of blocking in awaitResponse().
+ *  * With streams attached to the RPCManager, waits drain the devices’ sample lines.
+ *  * Frames are carved from `frames_`, which lives in the protocol object (and so in the
+ *    run arena); `kFrameBytes` bounds the coroutine state of one run.
+ */
+  class CoroutineProtocol : public ExperimentProtocol {
+  public:
+    static constexpr std::size_t kFrameBytes = 16 * 1024;
+
+    void run(core::RPCManager &rpc, core::Logger &log,
+             const core::ParameterStore &store) final {
+      core::ProtocolExecutor exec(frames_, *clock_);
+      if (rpc.streaming())
+        exec.attachStreams(rpc); // keep reading samples while the flow sleeps
+      exec.run(execute(exec, rpc, log, store));
+    }
+
+    void useClock(core::Clock &clock) override { clock_ = &clock; }
+    void useMemory(std::pmr::memory_resource &mr) override { memory_ = &mr; }
+    void useCheckpoints(core::Checkpointer &cp) override { checkpoints_ = &cp; }
+
+  protected:
+    /// Null unless the coordinator checkpoints runs (see ExperimentProtocol::useCheckpoints()).
+    core::Checkpointer *checkpoints() const { return checkpoints_; }
+    /// The run arena under SystemCoordinator (see ExperimentProtocol::useMemory()).
+    std::pmr::memory_resource *memory() const { return memory_; }
+
+    virtual core::Task<void> execute(core::ProtocolExecutor &exec, core::RPCManager &rpc,
+                                     core::Logger &log, const core::ParameterStore &store) = 0;
+
+  private:
+    core::Clock *clock_{ &core::Clock::steady() };
+    std::pmr::memory_resource *memory_{ std::pmr::get_default_resource() };
+    core::Checkpointer *checkpoints_{ nullptr };
+    alignas(std::max_align_t) std::array<std::byte, kFrameBytes> frames_{};
+  };
+
+} // namespace milo::protocols
@@ -0,0 +1,57 @@
+#pragma once
+/** @file  DeviceCommands.hpp
+ *  @brief Command schema of the bench instruments (PSU, pulse generator, pump).
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include "protocols/CommandSchema.hpp"
+
+namespace milo {
+  namespace protocols {
+
+    /// Understood by every instrument's firmware.
+    namespace common {
+      using namespace schema;
+
+      /// `PING` → `OK` — is the MCU there and listening (RPCManager::handshake()).
+      using Ping = CommandDef<"PING", Ack>;
+    } // namespace common
+
+    /// Bench power supply: two channels, 0–30 V in mV steps.
+    namespace psu {
+      using namespace schema;
+
+      /// `EN 1` — output on/off.
+      using Enable = CommandDef<"EN", Ack, Field<" ", Flag>>;
+      /// `VOLT 12.000 CH1 RAMP 50` — setpoint [V], channel, slew [V/s] (0 = step).
+      using SetVoltage = CommandDef<"VOLT", Ack, Field<" ", Fixed<0.0, 30.0, 3>>,
+                                    Field<" CH", Int<int, 1, 2>>, Field<" RAMP ", Int<int, 0, 1000>>>;
+      /// `VOLT? CH1` → `OK 11.998`
+      using MeasureVoltage = CommandDef<"VOLT?", Reading<double>, Field<" CH", Int<int, 1, 2>>>;
+    } // namespace psu
+
+    /// Pulse generator: pulse trains with µs width and delay.
+    namespace pg {
+      using namespace schema;
+
+      /// `ARM` — wait for the synchronized start.
+      using Arm = CommandDef<"ARM", Ack>;
+      /// `PULSE 10 WIDTH 250 DELAY 100` — count, width [µs], delay [µs].
+      using Pulse = CommandDef<"PULSE", Ack, Field<" ", Int<int, 1, 10000>>,
+                               Field<" WIDTH ", Int<int, 1, 1000000>>,
+                               Field<" DELAY ", Int<int, 0, 1000000>>>;
+    } // namespace pg
+
+    /// Syringe pump: flow in mL/min.
+    namespace pump {
+      using namespace schema;
+
+      /// `FLOW 2.5`
+      using SetFlow = CommandDef<"FLOW", Ack, Field<" ", Fixed<0.0, 50.0, 1>>>;
+      /// `FLOW?` → `OK 2.5`
+      using MeasureFlow = CommandDef<"FLOW?", Reading<double>>;
+    } // namespace pump
+
+  } // namespace protocols
+} // namespace milo
@@ -5,7 +5,11 @@
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
+#include <memory_resource>
+
 namespace milo::core { // forward decls only—keeps dependency light
+  class Checkpointer;
+  class Clock;
   class RPCManager;
   class Logger;
   class ParameterStore;
@@ -35,6 +39,21 @@ namespace milo::protocols {
      */
     virtual void run(core::RPCManager &rpc, core::Logger &log,
                      const core::ParameterStore &store) = 0;
+
+    /// Time source for the protocol’s own step timing (virtual in simulation); default ignores it.
+    virtual void useClock(core::Clock &) {}
+
+    /// The run arena (set before every run()): build Commands, batch reports and other
+    /// per-run containers here so RUNNING never reaches the heap; default ignores it.
+    virtual void useMemory(std::pmr::memory_resource &) {}
+
+    /**
+     * @brief Checkpoints of the current run (set before every run()). A protocol that can
+     *        pick up mid-way starts at `firstStep()` and reports `reached()` at its safe
+     *        points; the default ignores them, so a resumed run starts from its beginning.
+     *        Steps after the last save are repeated on resume: they must be safe to redo.
+     */
+    virtual void useCheckpoints(core::Checkpointer &) {}
   };
 
 } // namespace milo::protocols
@@ -5,14 +5,32 @@
  *  © 2025 Milo Medical — MIT-licensed.
  */
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+
+#include "core/StreamView.hpp"
+#include "core/TripleBuffer.hpp"
 
 namespace milo {
   namespace core { // forward decls so we don’t pull core headers in
     enum class Parameter;
     enum class SystemState;
+    class RuntimeProfile;
+    struct ChannelSummary;
+    struct SystemEvent;
+    template <typename T> class BroadcastRing;
+    template <typename T> class BroadcastListener;
   } // namespace core
 
+  namespace io {
+    class OLEDDisplay;
+  } // namespace io
+
   namespace ui {
 
     /** High-level user-interaction events emitted by the front panel. */
@@ -31,31 +49,93 @@ namespace milo {
  * * Emits `UIEvent` callbacks for the application layer.
  * * Provides convenience setters so other modules can update the screen without
  *   knowing display internals.
+ * * Setters only publish the desired screen (wait-free); a render thread owns the
+ *   `OLEDDisplay`, coalesces updates and redraws at most once per frame period, and
+ *   sleeps while nothing changes. Neither input handling nor the protocol thread ever
+ *   waits on SPI.
  */
     class UIController {
 
     public:
-      UIController() = default;
-      ~UIController() = default;
+      static constexpr std::chrono::milliseconds kDefaultFramePeriod{ 33 }; ///< ~30 fps cap
+
+      explicit UIController(std::unique_ptr<io::OLEDDisplay> display,
+                            std::chrono::milliseconds framePeriod = kDefaultFramePeriod);
+      ~UIController(); ///< stops the render thread
 
       // ---- public API ----------------------------------------------------------
       void start(); ///< launch background worker thread (poll + draw)
+      void stop();  ///< join the render thread; the last published screen is drawn first
+
+      /// Scheduling for the render thread (ThreadRole::UI); set before start().
+      void setRuntimeProfile(std::shared_ptr<const core::RuntimeProfile> profile) {
+        profile_ = std::move(profile);
+      }
 
       /// Register a lambda or free function to receive front-panel events.
       void registerCallback(std::function<void(UIEvent)> cb);
 
-      /// Change the high-level screen (BOOT, IDLE, RUNNING…).
+      /// Change the high-level screen (BOOT, IDLE, RUNNING…). Callable from any thread.
       void setDisplayState(core::SystemState state);
 
-      /// Show a live numeric readout on the HUD.
+      /// Follow the coordinator’s state changes from \p bus on a listener thread of our own,
+      /// so a busy render never holds up the publisher.
+      void attachEventBus(core::BroadcastRing<core::SystemEvent>& bus);
+
+      /// Show a live numeric readout on the HUD. Single publisher (the input path).
       void showParameterValue(core::Parameter param, float value);
 
+      /// Min/max trace of a streamed channel under the readout (SampleStreams::onDisplay()).
+      /// Single publisher (the protocol thread); drawing it costs the same at any sample rate.
+      void showStream(const core::StreamView& view);
+
+      /// Mean ± sd of the first channels of the run just finished, shown in place of the
+      /// readout while FINISHED (SystemCoordinator::onRunStats()). Single publisher.
+      void showRunStats(std::span<const core::ChannelSummary> stats);
+
+      /// Frames actually pushed to the panel (for tests / telemetry).
+      std::uint64_t framesRendered() const { return frames_.load(std::memory_order_relaxed); }
+
+      UIController(const UIController&) = delete;
+      UIController& operator=(const UIController&) = delete;
+
     private:
+      struct Readout {
+        core::Parameter param{};
+        float value{ 0.0f };
+        bool valid{ false };
+      };
+
+      /// Pre-formatted FINISHED screen; fixed size so it can go through a TripleBuffer.
+      struct RunSummary {
+        static constexpr std::size_t kLines = 5;
+        static constexpr std::size_t kChars = 21; ///< one display row
+        char lines[kLines][kChars + 1]{};
+        std::uint8_t count{ 0 };
+      };
+
       // internal helpers — implementation lives in .cpp
-      void pollEncoder();
-      void flushOLED();
+      void renderLoop();
+      void render(core::SystemState state, const Readout& readout, const core::StreamView& trace,
+                  const RunSummary& summary);
+      void wake();
 
       std::function<void(UIEvent)> cb_{};
+
+      std::unique_ptr<io::OLEDDisplay> display_; ///< touched by the render thread only
+      std::chrono::milliseconds framePeriod_;
+
+      std::atomic<core::SystemState> state_;
+      core::TripleBuffer<Readout> readout_{};
+      core::TripleBuffer<core::StreamView> trace_{};
+      core::TripleBuffer<RunSummary> summary_{};
+      std::atomic<std::uint32_t> generation_{ 0 }; ///< bumped on every publish; render waits on it
+
+      std::shared_ptr<const core::RuntimeProfile> profile_;
+      std::unique_ptr<core::BroadcastListener<core::SystemEvent>> busListener_;
+      std::thread renderer_;
+      std::atomic<bool> running_{ false };
+      std::atomic<std::uint64_t> frames_{ 0 };
     };
 
   } // namespace ui
@@ -0,0 +1,228 @@
+/* @file AllocationGuard.cpp
+ * @brief Global operator new/delete replacement that polices RUNNING-time allocations.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <iterator>
+#include <new>
+
+// Linux headers
+#include <execinfo.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/AllocationGuard.hpp"
+
+using namespace milo::core;
+
+namespace {
+  std::atomic<AllocationGuard::Mode> g_mode{ AllocationGuard::Mode::Off };
+  std::atomic<std::uint64_t> g_count{ 0 };
+  std::atomic<std::uint64_t> g_bytes{ 0 };
+
+  // site table: fixed storage, a spinlock is enough (only contended while misbehaving)
+  std::atomic_flag g_sitesLock = ATOMIC_FLAG_INIT;
+  std::array<AllocationGuard::Site, AllocationGuard::kMaxSites> g_sites{};
+  std::size_t g_numSites{ 0 };
+
+  thread_local int t_exempt{ 0 };
+  thread_local bool t_inHook{ false };
+
+  constexpr std::size_t kSkip = 2; // record() + operator new
+
+  void recordSite(void* const* frames, std::size_t depth, std::size_t n) {
+    while (g_sitesLock.test_and_set(std::memory_order_acquire)) {
+    }
+    AllocationGuard::Site* site = nullptr;
+    for (std::size_t i = 0; i < g_numSites && !site; ++i)
+      if (g_sites[i].depth == depth &&
+          std::equal(frames, frames + depth, g_sites[i].frames.begin()))
+        site = &g_sites[i];
+    if (!site && g_numSites < g_sites.size()) {
+      site = &g_sites[g_numSites++];
+      std::copy_n(frames, depth, site->frames.begin());
+      site->depth = depth;
+    }
+    if (site) { // table full: still counted globally
+      ++site->count;
+      site->bytes += n;
+    }
+    g_sitesLock.clear(std::memory_order_release);
+  }
+
+  std::string symbolise(void* addr) {
+    char** sym = backtrace_symbols(&addr, 1);
+    std::string out = sym ? sym[0] : "?";
+    std::free(sym);
+    // "binary(_ZN4milo…+0x1c) [0x…]" → demangle the part between '(' and '+'
+    const auto open = out.find('(');
+    const auto plus = out.find('+', open);
+    if (open != std::string::npos && plus != std::string::npos && plus > open + 1) {
+      int status = 0;
+      char* dem = abi::__cxa_demangle(out.substr(open + 1, plus - open - 1).c_str(), nullptr,
+                                      nullptr, &status);
+      if (status == 0 && dem)
+        out = std::string(dem) + "  " + out;
+      std::free(dem);
+    }
+    return out;
+  }
+} // namespace
+
+namespace milo::core::detail {
+  // noinline keeps the frame layout (and so kSkip) stable
+  [[gnu::noinline]] void onAllocate(std::size_t n) {
+    const auto mode = g_mode.load(std::memory_order_relaxed);
+    if (mode == AllocationGuard::Mode::Off || t_exempt > 0 || t_inHook)
+      return;
+    t_inHook = true;
+    g_count.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(n, std::memory_order_relaxed);
+
+    void* frames[AllocationGuard::kFrames + kSkip];
+    const auto depth = static_cast<std::size_t>(backtrace(frames, static_cast<int>(std::size(frames))));
+    if (mode == AllocationGuard::Mode::Abort) {
+      static constexpr char kMsg[] = "[AllocationGuard] heap allocation while RUNNING:\n";
+      (void)!::write(STDERR_FILENO, kMsg, sizeof(kMsg) - 1);
+      backtrace_symbols_fd(frames, static_cast<int>(depth), STDERR_FILENO);
+      std::abort();
+    }
+    if (depth > kSkip)
+      recordSite(frames + kSkip, depth - kSkip, n);
+    t_inHook = false;
+  }
+} // namespace milo::core::detail
+
+void AllocationGuard::arm(Mode mode) {
+  if (!kCompiledIn)
+    return;
+  {
+    // backtrace() loads libgcc lazily (and allocates) on first use: do that now
+    Exempt exempt;
+    void* warm[1];
+    backtrace(warm, 1);
+  }
+  while (g_sitesLock.test_and_set(std::memory_order_acquire)) {
+  }
+  g_numSites = 0;
+  g_sites = {};
+  g_sitesLock.clear(std::memory_order_release);
+  g_count = 0;
+  g_bytes = 0;
+  g_mode.store(mode, std::memory_order_release);
+}
+
+void AllocationGuard::disarm() { g_mode.store(Mode::Off, std::memory_order_release); }
+
+AllocationGuard::Mode AllocationGuard::mode() { return g_mode.load(std::memory_order_acquire); }
+
+std::uint64_t AllocationGuard::count() { return g_count.load(std::memory_order_relaxed); }
+
+std::uint64_t AllocationGuard::bytes() { return g_bytes.load(std::memory_order_relaxed); }
+
+std::vector<AllocationGuard::Site> AllocationGuard::sites() {
+  Exempt exempt;
+  std::vector<Site> out;
+  out.reserve(kMaxSites);
+  while (g_sitesLock.test_and_set(std::memory_order_acquire)) {
+  }
+  out.assign(g_sites.begin(), g_sites.begin() + static_cast<std::ptrdiff_t>(g_numSites));
+  g_sitesLock.clear(std::memory_order_release);
+  return out;
+}
+
+std::string AllocationGuard::report() {
+  Exempt exempt;
+  std::string out;
+  for (const auto& site : sites()) {
+    out += std::to_string(site.count) + " allocation(s), " + std::to_string(site.bytes) +
+           " bytes:\n";
+    for (std::size_t i = 0; i < site.depth; ++i)
+      out += "    " + symbolise(site.frames[i]) + "\n";
+  }
+  return out;
+}
+
+AllocationGuard::Exempt::Exempt() { ++t_exempt; }
+AllocationGuard::Exempt::~Exempt() { --t_exempt; }
+
+#ifdef MILO_ALLOC_GUARD
+
+// ─── global replacements ─────────────────────────────────────────────────────
+namespace {
+  // always_inline keeps onAllocate() exactly one frame below operator new (kSkip)
+  [[gnu::always_inline]] inline void* allocate(std::size_t n) {
+    milo::core::detail::onAllocate(n);
+    if (n == 0)
+      n = 1;
+    for (;;) {
+      if (void* p = std::malloc(n))
+        return p;
+      auto handler = std::get_new_handler();
+      if (!handler)
+        throw std::bad_alloc();
+      handler();
+    }
+  }
+
+  [[gnu::always_inline]] inline void* allocateAligned(std::size_t n, std::align_val_t al) {
+    milo::core::detail::onAllocate(n);
+    const auto a = std::max(static_cast<std::size_t>(al), sizeof(void*));
+    const auto size = (std::max<std::size_t>(n, 1) + a - 1) / a * a;
+    for (;;) {
+      if (void* p = std::aligned_alloc(a, size))
+        return p;
+      auto handler = std::get_new_handler();
+      if (!handler)
+        throw std::bad_alloc();
+      handler();
+    }
+  }
+} // namespace
+
+void* operator new(std::size_t n) { return allocate(n); }
+void* operator new[](std::size_t n) { return allocate(n); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+  try {
+    return allocate(n);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t n, const std::nothrow_t& nt) noexcept {
+  return operator new(n, nt);
+}
+void* operator new(std::size_t n, std::align_val_t al) { return allocateAligned(n, al); }
+void* operator new[](std::size_t n, std::align_val_t al) { return allocateAligned(n, al); }
+void* operator new(std::size_t n, std::align_val_t al, const std::nothrow_t&) noexcept {
+  try {
+    return allocateAligned(n, al);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t n, std::align_val_t al, const std::nothrow_t& nt) noexcept {
+  return operator new(n, al, nt);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif // MILO_ALLOC_GUARD
@@ -0,0 +1,233 @@
+/* @file Checkpoint.cpp
+ * @brief Checkpoint file format, atomic write-rename and the protocol-facing Checkpointer.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+// Linux headers
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/AllocationGuard.hpp"
+#include "core/Checkpoint.hpp"
+#include "core/Crc32.hpp"
+#include "core/FsSync.hpp"
+
+using namespace milo::core;
+
+namespace {
+  constexpr std::string_view kHeader = "# milo checkpoint v1\n";
+  constexpr std::string_view kCrcKey = "crc=";
+
+  template <std::size_t N> void copyName(char (&dst)[N], std::string_view src) {
+    const auto n = std::min(src.size(), N - 1);
+    std::copy_n(src.data(), n, dst);
+    dst[n] = '\0';
+  }
+
+  template <typename T> bool parse(std::string_view s, T& out, int base = 10) {
+    const auto [end, ec] = [&] {
+      if constexpr (std::is_floating_point_v<T>)
+        return std::from_chars(s.data(), s.data() + s.size(), out);
+      else
+        return std::from_chars(s.data(), s.data() + s.size(), out, base);
+    }();
+    return ec == std::errc{} && end == s.data() + s.size();
+  }
+
+  bool writeAll(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+      const auto w = ::write(fd, p, n);
+      if (w < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      p += w;
+      n -= static_cast<std::size_t>(w);
+    }
+    return true;
+  }
+} // namespace
+
+// ─── CheckpointStore ─────────────────────────────────────────────────────────
+CheckpointStore::CheckpointStore(std::string dir)
+    : dir_(std::move(dir)), path_(dir_ + "/" + kFileName), tmp_(path_ + ".tmp") {}
+
+bool CheckpointStore::save(const Checkpoint& cp) {
+  char buf[1024];
+  std::size_t len = 0;
+  const auto put = [&](const char* fmt, auto... args) {
+    const int n = std::snprintf(buf + len, sizeof(buf) - len, fmt, args...);
+    len = std::min(len + static_cast<std::size_t>(std::max(n, 0)), sizeof(buf) - 1);
+  };
+  put("%s", kHeader.data());
+  put("run=%s\nprotocol=%s\nsweep=%u/%u\nstep=%u\nelapsed_ms=%lld\n", cp.run, cp.protocol,
+      static_cast<unsigned>(cp.sweepRun), static_cast<unsigned>(cp.sweepTotal),
+      static_cast<unsigned>(cp.step), static_cast<long long>(cp.elapsed.count()));
+  for (std::size_t i = 0; i < std::size(kParameters); ++i)
+    put("param.%s=%.9g\n", toString(kParameters[i]), static_cast<double>(cp.params[i]));
+  put("%s%08x\n", kCrcKey.data(), static_cast<unsigned>(crc32(buf, len)));
+  if (len + 1 >= sizeof(buf))
+    return false; // cannot happen with names ≤ kNameLen; never write a truncated file
+
+  // on first use the directory may not exist yet (cold path: only before a run)
+  int fd = ::open(tmp_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0 && errno == ENOENT) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    fd = ::open(tmp_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  }
+  if (fd < 0)
+    return false;
+  const bool ok = writeAll(fd, buf, len) && ::fdatasync(fd) == 0;
+  ::close(fd);
+  return ok && ::rename(tmp_.c_str(), path_.c_str()) == 0 && syncDirectory(dir_);
+}
+
+std::optional<Checkpoint> CheckpointStore::load() const {
+  std::ifstream in(path_, std::ios::binary);
+  if (!in)
+    return std::nullopt;
+  const std::string text((std::istreambuf_iterator<char>(in)), {});
+  if (!text.starts_with(kHeader))
+    return std::nullopt;
+
+  // the CRC covers everything before its own line
+  const auto crcAt = text.rfind(kCrcKey);
+  if (crcAt == std::string::npos || (crcAt > 0 && text[crcAt - 1] != '\n'))
+    return std::nullopt;
+  std::string_view crcText = std::string_view(text).substr(crcAt + kCrcKey.size());
+  if (crcText.ends_with('\n'))
+    crcText.remove_suffix(1);
+  std::uint32_t crc = 0;
+  if (!parse(crcText, crc, 16) || crc != crc32(text.data(), crcAt))
+    return std::nullopt;
+
+  Checkpoint cp;
+  std::string_view rest = std::string_view(text).substr(kHeader.size(), crcAt - kHeader.size());
+  while (!rest.empty()) {
+    const auto nl = rest.find('\n');
+    const auto line = rest.substr(0, nl);
+    rest = nl == std::string_view::npos ? std::string_view{} : rest.substr(nl + 1);
+    const auto eq = line.find('=');
+    if (eq == std::string_view::npos)
+      continue;
+    const auto key = line.substr(0, eq);
+    const auto value = line.substr(eq + 1);
+    bool ok = true;
+    if (key == "run")
+      copyName(cp.run, value);
+    else if (key == "protocol")
+      copyName(cp.protocol, value);
+    else if (key == "sweep") {
+      const auto slash = value.find('/');
+      ok = slash != std::string_view::npos && parse(value.substr(0, slash), cp.sweepRun) &&
+           parse(value.substr(slash + 1), cp.sweepTotal);
+    } else if (key == "step")
+      ok = parse(value, cp.step);
+    else if (key == "elapsed_ms") {
+      long long ms = 0;
+      ok = parse(value, ms);
+      cp.elapsed = std::chrono::milliseconds{ ms };
+    } else if (key.starts_with("param.")) // unknown parameters are ignored, like other keys
+      for (std::size_t i = 0; i < std::size(kParameters); ++i)
+        if (key.substr(6) == toString(kParameters[i]))
+          ok = parse(value, cp.params[i]);
+    if (!ok)
+      return std::nullopt;
+  }
+  if (cp.protocol[0] == '\0' || cp.sweepRun >= cp.sweepTotal)
+    return std::nullopt;
+  return cp;
+}
+
+void CheckpointStore::clear() {
+  ::unlink(path_.c_str());
+  ::unlink(tmp_.c_str());
+  syncDirectory(dir_); // a finished sweep must not be offered for resuming after a reset
+}
+
+// ─── Checkpointer ────────────────────────────────────────────────────────────
+Checkpointer::Checkpointer(CheckpointStore& store, Clock& clock, Clock::Duration period)
+    : store_(store), clock_(&clock), period_(period), writer_([this] { writerLoop(); }) {}
+
+Checkpointer::~Checkpointer() {
+  stop_.store(true, std::memory_order_release);
+  signal_.fetch_add(1, std::memory_order_release);
+  signal_.notify_all();
+  writer_.join(); // saves what was handed over last
+}
+
+void Checkpointer::begin(const Checkpoint& cp) {
+  cp_ = cp;
+  first_ = cp.step;
+  started_ = clock_->now() - cp.elapsed; // a resumed run carries on counting
+  persist();
+  flush();
+}
+
+void Checkpointer::end() {
+  flush(); // nothing may land after the file is gone
+  store_.clear();
+}
+
+void Checkpointer::reached(std::uint32_t next) {
+  if (next <= cp_.step)
+    return;
+  cp_.step = next;
+  if (clock_->now() - savedAt_ >= period_)
+    persist();
+}
+
+void Checkpointer::persist() {
+  savedAt_ = clock_->now();
+  cp_.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(savedAt_ - started_);
+  auto& slot = pending_.back();
+  slot.cp = cp_;
+  slot.seq = ++handedOver_;
+  pending_.publish();
+  signal_.fetch_add(1, std::memory_order_release);
+  signal_.notify_all(); // no syscall unless the writer is actually asleep
+}
+
+void Checkpointer::flush() {
+  for (auto w = written_.load(std::memory_order_acquire); w < handedOver_;
+       w = written_.load(std::memory_order_acquire))
+    written_.wait(w, std::memory_order_acquire);
+}
+
+void Checkpointer::writerLoop() {
+  AllocationGuard::Exempt diskThread; // off the real-time path
+  const sched_param none{};           // started from the protocol thread: drop its policy
+  ::pthread_setschedparam(::pthread_self(), SCHED_OTHER, &none);
+
+  for (;;) {
+    const auto seen = signal_.load(std::memory_order_acquire);
+    if (pending_.consume()) {
+      const auto& p = pending_.front();
+      if (store_.save(p.cp))
+        saves_.fetch_add(1, std::memory_order_release);
+      written_.store(p.seq, std::memory_order_release);
+      written_.notify_all();
+      continue;
+    }
+    if (stop_.load(std::memory_order_acquire))
+      return;
+    signal_.wait(seen, std::memory_order_acquire);
+  }
+}
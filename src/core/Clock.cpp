@@ -0,0 +1,24 @@
+/* @file Clock.cpp
+ * @brief The process-wide steady clock.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <thread>
+
+// MiLO headers
+#include "core/Clock.hpp"
+
+using namespace milo::core;
+
+Clock& Clock::steady() {
+  static SteadyClock clock;
+  return clock;
+}
+
+void SteadyClock::sleepUntil(Duration t) {
+  std::this_thread::sleep_until(
+      std::chrono::steady_clock::time_point(std::chrono::duration_cast<
+                                            std::chrono::steady_clock::duration>(t)));
+}
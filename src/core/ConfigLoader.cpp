@@ -0,0 +1,183 @@
+/* @file ConfigLoader.cpp
+ * @brief config.json reader and the mappings of its blocks onto the structs they configure.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+// Third-party headers
+#include <nlohmann/json.hpp>
+
+// MiLO headers
+#include "core/ConfigLoader.hpp"
+
+using namespace milo::core;
+
+ConfigLoader::ConfigLoader(std::string configPath) : path_(std::move(configPath)) {}
+
+nlohmann::json ConfigLoader::load() const {
+  std::ifstream in(path_);
+  if (!in)
+    throw std::runtime_error("[ConfigLoader] cannot open " + path_);
+  try {
+    return nlohmann::json::parse(in);
+  } catch (const nlohmann::json::exception& e) {
+    throw std::runtime_error("[ConfigLoader] " + path_ + ": " + e.what());
+  }
+}
+
+RuntimeConfig milo::core::runtimeConfig(const nlohmann::json& config) {
+  RuntimeConfig cfg;
+  const auto rt = config.find("runtime");
+  if (rt == config.end())
+    return cfg;
+
+  try {
+    cfg.realtime = rt->value("realtime", cfg.realtime);
+    cfg.lockMemory = rt->value("lockMemory", cfg.lockMemory);
+    cfg.stackPrefault = rt->value("stackPrefaultKiB", cfg.stackPrefault / 1024) * 1024;
+
+    if (const auto threads = rt->find("threads"); threads != rt->end()) {
+      for (const auto role : kThreadRoles) {
+        const auto t = threads->find(toString(role));
+        if (t == threads->end())
+          continue;
+        auto& p = cfg[role];
+        if (const auto name = t->find("policy"); name != t->end()) {
+          const auto policy = RuntimeProfile::parsePolicy(name->get<std::string>());
+          if (!policy)
+            throw std::runtime_error(std::string("[ConfigLoader] runtime.threads.") +
+                                     toString(role) + ": unknown policy " + name->dump());
+          p.policy = *policy;
+        }
+        p.priority = t->value("priority", p.priority);
+        p.cpu = t->value("cpu", p.cpu);
+      }
+    }
+
+    if (const auto jitter = rt->find("jitter"); jitter != rt->end()) {
+      cfg.jitterPeriod = std::chrono::microseconds{ jitter->value("periodUs",
+                                                                  cfg.jitterPeriod.count()) };
+      cfg.jitterSamples = jitter->value("samples", cfg.jitterSamples);
+    }
+  } catch (const nlohmann::json::exception& e) {
+    throw std::runtime_error(std::string("[ConfigLoader] runtime: ") + e.what());
+  }
+  return cfg;
+}
+
+std::optional<SweepPlan> milo::core::sweepPlan(const nlohmann::json& config) {
+  const auto sw = config.find("sweep");
+  if (sw == config.end())
+    return std::nullopt;
+
+  const auto fail = [](const std::string& what) {
+    return std::runtime_error("[ConfigLoader] sweep: " + what);
+  };
+  SweepPlan plan;
+  try {
+    plan.protocol = sw->value("protocol", std::string{});
+    if (plan.protocol.empty())
+      throw fail("no protocol");
+    const auto repeats = sw->value("repeats", std::int64_t{ 1 });
+    if (repeats < 1)
+      throw fail("repeats must be at least 1");
+    plan.repeats = static_cast<std::size_t>(repeats);
+    plan.settle = std::chrono::milliseconds{ sw->value("settleMs", plan.settle.count()) };
+    plan.stopOnError = sw->value("stopOnError", plan.stopOnError);
+
+    if (const auto axes = sw->find("axes"); axes != sw->end()) {
+      for (const auto& a : axes->get_ref<const nlohmann::json::array_t&>()) {
+        const auto name = a.at("param").get<std::string>();
+        const auto param = parseParameter(name);
+        if (!param)
+          throw fail("unknown parameter \"" + name + '"');
+        if (const auto values = a.find("values"); values != a.end())
+          plan.axes.push_back(SweepAxis::list(*param, values->get<std::vector<float>>()));
+        else if (a.contains("from") && a.contains("to") && a.contains("step"))
+          plan.axes.push_back(SweepAxis::range(*param, a.at("from").get<float>(),
+                                               a.at("to").get<float>(),
+                                               a.at("step").get<float>()));
+        else
+          throw fail(name + " needs \"values\" or \"from\"/\"to\"/\"step\"");
+      }
+    }
+  } catch (const nlohmann::json::exception& e) {
+    throw fail(e.what());
+  } catch (const std::invalid_argument& e) { // SweepAxis::range: zero step
+    throw fail(e.what());
+  }
+  return plan;
+}
+
+LogRetention milo::core::logRetention(const nlohmann::json& config) {
+  LogRetention retention;
+  const auto lg = config.find("logging");
+  if (lg == config.end())
+    return retention;
+
+  try {
+    if (const auto quota = lg->find("quotaMiB"); quota != lg->end()) {
+      const auto mib = quota->get<double>();
+      if (!(mib > 0.0))
+        throw std::runtime_error("[ConfigLoader] logging: quotaMiB must be positive");
+      retention.quotaBytes = static_cast<std::uint64_t>(mib * 1024.0 * 1024.0);
+    }
+    retention.compress = lg->value("compress", retention.compress);
+  } catch (const nlohmann::json::exception& e) {
+    throw std::runtime_error(std::string("[ConfigLoader] logging: ") + e.what());
+  }
+  return retention;
+}
+
+DeviceRegistry milo::core::deviceRegistry(const nlohmann::json& config) {
+  const auto devices = config.find("devices");
+  if (devices == config.end())
+    return DeviceRegistry::defaults();
+
+  DeviceRegistry registry;
+  try {
+    for (const auto& d : devices->get_ref<const nlohmann::json::array_t&>()) {
+      DeviceSpec spec;
+      spec.name = d.at("name").get<std::string>();
+      spec.path = d.value("path", spec.path);
+      const auto fail = [&](const std::string& what) {
+        return std::runtime_error("[ConfigLoader] devices." + spec.name + ": " + what);
+      };
+      if (const auto serial = d.find("serial"); serial != d.end()) {
+        const auto baud = serial->value("baud", static_cast<unsigned long>(spec.serial.baud));
+        const auto rate = DeviceRegistry::parseBaud(baud);
+        if (!rate)
+          throw fail("unsupported baud " + std::to_string(baud));
+        spec.serial.baud = *rate;
+        spec.serial.lowLatency = serial->value("lowLatency", spec.serial.lowLatency);
+        // termios c_cc slots are one byte wide
+        const auto threshold = [&](const char* key, std::uint8_t fallback) {
+          const auto v = serial->value(key, static_cast<unsigned>(fallback));
+          if (v > 255)
+            throw fail(std::string("serial.") + key + " above 255");
+          return static_cast<std::uint8_t>(v);
+        };
+        spec.serial.vmin = threshold("vmin", spec.serial.vmin);
+        spec.serial.vtime = threshold("vtime", spec.serial.vtime);
+      }
+      if (const auto codec = d.find("codec"); codec != d.end()) {
+        const auto c = DeviceRegistry::parseCodec(codec->get<std::string>());
+        if (!c)
+          throw fail("unknown codec " + codec->dump());
+        spec.codec = *c;
+      }
+      registry.add(std::move(spec));
+    }
+  } catch (const nlohmann::json::exception& e) {
+    throw std::runtime_error(std::string("[ConfigLoader] devices: ") + e.what());
+  } catch (const std::invalid_argument& e) { // DeviceRegistry::add: empty/duplicate name, too many
+    throw std::runtime_error(std::string("[ConfigLoader] devices: ") + e.what());
+  }
+  return registry;
+}
@@ -0,0 +1,382 @@
+/* @file ControlServer.cpp
+ * @brief Unix-socket accept/read/write loop, request dispatch and stream fan-out.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <string_view>
+
+// Linux headers
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/AllocationGuard.hpp"
+#include "core/ControlServer.hpp"
+#include "core/ParameterStore.hpp"
+
+using namespace milo::core;
+using namespace milo::core::control;
+
+namespace {
+  constexpr std::uint64_t kListenTag = ~std::uint64_t{ 0 }; ///< epoll data of the listening fd
+  constexpr int kEventsPerWait = 16;
+
+  Frame errorReply(std::string_view what) { return std::move(Frame(MsgType::Error).putText(what)); }
+
+  std::optional<Parameter> parameterFromWire(std::uint8_t raw) {
+    const auto p = static_cast<Parameter>(raw);
+    if (std::string_view(toString(p)) == "Unknown")
+      return std::nullopt;
+    return p;
+  }
+
+  /// Below this much free output space a client’s requests wait: their replies must fit.
+  bool congested(std::size_t outLen) { return ControlServer::kOutBytes - outLen < kMaxFrame; }
+
+  /// Root, our own user or our group: whoever could also have read the socket's mode bits.
+  bool trusted(int fd) {
+    ucred peer{};
+    socklen_t len = sizeof(peer);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &len) != 0)
+      return false;
+    return peer.uid == 0 || peer.uid == ::geteuid() || peer.gid == ::getegid();
+  }
+} // namespace
+
+std::unique_ptr<ControlServer> ControlServer::create(const std::string& path,
+                                                     ParameterStore& params, Actions actions) {
+  sockaddr_un addr{};
+  if (path.empty() || path.size() >= sizeof(addr.sun_path))
+    return nullptr;
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return nullptr;
+  ::unlink(path.c_str()); // left behind by a previous daemon
+  // mode before listen(): nobody outside owner/group can connect while it is being set
+  if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::chmod(path.c_str(), static_cast<mode_t>(kSocketMode)) != 0 ||
+      ::listen(fd, static_cast<int>(kMaxClients)) != 0) {
+    ::close(fd);
+    ::unlink(path.c_str());
+    return nullptr;
+  }
+
+  const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.u64 = kListenTag;
+  if (epfd < 0 || ::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    if (epfd >= 0)
+      ::close(epfd);
+    ::close(fd);
+    ::unlink(path.c_str());
+    return nullptr;
+  }
+  return std::unique_ptr<ControlServer>(
+      new ControlServer(path, fd, epfd, params, std::move(actions)));
+}
+
+ControlServer::ControlServer(std::string path, int listenFd, int epfd, ParameterStore& params,
+                             Actions actions)
+    : path_(std::move(path)), listenFd_(listenFd), epfd_(epfd), params_(params),
+      actions_(std::move(actions)), clients_(kMaxClients) {}
+
+ControlServer::~ControlServer() {
+  for (auto& c : clients_)
+    if (c.fd >= 0)
+      ::close(c.fd);
+  ::close(epfd_);
+  ::close(listenFd_);
+  ::unlink(path_.c_str());
+}
+
+std::size_t ControlServer::clients() const {
+  return static_cast<std::size_t>(
+      std::count_if(clients_.begin(), clients_.end(), [](const Client& c) { return c.fd >= 0; }));
+}
+
+std::size_t ControlServer::service() {
+  AllocationGuard::Exempt controlThread; // off the real-time path; actions may allocate
+
+  std::size_t handled = 0;
+  epoll_event evs[kEventsPerWait];
+  int n;
+  while ((n = ::epoll_wait(epfd_, evs, kEventsPerWait, 0)) > 0) {
+    for (int i = 0; i < n; ++i) {
+      if (evs[i].data.u64 == kListenTag) {
+        accept();
+        continue;
+      }
+      auto& c = clients_[evs[i].data.u64];
+      if (c.fd < 0)
+        continue; // dropped earlier in this batch
+      if (evs[i].events & EPOLLOUT)
+        flush(c);
+      if (c.fd >= 0 && (evs[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+        receive(c);
+      if (c.fd >= 0)
+        handled += handleInput(c);
+    }
+    if (n < kEventsPerWait)
+      break;
+  }
+
+  drainBuses();
+  for (auto& c : clients_) {
+    if (c.fd < 0)
+      continue;
+    flush(c);
+    if (c.fd >= 0)
+      handled += handleInput(c); // requests held back while the client’s output was full
+  }
+  return handled;
+}
+
+void ControlServer::accept() {
+  for (;;) {
+    const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      return; // EAGAIN: backlog drained
+    if (!trusted(fd)) {
+      ::close(fd);
+      ++refused_;
+      continue;
+    }
+    auto slot =
+        std::find_if(clients_.begin(), clients_.end(), [](const Client& c) { return c.fd < 0; });
+    if (slot == clients_.end()) {
+      ::close(fd); // full: the client sees EOF
+      continue;
+    }
+    // the kernel’s share of the backlog is bounded too, or a stalled reader hides in it
+    const int sndbuf = static_cast<int>(kOutBytes);
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = static_cast<std::uint64_t>(slot - clients_.begin());
+    if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      ::close(fd);
+      continue;
+    }
+    slot->fd = fd;
+    slot->topics = 0;
+    slot->interest = EPOLLIN;
+    slot->lost = 0;
+    slot->inLen = slot->outLen = 0;
+  }
+}
+
+void ControlServer::receive(Client& c) {
+  while (c.fd >= 0 && c.inLen < c.in.size() && !congested(c.outLen)) {
+    const auto n = ::recv(c.fd, c.in.data() + c.inLen, c.in.size() - c.inLen, 0);
+    if (n > 0) {
+      c.inLen += static_cast<std::size_t>(n);
+      handleInput(c);
+    } else if (n == 0 || (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      drop(c); // EOF or reset
+    } else if (errno != EINTR) {
+      break;
+    }
+  }
+}
+
+std::size_t ControlServer::handleInput(Client& c) {
+  std::size_t handled = 0;
+  while (c.fd >= 0 && c.inLen >= kLengthBytes && !congested(c.outLen)) {
+    const auto len = Frame::peekLength(c.in);
+    if (len == 0 || len > 1 + kMaxBody) {
+      enqueue(c, errorReply("[ControlServer] bad frame length"));
+      flush(c);
+      drop(c); // the stream cannot be re-synchronised
+      return handled;
+    }
+    const auto total = kLengthBytes + len;
+    if (c.inLen < total)
+      break;
+    auto req = Frame::decode(std::span(c.in).subspan(kLengthBytes, len));
+    enqueue(c, handle(c, *req));
+    ++handled;
+    std::memmove(c.in.data(), c.in.data() + total, c.inLen - total);
+    c.inLen -= total;
+  }
+  return handled;
+}
+
+Frame ControlServer::handle(Client& c, Frame& req) {
+  try {
+    switch (req.type()) {
+    case MsgType::Ping:
+      return Frame(MsgType::Ok);
+    case MsgType::SetParam: {
+      const auto raw = req.getU8();
+      const auto value = req.getF32();
+      if (!raw || !value)
+        break;
+      const auto p = parameterFromWire(*raw);
+      if (!p)
+        return errorReply("[ControlServer] unknown parameter");
+      params_.set(*p, *value);
+      return Frame(MsgType::Ok);
+    }
+    case MsgType::GetParam: {
+      const auto raw = req.getU8();
+      if (!raw)
+        break;
+      const auto p = parameterFromWire(*raw);
+      if (!p)
+        return errorReply("[ControlServer] unknown parameter");
+      return std::move(Frame(MsgType::Ok).putF32(params_.get(*p)));
+    }
+    case MsgType::SelectProtocol: {
+      const auto name = req.getText();
+      if (name.empty())
+        break;
+      if (!actions_.selectProtocol)
+        return errorReply("[ControlServer] protocol selection not available");
+      actions_.selectProtocol(std::string(name));
+      return Frame(MsgType::Ok);
+    }
+    case MsgType::Start:
+      if (!actions_.start)
+        return errorReply("[ControlServer] start not available");
+      actions_.start();
+      return Frame(MsgType::Ok);
+    case MsgType::Abort:
+      if (!actions_.abort)
+        return errorReply("[ControlServer] abort not available");
+      actions_.abort();
+      return Frame(MsgType::Ok);
+    case MsgType::Resume:
+      if (!actions_.resume)
+        return errorReply("[ControlServer] resume not available");
+      actions_.resume();
+      return Frame(MsgType::Ok);
+    case MsgType::Discard:
+      if (!actions_.discard)
+        return errorReply("[ControlServer] discard not available");
+      actions_.discard();
+      return Frame(MsgType::Ok);
+    case MsgType::Subscribe: {
+      const auto topics = req.getU8();
+      if (!topics)
+        break;
+      c.topics = *topics & (kEvents | kMeasurements);
+      c.lost = 0;
+      return Frame(MsgType::Ok);
+    }
+    default:
+      return errorReply("[ControlServer] unknown request");
+    }
+  } catch (const std::exception& e) {
+    return errorReply(e.what());
+  }
+  return errorReply("[ControlServer] malformed request");
+}
+
+bool ControlServer::enqueue(Client& c, const Frame& f) {
+  const auto n = f.encode(std::span(c.out).subspan(c.outLen));
+  c.outLen += n;
+  return n > 0;
+}
+
+void ControlServer::stream(std::uint8_t topic, const Frame& f) {
+  for (auto& c : clients_) {
+    if (c.fd < 0 || !(c.topics & topic))
+      continue;
+    // stream frames never eat into the room kept for one reply
+    const auto fits = [&](const Frame& g) {
+      return c.outLen + g.encodedSize() + kMaxFrame <= kOutBytes;
+    };
+    if (c.lost > 0) {
+      const auto lost = std::move(Frame(MsgType::Lost).putU32(c.lost));
+      if (!fits(lost) || !enqueue(c, lost)) {
+        ++c.lost;
+        ++dropped_;
+        continue;
+      }
+      c.lost = 0;
+    }
+    if (fits(f)) {
+      enqueue(c, f);
+    } else {
+      ++c.lost;
+      ++dropped_;
+    }
+  }
+}
+
+void ControlServer::drainBuses() {
+  if (events_.valid()) {
+    SystemEvent e;
+    while (events_.poll(e)) {
+      Frame f(e.kind == SystemEvent::Kind::Error ? MsgType::Fault : MsgType::StateChanged);
+      f.putI64(e.timestamp.count());
+      if (e.kind == SystemEvent::Kind::Error)
+        f.putU8(static_cast<std::uint8_t>(e.to)).putText(e.text);
+      else
+        f.putU8(static_cast<std::uint8_t>(e.from)).putU8(static_cast<std::uint8_t>(e.to));
+      stream(kEvents, f);
+    }
+  }
+  if (measurements_.valid()) {
+    LogEvent e;
+    while (measurements_.poll(e)) {
+      Frame f(MsgType::Measurement);
+      f.putI64(e.timestamp.count())
+          .putU8(static_cast<std::uint8_t>(e.type))
+          .putF64(e.value)
+          .putText(e.key);
+      stream(kMeasurements, f);
+    }
+  }
+}
+
+void ControlServer::flush(Client& c) {
+  std::size_t sent = 0;
+  while (sent < c.outLen) {
+    const auto n = ::send(c.fd, c.out.data() + sent, c.outLen - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n > 0) {
+      sent += static_cast<std::size_t>(n);
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      drop(c);
+      return;
+    }
+  }
+  std::memmove(c.out.data(), c.out.data() + sent, c.outLen - sent);
+  c.outLen -= sent;
+
+  // read while replies fit, wait for EPOLLOUT while output is pending
+  const std::uint32_t interest = (congested(c.outLen) ? 0u : std::uint32_t{ EPOLLIN }) |
+                                 (c.outLen ? std::uint32_t{ EPOLLOUT } : 0u);
+  if (interest != c.interest) {
+    epoll_event ev{};
+    ev.events = interest;
+    ev.data.u64 = static_cast<std::uint64_t>(&c - clients_.data());
+    ::epoll_ctl(epfd_, EPOLL_CTL_MOD, c.fd, &ev);
+    c.interest = interest;
+  }
+}
+
+void ControlServer::drop(Client& c) {
+  ::epoll_ctl(epfd_, EPOLL_CTL_DEL, c.fd, nullptr);
+  ::close(c.fd);
+  c.fd = -1;
+  c.topics = 0;
+  c.inLen = c.outLen = 0;
+}
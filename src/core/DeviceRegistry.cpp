@@ -0,0 +1,70 @@
+/* @file DeviceRegistry.cpp
+ * @brief Runtime device table: validation, name lookup and config value parsing.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <stdexcept>
+
+// MiLO headers
+#include "core/DeviceRegistry.hpp"
+
+using namespace milo::core;
+
+DeviceRegistry::DeviceRegistry(std::vector<DeviceSpec> specs) {
+  specs_.reserve(specs.size());
+  for (auto& s : specs)
+    add(std::move(s));
+}
+
+DeviceRegistry DeviceRegistry::defaults() {
+  return DeviceRegistry({ { "PG", "/dev/pg1" }, { "PSU", "/dev/psu1" }, { "Pump", "/dev/pump1" } });
+}
+
+Device DeviceRegistry::add(DeviceSpec spec) {
+  if (spec.name.empty())
+    throw std::invalid_argument("[DeviceRegistry] device without a name");
+  if (find(spec.name))
+    throw std::invalid_argument("[DeviceRegistry] duplicate device: " + spec.name);
+  if (specs_.size() >= kMaxDevices)
+    throw std::invalid_argument("[DeviceRegistry] more than " + std::to_string(kMaxDevices) +
+                                " devices");
+  specs_.push_back(std::move(spec));
+  return Device{ static_cast<std::uint8_t>(specs_.size() - 1) };
+}
+
+std::optional<Device> DeviceRegistry::find(std::string_view name) const {
+  for (std::size_t i = 0; i < specs_.size(); ++i)
+    if (specs_[i].name == name)
+      return Device{ static_cast<std::uint8_t>(i) };
+  return std::nullopt;
+}
+
+Device DeviceRegistry::at(std::string_view name) const {
+  if (auto d = find(name))
+    return *d;
+  throw std::invalid_argument("[DeviceRegistry] unknown device: " + std::string(name));
+}
+
+std::vector<Device> DeviceRegistry::all() const {
+  std::vector<Device> out;
+  out.reserve(specs_.size());
+  for (std::size_t i = 0; i < specs_.size(); ++i)
+    out.push_back(Device{ static_cast<std::uint8_t>(i) });
+  return out;
+}
+
+std::optional<std::uint32_t> DeviceRegistry::parseBaud(unsigned long baud) {
+  if (baud < io::SerialSettings::kMinBaud || baud > io::SerialSettings::kMaxBaud)
+    return std::nullopt;
+  return static_cast<std::uint32_t>(baud);
+}
+
+std::optional<Codec> DeviceRegistry::parseCodec(std::string_view name) {
+  if (name == "ascii-crlf")
+    return Codec::AsciiCrlf;
+  if (name == "ascii-lf")
+    return Codec::AsciiLf;
+  return std::nullopt;
+}
@@ -0,0 +1,267 @@
+/* @file LogCompressor.cpp
+ * @brief Block-wise `.mlz` writer/reader and the idle-priority compression worker.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+// Linux headers
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/AllocationGuard.hpp"
+#include "core/Crc32.hpp"
+#include "core/FsSync.hpp"
+#include "core/LogCompressor.hpp"
+#include "core/Lz.hpp"
+
+using namespace milo::core;
+
+namespace {
+  constexpr char kMagic[4] = { 'M', 'L', 'Z', '1' };
+
+  void putU32(std::FILE* fp, std::uint32_t v) {
+    const unsigned char b[4] = { static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8),
+                                 static_cast<unsigned char>(v >> 16),
+                                 static_cast<unsigned char>(v >> 24) };
+    std::fwrite(b, 1, sizeof(b), fp);
+  }
+
+  bool getU32(std::FILE* fp, std::uint32_t& v) {
+    unsigned char b[4];
+    if (std::fread(b, 1, sizeof(b), fp) != sizeof(b))
+      return false;
+    v = b[0] | (std::uint32_t{ b[1] } << 8) | (std::uint32_t{ b[2] } << 16) |
+        (std::uint32_t{ b[3] } << 24);
+    return true;
+  }
+
+  struct File {
+    std::FILE* fp;
+    ~File() {
+      if (fp)
+        std::fclose(fp);
+    }
+  };
+} // namespace
+
+LogCompressor::LogCompressor(Done done) : done_(std::move(done)) {}
+
+LogCompressor::~LogCompressor() {
+  {
+    std::lock_guard lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable())
+    worker_.join();
+}
+
+void LogCompressor::enqueue(const std::string& path) {
+  {
+    std::lock_guard lock(mtx_);
+    if (path == current_ || std::find(queue_.begin(), queue_.end(), path) != queue_.end())
+      return;
+    queue_.push_back(path);
+    if (!worker_.joinable())
+      worker_ = std::thread([this] { workerLoop(); });
+  }
+  cv_.notify_all();
+}
+
+void LogCompressor::pause() {
+  std::lock_guard lock(mtx_);
+  paused_ = true;
+}
+
+void LogCompressor::resume() {
+  {
+    std::lock_guard lock(mtx_);
+    paused_ = false;
+  }
+  cv_.notify_all();
+}
+
+bool LogCompressor::paused() const {
+  std::lock_guard lock(mtx_);
+  return paused_;
+}
+
+std::size_t LogCompressor::pending() const {
+  std::lock_guard lock(mtx_);
+  return queue_.size() + (current_.empty() ? 0 : 1);
+}
+
+void LogCompressor::waitIdle() {
+  std::unique_lock lock(mtx_);
+  idleCv_.wait(lock, [this] { return (queue_.empty() && current_.empty()) || paused_ || stop_; });
+}
+
+bool LogCompressor::waitWhilePaused() {
+  std::unique_lock lock(mtx_);
+  if (paused_)
+    idleCv_.notify_all(); // waitIdle() callers: nothing more happens until resume()
+  cv_.wait(lock, [this] { return !paused_ || stop_; });
+  return !stop_;
+}
+
+void LogCompressor::workerLoop() {
+  AllocationGuard::Exempt diskThread;
+  // lowest class the kernel has: runs only when nothing else wants the CPU
+  sched_param sp{};
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &sp);
+
+  for (;;) {
+    {
+      std::unique_lock lock(mtx_);
+      current_.clear();
+      idleCv_.notify_all();
+      cv_.wait(lock, [this] { return stop_ || (!paused_ && !queue_.empty()); });
+      if (stop_)
+        return;
+      current_ = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    const auto src = current_;
+    const auto dst = src + kSuffix;
+    const bool ok = compressFile(src, dst, [this] { return waitWhilePaused(); });
+
+    std::uint64_t raw = 0, packed = 0;
+    if (ok) {
+      std::error_code ec;
+      raw = std::filesystem::file_size(src, ec);
+      packed = std::filesystem::file_size(dst, ec);
+    }
+    {
+      std::lock_guard lock(mtx_);
+      if (stop_ && !ok)
+        return; // shutdown mid-file: the CSV stays, a later run re-queues it
+    }
+    if (done_)
+      done_(src, raw, packed, ok);
+  }
+}
+
+bool LogCompressor::compressFile(const std::string& src, const std::string& dst,
+                                 const std::function<bool()>& keepGoing) {
+  File in{ std::fopen(src.c_str(), "rbe") };
+  if (!in.fp)
+    return false;
+  const auto tmp = dst + ".tmp";
+  File out{ std::fopen(tmp.c_str(), "wbe") };
+  if (!out.fp)
+    return false;
+
+  std::vector<char> raw(kBlock);
+  std::vector<char> packed(lz::maxCompressedSize(kBlock));
+  std::fwrite(kMagic, 1, sizeof(kMagic), out.fp);
+
+  bool ok = true;
+  for (;;) {
+    if (keepGoing && !keepGoing()) {
+      ok = false;
+      break;
+    }
+    const auto n = std::fread(raw.data(), 1, raw.size(), in.fp);
+    if (n == 0)
+      break;
+    auto m = lz::compress({ raw.data(), n }, packed);
+    const bool store = m >= n; // incompressible block
+    if (store)
+      m = n;
+    putU32(out.fp, static_cast<std::uint32_t>(n));
+    putU32(out.fp, static_cast<std::uint32_t>(m));
+    putU32(out.fp, crc32(raw.data(), n));
+    std::fwrite(store ? raw.data() : packed.data(), 1, m, out.fp);
+  }
+  putU32(out.fp, 0);
+  putU32(out.fp, 0);
+  putU32(out.fp, 0);
+
+  // the archive is on disk before it replaces anything, and its name is before we report
+  // success — the caller deletes the CSV on our word
+  ok = ok && !std::ferror(in.fp) && std::fflush(out.fp) == 0 && !std::ferror(out.fp) &&
+       ::fdatasync(::fileno(out.fp)) == 0;
+  std::fclose(out.fp);
+  out.fp = nullptr;
+  if (!ok || std::rename(tmp.c_str(), dst.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return syncDirectory(std::filesystem::path(dst).parent_path().string());
+}
+
+std::optional<std::string> LogCompressor::readFile(const std::string& path) {
+  return readRange(path, 0, UINT64_MAX);
+}
+
+std::optional<std::string> LogCompressor::readRange(const std::string& path, std::uint64_t offset,
+                                                    std::uint64_t length) {
+  File in{ std::fopen(path.c_str(), "rbe") };
+  if (!in.fp)
+    return std::nullopt;
+  const auto end = length > UINT64_MAX - offset ? UINT64_MAX : offset + length;
+
+  char magic[sizeof(kMagic)];
+  const bool packedFile = std::fread(magic, 1, sizeof(magic), in.fp) == sizeof(magic) &&
+                          std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  std::string text;
+  if (!packedFile) { // plain CSV
+    if (::fseeko(in.fp, static_cast<off_t>(offset), SEEK_SET) != 0)
+      return std::nullopt;
+    char buf[4096];
+    std::uint64_t left = end - offset;
+    while (left > 0) {
+      const auto n = std::fread(buf, 1, static_cast<std::size_t>(std::min<std::uint64_t>(left, sizeof(buf))), in.fp);
+      if (n == 0)
+        break;
+      text.append(buf, n);
+      left -= n;
+    }
+    return text;
+  }
+
+  // blocks are independent: skip by header, decode only those overlapping the range
+  std::vector<char> packed;
+  std::vector<char> block;
+  for (std::uint64_t pos = 0; pos < end;) {
+    std::uint32_t n, m, crc;
+    if (!getU32(in.fp, n) || !getU32(in.fp, m) || !getU32(in.fp, crc))
+      return std::nullopt;
+    if (n == 0)
+      break;
+    if (n > kBlock || m > lz::maxCompressedSize(kBlock))
+      return std::nullopt;
+    if (pos + n <= offset) {
+      if (::fseeko(in.fp, m, SEEK_CUR) != 0)
+        return std::nullopt;
+      pos += n;
+      continue;
+    }
+    packed.resize(m);
+    block.resize(n);
+    if (std::fread(packed.data(), 1, m, in.fp) != m)
+      return std::nullopt;
+    if (m == n)
+      std::memcpy(block.data(), packed.data(), n);
+    else if (lz::decompress(packed, block) != n)
+      return std::nullopt;
+    if (crc32(block.data(), n) != crc)
+      return std::nullopt;
+
+    const auto from = std::max(offset, pos) - pos;
+    const auto to = std::min<std::uint64_t>(end, pos + n) - pos;
+    text.append(block.data() + from, static_cast<std::size_t>(to - from));
+    pos += n;
+  }
+  return text;
+}
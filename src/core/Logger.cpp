@@ -0,0 +1,372 @@
+/* @file Logger.cpp
+ * @brief Per-run CSV files fed from an SPSC ring by a worker thread.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <stdexcept>
+
+// MiLO headers
+#include "core/AllocationGuard.hpp"
+#include "core/Logger.hpp"
+#include "core/RingBuffer.hpp"
+#include "core/RunStats.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/Telemetry.hpp"
+#include "io/LogJournal.hpp"
+
+using namespace milo::core;
+
+namespace {
+  constexpr auto kIdleWait = std::chrono::milliseconds{ 10 };
+  constexpr auto kFlushPeriod = std::chrono::seconds{ 1 };
+
+  /// "…_run042.csv" (or its archive "…_run042.csv.mlz") → 42, anything else → 0.
+  unsigned runIndex(std::string name) {
+    if (name.ends_with(LogCompressor::kSuffix))
+      name.resize(name.size() - std::char_traits<char>::length(LogCompressor::kSuffix));
+    const auto pos = name.rfind("_run");
+    if (pos == std::string::npos || name.size() < pos + 4 + 4 ||
+        name.compare(name.size() - 4, 4, ".csv") != 0)
+      return 0;
+    unsigned idx = 0;
+    const auto* first = name.data() + pos + 4;
+    const auto* last = name.data() + name.size() - 4;
+    auto [ptr, ec] = std::from_chars(first, last, idx);
+    return (ec == std::errc{} && ptr == last) ? idx : 0;
+  }
+} // namespace
+
+Logger::Logger(std::string logDir, std::size_t queueCapacity)
+    : logDir_(std::move(logDir)),
+      buffer_(std::make_unique<RingBuffer<LogEvent>>(queueCapacity)),
+      blocks_(std::make_unique<RingBuffer<SampleBlock>>(kBlockQueue)), manifest_(logDir_),
+      compressor_([this](const std::string& src, std::uint64_t raw, std::uint64_t packed,
+                         bool ok) { onCompressed(src, raw, packed, ok); }) {
+  recoverInterruptedRuns();
+}
+
+void Logger::recoverInterruptedRuns() {
+  for (const auto& r : manifest_.runs()) {
+    if (r.finished())
+      continue;
+    // a run still open at boot was cut short: only its journal is read, not the log
+    const auto path = (std::filesystem::path(logDir_) / r.name).string();
+    const auto rec = io::LogJournal::recover(path, io::FileLogger::journalPath(path));
+
+    std::string mark = "# interrupted: ";
+    mark += rec ? "recovered " + std::to_string(rec->blocks) + " journal block(s), " +
+                      std::to_string(rec->discarded) + " torn byte(s) dropped\n"
+                : "no journal, log kept as found\n";
+    if (std::FILE* fp = std::fopen(path.c_str(), "ae")) {
+      std::fputs(mark.c_str(), fp);
+      std::fclose(fp);
+    }
+
+    std::error_code ec;
+    const auto bytes = std::filesystem::file_size(path, ec);
+    manifest_.update(r.name, [&](RunRecord& m) {
+      m.status = RunRecord::Status::Interrupted;
+      m.rawBytes = m.storedBytes = ec ? 0 : bytes;
+    });
+    recovered_.push_back(r.name);
+  }
+}
+
+Logger::~Logger() { finishRun(); }
+
+std::string Logger::nextRunPath() const {
+  unsigned last = 0;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(logDir_, ec))
+    last = std::max(last, runIndex(entry.path().filename().string()));
+
+  const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::tm utc{};
+  gmtime_r(&now, &utc);
+  char name[64];
+  const auto n = std::strftime(name, sizeof(name), "%Y-%m-%dT%H-%M-%S", &utc);
+  std::snprintf(name + n, sizeof(name) - n, "_run%03u.csv", last + 1);
+  return (std::filesystem::path(logDir_) / name).string();
+}
+
+void Logger::setRetention(const LogRetention& retention) {
+  retention_ = retention;
+  scheduleCompression();
+}
+
+void Logger::enforceQuota() {
+  auto total = manifest_.storedBytes();
+  for (const auto& r : manifest_.runs()) { // oldest first
+    if (total <= retention_.quotaBytes)
+      break;
+    std::error_code ec;
+    std::filesystem::remove(std::filesystem::path(logDir_) / r.stored, ec);
+    std::filesystem::remove(std::filesystem::path(logDir_) / r.name, ec);
+    if (!r.index.empty())
+      std::filesystem::remove(std::filesystem::path(logDir_) / r.index, ec);
+    manifest_.erase(r.name);
+    total -= std::min(total, r.storedBytes);
+  }
+}
+
+void Logger::scheduleCompression() {
+  if (!retention_.compress)
+    return;
+  const auto runs = manifest_.runs();
+  // the newest finished run stays plain CSV: it is the one people open right away
+  auto newest = std::find_if(runs.rbegin(), runs.rend(), [](const RunRecord& r) {
+    return r.finished();
+  });
+  for (auto it = runs.begin(); newest != runs.rend() && it != std::prev(newest.base()); ++it)
+    if (it->finished() && !it->compressed())
+      compressor_.enqueue((std::filesystem::path(logDir_) / it->name).string());
+}
+
+void Logger::onCompressed(const std::string& src, std::uint64_t raw, std::uint64_t packed,
+                          bool ok) {
+  if (!ok)
+    return;
+  const auto name = std::filesystem::path(src).filename().string();
+  const bool listed = manifest_.update(name, [&](RunRecord& r) {
+    r.rawBytes = raw;
+    r.storedBytes = packed;
+    r.stored = name + LogCompressor::kSuffix;
+  });
+  // ok means the archive is durable and the manifest update() above is too: only now may
+  // the CSV go. Rotated away while we were compressing it: the archive goes instead.
+  std::error_code ec;
+  std::filesystem::remove(listed ? src : src + LogCompressor::kSuffix, ec);
+}
+
+void Logger::startNewRun() {
+  finishRun();
+  compressor_.pause(); // the disk belongs to the run until finishRun()
+
+  std::error_code ec;
+  std::filesystem::create_directories(logDir_, ec);
+  enforceQuota();
+  runPath_ = nextRunPath();
+  if (!file_.open(runPath_, /*journaled=*/true)) {
+    compressor_.resume();
+    throw std::runtime_error("[Logger] cannot create run log: " + runPath_);
+  }
+  {
+    std::lock_guard lock(notesMtx_);
+    for (const auto& [key, value] : headers_)
+      file_.write("# " + key + ": " + value + "\n");
+    notes_.clear();
+    stats_.clear();
+  }
+  file_.write("timestamp_ns,type,key,value\n");
+  if (!file_.flush()) {
+    file_.close();
+    compressor_.resume();
+    throw std::runtime_error("[Logger] cannot write run log: " + runPath_);
+  }
+  RunRecord rec;
+  rec.name = std::filesystem::path(runPath_).filename().string();
+  if (index_.open(runPath_ + RunIndex::kSuffix))
+    rec.index = rec.name + RunIndex::kSuffix;
+  manifest_.put(rec);
+
+  if (busCursor_.valid())
+    busCursor_.skipToHead(); // between-run chatter does not belong to this run
+  running_.store(true, std::memory_order_release);
+  worker_ = std::thread([this] { workerLoop(); });
+}
+
+void Logger::log(const LogEvent& event) {
+  if (!buffer_->push(event))
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  if (measurements_)
+    measurements_->publish(event);
+}
+
+void Logger::logBlock(const SampleBlock& block) {
+  if (!blocks_->push(block))
+    dropped_.fetch_add(block.count, std::memory_order_relaxed);
+}
+
+void Logger::finishRun() {
+  if (!running_.exchange(false, std::memory_order_acq_rel))
+    return;
+  if (worker_.joinable())
+    worker_.join();
+  const std::uint64_t bytes = file_.bytesWritten();
+  file_.close();
+  index_.close();
+
+  std::string stats;
+  {
+    std::lock_guard lock(notesMtx_);
+    stats.swap(stats_);
+  }
+  manifest_.update(std::filesystem::path(runPath_).filename().string(), [&](RunRecord& r) {
+    r.status = RunRecord::Status::Closed;
+    r.rawBytes = r.storedBytes = bytes;
+    r.stats = std::move(stats);
+  });
+  scheduleCompression();
+  compressor_.resume();
+}
+
+void Logger::attachTelemetry(TelemetryPublisher& telemetry) {
+  telemetry_ = &telemetry;
+  queueSlot_ = telemetry.addQueue("log-queue", buffer_->capacity());
+  threadSlot_ = telemetry.addThread("logger");
+}
+
+void Logger::setRunHeader(const std::string& key, std::string value) {
+  std::lock_guard lock(notesMtx_);
+  for (auto& [k, v] : headers_)
+    if (k == key) {
+      v = std::move(value);
+      return;
+    }
+  headers_.emplace_back(key, std::move(value));
+}
+
+void Logger::clearRunHeader(const std::string& key) {
+  std::lock_guard lock(notesMtx_);
+  std::erase_if(headers_, [&](const auto& h) { return h.first == key; });
+}
+
+void Logger::note(const std::string& key, const std::string& text) {
+  if (!running_.load(std::memory_order_acquire))
+    return;
+  std::lock_guard lock(notesMtx_);
+  notes_.push_back("# " + key + ": " + text + "\n");
+}
+
+void Logger::recordStats(std::span<const ChannelSummary> stats) {
+  if (!running_.load(std::memory_order_acquire))
+    return;
+  std::lock_guard lock(notesMtx_);
+  stats_.clear();
+  for (const auto& s : stats) {
+    const auto text = s.key + " " + s.toString();
+    notes_.push_back("# stats: " + text + "\n");
+    stats_ += (stats_.empty() ? "" : ";") + text;
+  }
+}
+
+void Logger::workerLoop() {
+  AllocationGuard::Exempt diskThread; // off the real-time path; notes and stdio may allocate
+  if (profile_)
+    profile_->apply(ThreadRole::Logger);
+
+  auto lastFlush = std::chrono::steady_clock::now();
+  LogEvent e;
+  for (;;) {
+    // read the flag first so nothing pushed before finishRun() is left behind
+    const bool stopping = !running_.load(std::memory_order_acquire);
+    bool idle = true;
+    while (buffer_->pop(e)) {
+      writeEvent(e);
+      idle = false;
+    }
+    while (blocks_->pop(block_)) {
+      writeBlock(block_);
+      idle = false;
+    }
+    drainEventBus();
+    drainNotes();
+
+    if (telemetry_) {
+      telemetry_->queueLevel(queueSlot_, buffer_->size(), dropped());
+      telemetry_->heartbeat(threadSlot_);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastFlush >= kFlushPeriod) {
+      file_.sync(); // group commit: at most one flush period is lost on a reset
+      index_.flush();
+      lastFlush = now;
+    }
+    if (stopping)
+      break;
+    if (idle)
+      std::this_thread::sleep_for(kIdleWait);
+  }
+  file_.flush();
+}
+
+void Logger::writeEvent(const LogEvent& e) {
+  char num[32];
+  line_.clear();
+  auto r = std::to_chars(num, num + sizeof(num), e.timestamp.count());
+  line_.append(num, r.ptr);
+  line_ += ',';
+  line_ += toString(e.type);
+  line_ += ',';
+  line_ += e.key;
+  line_ += ',';
+  r = std::to_chars(num, num + sizeof(num), e.value);
+  line_.append(num, r.ptr);
+  line_ += '\n';
+  index_.add(e.timestamp, e.type, file_.bytesWritten(), line_.size());
+  file_.write(line_);
+}
+
+void Logger::writeBlock(const SampleBlock& b) {
+  // as writeEvent(), but the value is printed as the float it is ("2.51", not "2.50999…")
+  char num[32];
+  const auto n = std::min<std::uint32_t>(b.count, SampleBlock::kSamples);
+  for (std::uint32_t i = 0; i < n; ++i) {
+    line_.clear();
+    auto r = std::to_chars(num, num + sizeof(num), b.t[i]);
+    line_.append(num, r.ptr);
+    line_ += ",sample,";
+    line_ += b.key;
+    line_ += ',';
+    r = std::to_chars(num, num + sizeof(num), b.v[i]);
+    line_.append(num, r.ptr);
+    line_ += '\n';
+    index_.add(std::chrono::nanoseconds{ b.t[i] }, LogEvent::Type::Sample, file_.bytesWritten(),
+               line_.size());
+    file_.write(line_);
+  }
+}
+
+void Logger::drainEventBus() {
+  if (!busCursor_.valid())
+    return;
+  SystemEvent ev;
+  while (busCursor_.poll(ev)) {
+    LogEvent e;
+    e.timestamp = ev.timestamp;
+    if (ev.kind == SystemEvent::Kind::StateChanged) {
+      e.type = LogEvent::Type::State;
+      const std::string_view to = toString(ev.to);
+      std::copy_n(to.data(), std::min(to.size(), LogEvent::kKeyLen), e.key);
+      e.value = static_cast<double>(ev.to);
+    } else {
+      e.type = LogEvent::Type::Error;
+      std::copy_n(ev.text, LogEvent::kKeyLen, e.key); // text is NUL-padded
+      std::replace_if(e.key, e.key + LogEvent::kKeyLen,
+                      [](char c) { return c == ',' || c == '\n'; }, ';');
+      e.value = static_cast<double>(ev.from);
+    }
+    writeEvent(e);
+  }
+}
+
+void Logger::drainNotes() {
+  std::vector<std::string> pending;
+  {
+    std::lock_guard lock(notesMtx_);
+    if (notes_.empty())
+      return;
+    pending.swap(notes_);
+  }
+  for (const auto& n : pending)
+    file_.write(n);
+}
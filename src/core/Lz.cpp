@@ -0,0 +1,149 @@
+/* @file Lz.cpp
+ * @brief Greedy single-probe LZ77 encoder and bounds-checked decoder.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+// MiLO headers
+#include "core/Lz.hpp"
+
+using namespace milo::core;
+
+namespace {
+  using byte = unsigned char;
+
+  constexpr std::size_t kMinMatch = 4;
+  constexpr std::size_t kMaxOffset = 65535;
+  constexpr unsigned kHashBits = 12;
+
+  std::uint32_t read32(const byte* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  std::uint32_t hash(std::uint32_t v) { return (v * 2654435761u) >> (32 - kHashBits); }
+
+  void putLength(byte*& op, std::size_t len) { // the part beyond the 15 in the token
+    len -= 15;
+    for (; len >= 255; len -= 255)
+      *op++ = 255;
+    *op++ = static_cast<byte>(len);
+  }
+
+  bool getLength(const byte*& ip, const byte* end, std::size_t& len, std::size_t limit) {
+    for (;;) {
+      if (ip == end || len > limit)
+        return false;
+      const byte b = *ip++;
+      len += b;
+      if (b != 255)
+        return true;
+    }
+  }
+
+  void putLiterals(byte*& op, const byte* lit, std::size_t n) {
+    std::memcpy(op, lit, n);
+    op += n;
+  }
+} // namespace
+
+std::size_t lz::compress(std::span<const char> in, std::span<char> out) {
+  const auto* const base = reinterpret_cast<const byte*>(in.data());
+  const auto* const end = base + in.size();
+  auto* op = reinterpret_cast<byte*>(out.data());
+  const auto* const obase = op;
+
+  std::array<std::uint32_t, 1u << kHashBits> table{};
+  const byte* anchor = base;
+  const byte* ip = base;
+
+  while (in.size() >= kMinMatch && ip <= end - kMinMatch) {
+    const auto seq = read32(ip);
+    const auto h = hash(seq);
+    const byte* ref = base + table[h];
+    table[h] = static_cast<std::uint32_t>(ip - base);
+    if (ref >= ip || static_cast<std::size_t>(ip - ref) > kMaxOffset || read32(ref) != seq) {
+      ++ip;
+      continue;
+    }
+
+    const byte* mp = ip + kMinMatch;
+    const byte* rp = ref + kMinMatch;
+    while (mp < end && *mp == *rp) {
+      ++mp;
+      ++rp;
+    }
+
+    const auto lit = static_cast<std::size_t>(ip - anchor);
+    const auto ml = static_cast<std::size_t>(mp - ip) - kMinMatch;
+    const auto offset = static_cast<std::size_t>(ip - ref);
+    byte* token = op++;
+    *token = static_cast<byte>((std::min<std::size_t>(lit, 15) << 4) | std::min<std::size_t>(ml, 15));
+    if (lit >= 15)
+      putLength(op, lit);
+    putLiterals(op, anchor, lit);
+    *op++ = static_cast<byte>(offset & 0xFF);
+    *op++ = static_cast<byte>(offset >> 8);
+    if (ml >= 15)
+      putLength(op, ml);
+
+    ip = anchor = mp;
+  }
+
+  // last sequence: the remaining literals, no match
+  const auto lit = static_cast<std::size_t>(end - anchor);
+  byte* token = op++;
+  *token = static_cast<byte>(std::min<std::size_t>(lit, 15) << 4);
+  if (lit >= 15)
+    putLength(op, lit);
+  putLiterals(op, anchor, lit);
+  return static_cast<std::size_t>(op - obase);
+}
+
+std::optional<std::size_t> lz::decompress(std::span<const char> in, std::span<char> out) {
+  const auto* ip = reinterpret_cast<const byte*>(in.data());
+  const auto* const iend = ip + in.size();
+  auto* op = reinterpret_cast<byte*>(out.data());
+  const auto* const obase = op;
+  const auto* const oend = op + out.size();
+
+  while (ip < iend) {
+    const byte token = *ip++;
+
+    std::size_t lit = token >> 4;
+    if (lit == 15 && !getLength(ip, iend, lit, out.size()))
+      return std::nullopt;
+    if (static_cast<std::size_t>(iend - ip) < lit || static_cast<std::size_t>(oend - op) < lit)
+      return std::nullopt;
+    std::memcpy(op, ip, lit);
+    ip += lit;
+    op += lit;
+    if (ip == iend)
+      break; // last sequence
+
+    if (iend - ip < 2)
+      return std::nullopt;
+    const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<std::size_t>(op - obase))
+      return std::nullopt;
+
+    std::size_t ml = token & 0x0F;
+    if (ml == 15 && !getLength(ip, iend, ml, out.size()))
+      return std::nullopt;
+    ml += kMinMatch;
+    if (static_cast<std::size_t>(oend - op) < ml)
+      return std::nullopt;
+    const byte* m = op - offset;
+    for (std::size_t i = 0; i < ml; ++i) // may overlap: byte-wise on purpose
+      *op++ = *m++;
+  }
+  return static_cast<std::size_t>(op - obase);
+}
@@ -0,0 +1,22 @@
+/* @file ParameterStore.cpp
+ * @brief Mutex-guarded parameter map.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// MiLO headers
+#include "core/ParameterStore.hpp"
+
+using namespace milo::core;
+
+void ParameterStore::set(Parameter p, float value) {
+  std::lock_guard lock(mtx_);
+  values_[p] = value;
+  version_.fetch_add(1, std::memory_order_release);
+}
+
+float ParameterStore::get(Parameter p) const {
+  std::lock_guard lock(mtx_);
+  auto it = values_.find(p);
+  return it == values_.end() ? 0.0f : it->second;
+}
@@ -0,0 +1,96 @@
+/* @file ProtocolExecutor.cpp
+ * @brief Ready queue, poll loop and idle wait of the coroutine protocol executor.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <stdexcept>
+
+// MiLO headers
+#include "core/ProtocolExecutor.hpp"
+
+using namespace milo::core;
+
+namespace {
+  constexpr std::size_t kReadyReserve = 64; ///< concurrent sub-sequences before the queue grows
+  /// Small chunks: the pool must not pre-carve more of a 16 KiB buffer than frames need.
+  constexpr std::pmr::pool_options kFramePools{ 4, 1024 };
+} // namespace
+
+ProtocolExecutor::ProtocolExecutor(std::span<std::byte> frames, Clock& clock,
+                                   std::chrono::microseconds pollPeriod)
+    : buffer_(frames.data(), frames.size()), frames_(kFramePools, &buffer_),
+      previous_(std::exchange(detail::frameResource, &frames_)), clock_(clock),
+      pollPeriod_(pollPeriod), wheel_(std::chrono::milliseconds{ 1 }, false, clock.now()),
+      ready_(&frames_), running_(&frames_) {
+  ready_.reserve(kReadyReserve);
+  running_.reserve(kReadyReserve);
+}
+
+ProtocolExecutor::~ProtocolExecutor() { detail::frameResource = previous_; }
+
+void ProtocolExecutor::schedule(std::coroutine_handle<> h) { ready_.push_back(h); }
+
+void ProtocolExecutor::armIn(Timer& t, Duration delay) {
+  wheel_.arm(t, clock_.now() + delay);
+}
+
+Task<void> ProtocolExecutor::whenAll(std::span<Task<void>> tasks) {
+  detail::JoinGroup group;
+  group.pending = tasks.size();
+  for (auto& t : tasks)
+    start(t.handle(), group);
+  co_await JoinAwaiter{ group };
+  for (auto& t : tasks)
+    t.result(); // first failure wins
+}
+
+void ProtocolExecutor::drive(std::coroutine_handle<> main) {
+  schedule(main);
+  while (!main.done()) {
+    running_.swap(ready_);
+    for (auto h : running_) {
+      ++resumptions_;
+      h.resume(); // never throws: task bodies store their exception in the promise
+    }
+    running_.clear();
+    if (main.done())
+      break;
+
+    const bool polled = pollAll();
+    wheel_.advance(clock_.now());
+    if (!polled && ready_.empty())
+      idle();
+  }
+}
+
+bool ProtocolExecutor::pollAll() {
+  bool any = false;
+  for (auto* p = pollers_; p;) {
+    auto* next = p->next();
+    if (p->poll()) {
+      p->unlink();
+      schedule(p->waiter);
+      any = true;
+    }
+    p = next;
+  }
+  return any;
+}
+
+void ProtocolExecutor::idle() {
+  auto wake = wheel_.nextDeadline();
+  if (pollers_) {
+    const Duration poll = clock_.now() + pollPeriod_;
+    wake = wake ? std::min(*wake, poll) : poll;
+  }
+  if (!wake)
+    throw std::logic_error("[ProtocolExecutor] every task is waiting and nothing can wake one");
+  if (streams_) {
+    streams_->pumpStreams();
+    wake = std::min(*wake, clock_.now() + streamPeriod_);
+  }
+  clock_.sleepUntil(*wake);
+}
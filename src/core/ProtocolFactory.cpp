@@ -0,0 +1,26 @@
+/* @file ProtocolFactory.cpp
+ * @brief Name → creator registry; protocol instances are built in the run arena.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <stdexcept>
+
+// MiLO headers
+#include "core/ProtocolFactory.hpp"
+#include "protocols/ExperimentProtocol.hpp"
+
+using namespace milo::core;
+
+bool ProtocolFactory::registerProtocol(const std::string &name, Creator maker) {
+  return creators_.emplace(name, std::move(maker)).second;
+}
+
+ArenaPtr<milo::protocols::ExperimentProtocol> ProtocolFactory::create(const std::string &name,
+                                                                      RunArena &arena) const {
+  auto it = creators_.find(name);
+  if (it == creators_.end())
+    throw std::out_of_range("[ProtocolFactory] unknown protocol: " + name);
+  return it->second(arena);
+}
@@ -5,19 +5,40 @@
  */
 
 // STL headers
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
 #include <string>
 
 // MiLO headers
+#include "core/AllocationGuard.hpp"
 #include "core/RPCManager.hpp"
+#include "core/RunStats.hpp"
+#include "core/SampleStream.hpp"
+#include "io/SerialCapture.hpp"
 #include "io/SerialChannel.hpp"
+#include "protocols/DeviceCommands.hpp"
 #include "protocols/Response.hpp"
 
 using namespace milo::core;
 
-RPCManager::RPCManager(std::shared_ptr<ErrorMonitor> errorMonitor)
-    : errorMonitor_(std::move(errorMonitor)) {
+static_assert(DeviceRegistry::kMaxDevices <= telemetry::kMaxDevices,
+              "every registered device needs a telemetry slot");
+
+namespace {
+  /// Command::toWire() frames CRLF; a channel speaking another codec appends its own terminator.
+  std::string_view frame(std::string_view wire, const milo::io::SerialChannel& ch) {
+    if (ch.terminator() != "\r\n" && wire.ends_with("\r\n"))
+      wire.remove_suffix(2);
+    return wire;
+  }
+} // namespace
+
+RPCManager::RPCManager(std::shared_ptr<ErrorMonitor> errorMonitor, DeviceRegistry devices)
+    : errorMonitor_(std::move(errorMonitor)), devices_(std::move(devices)) {
   assert(errorMonitor_ && "[RPCManager] error monitor is nullptr");
+  channels_.resize(devices_.size());
+  held_.resize(devices_.size());
 }
 
 void RPCManager::connect() {
@@ -25,67 +46,385 @@ void RPCManager::connect() {
     return;
 
   channels_.clear();
+  channels_.resize(devices_.size());
 
-  for (auto& [dev, path] : symlinks_) {
+  for (auto dev : devices_.all()) {
+    const auto& spec = devices_.spec(dev);
     auto ch = std::make_unique<io::SerialChannel>();
-    if (!ch->open(path, kDefaultBaud)) {
-      std::string errMsg =
-          std::string("[RPCManager] serial device: ") + toString(dev) + " open failed";
+    if (!ch->open(spec.path, spec.serial)) {
+      std::string errMsg = "[RPCManager] serial device: " + spec.name + " open failed";
       errorMonitor_->notifyFailure(errMsg);
       throw std::runtime_error(errMsg);
     }
-    channels_.emplace(dev, std::move(ch));
+    ch->setTerminator(terminator(spec.codec));
+    ch->setClock(*clock_);
+    channels_[dev.index] = std::move(ch);
   }
   //TODO: Logger hook
   connected_ = true;
 }
 
+void RPCManager::handshake(std::chrono::milliseconds timeout) {
+  using protocols::common::Ping;
+  const auto devices = devices_.all();
+  for (auto dev : devices)
+    sendCommand(dev, Ping::make<>());
+  const auto deadline = clock_->now() + timeout;
+  for (auto dev : devices)
+    awaitReply<Ping>(dev, std::max(std::chrono::milliseconds{ 0 },
+                                   std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       deadline - clock_->now())));
+}
+
+void RPCManager::attachChannel(Device dev, std::unique_ptr<io::SerialChannel> channel) {
+  if (!channel)
+    throw std::invalid_argument("[RPCManager] attachChannel: null channel");
+  if (!devices_.contains(dev))
+    throw std::invalid_argument("[RPCManager] attachChannel: unregistered device");
+  channel->setTerminator(terminator(devices_.spec(dev).codec));
+  channel->setClock(*clock_);
+  channels_[dev.index] = std::move(channel);
+  connected_ = true;
+}
+
+void RPCManager::setClock(Clock& clock) {
+  clock_ = &clock;
+  for (auto& ch : channels_)
+    if (ch)
+      ch->setClock(clock);
+}
+
+bool RPCManager::startCapture(const std::string& path) {
+  auto writer = io::CaptureWriter::create(path);
+  if (!writer) {
+    errorMonitor_->notifyFailure("[RPCManager] cannot create capture file: " + path);
+    return false;
+  }
+  for (auto dev : devices_.all())
+    if (auto* ch = channel(dev))
+      if (auto id = writer->addChannel(devices_.name(dev), ch->terminator()))
+        ch->attachCapture(writer, *id);
+  capture_ = std::move(writer);
+  return true;
+}
+
+void RPCManager::stopCapture() {
+  for (auto& ch : channels_)
+    if (ch)
+      ch->attachCapture(nullptr, 0);
+  capture_.reset(); // last reference: flush + close
+}
+
+void RPCManager::attachTimers(TimerWheel& wheel, std::chrono::milliseconds deadline) {
+  timers_ = &wheel;
+  inFlightDeadline_ = deadline;
+  inFlight_.clear();
+  inFlight_.reserve(devices_.size());
+  for (auto d : devices_.all())
+    inFlight_.push_back(std::make_unique<Timer>([this, d] {
+      AllocationGuard::Exempt coldPath;
+      errorMonitor_->notifyFailure("[RPCManager] no reply within deadline from serial device: " +
+                                   devices_.name(d));
+    }));
+}
+
+void RPCManager::attachTelemetry(TelemetryPublisher& telemetry) {
+  telemetry_ = &telemetry;
+  deviceTelemetry_.assign(devices_.size(), DeviceTelemetry{});
+  for (auto d : devices_.all())
+    deviceTelemetry_[d.index].slot = telemetry.addDevice(devices_.name(d));
+}
+
+void RPCManager::noteSent(Device dev) {
+  if (!telemetry_)
+    return;
+  if (dev.index < deviceTelemetry_.size()) {
+    auto& t = deviceTelemetry_[dev.index];
+    t.sentAt = clock_->now();
+    telemetry_->commandSent(t.slot);
+  }
+}
+
+void RPCManager::noteReply(Device dev) {
+  if (!telemetry_)
+    return;
+  if (dev.index < deviceTelemetry_.size()) {
+    const auto& t = deviceTelemetry_[dev.index];
+    telemetry_->replyReceived(t.slot, std::chrono::duration_cast<std::chrono::microseconds>(
+                                          clock_->now() - t.sentAt));
+  }
+}
+
+void RPCManager::noteError(Device dev) {
+  if (!telemetry_)
+    return;
+  if (dev.index < deviceTelemetry_.size())
+    telemetry_->deviceError(deviceTelemetry_[dev.index].slot);
+}
+
+void RPCManager::markInFlight(Device dev) {
+  if (!timers_)
+    return;
+  if (dev.index < inFlight_.size())
+    timers_->armAfter(*inFlight_[dev.index], inFlightDeadline_);
+}
+
+void RPCManager::clearInFlight(Device dev) {
+  if (dev.index < inFlight_.size())
+    inFlight_[dev.index]->cancel();
+}
+
 void RPCManager::sendCommand(Device dev, const protocols::Command& cmd) {
+  sendCommand(dev, std::string_view(cmd.toWire()));
+}
+
+void RPCManager::sendCommand(Device dev, std::string_view wire) {
 
   if (!connected_)
     throw std::runtime_error("[RPCManager] RPCmanager not connected");
 
-  auto it = channels_.find(dev);
-  if (it == channels_.end())
+  auto* ch = channel(dev);
+  if (!ch)
     throw std::invalid_argument("[RPCManager] send failed: unknown serial device");
-  auto cmdStr = cmd.toWire();
 
-  assert(cmdStr.size() <= 256 && "[RPCManager] command exceeds 256 byte threashold");
+  assert(wire.size() <= protocols::kMaxCommandBytes &&
+         "[RPCManager] command exceeds 256 byte threashold");
 
-  if (!it->second->writeLine(cmdStr)) {
-    std::string errMsg =
-        "[RPCManager] failed to write to serial device: " + std::string(toString(it->first));
+  if (!ch->writeLine(frame(wire, *ch))) {
+    noteError(dev);
+    AllocationGuard::Exempt coldPath; // the run is failing anyway
+    std::string errMsg = "[RPCManager] failed to write to serial device: " + devices_.name(dev);
     errorMonitor_->notifyFailure(errMsg);
     throw std::runtime_error(errMsg);
   }
 
-  //TODO: (Week 3) - recored an "in-flight" entry (device->timestamp) so that awaitResponse() can enforce round trip timeouts for now we skip this ashy
+  markInFlight(dev);
+  noteSent(dev);
 }
 
-milo::protocols::Response RPCManager::awaitResponse(Device dev, std::chrono::milliseconds timeout) {
+std::string RPCManager::awaitLine(Device dev, std::chrono::milliseconds timeout) {
 
   if (!connected_)
     throw std::logic_error("[RPCManager] not connected");
 
-  auto it = channels_.find(dev);
-  if (it == channels_.end())
+  auto* ch = channel(dev);
+  if (!ch)
     throw std::invalid_argument("[RPCManager] incorrect device input");
 
-  auto line = it->second->readLine(timeout);
-  if (!line.has_value()) {
-    std::string errMsg =
-        "[RPCManager] failed to read line from serial device: " + std::string(toString(it->first));
-    errorMonitor_->notifyFailure(errMsg);
-    throw std::runtime_error(errMsg);
+  auto line = readReply(dev, *ch, timeout);
+  clearInFlight(dev);
+  if (!line.has_value())
+    replyTimedOut(dev);
+  return std::move(*line);
+}
+
+std::optional<std::string> RPCManager::pollLine(Device dev) {
+
+  if (!connected_)
+    throw std::logic_error("[RPCManager] not connected");
+
+  auto* ch = channel(dev);
+  if (!ch)
+    throw std::invalid_argument("[RPCManager] incorrect device input");
+
+  auto line = readReply(dev, *ch, std::chrono::milliseconds{ 0 });
+  if (line)
+    clearInFlight(dev);
+  return line;
+}
+
+std::optional<std::string> RPCManager::readReply(Device dev, io::SerialChannel& ch,
+                                                 std::chrono::milliseconds timeout) {
+  if (dev.index < held_.size() && held_[dev.index]) {
+    std::optional<std::string> line = std::move(held_[dev.index]);
+    held_[dev.index].reset();
+    return line;
+  }
+  const auto deadline = clock_->now() + timeout;
+  for (;;) {
+    auto line = ch.readLine(timeout);
+    if (!line || !routeStream(dev, *line))
+      return line;
+    // a sample, not the reply: wait out what is left of the timeout
+    timeout = std::max(std::chrono::milliseconds{ 0 },
+                       std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+                                                                             clock_->now()));
+  }
+}
+
+bool RPCManager::routeStream(Device dev, const std::string& line) {
+  if (line.empty() || line.front() != stream::kMarker)
+    return false;
+  ++streamLines_;
+  if (!streams_ && !stats_)
+    return true;
+  if (const auto sample = stream::parse(line)) {
+    if (streams_)
+      streams_->add(dev, devices_.name(dev), sample->channel, clock_->now(), sample->value);
+    if (stats_)
+      stats_->add(dev, devices_.name(dev), sample->channel, sample->value);
   }
+  return true;
+}
 
-  auto parsedResponse = milo::protocols::Response::fromWire(*line);
+void RPCManager::noteValue(Device dev, std::string_view command, double value) {
+  if (!command.empty() && command.back() == '?')
+    command.remove_suffix(1);
+  stats_->add(dev, devices_.name(dev), command, value);
+}
+
+void RPCManager::pumpStreams() {
+  for (std::size_t i = 0; i < channels_.size() && i < held_.size(); ++i) {
+    auto* ch = channels_[i].get();
+    if (!ch || held_[i])
+      continue;
+    const Device dev{ static_cast<std::uint8_t>(i) };
+    while (auto line = ch->readLine(std::chrono::milliseconds{ 0 }))
+      if (!routeStream(dev, *line)) {
+        held_[i] = std::move(line);
+        break;
+      }
+  }
+}
+
+void RPCManager::flushStreams() {
+  if (connected_)
+    pumpStreams();
+  if (streams_)
+    streams_->flush();
+}
+
+void RPCManager::replyTimedOut(Device dev) {
+  clearInFlight(dev);
+  noteError(dev);
+  AllocationGuard::Exempt coldPath;
+  std::string errMsg = "[RPCManager] failed to read line from serial device: " + devices_.name(dev);
+  errorMonitor_->notifyFailure(errMsg);
+  throw std::runtime_error(errMsg);
+}
+
+milo::protocols::Response RPCManager::awaitResponse(Device dev, std::chrono::milliseconds timeout) {
+  return parseResponse(dev, awaitLine(dev, timeout));
+}
+
+std::optional<milo::protocols::Response> RPCManager::pollResponse(Device dev) {
+  const auto line = pollLine(dev);
+  if (!line)
+    return std::nullopt;
+  return parseResponse(dev, *line);
+}
+
+milo::protocols::Response RPCManager::parseResponse(Device dev, const std::string& line) {
+  auto parsedResponse = milo::protocols::Response::fromWire(line);
 
   if (!parsedResponse.has_value()) {
+    noteError(dev);
+    AllocationGuard::Exempt coldPath;
     errorMonitor_->notifyFailure("[RPCManager] response parsing failed");
     throw std::runtime_error("[RPCManager] response parse failed");
   }
 
+  noteReply(dev);
   return *parsedResponse;
 }
 
+void RPCManager::rejectReply(Device dev, std::string_view command, const std::string& line) {
+  noteError(dev);
+  AllocationGuard::Exempt coldPath;
+  std::string errMsg = "[RPCManager] " + devices_.name(dev) + " rejected " + std::string(command) +
+                       ": " + line;
+  errorMonitor_->notifyFailure(errMsg);
+  throw std::runtime_error(errMsg);
+}
+
+BatchReport RPCManager::scatterGather(std::span<const BatchRequest> batch,
+                                      std::chrono::milliseconds timeout,
+                                      std::optional<std::chrono::microseconds> maxSkew,
+                                      std::pmr::memory_resource* mr) {
+  if (!connected_)
+    throw std::logic_error("[RPCManager] not connected");
+
+  // per-call scratch on the stack; only an oversized batch spills to the heap
+  std::array<std::byte, 2048> scratchBuf;
+  std::pmr::monotonic_buffer_resource scratch(scratchBuf.data(), scratchBuf.size());
+
+  // validate the whole batch before touching the wire - a half-sent batch is worse than none
+  std::pmr::vector<io::SerialChannel*> chans(&scratch);
+  std::pmr::vector<std::pmr::string> wire(&scratch);
+  chans.reserve(batch.size());
+  wire.reserve(batch.size());
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    auto* ch = channel(batch[i].dev);
+    if (!ch)
+      throw std::invalid_argument("[RPCManager] batch failed: unknown serial device");
+    for (std::size_t j = 0; j < i; ++j)
+      if (batch[j].dev == batch[i].dev)
+        throw std::invalid_argument("[RPCManager] batch failed: duplicate device " +
+                                    devices_.name(batch[i].dev));
+    chans.push_back(ch);
+    wire.push_back(batch[i].cmd.toWire(&scratch));
+    assert(wire.back().size() <= protocols::kMaxCommandBytes &&
+           "[RPCManager] command exceeds 256 byte threashold");
+  }
+
+  BatchReport report{ std::pmr::vector<BatchResult>(mr) };
+  report.results.reserve(batch.size());
+  std::pmr::vector<Clock::Duration> sentAt(batch.size(), &scratch);
+
+  // --- scatter ---------------------------------------------------------------
+  const auto firstWrite = clock_->now();
+  auto lastWrite = firstWrite;
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    BatchResult res{ batch[i].dev };
+    res.sent = chans[i]->writeLine(frame(wire[i], *chans[i]));
+    sentAt[i] = lastWrite = clock_->now();
+    if (res.sent) {
+      markInFlight(batch[i].dev);
+      noteSent(batch[i].dev);
+    } else {
+      noteError(batch[i].dev);
+      AllocationGuard::Exempt coldPath;
+      errorMonitor_->notifyFailure("[RPCManager] failed to write to serial device: " +
+                                   devices_.name(batch[i].dev));
+    }
+    report.results.push_back(std::move(res));
+  }
+  report.writeSkew = std::chrono::duration_cast<std::chrono::microseconds>(lastWrite - firstWrite);
+
+  if (maxSkew && report.writeSkew > *maxSkew) {
+    AllocationGuard::Exempt coldPath;
+    report.skewExceeded = true;
+    errorMonitor_->notifyFailure("[RPCManager] synchronized start exceeded skew window");
+  }
+
+  // --- gather (single deadline for the whole batch) --------------------------
+  const auto deadline = firstWrite + timeout;
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    auto& res = report.results[i];
+    if (!res.sent)
+      continue;
+
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock_->now());
+    auto line = readReply(res.dev, *chans[i], std::max(left, std::chrono::milliseconds{ 0 }));
+    clearInFlight(res.dev);
+    if (!line.has_value()) {
+      noteError(res.dev);
+      AllocationGuard::Exempt coldPath;
+      errorMonitor_->notifyFailure("[RPCManager] failed to read line from serial device: " +
+                                   devices_.name(res.dev));
+      continue;
+    }
+    res.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock_->now() - sentAt[i]);
+
+    res.response = protocols::Response::fromWire(*line);
+    if (res.response.has_value()) {
+      noteReply(res.dev);
+    } else {
+      noteError(res.dev);
+      AllocationGuard::Exempt coldPath;
+      errorMonitor_->notifyFailure("[RPCManager] response parsing failed");
+    }
+  }
+
+  return report;
+}
@@ -0,0 +1,48 @@
+/* @file RunArena.cpp
+ * @brief Buffer setup, metering and reset of the per-run arena.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <span>
+
+// MiLO headers
+#include "core/RunArena.hpp"
+#include "core/RuntimeProfile.hpp"
+
+using namespace milo::core;
+
+RunArena::RunArena(std::size_t capacity)
+    : capacity_(capacity), storage_(std::make_unique<std::byte[]>(capacity)),
+      mono_(storage_.get(), capacity, &spill_), pool_(&meter_) {
+  // make_unique value-initialises, so the pages are already touched; keep them resident
+  RuntimeProfile::prefault(std::span(storage_.get(), capacity_));
+}
+
+void RunArena::reset() {
+  pool_.release();
+  mono_.release();
+  meter_.bytes = 0;
+}
+
+void* RunArena::Meter::do_allocate(std::size_t n, std::size_t a) {
+  void* p = upstream->allocate(n, a);
+  bytes += n;
+  peak = std::max(peak, bytes);
+  return p;
+}
+
+void RunArena::Meter::do_deallocate(void* p, std::size_t n, std::size_t a) {
+  upstream->deallocate(p, n, a); // monotonic: no-op until reset()
+}
+
+void* RunArena::Spill::do_allocate(std::size_t n, std::size_t a) {
+  ++count;
+  return std::pmr::new_delete_resource()->allocate(n, a);
+}
+
+void RunArena::Spill::do_deallocate(void* p, std::size_t n, std::size_t a) {
+  std::pmr::new_delete_resource()->deallocate(p, n, a);
+}
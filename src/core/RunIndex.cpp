@@ -0,0 +1,171 @@
+/* @file RunIndex.cpp
+ * @brief Index blocks on the logger thread; window and per-type queries over the blocks.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+// MiLO headers
+#include "core/LogCompressor.hpp"
+#include "core/RunIndex.hpp"
+
+using namespace milo::core;
+
+namespace {
+  constexpr char kMagic[8] = { 'M', 'I', 'L', 'O', 'I', 'D', 'X', '1' };
+  static_assert(std::is_trivially_copyable_v<IndexEntry> && sizeof(IndexEntry) == 48,
+                "index entries are stored as raw records");
+
+  /// Calls \p fn(line, timestamp, type) for every event line of \p text.
+  template <typename Fn> void forEachEvent(std::string_view text, Fn&& fn) {
+    while (!text.empty()) {
+      const auto eol = text.find('\n');
+      const auto line = text.substr(0, eol);
+      text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+      if (eol == std::string_view::npos || line.empty() || line[0] == '#')
+        continue; // unterminated tail of a range, notes, header
+      std::int64_t ts = 0;
+      const auto [p, ec] = std::from_chars(line.data(), line.data() + line.size(), ts);
+      if (ec != std::errc{} || p == line.data() + line.size() || *p != ',')
+        continue; // column header
+      auto rest = line.substr(static_cast<std::size_t>(p - line.data()) + 1);
+      fn(line, ts, rest.substr(0, rest.find(',')));
+    }
+  }
+} // namespace
+
+// ─── writer ──────────────────────────────────────────────────────────────────
+bool RunIndexWriter::open(const std::string& path) {
+  close();
+  fp_ = std::fopen(path.c_str(), "we");
+  if (!fp_)
+    return false;
+  std::fwrite(kMagic, 1, sizeof(kMagic), fp_);
+  records_ = 0;
+  return true;
+}
+
+void RunIndexWriter::add(std::chrono::nanoseconds timestamp, LogEvent::Type type,
+                         std::uint64_t offset, std::size_t length) {
+  if (!fp_)
+    return;
+  const auto ts = static_cast<std::int64_t>(timestamp.count());
+  if (records_ >= kEveryRecords ||
+      (records_ > 0 && ts - block_.firstNs >= std::chrono::nanoseconds{ kEveryPeriod }.count()))
+    emit();
+  if (records_ == 0) {
+    block_ = {};
+    block_.firstNs = block_.lastNs = ts;
+    block_.offset = offset;
+  }
+  // streamed samples reach the log a block late: keep the block's true time span
+  block_.firstNs = std::min(block_.firstNs, ts);
+  block_.lastNs = std::max(block_.lastNs, ts);
+  block_.length = static_cast<std::uint32_t>(offset + length - block_.offset);
+  ++block_.counts[static_cast<std::size_t>(type)];
+  ++records_;
+}
+
+void RunIndexWriter::emit() {
+  std::fwrite(&block_, sizeof(block_), 1, fp_);
+  records_ = 0;
+}
+
+void RunIndexWriter::flush() {
+  if (fp_)
+    std::fflush(fp_);
+}
+
+void RunIndexWriter::close() {
+  if (!fp_)
+    return;
+  if (records_)
+    emit();
+  std::fclose(fp_);
+  fp_ = nullptr;
+}
+
+// ─── queries ─────────────────────────────────────────────────────────────────
+std::optional<RunIndex> RunIndex::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::nullopt;
+  char magic[sizeof(kMagic)];
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    return std::nullopt;
+  RunIndex idx;
+  IndexEntry e;
+  while (in.read(reinterpret_cast<char*>(&e), sizeof(e))) // a torn last entry is dropped
+    idx.entries_.push_back(e);
+  return idx;
+}
+
+std::optional<RunIndex> RunIndex::forRun(const std::string& logDir, const RunRecord& run) {
+  if (run.index.empty())
+    return std::nullopt;
+  return load(logDir + "/" + run.index);
+}
+
+std::vector<std::string> RunIndex::window(const std::string& logPath,
+                                          std::chrono::nanoseconds from,
+                                          std::chrono::nanoseconds to) const {
+  std::vector<std::string> out;
+  const auto lo = static_cast<std::int64_t>(from.count());
+  const auto hi = static_cast<std::int64_t>(to.count());
+  auto keep = [&](std::string_view line, std::int64_t ts, std::string_view) {
+    if (ts >= lo && ts <= hi)
+      out.emplace_back(line);
+  };
+
+  // block ranges overlap where late samples landed, so neither end is sorted: test each one
+  const auto hit = [&](const IndexEntry& e) { return e.firstNs <= hi && e.lastNs >= lo; };
+  for (auto it = std::find_if(entries_.begin(), entries_.end(), hit); it != entries_.end();
+       it = std::find_if(it, entries_.end(), hit)) {
+    auto run = it; // adjacent blocks in the window are read in one go
+    while (std::next(run) != entries_.end() && hit(*std::next(run)))
+      ++run;
+    const auto end = run->offset + run->length;
+    if (auto text = LogCompressor::readRange(logPath, it->offset, end - it->offset))
+      forEachEvent(*text, keep);
+    it = std::next(run);
+  }
+  // the unindexed tail may hold events of any window, late samples included
+  if (auto text = LogCompressor::readRange(logPath, indexedBytes(), UINT64_MAX))
+    forEachEvent(*text, keep);
+  return out;
+}
+
+std::vector<std::string> RunIndex::ofType(const std::string& logPath, LogEvent::Type type) const {
+  std::vector<std::string> out;
+  const std::string_view want = toString(type);
+  auto keep = [&](std::string_view line, std::int64_t, std::string_view t) {
+    if (t == want)
+      out.emplace_back(line);
+  };
+
+  const auto k = static_cast<std::size_t>(type);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->counts[k] == 0) {
+      ++it;
+      continue;
+    }
+    auto run = it; // adjacent blocks with hits are read in one go
+    while (std::next(run) != entries_.end() && std::next(run)->counts[k] != 0)
+      ++run;
+    const auto end = run->offset + run->length;
+    if (auto text = LogCompressor::readRange(logPath, it->offset, end - it->offset))
+      forEachEvent(*text, keep);
+    it = std::next(run);
+  }
+  if (auto text = LogCompressor::readRange(logPath, indexedBytes(), UINT64_MAX))
+    forEachEvent(*text, keep);
+  return out;
+}
@@ -0,0 +1,154 @@
+/* @file RunManifest.cpp
+ * @brief Line-per-run manifest, rewritten atomically (temp file + rename).
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+// MiLO headers
+#include "core/FsSync.hpp"
+#include "core/RunManifest.hpp"
+
+using namespace milo::core;
+
+namespace {
+  std::uint64_t toU64(std::string_view s) {
+    std::uint64_t v = 0;
+    std::from_chars(s.data(), s.data() + s.size(), v);
+    return v;
+  }
+} // namespace
+
+const char* milo::core::toString(RunRecord::Status s) {
+  switch (s) {
+  case RunRecord::Status::Open:
+    return "open";
+  case RunRecord::Status::Closed:
+    return "closed";
+  case RunRecord::Status::Interrupted:
+    return "interrupted";
+  }
+  return "unknown";
+}
+
+RunManifest::RunManifest(std::string logDir)
+    : dir_(std::move(logDir)), path_((std::filesystem::path(dir_) / kFileName).string()) {
+  load();
+}
+
+void RunManifest::load() {
+  std::ifstream in(path_);
+  for (std::string line; std::getline(in, line);) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    RunRecord r;
+    std::string_view rest = line;
+    while (!rest.empty()) {
+      const auto tab = rest.find('\t');
+      const auto field = rest.substr(0, tab);
+      rest = tab == std::string_view::npos ? std::string_view{} : rest.substr(tab + 1);
+      const auto eq = field.find('=');
+      if (eq == std::string_view::npos)
+        continue;
+      const auto key = field.substr(0, eq);
+      const auto value = field.substr(eq + 1);
+      if (key == "run")
+        r.name = value;
+      else if (key == "status")
+        r.status = value == "open"          ? RunRecord::Status::Open
+                   : value == "interrupted" ? RunRecord::Status::Interrupted
+                                            : RunRecord::Status::Closed;
+      else if (key == "raw")
+        r.rawBytes = toU64(value);
+      else if (key == "stored")
+        r.storedBytes = toU64(value);
+      else if (key == "file")
+        r.stored = value;
+      else if (key == "index")
+        r.index = value;
+      else if (key == "stats")
+        r.stats = value;
+    }
+    if (r.name.empty())
+      continue;
+    if (r.stored.empty())
+      r.stored = r.name;
+    runs_.push_back(std::move(r));
+  }
+}
+
+void RunManifest::saveLocked() const {
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  const auto tmp = path_ + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    out << "# milo run manifest v1\n";
+    for (const auto& r : runs_) {
+      out << "run=" << r.name << "\tstatus=" << toString(r.status) << "\traw=" << r.rawBytes
+          << "\tstored=" << r.storedBytes << "\tfile=" << r.stored;
+      if (!r.index.empty())
+        out << "\tindex=" << r.index;
+      if (!r.stats.empty())
+        out << "\tstats=" << r.stats;
+      out << '\n';
+    }
+    if (!out.flush())
+      return; // keep the previous manifest rather than a truncated one
+  }
+  // data, then name: a power cut leaves the old manifest or the new one, never an empty file
+  if (!syncFile(tmp) || std::rename(tmp.c_str(), path_.c_str()) != 0)
+    return;
+  syncDirectory(dir_);
+}
+
+void RunManifest::put(const RunRecord& rec) {
+  RunRecord normalized = rec;
+  if (normalized.stored.empty())
+    normalized.stored = normalized.name;
+
+  std::lock_guard lock(mtx_);
+  auto it = std::find_if(runs_.begin(), runs_.end(),
+                         [&](const RunRecord& r) { return r.name == rec.name; });
+  if (it != runs_.end())
+    *it = std::move(normalized);
+  else
+    runs_.push_back(std::move(normalized));
+  saveLocked();
+}
+
+bool RunManifest::erase(const std::string& name) {
+  std::lock_guard lock(mtx_);
+  const auto n = std::erase_if(runs_, [&](const RunRecord& r) { return r.name == name; });
+  if (n)
+    saveLocked();
+  return n != 0;
+}
+
+std::optional<RunRecord> RunManifest::find(const std::string& name) const {
+  std::lock_guard lock(mtx_);
+  for (const auto& r : runs_)
+    if (r.name == name)
+      return r;
+  return std::nullopt;
+}
+
+std::vector<RunRecord> RunManifest::runs() const {
+  std::lock_guard lock(mtx_);
+  return runs_;
+}
+
+std::uint64_t RunManifest::storedBytes() const {
+  std::lock_guard lock(mtx_);
+  std::uint64_t total = 0;
+  for (const auto& r : runs_)
+    total += r.storedBytes;
+  return total;
+}
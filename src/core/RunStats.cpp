@@ -0,0 +1,131 @@
+/* @file RunStats.cpp
+ * @brief Welford moments, the log-bucket quantile sketch and the per-channel run summary.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// MiLO headers
+#include "core/RunStats.hpp"
+
+using namespace milo::core;
+
+namespace {
+  constexpr double kGamma =
+      (1.0 + QuantileSketch::kRelativeError) / (1.0 - QuantileSketch::kRelativeError);
+  const double kLogGamma = std::log(kGamma);
+
+  std::size_t bucketOf(double magnitude) {
+    const auto i = std::ceil(std::log(magnitude / QuantileSketch::kMinMagnitude) / kLogGamma);
+    return static_cast<std::size_t>(
+        std::clamp(i, 0.0, static_cast<double>(QuantileSketch::kBuckets - 1)));
+  }
+
+  /// Midpoint of bucket \p i (within kRelativeError of everything counted in it).
+  double valueOf(std::size_t i) {
+    return QuantileSketch::kMinMagnitude * 2.0 * std::pow(kGamma, static_cast<double>(i)) /
+           (kGamma + 1.0);
+  }
+} // namespace
+
+// ─── RunningStats ────────────────────────────────────────────────────────────
+double RunningStats::stddev() const { return std::sqrt(variance()); }
+
+// ─── QuantileSketch ──────────────────────────────────────────────────────────
+void QuantileSketch::add(double v) {
+  ++count_;
+  const double magnitude = std::fabs(v);
+  if (!(magnitude >= kMinMagnitude)) { // NaN lands here too
+    ++zero_;
+    return;
+  }
+  ++(v > 0 ? positive_ : negative_)[bucketOf(magnitude)];
+}
+
+double QuantileSketch::quantile(double q) const {
+  if (count_ == 0)
+    return 0.0;
+  const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) *
+                                               static_cast<double>(count_ - 1));
+  std::uint64_t seen = 0;
+  for (std::size_t i = kBuckets; i-- > 0;) { // most negative first
+    seen += negative_[i];
+    if (seen > rank)
+      return -valueOf(i);
+  }
+  seen += zero_;
+  if (seen > rank)
+    return 0.0;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    seen += positive_[i];
+    if (seen > rank)
+      return valueOf(i);
+  }
+  return valueOf(kBuckets - 1);
+}
+
+// ─── ChannelSummary ──────────────────────────────────────────────────────────
+std::string ChannelSummary::toString() const {
+  char buf[192];
+  std::snprintf(buf, sizeof(buf), "n=%llu mean=%.6g sd=%.4g min=%.6g max=%.6g p50=%.4g "
+                "p95=%.4g p99=%.4g",
+                static_cast<unsigned long long>(count), mean, stddev, min, max, p50, p95, p99);
+  return buf;
+}
+
+// ─── RunStats ────────────────────────────────────────────────────────────────
+RunStats::RunStats() : channels_(kMaxChannels) {}
+
+int RunStats::channel(Device dev, std::string_view deviceName, std::string_view channel) {
+  for (std::size_t i = 0; i < used_; ++i)
+    if (channels_[i].key.matches(dev, channel))
+      return static_cast<int>(i);
+  if (used_ == kMaxChannels)
+    return -1;
+  channels_[used_].key = ChannelKey(dev, deviceName, channel);
+  return static_cast<int>(used_++);
+}
+
+void RunStats::add(int channel, double value) {
+  if (channel < 0 || static_cast<std::size_t>(channel) >= used_) {
+    ++dropped_;
+    return;
+  }
+  auto& ch = channels_[static_cast<std::size_t>(channel)];
+  ch.stats.add(value);
+  ch.sketch.add(value);
+}
+
+bool RunStats::add(Device dev, std::string_view deviceName, std::string_view channel,
+                   double value) {
+  const int i = this->channel(dev, deviceName, channel);
+  add(i, value);
+  return i >= 0;
+}
+
+void RunStats::reset() {
+  for (std::size_t i = 0; i < used_; ++i)
+    channels_[i] = Channel{};
+  used_ = 0;
+  dropped_ = 0;
+}
+
+std::vector<ChannelSummary> RunStats::summary() const {
+  std::vector<ChannelSummary> out;
+  out.reserve(used_);
+  for (std::size_t i = 0; i < used_; ++i) {
+    const auto& ch = channels_[i];
+    const auto& s = ch.stats;
+    if (s.count() == 0)
+      continue;
+    // the sketch is only ±1 %: never report a quantile outside what was actually seen
+    const auto q = [&](double p) { return std::clamp(ch.sketch.quantile(p), s.min(), s.max()); };
+    out.push_back({ std::string(ch.key.view()), s.count(), s.mean(), s.stddev(), s.min(), s.max(), q(0.50), q(0.95),
+                    q(0.99) });
+  }
+  return out;
+}
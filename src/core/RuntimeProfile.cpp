@@ -0,0 +1,192 @@
+/* @file RuntimeProfile.cpp
+ * @brief SCHED_FIFO/affinity/mlockall setup and the cyclictest-style wake-up check.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+// Linux headers
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/RuntimeProfile.hpp"
+
+using namespace milo::core;
+
+namespace {
+  const char* policyName(int policy) {
+    switch (policy) {
+    case SCHED_FIFO:
+      return "fifo";
+    case SCHED_RR:
+      return "rr";
+    case SCHED_IDLE:
+      return "idle";
+    default:
+      return "other";
+    }
+  }
+
+  std::size_t pageSize() {
+    static const auto sz = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return sz;
+  }
+
+  std::string us(std::chrono::nanoseconds ns) {
+    return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(ns).count()) +
+           "us";
+  }
+} // namespace
+
+std::optional<int> RuntimeProfile::parsePolicy(std::string_view name) {
+  if (name == "fifo")
+    return SCHED_FIFO;
+  if (name == "rr")
+    return SCHED_RR;
+  if (name == "other")
+    return SCHED_OTHER;
+  if (name == "idle")
+    return SCHED_IDLE;
+  return std::nullopt;
+}
+
+bool RuntimeProfile::lockMemory() const {
+  if (!cfg_.lockMemory)
+    return true;
+  // freed heap stays mapped and big blocks come from the (locked) heap, not fresh mmaps
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+  return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+}
+
+bool RuntimeProfile::apply(ThreadRole role) const {
+  const auto& p = cfg_[role];
+  bool ok = true;
+
+  if (cfg_.realtime) {
+    sched_param sp{};
+    sp.sched_priority = (p.policy == SCHED_FIFO || p.policy == SCHED_RR) ? p.priority : 0;
+    ok = pthread_setschedparam(pthread_self(), p.policy, &sp) == 0;
+  }
+
+  if (p.cpu >= 0 && p.cpu < CPU_SETSIZE &&
+      static_cast<long>(p.cpu) < sysconf(_SC_NPROCESSORS_ONLN)) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<std::size_t>(p.cpu), &set);
+    ok = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 && ok;
+  }
+
+  prefaultStack(cfg_.stackPrefault);
+  return ok;
+}
+
+void RuntimeProfile::prefaultStack(std::size_t bytes) {
+  if (bytes == 0)
+    return;
+  auto* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+  for (std::size_t i = 0; i < bytes; i += pageSize())
+    stack[i] = 0;
+}
+
+void RuntimeProfile::prefault(std::span<std::byte> buffer) {
+  auto* p = reinterpret_cast<volatile std::byte*>(buffer.data());
+  for (std::size_t i = 0; i < buffer.size(); i += pageSize())
+    p[i] = p[i];
+}
+
+JitterReport RuntimeProfile::measureJitter(ThreadRole role) const {
+  JitterReport report;
+  std::thread probe([&] {
+    apply(role);
+    report = measureJitterHere(cfg_.jitterPeriod, cfg_.jitterSamples);
+  });
+  probe.join();
+  report.role = toString(role);
+  const auto& p = cfg_[role];
+  if (cfg_.realtime)
+    report.role += std::string("/") + policyName(p.policy) + "/" + std::to_string(p.priority);
+  return report;
+}
+
+JitterReport RuntimeProfile::measureJitterHere(std::chrono::microseconds period,
+                                               std::size_t samples) {
+  JitterReport report;
+  report.period = period;
+  if (samples == 0 || period.count() <= 0)
+    return report;
+
+  std::vector<std::int64_t> lat(samples);
+  prefault(std::as_writable_bytes(std::span(lat)));
+
+  const auto periodNs = std::chrono::nanoseconds{ period }.count();
+  timespec next{};
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  auto toNs = [](const timespec& t) { return std::int64_t{ t.tv_sec } * 1'000'000'000 + t.tv_nsec; };
+  auto target = toNs(next);
+
+  for (std::size_t i = 0; i < samples; ++i) {
+    target += periodNs;
+    next.tv_sec = static_cast<time_t>(target / 1'000'000'000);
+    next.tv_nsec = static_cast<long>(target % 1'000'000'000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR) {
+    }
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const auto late = toNs(now) - target;
+    lat[i] = late;
+    if (late >= periodNs) { // missed whole periods: resynchronise instead of firing a burst
+      report.overruns += static_cast<std::size_t>(late / periodNs);
+      target += (late / periodNs) * periodNs;
+    }
+  }
+
+  const auto [mn, mx] = std::minmax_element(lat.begin(), lat.end());
+  report.samples = samples;
+  report.min = std::chrono::nanoseconds{ *mn };
+  report.max = std::chrono::nanoseconds{ *mx };
+  report.mean = std::chrono::nanoseconds{ std::accumulate(lat.begin(), lat.end(), std::int64_t{ 0 }) /
+                                          static_cast<std::int64_t>(samples) };
+  auto p99 = lat.begin() + static_cast<std::ptrdiff_t>((samples * 99) / 100);
+  if (p99 == lat.end())
+    --p99;
+  std::nth_element(lat.begin(), p99, lat.end());
+  report.p99 = std::chrono::nanoseconds{ *p99 };
+  return report;
+}
+
+std::string RuntimeProfile::describe() const {
+  std::string out;
+  for (auto role : kThreadRoles) {
+    const auto& p = cfg_[role];
+    if (!out.empty())
+      out += ' ';
+    out += toString(role);
+    out += '=';
+    out += cfg_.realtime ? policyName(p.policy) : "other";
+    if (cfg_.realtime && (p.policy == SCHED_FIFO || p.policy == SCHED_RR))
+      out += "/" + std::to_string(p.priority);
+    if (p.cpu >= 0)
+      out += "@cpu" + std::to_string(p.cpu);
+  }
+  out += cfg_.lockMemory ? " mlock=on" : " mlock=off";
+  return out;
+}
+
+std::string JitterReport::toString() const {
+  return "period=" + std::to_string(period.count()) + "us n=" + std::to_string(samples) +
+         " min=" + us(min) + " avg=" + us(mean) + " p99=" + us(p99) + " max=" + us(max) +
+         " overruns=" + std::to_string(overruns) + (role.empty() ? "" : " thread=" + role);
+}
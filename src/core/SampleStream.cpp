@@ -0,0 +1,197 @@
+/* @file SampleStream.cpp
+ * @brief Stream-line parsing, columnar rings, min/max buckets and the Logger/telemetry/OLED
+ *        fan-out of streamed samples.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// MiLO headers
+#include "core/Logger.hpp"
+#include "core/SampleStream.hpp"
+#include "core/Telemetry.hpp"
+
+using namespace milo::core;
+
+// ─── line format ─────────────────────────────────────────────────────────────
+std::optional<stream::Line> stream::parse(std::string_view line) {
+  if (line.empty() || line.front() != kMarker)
+    return std::nullopt;
+  while (!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' '))
+    line.remove_suffix(1);
+
+  const auto space = line.find(' ');
+  if (space == std::string_view::npos || space == 1)
+    return std::nullopt;
+  Line out{ line.substr(1, space - 1) };
+  const auto* first = line.data() + space + 1;
+  const auto* last = line.data() + line.size();
+  const auto [end, ec] = std::from_chars(first, last, out.value);
+  if (ec != std::errc{} || end != last || first == last)
+    return std::nullopt;
+  return out;
+}
+
+// ─── SampleColumns ───────────────────────────────────────────────────────────
+SampleColumns::SampleColumns(std::size_t capacity) {
+  std::size_t cap = SampleBlock::kSamples;
+  while (cap < capacity)
+    cap <<= 1;
+  t_ = std::make_unique<std::int64_t[]>(cap);
+  v_ = std::make_unique<float[]>(cap);
+  mask_ = cap - 1;
+}
+
+std::size_t SampleColumns::run(std::uint64_t seq, std::size_t max) const {
+  const auto available = static_cast<std::size_t>(written_ - seq);
+  const auto toWrap = capacity() - index(seq);
+  return std::min({ max, available, toWrap });
+}
+
+// ─── MinMaxView ──────────────────────────────────────────────────────────────
+MinMaxView::MinMaxView(Clock::Duration bucket)
+    : bucketNs_(std::max<std::int64_t>(1, bucket.count())) {}
+
+bool MinMaxView::add(std::int64_t tNs, float value) {
+  last_ = value;
+  const auto bucket = tNs / bucketNs_;
+  if (filled_ == 0) {
+    current_ = bucket;
+    ring_[head_] = MinMax{};
+    ring_[head_].add(value);
+    filled_ = 1;
+    return false;
+  }
+  if (bucket <= current_) { // same bucket (or a late sample: counted in the newest)
+    ring_[head_].add(value);
+    return false;
+  }
+
+  // open the new bucket, leaving empty ones for a gap (at most a full screen of them)
+  const auto steps = std::min<std::int64_t>(bucket - current_, StreamView::kBuckets);
+  for (std::int64_t i = 0; i < steps; ++i) {
+    head_ = (head_ + 1) % StreamView::kBuckets;
+    ring_[head_] = MinMax{};
+  }
+  filled_ = static_cast<std::uint32_t>(
+      std::min<std::int64_t>(filled_ + steps, StreamView::kBuckets));
+  current_ = bucket;
+  ring_[head_].add(value);
+  return true;
+}
+
+void MinMaxView::copyTo(StreamView& out) const {
+  out.bucketNs = bucketNs_;
+  out.endNs = (current_ + 1) * bucketNs_;
+  out.last = last_;
+  out.filled = filled_;
+  const auto first = (head_ + StreamView::kBuckets + 1 - filled_) % StreamView::kBuckets;
+  for (std::uint32_t i = 0; i < filled_; ++i)
+    out.buckets[i] = ring_[(first + i) % StreamView::kBuckets];
+  std::fill(out.buckets + filled_, out.buckets + StreamView::kBuckets, MinMax{});
+}
+
+// ─── SampleStreams ───────────────────────────────────────────────────────────
+SampleStreams::SampleStreams() : SampleStreams(Options{}) {}
+
+SampleStreams::SampleStreams(Options options) : options_(std::move(options)) {
+  channels_.reserve(kMaxChannels);
+  for (std::size_t i = 0; i < kMaxChannels; ++i)
+    channels_.emplace_back(options_.samplesPerChannel, options_.bucket);
+}
+
+SampleStreams::~SampleStreams() = default;
+
+std::optional<std::size_t> SampleStreams::find(std::string_view key) const {
+  for (std::size_t i = 0; i < used_; ++i)
+    if (key == channels_[i].key.view())
+      return i;
+  return std::nullopt;
+}
+
+SampleStreams::Channel* SampleStreams::claim(Device dev, std::string_view deviceName,
+                                             std::string_view channel) {
+  for (std::size_t i = 0; i < used_; ++i)
+    if (channels_[i].key.matches(dev, channel))
+      return &channels_[i];
+  if (used_ == kMaxChannels)
+    return nullptr;
+
+  auto& ch = channels_[used_];
+  ch.key = ChannelKey(dev, deviceName, channel);
+
+  if (telemetry_)
+    ch.slot = telemetry_->addStream(ch.key.view());
+  if (!displayed_ && (options_.display.empty() || options_.display == ch.key.view()))
+    displayed_ = used_;
+  ++used_;
+  return &ch;
+}
+
+bool SampleStreams::add(Device dev, std::string_view deviceName, std::string_view channel,
+                        Clock::Duration t, float value) {
+  auto* ch = claim(dev, deviceName, channel);
+  if (!ch) {
+    ++dropped_;
+    return false;
+  }
+  const auto ns = t.count();
+  ch->columns.push(ns, value);
+  if (ch->columns.written() - ch->logged >= SampleBlock::kSamples)
+    logBlocks(*ch, SampleBlock::kSamples);
+  if (ch->view.add(ns, value))
+    publish(static_cast<std::size_t>(ch - channels_.data()));
+  return true;
+}
+
+void SampleStreams::flush() {
+  for (std::size_t i = 0; i < used_; ++i) {
+    logBlocks(channels_[i], 1);
+    publish(i);
+  }
+}
+
+void SampleStreams::logBlocks(Channel& ch, std::size_t minimum) {
+  const auto& cols = ch.columns;
+  ch.logged = std::max(ch.logged, cols.oldest()); // nothing to send for overwritten samples
+  if (!logger_) {
+    ch.logged = cols.written();
+    return;
+  }
+  std::memcpy(block_.key, ch.key.text, sizeof(block_.key));
+  while (cols.written() - ch.logged >= minimum) {
+    block_.count = 0;
+    while (block_.count < SampleBlock::kSamples && ch.logged < cols.written()) {
+      const auto want = SampleBlock::kSamples - block_.count;
+      const auto t = cols.times(ch.logged, want);
+      const auto v = cols.values(ch.logged, want);
+      std::copy(t.begin(), t.end(), block_.t + block_.count);
+      std::copy(v.begin(), v.end(), block_.v + block_.count);
+      block_.count += static_cast<std::uint32_t>(t.size());
+      ch.logged += t.size();
+    }
+    logger_->logBlock(block_);
+  }
+}
+
+void SampleStreams::view(std::size_t i, StreamView& out) const {
+  const auto& ch = channels_[i];
+  std::memcpy(out.key, ch.key.text, sizeof(out.key));
+  out.samples = ch.columns.written();
+  ch.view.copyTo(out);
+}
+
+void SampleStreams::publish(std::size_t i) {
+  const bool shown = display_ && displayed_ == i;
+  if (!shown && (!telemetry_ || channels_[i].slot < 0))
+    return;
+  view(i, scratch_);
+  if (telemetry_)
+    telemetry_->publishStream(channels_[i].slot, scratch_);
+  if (shown)
+    display_(scratch_);
+}
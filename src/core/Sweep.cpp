@@ -0,0 +1,71 @@
+/* @file Sweep.cpp
+ * @brief Sweep expansion (cartesian product of axes) and point labels.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+// MiLO headers
+#include "core/Sweep.hpp"
+
+using namespace milo::core;
+
+SweepAxis SweepAxis::range(Parameter p, float from, float to, float step) {
+  if (!(std::fabs(step) > 0.0f))
+    throw std::invalid_argument("[Sweep] zero step for " + std::string(toString(p)));
+  const float s = to >= from ? std::fabs(step) : -std::fabs(step);
+  // count first, so float accumulation cannot add or lose the end point
+  const auto n = static_cast<std::size_t>(std::floor((to - from) / s + 1e-4f)) + 1;
+  SweepAxis axis{ p, {} };
+  axis.values.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    axis.values.push_back(from + static_cast<float>(i) * s);
+  return axis;
+}
+
+std::size_t SweepPlan::size() const {
+  if (axes.empty())
+    return repeats;
+  std::size_t n = repeats;
+  for (const auto& a : axes)
+    n *= a.values.size();
+  return n;
+}
+
+SweepPoint SweepPlan::point(std::size_t index) const {
+  if (index >= size())
+    throw std::out_of_range("[Sweep] run index out of range");
+  index /= repeats; // repeats of a point run back to back
+  SweepPoint p(axes.size());
+  for (std::size_t i = axes.size(); i-- > 0;) {
+    const auto& a = axes[i];
+    p[i] = { a.param, a.values[index % a.values.size()] };
+    index /= a.values.size();
+  }
+  return p;
+}
+
+std::string SweepPlan::label(const SweepPoint& point) {
+  std::string out;
+  for (const auto& [param, value] : point) {
+    char num[32];
+    std::snprintf(num, sizeof(num), "%g", static_cast<double>(value));
+    if (!out.empty())
+      out += ' ';
+    out += toString(param);
+    out += '=';
+    out += num;
+  }
+  return out;
+}
+
+std::optional<Parameter> milo::core::parseParameter(std::string_view name) {
+  for (auto p : kParameters)
+    if (name == toString(p))
+      return p;
+  return std::nullopt;
+}
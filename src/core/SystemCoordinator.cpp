@@ -0,0 +1,324 @@
+/* @file SystemCoordinator.cpp
+ * @brief FSM transitions and the per-run memory discipline around RUNNING.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// MiLO headers
+#include "core/Logger.hpp"
+#include "core/ParameterStore.hpp"
+#include "core/ProtocolFactory.hpp"
+#include "core/RPCManager.hpp"
+#include "core/RunStats.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/SystemCoordinator.hpp"
+#include "core/Telemetry.hpp"
+#include "protocols/ExperimentProtocol.hpp"
+
+using namespace milo::core;
+
+namespace {
+  /// One PING round trip to every MCU before a resumed run.
+  constexpr auto kHandshakeTimeout = std::chrono::milliseconds{ 500 };
+
+  std::string summaryPathFor(const std::string& firstRunLog) {
+    const auto stem = firstRunLog.ends_with(".csv") ? firstRunLog.substr(0, firstRunLog.size() - 4)
+                                                    : firstRunLog;
+    return stem + "_sweep.csv";
+  }
+} // namespace
+
+void SystemCoordinator::initialize() {
+  if (currentState_ != State::BOOT)
+    throw std::logic_error("[SystemCoordinator] initialize() called twice");
+  transitionTo(State::INIT);
+  // TODO: mount SD, load config, init subsystems
+  if (checkpoints_)
+    interrupted_ = checkpoints_->load();
+  transitionTo(State::IDLE);
+}
+
+void SystemCoordinator::handleStart() {
+  if (currentState_ != State::IDLE && currentState_ != State::FINISHED)
+    throw std::logic_error(std::string("[SystemCoordinator] cannot start from ") +
+                           toString(currentState_));
+  transitionTo(State::RUNNING);
+}
+
+void SystemCoordinator::handleAbort() {
+  if (sweeping_.load()) {
+    {
+      std::lock_guard lock(abortMtx_);
+      abortRequested_ = true;
+    }
+    abortCv_.notify_all();
+    return;
+  }
+  if (currentState_ == State::RUNNING)
+    transitionTo(State::FINISHED);
+}
+
+void SystemCoordinator::handleError(const std::string &reason) {
+  AllocationGuard::Exempt coldPath;
+  std::cerr << "[SystemCoordinator] error: " << reason << "\n";
+  if (bus_)
+    bus_->publish(SystemEvent::error(currentState_, reason));
+  transitionTo(State::ERROR);
+}
+
+void SystemCoordinator::selectProtocol(const std::string &name) {
+  if (protocols_ && !protocols_->contains(name))
+    throw std::invalid_argument("[SystemCoordinator] unknown protocol: " + name);
+  selected_ = name;
+}
+
+void SystemCoordinator::attachRunContext(RPCManager &rpc, Logger &log, ParameterStore &params,
+                                         const ProtocolFactory &protocols) {
+  rpc_ = &rpc;
+  log_ = &log;
+  params_ = &params;
+  protocols_ = &protocols;
+  if (!jitter_.empty()) {
+    log.setRunHeader("jitter", jitter_);
+    log.setRunHeader("runtime", runtime_);
+  }
+}
+
+void SystemCoordinator::setRunConditions(const RuntimeProfile &profile,
+                                         const JitterReport &jitter) {
+  jitter_ = jitter.toString();
+  runtime_ = profile.describe();
+  if (log_) {
+    log_->setRunHeader("jitter", jitter_);
+    log_->setRunHeader("runtime", runtime_);
+  }
+}
+
+void SystemCoordinator::requireRunnable(const SweepPlan &plan) const {
+  if (!rpc_ || !log_ || !params_ || !protocols_)
+    throw std::logic_error("[SystemCoordinator] runSweep() without attachRunContext()");
+  if (currentState_ != State::IDLE && currentState_ != State::FINISHED)
+    throw std::logic_error(std::string("[SystemCoordinator] cannot start a sweep from ") +
+                           toString(currentState_));
+  if (plan.size() == 0)
+    throw std::invalid_argument("[SystemCoordinator] sweep has no runs");
+  if (!protocols_->contains(plan.protocol)) // checked up front: protocols are built per run
+    throw std::out_of_range("[SystemCoordinator] unknown protocol: " + plan.protocol);
+}
+
+SweepSummary SystemCoordinator::runSweep(const SweepPlan &plan) {
+  requireRunnable(plan);
+  interrupted_.reset(); // a new sweep replaces the interrupted one's checkpoint
+  return sweep(plan, nullptr);
+}
+
+SweepSummary SystemCoordinator::resumeSweep(const SweepPlan &plan) {
+  resumeRequested_ = std::chrono::steady_clock::now();
+  if (!interrupted_)
+    throw std::logic_error("[SystemCoordinator] no interrupted sweep to resume");
+  requireRunnable(plan);
+  const Checkpoint cp = *interrupted_;
+  if (plan.protocol != cp.protocol || plan.size() != cp.sweepTotal)
+    throw std::invalid_argument("[SystemCoordinator] plan is not the interrupted sweep (" +
+                                std::string(cp.protocol) + ", " +
+                                std::to_string(cp.sweepTotal) + " runs)");
+
+  // the MCUs may have been reset with us (or not at all): make sure all of them answer
+  rpc_->handshake(kHandshakeTimeout);
+  for (std::size_t i = 0; i < std::size(kParameters); ++i)
+    params_->set(kParameters[i], cp.params[i]);
+  interrupted_.reset();
+  return sweep(plan, &cp);
+}
+
+void SystemCoordinator::discardInterruptedRun() {
+  interrupted_.reset();
+  if (checkpoints_)
+    checkpoints_->clear();
+}
+
+SweepSummary SystemCoordinator::sweep(const SweepPlan &plan, const Checkpoint *resume) {
+  const auto total = plan.size();
+  const std::size_t first = resume ? resume->sweepRun : 0;
+
+  std::optional<Checkpointer> checkpointer;
+  if (checkpoints_)
+    checkpointer.emplace(*checkpoints_, *clock_, checkpointPeriod_);
+  Checkpoint cp{};
+  std::snprintf(cp.protocol, sizeof(cp.protocol), "%s", plan.protocol.c_str());
+  cp.sweepTotal = static_cast<std::uint32_t>(total);
+
+  SweepSummary summary;
+  summary.runs.reserve(total);
+  std::ofstream csv;
+
+  abortRequested_ = false;
+  sweeping_ = true;
+  struct Done {
+    std::atomic<bool> &flag;
+    ~Done() { flag = false; }
+  } done{ sweeping_ };
+
+  for (std::size_t i = first; i < total && !abortRequested_; ++i) {
+    const bool resumed = resume && i == first;
+    SweepRun run;
+    run.index = i;
+    run.point = plan.point(i);
+    for (const auto &[param, value] : run.point)
+      params_->set(param, value);
+
+    log_->setRunHeader("sweep_run", std::to_string(i + 1) + "/" + std::to_string(total));
+    log_->setRunHeader("sweep_point", SweepPlan::label(run.point));
+    if (resumed)
+      log_->setRunHeader("resumed_from", std::string(resume->run[0] ? resume->run : "-") +
+                                             " step " + std::to_string(resume->step));
+    try {
+      log_->startNewRun();
+    } catch (const std::runtime_error &e) {
+      handleError(e.what());
+      summary.aborted = true;
+      break;
+    }
+    log_->clearRunHeader("resumed_from");
+    run.logPath = log_->currentRunPath();
+
+    if (checkpointer) {
+      std::snprintf(cp.run, sizeof(cp.run), "%s",
+                    std::filesystem::path(run.logPath).filename().c_str());
+      cp.sweepRun = static_cast<std::uint32_t>(i);
+      cp.step = resumed ? resume->step : 0;
+      cp.elapsed = resumed ? resume->elapsed : std::chrono::milliseconds{ 0 };
+      for (std::size_t p = 0; p < std::size(kParameters); ++p)
+        cp.params[p] = params_->get(kParameters[p]);
+      checkpointer->begin(cp);
+    }
+
+    if (i == first) {
+      summary.path = summaryPathFor(run.logPath);
+      csv.open(summary.path);
+      csv << "# protocol: " << plan.protocol << "\n# runs: " << total << "\nrun";
+      for (const auto &[param, value] : run.point)
+        csv << ',' << toString(param);
+      csv << ",ok,duration_ms,error,log\n";
+    }
+
+    auto *stats = rpc_->stats();
+    if (stats)
+      stats->reset();
+    const auto t0 = clock_->now();
+    {
+      // fresh for every run, in the run arena: leaving RUNNING resets it once this is gone
+      auto protocol = protocols_->create(plan.protocol, arena_);
+      protocol->useClock(*clock_);
+      protocol->useMemory(*arena_.resource());
+      if (checkpointer)
+        protocol->useCheckpoints(*checkpointer);
+
+      transitionTo(State::RUNNING);
+      if (resumed)
+        resumeLatency_ = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - resumeRequested_);
+      try {
+        protocol->run(*rpc_, *log_, *params_);
+        run.ok = true;
+      } catch (const std::exception &e) {
+        AllocationGuard::Exempt coldPath;
+        run.error = e.what();
+        std::replace(run.error.begin(), run.error.end(), ',', ';');
+      }
+    }
+    run.duration = std::chrono::duration_cast<std::chrono::milliseconds>(clock_->now() - t0);
+    rpc_->flushStreams(); // the run's last streamed samples belong in its own log
+
+    const bool stop = !run.ok && plan.stopOnError;
+    if (stop)
+      handleError("sweep run " + std::to_string(i + 1) + " failed: " + run.error);
+    else
+      transitionTo(State::FINISHED);
+    if (stats) { // built from the running totals: nothing is re-read from the log
+      run.stats = stats->summary();
+      log_->recordStats(run.stats);
+      if (showStats_)
+        showStats_(run.stats);
+    }
+    log_->finishRun();
+
+    csv << i + 1;
+    for (const auto &[param, value] : run.point)
+      csv << ',' << value;
+    csv << ',' << (run.ok ? 1 : 0) << ',' << run.duration.count() << ',' << run.error << ','
+        << run.logPath << '\n';
+    csv.flush(); // the summary survives a crash half-way through a long sweep
+
+    summary.failed += run.ok ? 0 : 1;
+    summary.runs.push_back(std::move(run));
+    if (stop) {
+      summary.aborted = true;
+      break;
+    }
+    if (checkpointer && i + 1 < total) { // a reset from here on resumes with the next run
+      cp.run[0] = '\0';
+      cp.sweepRun = static_cast<std::uint32_t>(i + 1);
+      cp.step = 0;
+      cp.elapsed = std::chrono::milliseconds{ 0 };
+      checkpointer->begin(cp);
+    }
+
+    if (i + 1 < total && plan.settle.count() > 0) {
+      if (clock_->isVirtual()) {
+        clock_->sleepFor(plan.settle); // an abort is still seen by the loop condition
+      } else {
+        std::unique_lock lock(abortMtx_);
+        abortCv_.wait_for(lock, plan.settle, [this] { return abortRequested_.load(); });
+      }
+    }
+  }
+  if (abortRequested_)
+    summary.aborted = true;
+
+  if (checkpointer)
+    checkpointer->end(); // finished, aborted or failed: nothing left to resume
+  log_->clearRunHeader("sweep_run");
+  log_->clearRunHeader("sweep_point");
+  if (currentState_ != State::ERROR)
+    transitionTo(State::IDLE);
+  return summary;
+}
+
+void SystemCoordinator::attachTelemetry(TelemetryPublisher &telemetry) {
+  telemetry_ = &telemetry;
+  telemetry.publishState(currentState_);
+}
+
+void SystemCoordinator::transitionTo(State next) {
+  if (currentState_ == State::RUNNING && next != State::RUNNING) {
+    AllocationGuard::disarm();
+    allocReport_.clear();
+    if (AllocationGuard::count() > 0) {
+      allocReport_ = std::to_string(AllocationGuard::count()) + " heap allocation(s) while RUNNING\n" +
+                     AllocationGuard::report();
+      std::cerr << "[SystemCoordinator] " << allocReport_;
+    }
+    // FINISHED or ERROR alike: the run's objects are gone, the next one starts from empty
+    arena_.reset();
+  }
+
+
+  const auto prev = currentState_;
+  currentState_ = next;
+  if (telemetry_)
+    telemetry_->publishState(next);
+  if (bus_)
+    bus_->publish(SystemEvent::stateChanged(prev, next));
+
+  if (next == State::RUNNING)
+    AllocationGuard::arm(allocPolicy_);
+}
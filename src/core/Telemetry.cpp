@@ -0,0 +1,225 @@
+/* @file Telemetry.cpp
+ * @brief Shared-memory segment lifecycle and the publisher/reader record operations.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <new>
+
+// Linux headers
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/SystemEvent.hpp"
+#include "core/Telemetry.hpp"
+
+using namespace milo::core;
+using namespace milo::core::telemetry;
+
+namespace {
+  template <std::size_t N> bool valid(int slot, const std::atomic<std::uint32_t>& count) {
+    return slot >= 0 && static_cast<std::uint32_t>(slot) < count.load(std::memory_order_relaxed) &&
+           static_cast<std::size_t>(slot) < N;
+  }
+
+  /// Setup-time slot claim (single setup thread); the count is published after the name.
+  template <typename T, std::size_t N, typename F>
+  int claim(Seqlocked<T> (&table)[N], std::atomic<std::uint32_t>& count, F&& init) {
+    const auto idx = count.load(std::memory_order_relaxed);
+    if (idx >= N)
+      return -1;
+    table[idx].update(init);
+    count.store(idx + 1, std::memory_order_release);
+    return static_cast<int>(idx);
+  }
+} // namespace
+
+// ─── publisher ───────────────────────────────────────────────────────────────
+std::unique_ptr<TelemetryPublisher> TelemetryPublisher::create(const std::string& name) {
+  const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0)
+    return nullptr;
+  if (ftruncate(fd, sizeof(Segment)) != 0) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  void* mem = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mem == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+
+  auto* seg = ::new (mem) Segment{};
+  seg->size = sizeof(Segment);
+  seg->pid = static_cast<std::int32_t>(::getpid());
+  seg->fsm.update([](Fsm& f) { f.sinceNs = nowNs(); });
+  seg->magic.store(kMagic, std::memory_order_release);
+  return std::unique_ptr<TelemetryPublisher>(new TelemetryPublisher(name, seg));
+}
+
+TelemetryPublisher::TelemetryPublisher(std::string name, Segment* seg)
+    : name_(std::move(name)), seg_(seg) {}
+
+TelemetryPublisher::~TelemetryPublisher() {
+  busListener_.reset();
+  seg_->magic.store(0, std::memory_order_release); // readers still mapped see "gone"
+  munmap(seg_, sizeof(Segment));
+  shm_unlink(name_.c_str());
+}
+
+void TelemetryPublisher::attachEventBus(EventBus& bus) {
+  // claimed here on the setup thread, before the listener (which only updates them) starts
+  busSlots_.clear();
+  for (std::size_t i = 0; i < bus.subscribers(); ++i)
+    busSlots_.push_back(addQueue("bus:" + std::string(bus.stats(i).name), bus.capacity()));
+  busSlots_.push_back(addQueue("bus:telemetry", bus.capacity()));
+
+  busListener_ = std::make_unique<BroadcastListener<SystemEvent>>(
+      bus, "telemetry", [this, &bus](const SystemEvent& e) {
+        if (e.kind == SystemEvent::Kind::StateChanged)
+          publishState(e.to);
+        for (std::size_t i = 0; i < busSlots_.size(); ++i) {
+          const auto s = bus.stats(i);
+          queueLevel(busSlots_[i], static_cast<std::size_t>(s.lag), s.lost);
+        }
+      });
+}
+
+void TelemetryPublisher::publishState(SystemState s) {
+  seg_->fsm.update([s](Fsm& f) {
+    f.state = s;
+    ++f.transitions;
+    f.sinceNs = nowNs();
+  });
+}
+
+int TelemetryPublisher::addDevice(std::string_view name) {
+  return claim(seg_->devices, seg_->deviceCount, [name](Device& d) { setName(d.name, name); });
+}
+
+void TelemetryPublisher::commandSent(int slot) {
+  if (valid<kMaxDevices>(slot, seg_->deviceCount))
+    seg_->devices[slot].update([](Device& d) { ++d.commands; });
+}
+
+void TelemetryPublisher::replyReceived(int slot, std::chrono::microseconds rtt) {
+  if (!valid<kMaxDevices>(slot, seg_->deviceCount))
+    return;
+  const auto us = static_cast<std::uint32_t>(std::clamp<std::int64_t>(rtt.count(), 0, UINT32_MAX));
+  seg_->devices[slot].update([us](Device& d) {
+    ++d.replies;
+    d.lastRttUs = us;
+    d.minRttUs = std::min(d.minRttUs, us);
+    d.maxRttUs = std::max(d.maxRttUs, us);
+    d.avgRttUs = d.replies == 1 ? us
+                                : static_cast<std::uint32_t>(
+                                      (std::uint64_t{ d.avgRttUs } * 7 + us) / 8);
+  });
+}
+
+void TelemetryPublisher::deviceError(int slot) {
+  if (valid<kMaxDevices>(slot, seg_->deviceCount))
+    seg_->devices[slot].update([](Device& d) { ++d.errors; });
+}
+
+int TelemetryPublisher::addQueue(std::string_view name, std::size_t capacity) {
+  return claim(seg_->queues, seg_->queueCount, [&](Queue& q) {
+    setName(q.name, name);
+    q.capacity = static_cast<std::uint32_t>(capacity);
+  });
+}
+
+void TelemetryPublisher::queueLevel(int slot, std::size_t fill, std::uint64_t dropped) {
+  if (!valid<kMaxQueues>(slot, seg_->queueCount))
+    return;
+  const auto f = static_cast<std::uint32_t>(fill);
+  seg_->queues[slot].update([f, dropped](Queue& q) {
+    q.fill = f;
+    q.peak = std::max(q.peak, f);
+    q.dropped = dropped;
+  });
+}
+
+int TelemetryPublisher::addThread(std::string_view name) {
+  return claim(seg_->threads, seg_->threadCount, [name](Heartbeat& h) { setName(h.name, name); });
+}
+
+void TelemetryPublisher::heartbeat(int slot) {
+  if (!valid<kMaxThreads>(slot, seg_->threadCount))
+    return;
+  const auto now = nowNs();
+  seg_->threads[slot].update([now](Heartbeat& h) {
+    h.lastNs = now;
+    ++h.beats;
+  });
+}
+
+int TelemetryPublisher::addStream(std::string_view key) {
+  return claim(seg_->streams, seg_->streamCount, [key](StreamView& v) {
+    const auto n = std::min(key.size(), StreamView::kKeyLen);
+    std::memcpy(v.key, key.data(), n);
+    v.key[n] = '\0';
+  });
+}
+
+void TelemetryPublisher::publishStream(int slot, const StreamView& view) {
+  if (valid<kMaxStreams>(slot, seg_->streamCount))
+    seg_->streams[slot].update([&view](StreamView& v) { v = view; });
+}
+
+// ─── reader ──────────────────────────────────────────────────────────────────
+std::unique_ptr<TelemetryReader> TelemetryReader::open(const std::string& name) {
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    return nullptr;
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != sizeof(Segment)) {
+    ::close(fd);
+    return nullptr;
+  }
+  void* mem = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mem == MAP_FAILED)
+    return nullptr;
+
+  const auto* seg = static_cast<const Segment*>(mem);
+  if (seg->magic.load(std::memory_order_acquire) != kMagic || seg->version != kVersion ||
+      seg->size != sizeof(Segment)) {
+    munmap(mem, sizeof(Segment));
+    return nullptr;
+  }
+  return std::unique_ptr<TelemetryReader>(new TelemetryReader(seg));
+}
+
+TelemetryReader::~TelemetryReader() { munmap(const_cast<Segment*>(seg_), sizeof(Segment)); }
+
+bool TelemetryReader::alive() const {
+  return seg_->magic.load(std::memory_order_acquire) == kMagic;
+}
+
+bool TelemetryReader::snapshot(TelemetrySnapshot& out) const {
+  if (!alive())
+    return false;
+  out.pid = seg_->pid;
+  out.deviceCount = std::min<std::uint32_t>(seg_->deviceCount.load(std::memory_order_acquire), kMaxDevices);
+  out.queueCount = std::min<std::uint32_t>(seg_->queueCount.load(std::memory_order_acquire), kMaxQueues);
+  out.threadCount = std::min<std::uint32_t>(seg_->threadCount.load(std::memory_order_acquire), kMaxThreads);
+  out.streamCount = std::min<std::uint32_t>(seg_->streamCount.load(std::memory_order_acquire), kMaxStreams);
+
+  bool ok = seg_->fsm.read(out.fsm);
+  for (std::uint32_t i = 0; i < out.deviceCount; ++i)
+    ok = seg_->devices[i].read(out.devices[i]) && ok;
+  for (std::uint32_t i = 0; i < out.queueCount; ++i)
+    ok = seg_->queues[i].read(out.queues[i]) && ok;
+  for (std::uint32_t i = 0; i < out.threadCount; ++i)
+    ok = seg_->threads[i].read(out.threads[i]) && ok;
+  for (std::uint32_t i = 0; i < out.streamCount; ++i)
+    ok = seg_->streams[i].read(out.streams[i]) && ok;
+  return ok;
+}
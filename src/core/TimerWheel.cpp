@@ -0,0 +1,220 @@
+/* @file TimerWheel.cpp
+ * @brief Cascading hierarchical timer wheel with occupancy bitmaps and a timerfd wakeup.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <bit>
+#include <cassert>
+#include <cerrno>
+
+// Linux headers
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/TimerWheel.hpp"
+
+using namespace milo::core;
+
+Timer::~Timer() { cancel(); }
+
+void Timer::cancel() {
+  if (wheel_)
+    wheel_->cancel(*this);
+}
+
+TimerWheel::TimerWheel(std::chrono::microseconds resolution, bool useTimerFd,
+                       std::optional<Duration> start)
+    : resolution_(resolution) {
+  assert(resolution_.count() > 0 && "[TimerWheel] zero resolution");
+  current_ = static_cast<std::uint64_t>(
+      start.value_or(std::chrono::steady_clock::now().time_since_epoch()) / resolution_);
+  if (useTimerFd)
+    tfd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+}
+
+TimerWheel::~TimerWheel() {
+  // leave no dangling back-pointers in timers that outlive us
+  for (auto& level : slots_)
+    for (auto* head : level)
+      for (auto* t = head; t;) {
+        auto* next = t->next_;
+        t->wheel_ = nullptr;
+        t->prev_ = t->next_ = nullptr;
+        t = next;
+      }
+  if (tfd_ >= 0)
+    ::close(tfd_);
+}
+
+void TimerWheel::arm(Timer& t, Duration deadline) {
+  t.cancel();
+
+  // round up: a timer never fires early
+  const auto ticks = deadline.count() <= 0
+                         ? 0
+                         : static_cast<std::uint64_t>((deadline + resolution_ - Duration{ 1 }) /
+                                                      resolution_);
+  t.expiry_ = std::max(ticks, current_ + 1);
+  t.wheel_ = this;
+  ++armed_;
+  insert(t);
+
+  if (tfd_ >= 0 && t.expiry_ < programmed_)
+    programFd();
+}
+
+void TimerWheel::cancel(Timer& t) {
+  if (t.wheel_ != this)
+    return;
+  unlink(t);
+  t.wheel_ = nullptr;
+  --armed_;
+}
+
+void TimerWheel::insert(Timer& t) {
+  // smallest level whose block distance fits in one revolution; clamp beyond the top
+  unsigned level = 0;
+  while (level + 1 < kLevels &&
+         (t.expiry_ >> (kBits * level)) - (current_ >> (kBits * level)) >= kSlots) {
+    ++level;
+  }
+  auto block = t.expiry_ >> (kBits * level);
+  const auto top = (current_ >> (kBits * level)) + kSlots - 1;
+  if (block > top)
+    block = top; // re-cascaded when that block starts
+
+  const auto slot = static_cast<std::uint8_t>(block & (kSlots - 1));
+  t.level_ = static_cast<std::uint8_t>(level);
+  t.slot_ = slot;
+
+  auto& head = slots_[level][slot];
+  t.prev_ = nullptr;
+  t.next_ = head;
+  if (head)
+    head->prev_ = &t;
+  head = &t;
+  occupied_[level] |= 1ull << slot;
+}
+
+void TimerWheel::unlink(Timer& t) {
+  auto& head = slots_[t.level_][t.slot_];
+  if (t.prev_)
+    t.prev_->next_ = t.next_;
+  else
+    head = t.next_;
+  if (t.next_)
+    t.next_->prev_ = t.prev_;
+  t.prev_ = t.next_ = nullptr;
+  if (!head)
+    occupied_[t.level_] &= ~(1ull << t.slot_);
+}
+
+std::optional<std::uint64_t> TimerWheel::nextEventTick() const {
+  std::optional<std::uint64_t> best;
+  for (unsigned level = 0; level < kLevels; ++level) {
+    if (!occupied_[level])
+      continue;
+    const unsigned shift = kBits * level;
+    const auto cur = current_ >> shift;
+    // first occupied slot strictly after the current block (level 0: after current tick)
+    const auto from = static_cast<unsigned>((cur + 1) & (kSlots - 1));
+    const auto rotated = std::rotr(occupied_[level], static_cast<int>(from));
+    const auto dist = static_cast<std::uint64_t>(std::countr_zero(rotated)) + 1;
+    const auto tick = (cur + dist) << shift;
+    if (!best || tick < *best)
+      best = tick;
+  }
+  return best;
+}
+
+std::optional<TimerWheel::Duration> TimerWheel::nextDeadline() const {
+  if (auto t = nextEventTick())
+    return *t * resolution_;
+  return std::nullopt;
+}
+
+std::size_t TimerWheel::advance(Duration now) {
+  const auto target = static_cast<std::uint64_t>(now / resolution_);
+  std::size_t fired = 0;
+
+  for (;;) {
+    const auto next = nextEventTick();
+    if (!next || *next > target)
+      break;
+    current_ = *next;
+
+    // cascade every level whose block starts now, top-down, so timers trickle to level 0
+    for (unsigned level = kLevels - 1; level > 0; --level) {
+      const unsigned shift = kBits * level;
+      if (current_ & ((1ull << shift) - 1))
+        continue;
+      const auto slot = static_cast<std::uint8_t>((current_ >> shift) & (kSlots - 1));
+      auto* t = slots_[level][slot];
+      slots_[level][slot] = nullptr;
+      occupied_[level] &= ~(1ull << slot);
+      while (t) {
+        auto* following = t->next_;
+        insert(*t);
+        t = following;
+      }
+    }
+
+    // expire level 0; callbacks may arm or cancel anything, so pop one at a time
+    const auto slot = static_cast<std::uint8_t>(current_ & (kSlots - 1));
+    while (auto* t = slots_[0][slot]) {
+      if (t->expiry_ > current_) { // clamped far timer: cascade again later
+        unlink(*t);
+        insert(*t);
+        continue;
+      }
+      cancel(*t);
+      ++fired;
+      if (t->cb_)
+        t->cb_();
+    }
+  }
+
+  if (target > current_)
+    current_ = target;
+  if (tfd_ >= 0)
+    programFd();
+  return fired;
+}
+
+std::size_t TimerWheel::service() {
+  if (tfd_ >= 0) {
+    std::uint64_t expirations;
+    while (::read(tfd_, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {
+    }
+  }
+  return advance(clock_->now());
+}
+
+std::size_t TimerWheel::serviceNext() {
+  if (armed_ == 0)
+    return 0;
+  std::size_t fired = 0;
+  while (fired == 0 && armed_ > 0) { // the next event may only be a cascade point
+    if (auto next = nextDeadline())
+      clock_->sleepUntil(*next);
+    fired = service();
+  }
+  return fired;
+}
+
+void TimerWheel::programFd() {
+  const auto next = nextEventTick();
+  const auto tick = next.value_or(0); // 0 disarms
+  if (tick == programmed_ || (!next && programmed_ == UINT64_MAX))
+    return;
+
+  const auto ns = std::chrono::nanoseconds{ tick * resolution_ };
+  itimerspec spec{};
+  spec.it_value.tv_sec = static_cast<time_t>(ns.count() / 1'000'000'000);
+  spec.it_value.tv_nsec = static_cast<long>(ns.count() % 1'000'000'000);
+  timerfd_settime(tfd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+  programmed_ = next ? tick : UINT64_MAX;
+}
@@ -1,7 +1,45 @@
+/* @file ButtonGPIO.cpp
+ * @brief Short/long press classification on top of debounced kernel edges.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
 #include "io/ButtonGPIO.hpp"
 using namespace milo::io;
 
-void ButtonGPIO::poll(std::chrono::milliseconds) {
-  // TODO real debounce; for now do nothing
+void ButtonGPIO::onEdge(Edge e, std::chrono::nanoseconds timestamp) {
+  if (e == Edge::Rising) {
+    pressed_ = true;
+    longEmitted_ = false;
+    pressTs_ = timestamp;
+    if (timers_) {
+      if (!holdTimer_)
+        holdTimer_ = std::make_unique<core::Timer>([this] { onHoldTimeout(); });
+      timers_->arm(*holdTimer_, pressTs_ + longThreshold_);
+    }
+    return;
+  }
+
+  if (!pressed_)
+    return;
+  pressed_ = false;
+  if (holdTimer_)
+    holdTimer_->cancel();
+  if (longEmitted_)
+    return;
+  emitPress(timestamp - pressTs_ >= longThreshold_ ? Event::LongPress : Event::ShortPress);
+}
+
+void ButtonGPIO::poll(std::chrono::milliseconds now) {
+  GPIOInput::poll(now); // settle any bounce first
+
+  if (pressed_ && now - pressTs_ >= longThreshold_)
+    onHoldTimeout();
 }
 
+void ButtonGPIO::onHoldTimeout() {
+  if (!pressed_ || longEmitted_)
+    return;
+  longEmitted_ = true;
+  emitPress(Event::LongPress);
+}
@@ -0,0 +1,139 @@
+/* @file EdgeEventSource.cpp
+ * @brief GPIO character-device v2 edge-event request (line fd + event decoding).
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+// Linux headers
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "io/EdgeEventSource.hpp"
+
+using namespace milo::io;
+
+namespace {
+  constexpr std::size_t kMaxBatch = 16; ///< events pulled per read() syscall
+} // namespace
+
+std::unique_ptr<GpioCdevEventSource>
+GpioCdevEventSource::open(const std::string& chip, std::span<const unsigned int> lines,
+                          bool activeLow, std::chrono::microseconds kernelDebounce) {
+  if (lines.empty() || lines.size() > kMaxLines)
+    return nullptr;
+
+  int chipFd = ::open(chip.c_str(), O_RDONLY | O_CLOEXEC);
+  if (chipFd < 0) {
+    std::cerr << "Error " << errno << " from open: " << strerror(errno) << "\n";
+    return nullptr;
+  }
+
+  gpio_v2_line_request req{};
+  for (std::size_t i = 0; i < lines.size(); ++i)
+    req.offsets[i] = lines[i];
+  req.num_lines = static_cast<std::uint32_t>(lines.size());
+  std::strncpy(req.consumer, "milo", sizeof(req.consumer) - 1);
+  // no EVENT_CLOCK_* flag → CLOCK_MONOTONIC timestamps, the same base as steady_clock
+  req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING |
+                     GPIO_V2_LINE_FLAG_EDGE_FALLING;
+  if (activeLow)
+    req.config.flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+  if (kernelDebounce.count() > 0) {
+    auto& attr = req.config.attrs[req.config.num_attrs++];
+    attr.attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+    attr.attr.debounce_period_us = static_cast<std::uint32_t>(kernelDebounce.count());
+    attr.mask = (1ull << lines.size()) - 1;
+  }
+  req.event_buffer_size = 64;
+
+  const int rc = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &req);
+  const int err = errno;
+  ::close(chipFd);
+  if (rc < 0) {
+    std::cerr << "Error " << err << " from GPIO_V2_GET_LINE_IOCTL: " << strerror(err) << "\n";
+    return nullptr;
+  }
+
+  // non-blocking so an epoll-driven owner can drain until EAGAIN
+  fcntl(req.fd, F_SETFL, fcntl(req.fd, F_GETFL) | O_NONBLOCK);
+
+  std::unique_ptr<GpioCdevEventSource> src(new GpioCdevEventSource());
+  src->fd_ = req.fd;
+  src->numLines_ = lines.size();
+  for (std::size_t i = 0; i < lines.size(); ++i)
+    src->lines_[i] = lines[i];
+  return src;
+}
+
+GpioCdevEventSource::GpioCdevEventSource(GpioCdevEventSource&& o) noexcept
+    : fd_(std::exchange(o.fd_, -1)), numLines_(std::exchange(o.numLines_, 0)) {
+  std::copy(std::begin(o.lines_), std::end(o.lines_), lines_);
+}
+
+GpioCdevEventSource& GpioCdevEventSource::operator=(GpioCdevEventSource&& o) noexcept {
+  if (this != &o) {
+    if (fd_ >= 0)
+      ::close(fd_);
+    fd_ = std::exchange(o.fd_, -1);
+    numLines_ = std::exchange(o.numLines_, 0);
+    std::copy(std::begin(o.lines_), std::end(o.lines_), lines_);
+  }
+  return *this;
+}
+
+GpioCdevEventSource::~GpioCdevEventSource() {
+  if (fd_ >= 0)
+    ::close(fd_);
+  fd_ = -1;
+}
+
+std::size_t GpioCdevEventSource::read(std::span<EdgeEvent> out) {
+  if (fd_ < 0 || out.empty())
+    return 0;
+
+  gpio_v2_line_event raw[kMaxBatch];
+  const std::size_t want = std::min(out.size(), kMaxBatch);
+  ssize_t n;
+  do {
+    n = ::read(fd_, raw, want * sizeof(gpio_v2_line_event));
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0)
+    return 0; // EAGAIN: drained
+
+  const auto count = static_cast<std::size_t>(n) / sizeof(gpio_v2_line_event);
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i].line = raw[i].offset;
+    out[i].kind = raw[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE ? EdgeEvent::Kind::Rising
+                                                              : EdgeEvent::Kind::Falling;
+    out[i].timestamp = std::chrono::nanoseconds{ raw[i].timestamp_ns };
+    out[i].seqno = raw[i].seqno;
+  }
+  return count;
+}
+
+bool GpioCdevEventSource::level(unsigned int line) const {
+  if (fd_ < 0)
+    return false;
+
+  gpio_v2_line_values vals{};
+  for (std::size_t i = 0; i < numLines_; ++i) {
+    if (lines_[i] != line)
+      continue;
+    vals.mask = 1ull << i;
+    if (ioctl(fd_, GPIO_V2_LINE_GET_VALUES_IOCTL, &vals) < 0)
+      return false;
+    return (vals.bits >> i) & 1u;
+  }
+  return false;
+}
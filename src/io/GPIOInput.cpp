@@ -1,16 +1,88 @@
-/* @file SerialChannel.cpp
- * @brief stub impl
+/* @file GPIOInput.cpp
+ * @brief Kernel edge-event consumer with timestamp-based debounce.
  *
  * © 2025 Milo Medical — MIT-licensed.
  */
 
+#include <array>
+
 #include "io/GPIOInput.hpp"
 
 using namespace milo::io;
 
 GPIOInput::~GPIOInput() = default;
 
-bool GPIOInput::open(const std::string&, unsigned int, bool) { return true; }
+bool GPIOInput::open(const std::string& chip, unsigned int line, bool activeLow) {
+  const unsigned int lines[] = { line };
+  auto src = GpioCdevEventSource::open(chip, lines, activeLow);
+  if (!src)
+    return false;
+  attach(std::move(src), line);
+  return true;
+}
+
+void GPIOInput::attach(std::unique_ptr<EdgeEventSource> source, unsigned int line) {
+  source_ = std::move(source);
+  line_ = line;
+  lastState_ = rawState_ = source_ ? source_->level(line) : false;
+  lastEdgeTs_ = lastRawTs_ = std::chrono::nanoseconds{ 0 };
+}
+
+void GPIOInput::service() {
+  if (!source_)
+    return;
+
+  std::array<EdgeEvent, 16> batch;
+  while (auto n = source_->read(batch)) {
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto& ev = batch[i];
+      if (ev.line != line_)
+        continue;
+
+      rawState_ = ev.kind == Edge::Rising;
+      lastRawTs_ = ev.timestamp;
+
+      // leading-edge debounce: the first transition counts immediately, bounces inside the
+      // window after it are ignored (settle() catches a bounce that ends in the other state)
+      if (rawState_ == lastState_) {
+        if (settleTimer_)
+          settleTimer_->cancel();
+        continue;
+      }
+      if (lastEdgeTs_.count() != 0 && ev.timestamp - lastEdgeTs_ < debounce_) {
+        if (timers_) {
+          if (!settleTimer_)
+            settleTimer_ = std::make_unique<core::Timer>(
+                [this] { settle(timers_->now()); });
+          timers_->arm(*settleTimer_, lastRawTs_ + debounce_);
+        }
+        continue;
+      }
+
+      lastState_ = rawState_;
+      lastEdgeTs_ = ev.timestamp;
+      onEdge(ev.kind, ev.timestamp);
+    }
+    if (n < batch.size())
+      break;
+  }
+}
+
+void GPIOInput::poll(std::chrono::milliseconds now) { settle(now); }
+
+void GPIOInput::settle(std::chrono::nanoseconds now) {
+  if (rawState_ == lastState_ || now - lastRawTs_ < debounce_)
+    return;
+
+  // line has been quiet for a full window in a different level than we reported
+  lastState_ = rawState_;
+  lastEdgeTs_ = lastRawTs_;
+  onEdge(rawState_ ? Edge::Rising : Edge::Falling, lastRawTs_);
+}
 
-void GPIOInput::close() {}
+void GPIOInput::onEdge(Edge e, std::chrono::nanoseconds) { emit(e); }
 
+void GPIOInput::close() {
+  settleTimer_.reset();
+  source_.reset();
+}
@@ -0,0 +1,57 @@
+/* @file GlyphRunCache.cpp
+ * @brief LRU label cache backed by the compile-time font atlas.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "io/Font5x7.hpp"
+#include "io/GlyphRunCache.hpp"
+
+using namespace milo::io;
+
+static_assert(font::kAdvance == 6, "Slot::columns is sized for a 6 px advance");
+
+namespace {
+  std::uint64_t fnv1a(std::string_view s) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (char c : s) {
+      h ^= static_cast<unsigned char>(c);
+      h *= 1099511628211ull;
+    }
+    return h;
+  }
+} // namespace
+
+GlyphRunCache::Run GlyphRunCache::lookup(std::string_view text) {
+  if (text.empty() || text.size() > kMaxChars)
+    return {};
+
+  const auto h = fnv1a(text);
+  ++tick_;
+
+  Slot* victim = &slots_[0];
+  for (auto& s : slots_) {
+    if (s.lastUse != 0 && s.hash == h && s.len == text.size() &&
+        std::memcmp(s.key.data(), text.data(), text.size()) == 0) {
+      s.lastUse = tick_;
+      ++hits_;
+      return { s.columns.data(), static_cast<int>(s.len) * font::kAdvance };
+    }
+    if (s.lastUse < victim->lastUse)
+      victim = &s;
+  }
+
+  // miss: rasterize into the least-recently-used slot
+  ++misses_;
+  victim->hash = h;
+  victim->lastUse = tick_;
+  victim->len = static_cast<std::uint8_t>(text.size());
+  std::copy(text.begin(), text.end(), victim->key.begin());
+  for (std::size_t i = 0; i < text.size(); ++i)
+    std::memcpy(victim->columns.data() + i * font::kAdvance, font::glyph(text[i]),
+                font::kAdvance);
+  return { victim->columns.data(), static_cast<int>(victim->len) * font::kAdvance };
+}
@@ -0,0 +1,88 @@
+/* @file LatencyProbe.cpp
+ * @brief Round-trip timing of a serial device per line setting.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+
+// MiLO headers
+#include "io/LatencyProbe.hpp"
+#include "io/SerialChannel.hpp"
+
+using namespace milo::io;
+
+namespace {
+  std::chrono::microseconds quantile(const std::vector<std::chrono::microseconds>& sorted,
+                                     double q) {
+    const auto i = static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[i];
+  }
+} // namespace
+
+LatencyReport LatencyProbe::measure(SerialChannel& channel, const Options& options) {
+  LatencyReport report;
+  report.opened = true;
+  report.requested = report.effective = channel.settings();
+
+  std::vector<std::chrono::microseconds> rtt;
+  rtt.reserve(options.rounds);
+  for (std::size_t i = 0; i < options.rounds; ++i) {
+    // a late reply from the previous round must not be timed as this one's
+    while (channel.readLine(std::chrono::milliseconds{ 0 }))
+      ;
+
+    ++report.rounds;
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!channel.writeLine(options.command)) {
+      ++report.timeouts;
+      continue;
+    }
+    if (!channel.readLine(options.timeout)) {
+      ++report.timeouts;
+      continue;
+    }
+    rtt.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0));
+  }
+
+  report.replies = rtt.size();
+  if (!rtt.empty()) {
+    std::sort(rtt.begin(), rtt.end());
+    report.min = rtt.front();
+    report.p50 = quantile(rtt, 0.50);
+    report.p99 = quantile(rtt, 0.99);
+    report.max = rtt.back();
+  }
+  return report;
+}
+
+std::vector<LatencyReport> LatencyProbe::sweep(const std::string& device,
+                                               std::span<const SerialSettings> candidates,
+                                               const Options& options) {
+  std::vector<LatencyReport> reports;
+  reports.reserve(candidates.size());
+  for (const auto& settings : candidates) {
+    SerialChannel channel;
+    LatencyReport report;
+    if (channel.open(device, settings))
+      report = measure(channel, options);
+    report.requested = settings;
+    reports.push_back(report);
+  }
+  return reports;
+}
+
+std::optional<std::size_t> LatencyProbe::fastest(std::span<const LatencyReport> reports) {
+  std::optional<std::size_t> best;
+  for (std::size_t i = 0; i < reports.size(); ++i) {
+    const auto& r = reports[i];
+    if (!r.stable())
+      continue;
+    if (!best || r.p99 < reports[*best].p99 ||
+        (r.p99 == reports[*best].p99 && r.max < reports[*best].max))
+      best = i;
+  }
+  return best;
+}
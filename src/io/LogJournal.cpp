@@ -0,0 +1,194 @@
+/* @file LogJournal.cpp
+ * @brief Write-ahead journal blocks, group commit, checkpoints and replay.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+// Linux headers
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/Crc32.hpp"
+#include "io/LogJournal.hpp"
+
+using namespace milo::io;
+
+namespace {
+  constexpr std::uint32_t kMagic = 0x314A4C4D; // "MLJ1"
+
+#pragma pack(push, 1)
+  struct BlockHeader {
+    std::uint32_t magic;
+    std::uint64_t seq;
+    std::uint64_t offset;
+    std::uint32_t len;
+    std::uint32_t crc;
+  };
+#pragma pack(pop)
+  static_assert(sizeof(BlockHeader) == 28);
+
+  std::uint32_t blockCrc(const BlockHeader& h, const void* data) {
+    // everything but magic and the crc itself
+    auto crc = milo::core::crc32(&h.seq, sizeof(h.seq) + sizeof(h.offset) + sizeof(h.len));
+    return milo::core::crc32(data, h.len, crc);
+  }
+
+  bool writeAll(int fd, const iovec (&iov)[2], int n) {
+    iovec v[2] = { iov[0], iov[1] };
+    iovec* next = v;
+    while (n > 0) {
+      const auto w = ::writev(fd, next, n);
+      if (w < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      auto left = static_cast<std::size_t>(w);
+      while (n > 0 && left >= next->iov_len) {
+        left -= next->iov_len;
+        ++next;
+        --n;
+      }
+      if (n > 0) {
+        next->iov_base = static_cast<char*>(next->iov_base) + left;
+        next->iov_len -= left;
+      }
+    }
+    return true;
+  }
+
+  bool pwriteAll(int fd, const char* p, std::size_t n, off_t at) {
+    while (n > 0) {
+      const auto w = ::pwrite(fd, p, n, at);
+      if (w < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      p += w;
+      n -= static_cast<std::size_t>(w);
+      at += w;
+    }
+    return true;
+  }
+} // namespace
+
+LogJournal::~LogJournal() { close(false); }
+
+bool LogJournal::open(const std::string& path, std::uint64_t durableBytes) {
+  close(false);
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0)
+    return false;
+  path_ = path;
+  size_ = 0;
+  return writeBlock(durableBytes, {}) && commit();
+}
+
+bool LogJournal::writeBlock(std::uint64_t offset, std::string_view data) {
+  BlockHeader h{ kMagic, seq_++, offset, static_cast<std::uint32_t>(data.size()), 0 };
+  h.crc = blockCrc(h, data.data());
+  const iovec iov[2] = { { &h, sizeof(h) }, { const_cast<char*>(data.data()), data.size() } };
+  if (!writeAll(fd_, iov, data.empty() ? 1 : 2))
+    return false;
+  size_ += sizeof(h) + data.size();
+  return true;
+}
+
+bool LogJournal::append(std::uint64_t offset, std::string_view data) {
+  return fd_ >= 0 && (data.empty() || writeBlock(offset, data));
+}
+
+bool LogJournal::commit() { return fd_ >= 0 && ::fdatasync(fd_) == 0; }
+
+bool LogJournal::checkpoint(int logFd, std::uint64_t logBytes) {
+  if (fd_ < 0 || ::fdatasync(logFd) != 0)
+    return false;
+  // the run log now holds everything: the journal restarts with a single checkpoint
+  if (::ftruncate(fd_, 0) != 0)
+    return false;
+  size_ = 0;
+  return writeBlock(logBytes, {}) && commit();
+}
+
+void LogJournal::close(bool remove) {
+  if (fd_ < 0)
+    return;
+  ::close(fd_);
+  fd_ = -1;
+  if (remove)
+    ::unlink(path_.c_str());
+}
+
+std::optional<LogJournal::Recovery> LogJournal::recover(const std::string& logPath,
+                                                        const std::string& journalPath) {
+  const int jfd = ::open(journalPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (jfd < 0)
+    return std::nullopt;
+  std::vector<char> raw;
+  char buf[16 * 1024];
+  for (ssize_t n; (n = ::read(jfd, buf, sizeof(buf))) != 0;) {
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    raw.insert(raw.end(), buf, buf + n);
+  }
+  ::close(jfd);
+
+  Recovery rec;
+  const int lfd = ::open(logPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (lfd < 0)
+    return std::nullopt;
+  struct stat st{};
+  ::fstat(lfd, &st);
+  rec.logBytes = static_cast<std::uint64_t>(st.st_size);
+
+  // replay the intact prefix; the first bad magic, checksum or sequence gap ends it
+  std::size_t pos = 0;
+  bool anchored = false;
+  std::uint64_t seq = 0;
+  while (raw.size() - pos >= sizeof(BlockHeader)) {
+    BlockHeader h;
+    std::memcpy(&h, raw.data() + pos, sizeof(h));
+    if (h.magic != kMagic || raw.size() - pos - sizeof(h) < h.len ||
+        (anchored && h.seq != seq + 1))
+      break;
+    const char* data = raw.data() + pos + sizeof(h);
+    if (blockCrc(h, data) != h.crc)
+      break;
+
+    if (h.len == 0) { // checkpoint: the log is durable up to here
+      rec.logBytes = h.offset;
+    } else {
+      if (!pwriteAll(lfd, data, h.len, static_cast<off_t>(h.offset)))
+        break;
+      rec.logBytes = std::max(rec.logBytes, h.offset + h.len);
+      ++rec.blocks;
+    }
+    // bytes after the last intact block were never committed: they go
+    anchored = true;
+    seq = h.seq;
+    pos += sizeof(h) + h.len;
+  }
+  rec.discarded = raw.size() - pos;
+
+  if (anchored && ::ftruncate(lfd, static_cast<off_t>(rec.logBytes)) != 0) {
+    ::close(lfd);
+    return std::nullopt;
+  }
+  ::fdatasync(lfd);
+  ::close(lfd);
+  ::unlink(journalPath.c_str());
+  return rec;
+}
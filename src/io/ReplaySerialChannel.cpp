@@ -0,0 +1,111 @@
+/* @file ReplaySerialChannel.cpp
+ * @brief Capture playback behind the SerialChannel interface.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// MiLO headers
+#include "io/ReplaySerialChannel.hpp"
+
+using namespace milo::io;
+
+ReplaySerialChannel::ReplaySerialChannel(std::shared_ptr<const Capture> capture,
+                                         std::uint8_t channel, Pacing pacing)
+    : cap_(std::move(capture)), channel_(channel), pacing_(pacing) {
+  if (channel_ < cap_->terminators.size()) // points into cap_, which we keep alive
+    setTerminator(cap_->terminators[channel_]);
+  open({}, {});
+}
+
+std::unique_ptr<ReplaySerialChannel>
+ReplaySerialChannel::forChannel(std::shared_ptr<const Capture> capture, std::string_view name,
+                                Pacing pacing) {
+  const auto id = capture ? capture->channelId(name) : std::nullopt;
+  if (!id)
+    return nullptr;
+  return std::make_unique<ReplaySerialChannel>(std::move(capture), *id, pacing);
+}
+
+bool ReplaySerialChannel::open(const std::string&, const SerialSettings&) {
+  cursor_ = 0;
+  rx_.clear();
+  divergences_ = 0;
+  anchorRecorded_ = std::chrono::nanoseconds{ 0 };
+  anchorNow_.reset(); // taken on first use: the owner may still swap the clock after open()
+  return true;
+}
+
+const Capture::Record* ReplaySerialChannel::next() const {
+  for (auto i = cursor_; i < cap_->records.size(); ++i)
+    if (cap_->records[i].channel == channel_)
+      return &cap_->records[i];
+  return nullptr;
+}
+
+void ReplaySerialChannel::consume(const Capture::Record* r) {
+  cursor_ = static_cast<std::size_t>(r - cap_->records.data()) + 1;
+}
+
+bool ReplaySerialChannel::writeLine(std::string_view line) {
+  // anything the device sent before this command was on the wire already: keep it readable
+  const Capture::Record* r = next();
+  while (r && r->dir == Capture::Direction::Rx) {
+    rx_ += r->bytes;
+    consume(r);
+    r = next();
+  }
+
+  const auto eol = terminator();
+  const bool terminated = line.ends_with(eol);
+  if (!r) {
+    ++divergences_; // host sends more than was recorded
+    return true;
+  }
+  const std::string_view expected = r->bytes;
+  const bool same = terminated ? expected == line
+                               : expected.size() == line.size() + eol.size() &&
+                                     expected.starts_with(line) && expected.ends_with(eol);
+  if (!same)
+    ++divergences_;
+
+  consume(r);
+  anchorRecorded_ = r->t;
+  anchorNow_ = clock().now();
+  return true;
+}
+
+std::optional<std::string> ReplaySerialChannel::readLine(std::chrono::milliseconds timeout) {
+  auto& clk = clock();
+  const auto deadline = clk.now() + timeout;
+  const bool paced = pacing_ == Pacing::Recorded;
+  if (paced && !anchorNow_)
+    anchorNow_ = clk.now();
+
+  const auto eol = terminator();
+  for (;;) {
+    if (auto pos = rx_.find(eol); pos != std::string::npos) {
+      std::string line = rx_.substr(0, pos);
+      rx_.erase(0, pos + eol.size());
+      return line;
+    }
+
+    const Capture::Record* r = next();
+    if (!r || r->dir == Capture::Direction::Tx) {
+      // the device said nothing more before the next command: a timeout, as recorded
+      if (paced)
+        clk.sleepUntil(deadline);
+      return std::nullopt;
+    }
+
+    if (paced) {
+      const auto due = *anchorNow_ + (r->t - anchorRecorded_);
+      if (due > deadline) {
+        clk.sleepUntil(deadline);
+        return std::nullopt; // still pending for the next read
+      }
+      clk.sleepUntil(due);
+    }
+    rx_ += r->bytes;
+    consume(r);
+  }
+}
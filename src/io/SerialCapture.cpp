@@ -0,0 +1,175 @@
+/* @file SerialCapture.cpp
+ * @brief Capture file writer and loader.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// MiLO headers
+#include "io/SerialCapture.hpp"
+
+using namespace milo::io;
+
+namespace {
+  constexpr char kMagic[7] = { 'M', 'I', 'L', 'O', 'C', 'A', 'P' };
+  constexpr std::uint8_t kVersion = 2; ///< 2: channel declarations carry the terminator
+  constexpr std::uint8_t kChannelTag = 0xFF;
+
+  std::chrono::nanoseconds steadyNow() {
+    return std::chrono::steady_clock::now().time_since_epoch();
+  }
+
+  struct Cursor {
+    const unsigned char* p;
+    const unsigned char* end;
+
+    bool byte(std::uint8_t& out) {
+      if (p == end)
+        return false;
+      out = *p++;
+      return true;
+    }
+    bool varint(std::uint64_t& out) {
+      out = 0;
+      for (unsigned shift = 0; shift < 64; shift += 7) {
+        std::uint8_t b;
+        if (!byte(b))
+          return false;
+        out |= std::uint64_t{ b & 0x7Fu } << shift;
+        if (!(b & 0x80u))
+          return true;
+      }
+      return false;
+    }
+    bool bytes(std::string& out, std::uint64_t n) {
+      if (static_cast<std::uint64_t>(end - p) < n)
+        return false;
+      out.assign(reinterpret_cast<const char*>(p), static_cast<std::size_t>(n));
+      p += n;
+      return true;
+    }
+  };
+} // namespace
+
+// ─── writer ──────────────────────────────────────────────────────────────────
+std::shared_ptr<CaptureWriter> CaptureWriter::create(const std::string& path) {
+  FILE* fp = std::fopen(path.c_str(), "wbe");
+  if (!fp)
+    return nullptr;
+  return std::shared_ptr<CaptureWriter>(new CaptureWriter(fp));
+}
+
+CaptureWriter::CaptureWriter(FILE* fp) : fp_(fp), buf_(64 * 1024) {
+  std::setvbuf(fp_, buf_.data(), _IOFBF, buf_.size());
+  last_ = steadyNow();
+  std::fwrite(kMagic, 1, sizeof(kMagic), fp_);
+  std::fputc(kVersion, fp_);
+  const auto origin = static_cast<std::uint64_t>(last_.count());
+  for (int i = 0; i < 8; ++i)
+    std::fputc(static_cast<int>((origin >> (8 * i)) & 0xFF), fp_);
+}
+
+CaptureWriter::~CaptureWriter() {
+  std::fflush(fp_);
+  std::fclose(fp_);
+}
+
+void CaptureWriter::putVarint(std::uint64_t v) {
+  do {
+    auto b = static_cast<unsigned char>(v & 0x7F);
+    v >>= 7;
+    std::fputc(v ? (b | 0x80) : b, fp_);
+  } while (v);
+}
+
+std::optional<std::uint8_t> CaptureWriter::addChannel(std::string_view name, std::string_view eol) {
+  std::lock_guard lock(mtx_);
+  if (channels_ >= kMaxChannels)
+    return std::nullopt;
+  const auto id = channels_++;
+  std::fputc(kChannelTag, fp_);
+  putVarint(id);
+  putVarint(name.size());
+  std::fwrite(name.data(), 1, name.size(), fp_);
+  putVarint(eol.size());
+  std::fwrite(eol.data(), 1, eol.size(), fp_);
+  return id;
+}
+
+void CaptureWriter::record(std::uint8_t channel, Capture::Direction dir, std::string_view data,
+                           std::string_view tail) {
+  const auto now = steadyNow();
+  std::lock_guard lock(mtx_);
+  std::fputc((channel << 1) | static_cast<int>(dir), fp_);
+  putVarint(static_cast<std::uint64_t>(std::max(now - last_, std::chrono::nanoseconds{ 0 }).count()));
+  putVarint(data.size() + tail.size());
+  std::fwrite(data.data(), 1, data.size(), fp_);
+  std::fwrite(tail.data(), 1, tail.size(), fp_);
+  last_ = std::max(last_, now);
+}
+
+void CaptureWriter::flush() {
+  std::lock_guard lock(mtx_);
+  std::fflush(fp_);
+}
+
+// ─── loader ──────────────────────────────────────────────────────────────────
+std::optional<Capture> Capture::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::nullopt;
+  const std::vector<unsigned char> raw{ std::istreambuf_iterator<char>(in), {} };
+  if (raw.size() < sizeof(kMagic) + 1 + 8 || std::memcmp(raw.data(), kMagic, sizeof(kMagic)) != 0 ||
+      raw[sizeof(kMagic)] < 1 || raw[sizeof(kMagic)] > kVersion)
+    return std::nullopt;
+  const std::uint8_t version = raw[sizeof(kMagic)];
+
+  Capture cap;
+  std::uint64_t origin = 0;
+  for (int i = 0; i < 8; ++i)
+    origin |= std::uint64_t{ raw[sizeof(kMagic) + 1 + static_cast<std::size_t>(i)] } << (8 * i);
+  cap.origin = std::chrono::nanoseconds{ static_cast<std::int64_t>(origin) };
+
+  Cursor c{ raw.data() + sizeof(kMagic) + 1 + 8, raw.data() + raw.size() };
+  std::chrono::nanoseconds t{ 0 };
+  std::uint8_t tag;
+  while (c.byte(tag)) {
+    std::uint64_t a = 0, len = 0;
+    if (tag == kChannelTag) {
+      std::string name, eol = "\r\n";
+      if (!c.varint(a) || !c.varint(len) || !c.bytes(name, len))
+        break;
+      if (version >= 2 && (!c.varint(len) || !c.bytes(eol, len)))
+        break;
+      if (a >= CaptureWriter::kMaxChannels)
+        return std::nullopt; // not written by us: never size the table from it
+      if (cap.channels.size() <= a) {
+        cap.channels.resize(static_cast<std::size_t>(a) + 1);
+        cap.terminators.resize(static_cast<std::size_t>(a) + 1, "\r\n");
+      }
+      cap.channels[static_cast<std::size_t>(a)] = std::move(name);
+      cap.terminators[static_cast<std::size_t>(a)] = std::move(eol);
+      continue;
+    }
+    Record r;
+    if (!c.varint(a) || !c.varint(len) || !c.bytes(r.bytes, len))
+      break; // torn last record (crash mid-capture): keep what we have
+    t += std::chrono::nanoseconds{ static_cast<std::int64_t>(a) };
+    r.t = t;
+    r.channel = static_cast<std::uint8_t>(tag >> 1);
+    r.dir = static_cast<Direction>(tag & 1u);
+    cap.records.push_back(std::move(r));
+  }
+  return cap;
+}
+
+std::optional<std::uint8_t> Capture::channelId(std::string_view name) const {
+  for (std::size_t i = 0; i < channels.size(); ++i)
+    if (channels[i] == name)
+      return static_cast<std::uint8_t>(i);
+  return std::nullopt;
+}
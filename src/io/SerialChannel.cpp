@@ -5,24 +5,35 @@
  */
 
 // STL headers
+#include <algorithm>
 #include <cstddef>
 #include <cstring> // for strerror
 #include <iostream>
 
 // Linux headers
-#include <errno.h> // Error integer and strerror() function
-#include <fcntl.h> // Contains file controls like O_RDWR
+#include <asm/termbits.h> // termios2, BOTHER — instead of <termios.h>, which it clashes with
+#include <errno.h>        // Error integer and strerror() function
+#include <fcntl.h>        // Contains file controls like O_RDWR
+#include <linux/serial.h> // serial_struct, ASYNC_LOW_LATENCY
 #include <poll.h>
-#include <unistd.h> // write(), read(), close()
+#include <sys/ioctl.h>
+#include <sys/uio.h> // writev()
+#include <unistd.h>  // write(), read(), close()
 
 // MiLO headers
+#include "io/SerialCapture.hpp"
 #include "io/SerialChannel.hpp"
 
 using namespace milo::io;
 
 SerialChannel::~SerialChannel() { close(); }
 
-bool SerialChannel::open(const std::string& dev, speed_t baud) {
+bool SerialChannel::open(const std::string& dev, const SerialSettings& settings) {
+  if (settings.baud < SerialSettings::kMinBaud || settings.baud > SerialSettings::kMaxBaud) {
+    std::cerr << "Error: baud " << settings.baud << " out of range\n";
+    return false;
+  }
+
   // open non-blocking, dont become ctrl-TTY
   fd_ = ::open(dev.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
   if (fd_ < 0) {
@@ -30,51 +41,75 @@ bool SerialChannel::open(const std::string& dev, speed_t baud) {
     return false;
   }
 
-  // fetch current attrs
-  struct termios tty;
-  if (tcgetattr(fd_, &tty) != 0) {
-    std::cerr << "Error " << errno << " from tcgetattr: " << strerror(errno) << "\n";
+  // termios2 takes the rate as a number (BOTHER), standard or not — no B* table
+  struct termios2 tty;
+  if (ioctl(fd_, TCGETS2, &tty) != 0) {
+    std::cerr << "Error " << errno << " from TCGETS2: " << strerror(errno) << "\n";
     close();
     return false;
   }
 
-  cfmakeraw(&tty);
-  tty.c_cflag &= ~CSIZE;
-  tty.c_cflag |= CS8;
-  tty.c_cflag &= ~CRTSCTS;
-  tty.c_iflag &= ~(IXON | IXOFF | IXANY);
-
-  cfsetispeed(&tty, baud);
-  cfsetospeed(&tty, baud);
-
-  if (tcsetattr(fd_, TCSANOW, &tty) != 0) {
-    std::cerr << "Error " << errno << " from tcsetattr: " << strerror(errno) << "\n";
+  // raw 8N1, no flow control (what cfmakeraw() does, plus CRTSCTS/IXOFF off)
+  tty.c_iflag &=
+      ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+  tty.c_oflag &= ~OPOST;
+  tty.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+  tty.c_cflag &= ~(CSIZE | PARENB | CRTSCTS | CBAUD | (CBAUD << IBSHIFT));
+  tty.c_cflag |= CS8 | CREAD | CLOCAL | BOTHER | (BOTHER << IBSHIFT);
+  tty.c_ispeed = tty.c_ospeed = settings.baud;
+  tty.c_cc[VMIN] = settings.vmin;
+  tty.c_cc[VTIME] = settings.vtime;
+
+  if (ioctl(fd_, TCSETS2, &tty) != 0) {
+    std::cerr << "Error " << errno << " from TCSETS2: " << strerror(errno) << "\n";
     close();
     return false;
   }
+
+  settings_ = settings;
+  if (ioctl(fd_, TCGETS2, &tty) == 0 && tty.c_ospeed != 0)
+    settings_.baud = tty.c_ospeed; // the divisor the UART could actually do
+
+  // FTDI & co.: without this the bridge holds short replies for its latency timer (16 ms)
+  settings_.lowLatency = false;
+  serial_struct serial{};
+  if (settings.lowLatency && ioctl(fd_, TIOCGSERIAL, &serial) == 0) {
+    serial.flags |= ASYNC_LOW_LATENCY;
+    settings_.lowLatency = ioctl(fd_, TIOCSSERIAL, &serial) == 0;
+  }
   return true;
 }
 
-bool SerialChannel::writeLine(const std::string& line) {
+bool SerialChannel::writeLine(std::string_view line) {
 
   if (fd_ < 0) {
     return false;
   }
 
-  std::string out = line;
-  if (!out.ends_with("\r\n")) {
-    out += "\r\n";
-  }
+  // terminator goes out in the same writev as the payload — no copy, no allocation
+  const std::string_view eol = line.ends_with(eol_) ? std::string_view{} : eol_;
+  iovec iov[2] = { { const_cast<char*>(line.data()), line.size() },
+                   { const_cast<char*>(eol_.data()), eol.size() } };
+  iovec* next = iov;
+  int left = iov[1].iov_len ? 2 : 1;
 
   // Good Pattern for POSIX write loop (required if the tty blocks for instance)
-  std::size_t total = 0;
-  while (total < out.size()) {
-    ssize_t written = ::write(fd_, out.data() + total, out.size() - total);
-    if (written > 0) {
-      total += written;
-    } else if (written == -1 && errno == EINTR) {
+  while (left > 0) {
+    ssize_t written = ::writev(fd_, next, left);
+    if (written >= 0) {
+      auto n = static_cast<std::size_t>(written);
+      while (left > 0 && n >= next->iov_len) {
+        n -= next->iov_len;
+        ++next;
+        --left;
+      }
+      if (left > 0) {
+        next->iov_base = static_cast<char*>(next->iov_base) + n;
+        next->iov_len -= n;
+      }
+    } else if (errno == EINTR) {
       continue; // try again
-    } else if (written == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
       // TODO: wait on epoll or select; for now just retry
       continue;
     } else {
@@ -83,6 +118,8 @@ bool SerialChannel::writeLine(const std::string& line) {
     }
   }
 
+  if (capture_)
+    capture_->record(captureId_, Capture::Direction::Tx, line, eol);
   return true;
 }
 
@@ -95,16 +132,24 @@ std::optional<std::string> SerialChannel::readLine(std::chrono::milliseconds tim
   if (fd_ < 0)
     return std::nullopt;
 
+  // a previous read may already have buffered a complete line
+  if (auto pos = rx_buffer_.find(eol_); pos != std::string::npos) {
+    std::string line = rx_buffer_.substr(0, pos);
+    rx_buffer_.erase(0, pos + eol_.size());
+    return line;
+  }
+
   char temp[256];
   pollfd pfd{ fd_, POLLIN, 0 };
 
-  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  const auto deadline = clock_->now() + timeout;
 
-  while (std::chrono::steady_clock::now() < deadline) {
+  do { // at least one poll: a zero timeout is a non-blocking read
 
-    auto ms_left = std::chrono::duration_cast<std::chrono::milliseconds>(
-        deadline - std::chrono::steady_clock::now());
-    int ms = static_cast<int>(ms_left.count());
+    auto ms_left =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock_->now());
+    // virtual time: look once without blocking, then jump to the deadline below
+    int ms = clock_->isVirtual() ? 0 : std::max(0, static_cast<int>(ms_left.count()));
 
     int rc = ::poll(&pfd, 1, ms);
     if (rc == -1) {
@@ -113,13 +158,19 @@ std::optional<std::string> SerialChannel::readLine(std::chrono::milliseconds tim
       std::cerr << "poll: " << strerror(errno) << '\n';
       return std::nullopt;
     }
-    if (rc == 0)
-      break; // timeout
+    if (rc == 0) {
+      if (clock_->isVirtual())
+        clock_->sleepUntil(deadline); // nothing came in the (simulated) time we had
+      break;                          // timeout
+    }
 
     if (pfd.revents & POLLIN) {
       ssize_t n = ::read(fd_, temp, sizeof(temp));
       if (n > 0) {
         rx_buffer_.append(temp, n);
+        if (capture_)
+          capture_->record(captureId_, Capture::Direction::Rx,
+                           std::string_view(temp, static_cast<std::size_t>(n)));
       } else if (n == 0) { // EOF / disconnect
         close();
         return std::nullopt;
@@ -131,13 +182,13 @@ std::optional<std::string> SerialChannel::readLine(std::chrono::milliseconds tim
       }
 
       // Check for complete line
-      if (auto pos = rx_buffer_.find("\r\n"); pos != std::string::npos) {
+      if (auto pos = rx_buffer_.find(eol_); pos != std::string::npos) {
         std::string line = rx_buffer_.substr(0, pos);
-        rx_buffer_.erase(0, pos + 2); // remove line + CRLF
+        rx_buffer_.erase(0, pos + eol_.size()); // remove line + terminator
         return line;
       }
     }
-  }
+  } while (clock_->now() < deadline);
   return std::nullopt; // timeout/partial
 }
 
@@ -1,11 +1,139 @@
+#include <csignal>
+#include <exception>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
 
+#include <poll.h>
+
+#ifdef MILO_HAVE_CONFIG
+#include <nlohmann/json.hpp>
+
+#include "core/ConfigLoader.hpp"
+#endif
+#include "core/Checkpoint.hpp"
+#include "core/ControlServer.hpp"
+#include "core/ParameterStore.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/Sweep.hpp"
+#include "core/SystemCoordinator.hpp"
+#include "core/SystemEvent.hpp"
+#include "core/Telemetry.hpp"
+
+namespace {
+  volatile std::sig_atomic_t g_stop = 0;
+  constexpr const char* kDefaultConfig = "/mnt/sdcard/config.json";
+  /// Upper bound on how stale a streamed event/measurement gets while the socket is quiet.
+  constexpr int kStreamPeriodMs = 20;
+} // namespace
+
 int main(int argc, char* argv[]) {
-  if (argc > 1 && std::string(argv[1]) == "--hello") {
-    std::cout << "hello from stub" << std::endl;
+  std::string controlPath = milo::core::ControlServer::kDefaultPath;
+  std::string configPath = kDefaultConfig;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--hello")
+      std::cout << "hello from stub" << std::endl;
+    else if (arg == "--control" && i + 1 < argc)
+      controlPath = argv[++i];
+    else if (arg == "--config" && i + 1 < argc)
+      configPath = argv[++i];
   }
   std::cout << "milo-experimentd (bootstrap)\n";
+
+  milo::core::RuntimeConfig runtime;
+  std::optional<milo::core::SweepPlan> sweep; // the plan an interrupted sweep resumes with
+#ifdef MILO_HAVE_CONFIG
+  auto config = nlohmann::json::object();
+  try {
+    config = milo::core::ConfigLoader(configPath).load();
+  } catch (const std::exception& e) {
+    std::cerr << "config: " << e.what() << "; using built-in settings\n";
+  }
+  try {
+    runtime = milo::core::runtimeConfig(config);
+  } catch (const std::exception& e) {
+    std::cerr << "config: " << e.what() << "; using built-in runtime settings\n";
+  }
+  try {
+    sweep = milo::core::sweepPlan(config);
+  } catch (const std::exception& e) {
+    std::cerr << "config: " << e.what() << "; an interrupted sweep cannot be resumed\n";
+  }
+#else
+  std::cerr << "config: built without JSON support; ignoring " << configPath << '\n';
+#endif
+  auto profile = std::make_shared<const milo::core::RuntimeProfile>(runtime);
+  if (!profile->lockMemory())
+    std::cerr << "runtime: mlockall failed, running with pageable memory\n";
+  // this thread only serves the control socket; real-time roles go to the threads doing the work
+  if (!profile->apply(milo::core::ThreadRole::Control))
+    std::cerr << "runtime: cannot apply the control thread's scheduling\n";
+  std::cout << "runtime: " << profile->describe() << '\n';
+
+  // startup self-check; the coordinator puts it and the profile into every run log's header
+  // (setRunConditions() below) so each run records the timing conditions it ran under
+  const auto jitter = profile->measureJitter();
+  std::cout << "jitter: " << jitter.toString() << '\n';
+
+  // state changes and errors fan out from the coordinator; subscribers never hold it up
+  milo::core::EventBus bus(256);
+
+  // live counters for milo-top; observing never touches the daemon's threads
+  auto telemetry = milo::core::TelemetryPublisher::create();
+  if (!telemetry)
+    std::cerr << "telemetry: shared-memory segment unavailable\n";
+  else
+    telemetry->attachEventBus(bus); // last subscriber: it reports everyone's lag
+
+  milo::core::SystemCoordinator coordinator;
+  coordinator.attachEventBus(bus);
+  coordinator.setRunConditions(*profile, jitter);
+
+  // a sweep cut short by a crash or watchdog reset is offered for resume, not lost
+  milo::core::CheckpointStore checkpoints("/mnt/sdcard/logs");
+  coordinator.attachCheckpoints(checkpoints);
+
+  // scripted control: same verbs as the front panel, served from this thread's loop below.
+  // No run context (devices, Logger, protocols, protocol thread) is wired into the daemon
+  // yet, so Start is left out and answered with an Error instead of entering RUNNING with
+  // nothing running; for the same reason there is no measurement stream to attach. Resume
+  // goes to resumeSweep(), which refuses without a run context, so it is answered with that
+  // Error too; once one is wired, Resume and Start hand the sweep to its thread instead.
+  // Discard only drops the checkpoint and works either way.
+  milo::core::ParameterStore params;
+  auto control = milo::core::ControlServer::create(
+      controlPath, params,
+      { [&](const std::string& name) { coordinator.selectProtocol(name); }, {},
+        [&] { coordinator.handleAbort(); },
+        [&] {
+          if (!sweep)
+            throw std::runtime_error("[main] no \"sweep\" block in " + configPath +
+                                     " to resume with");
+          coordinator.resumeSweep(*sweep);
+        },
+        [&] { coordinator.discardInterruptedRun(); } });
+  if (!control)
+    std::cerr << "control: cannot listen on " << controlPath << '\n';
+  else
+    control->attachEventBus(bus);
+
+  coordinator.initialize();
+  if (const auto& cp = coordinator.interruptedRun())
+    std::cout << "recovery: sweep '" << cp->protocol << "' interrupted in run " << cp->sweepRun + 1
+              << '/' << cp->sweepTotal << " at step " << cp->step
+              << "; milo-ctl resume (same \"sweep\" block) or discard\n";
+  if (!control)
+    return 0;
+
+  std::signal(SIGINT, [](int) { g_stop = 1; });
+  std::signal(SIGTERM, [](int) { g_stop = 1; });
+  pollfd pfd{ control->fd(), POLLIN, 0 };
+  while (!g_stop) {
+    ::poll(&pfd, 1, kStreamPeriodMs);
+    control->service();
+  }
   return 0;
 }
-
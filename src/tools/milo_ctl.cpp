@@ -0,0 +1,204 @@
+/* @file milo_ctl.cpp
+ * @brief Command-line client of the daemon's control socket (scripted runs, live streams).
+ *
+ * One request per invocation; `watch` subscribes and prints stream frames until killed.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Linux headers
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// MiLO headers
+#include "core/ControlServer.hpp"
+#include "core/ParameterStore.hpp"
+
+using namespace milo::core;
+using namespace milo::core::control;
+
+namespace {
+  void usage() {
+    std::printf("usage: milo-ctl [--socket PATH] COMMAND\n"
+                "  ping | set PARAM VALUE | get PARAM | select PROTOCOL | start | abort\n"
+                "  resume | discard (the sweep a reset interrupted)\n"
+                "  watch [events|measurements|all]\n");
+  }
+
+  int connectTo(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path))
+      return -1;
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+      ::close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  bool readAll(int fd, std::byte* p, std::size_t n) {
+    while (n > 0) {
+      const auto r = ::read(fd, p, n);
+      if (r <= 0)
+        return false;
+      p += r;
+      n -= static_cast<std::size_t>(r);
+    }
+    return true;
+  }
+
+  bool send(int fd, const Frame& f) {
+    std::byte buf[kMaxFrame];
+    const auto n = f.encode(buf);
+    return ::send(fd, buf, n, MSG_NOSIGNAL) == static_cast<ssize_t>(n);
+  }
+
+  std::optional<Frame> receive(int fd) {
+    std::byte buf[kMaxFrame];
+    if (!readAll(fd, buf, kLengthBytes))
+      return std::nullopt;
+    const auto len = Frame::peekLength(buf);
+    if (len == 0 || len > 1 + kMaxBody || !readAll(fd, buf, len))
+      return std::nullopt;
+    return Frame::decode(std::span<const std::byte>(buf, len));
+  }
+
+  std::optional<std::uint8_t> parameterByName(std::string_view name) {
+    for (int raw = 0; raw < 256; ++raw) {
+      const auto s = std::string_view(toString(static_cast<Parameter>(raw)));
+      if (s == "Unknown")
+        break;
+      if (s == name)
+        return static_cast<std::uint8_t>(raw);
+    }
+    return std::nullopt;
+  }
+
+  void print(Frame& f) {
+    switch (f.type()) {
+    case MsgType::StateChanged: {
+      const auto ns = f.getI64().value_or(0);
+      const auto from = static_cast<SystemState>(f.getU8().value_or(0));
+      const auto to = static_cast<SystemState>(f.getU8().value_or(0));
+      std::printf("%lld state %s -> %s\n", static_cast<long long>(ns), toString(from),
+                  toString(to));
+      break;
+    }
+    case MsgType::Fault: {
+      const auto ns = f.getI64().value_or(0);
+      const auto state = static_cast<SystemState>(f.getU8().value_or(0));
+      const auto reason = f.getText();
+      std::printf("%lld fault in %s: %.*s\n", static_cast<long long>(ns), toString(state),
+                  static_cast<int>(reason.size()), reason.data());
+      break;
+    }
+    case MsgType::Measurement: {
+      const auto ns = f.getI64().value_or(0);
+      const auto type = static_cast<LogEvent::Type>(f.getU8().value_or(0));
+      const auto value = f.getF64().value_or(0.0);
+      const auto key = f.getText();
+      std::printf("%lld %s %.*s %g\n", static_cast<long long>(ns), toString(type),
+                  static_cast<int>(key.size()), key.data(), value);
+      break;
+    }
+    case MsgType::Lost:
+      std::printf("# %u frames lost (not reading fast enough)\n", f.getU32().value_or(0));
+      break;
+    default:
+      break;
+    }
+    std::fflush(stdout);
+  }
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::string path = ControlServer::kDefaultPath;
+  int i = 1;
+  if (i + 1 < argc && std::string_view(argv[i]) == "--socket") {
+    path = argv[i + 1];
+    i += 2;
+  }
+  if (i >= argc) {
+    usage();
+    return 2;
+  }
+  const std::string_view cmd = argv[i++];
+  const int rest = argc - i;
+
+  Frame req;
+  if (cmd == "ping" && rest == 0) {
+    req = Frame(MsgType::Ping);
+  } else if ((cmd == "set" && rest == 2) || (cmd == "get" && rest == 1)) {
+    const auto p = parameterByName(argv[i]);
+    if (!p) {
+      std::fprintf(stderr, "milo-ctl: unknown parameter %s\n", argv[i]);
+      return 2;
+    }
+    req = Frame(cmd == "set" ? MsgType::SetParam : MsgType::GetParam);
+    req.putU8(*p);
+    if (cmd == "set")
+      req.putF32(std::stof(argv[i + 1]));
+  } else if (cmd == "select" && rest == 1) {
+    req = std::move(Frame(MsgType::SelectProtocol).putText(argv[i]));
+  } else if (cmd == "start" && rest == 0) {
+    req = Frame(MsgType::Start);
+  } else if (cmd == "abort" && rest == 0) {
+    req = Frame(MsgType::Abort);
+  } else if (cmd == "resume" && rest == 0) {
+    req = Frame(MsgType::Resume);
+  } else if (cmd == "discard" && rest == 0) {
+    req = Frame(MsgType::Discard);
+  } else if (cmd == "watch" && rest <= 1) {
+    const std::string_view what = rest ? argv[i] : "all";
+    const std::uint8_t topics = what == "events"         ? kEvents
+                                : what == "measurements" ? kMeasurements
+                                                         : kEvents | kMeasurements;
+    req = std::move(Frame(MsgType::Subscribe).putU8(topics));
+  } else {
+    usage();
+    return cmd == "--help" ? 0 : 2;
+  }
+
+  const int fd = connectTo(path);
+  if (fd < 0) {
+    std::fprintf(stderr, "milo-ctl: cannot connect to %s (daemon not running?)\n", path.c_str());
+    return 1;
+  }
+  if (!send(fd, req)) {
+    std::fprintf(stderr, "milo-ctl: write failed\n");
+    return 1;
+  }
+
+  // stream frames may precede the reply; the reply is the first Ok/Error
+  for (;;) {
+    auto f = receive(fd);
+    if (!f) {
+      std::fprintf(stderr, "milo-ctl: connection closed\n");
+      return 1;
+    }
+    if (f->type() == MsgType::Error) {
+      const auto what = f->getText();
+      std::fprintf(stderr, "milo-ctl: %.*s\n", static_cast<int>(what.size()), what.data());
+      return 1;
+    }
+    if (f->type() == MsgType::Ok) {
+      if (cmd == "get")
+        std::printf("%g\n", static_cast<double>(f->getF32().value_or(0.0f)));
+      if (cmd != "watch")
+        return 0;
+      continue;
+    }
+    print(*f);
+  }
+}
@@ -0,0 +1,115 @@
+/* @file milo_devbench.cpp
+ * @brief RPCManager dispatch cost versus rig size: 1 … 16 simulated devices.
+ *
+ * Each device is an in-process loopback channel that answers every command at once, so the
+ * numbers are the host-side cost of routing, framing and reply parsing — not tty latency.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// MiLO headers
+#include "core/DeviceRegistry.hpp"
+#include "core/ErrorMonitor.hpp"
+#include "core/RPCManager.hpp"
+#include "io/SerialChannel.hpp"
+
+using namespace milo::core;
+
+namespace {
+  /// Simulated instrument: acknowledges the last command immediately.
+  class LoopbackChannel : public milo::io::SerialChannel {
+  public:
+    LoopbackChannel() { reply_.reserve(64); }
+
+    bool open(const std::string&, const milo::io::SerialSettings&) override { return true; }
+    bool writeLine(std::string_view line) override {
+      reply_.assign("OK ").append(line.substr(0, line.find('\r')));
+      pending_ = true;
+      return true;
+    }
+    std::optional<std::string> readLine(std::chrono::milliseconds) override {
+      if (!pending_)
+        return std::nullopt;
+      pending_ = false;
+      return reply_;
+    }
+
+  private:
+    std::string reply_;
+    bool pending_{ false };
+  };
+
+  void usage() { std::printf("usage: milo-devbench [--iterations N] [--max-devices N]\n"); }
+} // namespace
+
+int main(int argc, char** argv) {
+  std::size_t iterations = 200'000;
+  std::size_t maxDevices = DeviceRegistry::kMaxDevices;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc)
+      iterations = std::strtoul(argv[++i], nullptr, 10);
+    else if (!std::strcmp(argv[i], "--max-devices") && i + 1 < argc)
+      maxDevices = std::strtoul(argv[++i], nullptr, 10);
+    else {
+      usage();
+      return 2;
+    }
+  }
+  if (iterations == 0 || maxDevices == 0 || maxDevices > DeviceRegistry::kMaxDevices) {
+    usage();
+    return 2;
+  }
+
+  using clock = std::chrono::steady_clock;
+  const auto nsPer = [](clock::duration d, std::size_t n) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) /
+           static_cast<double>(n);
+  };
+
+  std::printf("devices  round-trip ns/cmd  scatter-gather ns/batch  ns/device\n");
+  for (std::size_t n = 1; n <= maxDevices; ++n) {
+    DeviceRegistry devices;
+    for (std::size_t i = 0; i < n; ++i)
+      devices.add({ "Dev" + std::to_string(i), "" });
+    RPCManager rpc(std::make_shared<ErrorMonitor>(), devices);
+    for (auto d : devices.all())
+      rpc.attachChannel(d, std::make_unique<LoopbackChannel>());
+
+    const auto all = devices.all();
+    milo::protocols::Command cmd{ std::pmr::string("FLOW 2.5") };
+
+    // one device at a time, round robin
+    auto t0 = clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+      const auto d = all[i % n];
+      rpc.sendCommand(d, cmd);
+      rpc.awaitResponse(d, std::chrono::milliseconds{ 0 });
+    }
+    const auto roundTrip = nsPer(clock::now() - t0, iterations);
+
+    // every device per batch
+    std::vector<BatchRequest> batch;
+    for (auto d : all)
+      batch.push_back({ d, cmd });
+    const auto batches = std::max<std::size_t>(1, iterations / n);
+    std::size_t failed = 0;
+    t0 = clock::now();
+    for (std::size_t i = 0; i < batches; ++i)
+      failed += !rpc.scatterGather(batch, std::chrono::milliseconds{ 0 }).allOk();
+    const auto perBatch = nsPer(clock::now() - t0, batches);
+
+    std::printf("%7zu  %17.0f  %23.0f  %9.0f%s\n", n, roundTrip, perBatch,
+                perBatch / static_cast<double>(n), failed ? "  (failures!)" : "");
+  }
+  return 0;
+}
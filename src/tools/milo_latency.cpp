@@ -0,0 +1,118 @@
+/* @file milo_latency.cpp
+ * @brief Serial round-trip latency per line setting, on the real instrument.
+ *
+ * Re-opens the device for every combination of baud, low-latency mode and VMIN, times a
+ * harmless query, and names the fastest setting that never missed a reply, printed as the
+ * `"serial"` object of the device's config.json entry.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// MiLO headers
+#include "core/DeviceRegistry.hpp"
+#include "io/LatencyProbe.hpp"
+
+using namespace milo::io;
+
+namespace {
+  void usage() {
+    std::printf("usage: milo-latency --device PATH [--baud 115200,921600,...]\n"
+                "                    [--low-latency on|off|both] [--vmin 1,4,...]\n"
+                "                    [--cmd QUERY] [--rounds N] [--timeout MS]\n");
+  }
+
+  std::vector<unsigned long> numbers(const std::string& csv) {
+    std::vector<unsigned long> out;
+    std::stringstream ss(csv);
+    for (std::string item; std::getline(ss, item, ',');)
+      out.push_back(std::stoul(item));
+    return out;
+  }
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::string device;
+  std::vector<unsigned long> bauds{ 115200 };
+  std::vector<unsigned long> vmins{ 1 };
+  std::vector<bool> lowLatency{ true, false };
+  LatencyProbe::Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--device" && hasValue) {
+      device = argv[++i];
+    } else if (arg == "--baud" && hasValue) {
+      bauds = numbers(argv[++i]);
+    } else if (arg == "--vmin" && hasValue) {
+      vmins = numbers(argv[++i]);
+    } else if (arg == "--low-latency" && hasValue) {
+      const std::string v = argv[++i];
+      lowLatency = v == "on" ? std::vector{ true } : v == "off" ? std::vector{ false }
+                                                                  : std::vector{ true, false };
+    } else if (arg == "--cmd" && hasValue) {
+      options.command = argv[++i];
+    } else if (arg == "--rounds" && hasValue) {
+      options.rounds = std::stoul(argv[++i]);
+    } else if (arg == "--timeout" && hasValue) {
+      options.timeout = std::chrono::milliseconds{ std::stol(argv[++i]) };
+    } else {
+      usage();
+      return arg == "--help" ? 0 : 2;
+    }
+  }
+  if (device.empty()) {
+    usage();
+    return 2;
+  }
+
+  std::vector<SerialSettings> candidates;
+  for (auto baud : bauds) {
+    const auto rate = milo::core::DeviceRegistry::parseBaud(baud);
+    if (!rate) {
+      std::fprintf(stderr, "milo-latency: baud %lu out of range\n", baud);
+      return 2;
+    }
+    for (bool ll : lowLatency)
+      for (auto vmin : vmins)
+        candidates.push_back({ .baud = *rate, .lowLatency = ll,
+                               .vmin = static_cast<std::uint8_t>(vmin) });
+  }
+
+  const auto reports = LatencyProbe::sweep(device, candidates, options);
+
+  std::printf("%10s %4s %4s %8s %8s %9s %9s %9s %9s\n", "BAUD", "LL", "VMIN", "REPLIES",
+              "TIMEOUT", "MIN(us)", "P50", "P99", "MAX");
+  for (const auto& r : reports) {
+    if (!r.opened) {
+      std::printf("%10u %4s %4u  open failed\n", r.requested.baud,
+                  r.requested.lowLatency ? "on" : "off", r.requested.vmin);
+      continue;
+    }
+    // LL shows what took: "off*" = requested, but the driver has no low-latency mode
+    const char* ll = r.effective.lowLatency ? "on" : r.requested.lowLatency ? "off*" : "off";
+    std::printf("%10u %4s %4u %8zu %8zu %9lld %9lld %9lld %9lld\n", r.effective.baud, ll,
+                r.requested.vmin, r.replies, r.timeouts, static_cast<long long>(r.min.count()),
+                static_cast<long long>(r.p50.count()), static_cast<long long>(r.p99.count()),
+                static_cast<long long>(r.max.count()));
+  }
+
+  const auto best = LatencyProbe::fastest(reports);
+  if (!best) {
+    std::printf("\nno setting answered every query within %lld ms\n",
+                static_cast<long long>(options.timeout.count()));
+    return 1;
+  }
+  const auto& b = reports[*best];
+  std::printf("\nfastest stable (p99 %lld us):\n"
+              "  \"serial\": { \"baud\": %u, \"lowLatency\": %s, \"vmin\": %u, \"vtime\": 0 }\n",
+              static_cast<long long>(b.p99.count()), b.requested.baud,
+              b.requested.lowLatency ? "true" : "false", b.requested.vmin);
+  return 0;
+}
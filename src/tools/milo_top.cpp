@@ -0,0 +1,124 @@
+/* @file milo_top.cpp
+ * @brief Read-only live view of the daemon's telemetry segment.
+ *
+ * Maps the segment PROT_READ and copies seqlocked records; the daemon never notices.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// MiLO headers
+#include "core/Telemetry.hpp"
+
+using namespace milo::core;
+
+namespace {
+  void usage() {
+    std::printf("usage: milo-top [--once] [--interval MS] [--name /shm-name]\n");
+  }
+
+  std::string age(std::int64_t thenNs) {
+    if (thenNs == 0)
+      return "never";
+    const auto ms = (telemetry::nowNs() - thenNs) / 1'000'000;
+    return ms < 10'000 ? std::to_string(ms) + " ms" : std::to_string(ms / 1000) + " s";
+  }
+
+  void render(const TelemetrySnapshot& s, bool clear) {
+    if (clear)
+      std::printf("\x1b[H\x1b[2J");
+    std::printf("milo-experimentd pid %d   state %-8s (%s, %u transitions)\n\n", s.pid,
+                toString(s.fsm.state), age(s.fsm.sinceNs).c_str(), s.fsm.transitions);
+
+    std::printf("%-10s %10s %10s %7s %9s %9s %9s %9s\n", "DEVICE", "CMDS", "REPLIES", "ERRORS",
+                "RTT(us)", "AVG", "MIN", "MAX");
+    for (std::uint32_t i = 0; i < s.deviceCount; ++i) {
+      const auto& d = s.devices[i];
+      std::printf("%-10s %10llu %10llu %7llu %9u %9u %9u %9u\n", d.name,
+                  static_cast<unsigned long long>(d.commands),
+                  static_cast<unsigned long long>(d.replies),
+                  static_cast<unsigned long long>(d.errors), d.lastRttUs, d.avgRttUs,
+                  d.replies ? d.minRttUs : 0u, d.maxRttUs);
+    }
+
+    std::printf("\n%-16s %8s %8s %8s %10s\n", "QUEUE", "FILL", "PEAK", "CAP", "DROPPED");
+    for (std::uint32_t i = 0; i < s.queueCount; ++i) {
+      const auto& q = s.queues[i];
+      std::printf("%-16s %8u %8u %8u %10llu\n", q.name, q.fill, q.peak, q.capacity,
+                  static_cast<unsigned long long>(q.dropped));
+    }
+
+    std::printf("\n%-16s %12s %12s\n", "THREAD", "LAST BEAT", "BEATS");
+    for (std::uint32_t i = 0; i < s.threadCount; ++i) {
+      const auto& h = s.threads[i];
+      std::printf("%-16s %12s %12llu\n", h.name, age(h.lastNs).c_str(),
+                  static_cast<unsigned long long>(h.beats));
+    }
+
+    if (s.streamCount > 0)
+      std::printf("\n%-24s %10s %10s %10s %10s %8s\n", "STREAM", "SAMPLES", "LAST", "MIN", "MAX",
+                  "WINDOW");
+    for (std::uint32_t i = 0; i < s.streamCount; ++i) {
+      const auto& v = s.streams[i];
+      MinMax range; // over the whole window: merge the buckets the daemon already reduced
+      for (std::uint32_t b = 0; b < v.filled; ++b)
+        if (!v.buckets[b].empty()) {
+          range.add(v.buckets[b].min);
+          range.add(v.buckets[b].max);
+        }
+      const double window = static_cast<double>(v.bucketNs) * v.filled / 1e9;
+      std::printf("%-24s %10llu %10g %10g %10g %7.1fs\n", v.key,
+                  static_cast<unsigned long long>(v.samples), static_cast<double>(v.last),
+                  range.empty() ? 0.0 : static_cast<double>(range.min),
+                  range.empty() ? 0.0 : static_cast<double>(range.max), window);
+    }
+    std::fflush(stdout);
+  }
+} // namespace
+
+int main(int argc, char* argv[]) {
+  bool once = false;
+  std::chrono::milliseconds interval{ 500 };
+  std::string name = telemetry::kDefaultName;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--once") {
+      once = true;
+    } else if (arg == "--interval" && i + 1 < argc) {
+      interval = std::chrono::milliseconds{ std::stol(argv[++i]) };
+    } else if (arg == "--name" && i + 1 < argc) {
+      name = argv[++i];
+    } else {
+      usage();
+      return arg == "--help" ? 0 : 2;
+    }
+  }
+
+  auto reader = TelemetryReader::open(name);
+  if (!reader) {
+    std::fprintf(stderr, "milo-top: no telemetry segment %s (daemon not running?)\n", name.c_str());
+    return 1;
+  }
+
+  TelemetrySnapshot snap;
+  for (;;) {
+    if (!reader->alive()) {
+      std::fprintf(stderr, "milo-top: daemon exited\n");
+      return 1;
+    }
+    // a record caught mid-update is simply shown on the next refresh
+    if (reader->snapshot(snap)) {
+      render(snap, !once);
+      if (once)
+        return 0;
+    }
+    std::this_thread::sleep_for(once ? std::chrono::milliseconds{ 1 } : interval);
+  }
+}
@@ -0,0 +1,184 @@
+/* @file UIController.cpp
+ * @brief Front-panel render thread: coalesced, frame-rate-capped OLED updates.
+ *
+ * © 2025 Milo Medical — MIT-licensed.
+ */
+
+// STL headers
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+// MiLO headers
+#include "core/ParameterStore.hpp"
+#include "core/RunStats.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/SystemEvent.hpp"
+#include "core/SystemState.hpp"
+#include "io/OLEDDisplay.hpp"
+#include "ui/UIController.hpp"
+
+using namespace milo::ui;
+
+UIController::UIController(std::unique_ptr<io::OLEDDisplay> display,
+                           std::chrono::milliseconds framePeriod)
+    : display_(std::move(display)), framePeriod_(framePeriod), state_(core::SystemState::BOOT) {
+  assert(display_ && "[UIController] display is nullptr");
+}
+
+UIController::~UIController() {
+  busListener_.reset(); // no more setDisplayState() from the listener
+  stop();
+}
+
+void UIController::attachEventBus(core::EventBus& bus) {
+  busListener_ = std::make_unique<core::BroadcastListener<core::SystemEvent>>(
+      bus, "ui", [this](const core::SystemEvent& e) {
+        if (e.kind == core::SystemEvent::Kind::StateChanged)
+          setDisplayState(e.to);
+      });
+}
+
+void UIController::start() {
+  if (running_.exchange(true))
+    return;
+  renderer_ = std::thread([this] {
+    if (profile_)
+      profile_->apply(core::ThreadRole::UI);
+    renderLoop();
+  });
+}
+
+void UIController::stop() {
+  if (!running_.exchange(false))
+    return;
+  wake();
+  if (renderer_.joinable())
+    renderer_.join();
+}
+
+void UIController::registerCallback(std::function<void(UIEvent)> cb) { cb_ = std::move(cb); }
+
+void UIController::setDisplayState(core::SystemState state) {
+  state_.store(state, std::memory_order_release);
+  wake();
+}
+
+void UIController::showParameterValue(core::Parameter param, float value) {
+  readout_.publish(Readout{ param, value, true });
+  wake();
+}
+
+void UIController::showStream(const core::StreamView& view) {
+  trace_.publish(view);
+  wake();
+}
+
+void UIController::showRunStats(std::span<const core::ChannelSummary> stats) {
+  RunSummary out;
+  for (const auto& s : stats.first(std::min(stats.size(), RunSummary::kLines))) {
+    // the numbers are what matter: the key gets whatever room they leave
+    char value[RunSummary::kChars + 1];
+    const auto n = std::min<std::size_t>(
+        static_cast<std::size_t>(
+            std::max(0, std::snprintf(value, sizeof(value), " %.4g+-%.2g", s.mean, s.stddev))),
+        RunSummary::kChars);
+    char* line = out.lines[out.count++]; // zero-filled: stays terminated
+    line = std::copy_n(s.key.data(), std::min(RunSummary::kChars - n, s.key.size()), line);
+    std::copy_n(value, n, line);
+  }
+  summary_.publish(out);
+  wake();
+}
+
+void UIController::wake() {
+  generation_.fetch_add(1, std::memory_order_release);
+  generation_.notify_one();
+}
+
+void UIController::renderLoop() {
+  using clock = std::chrono::steady_clock;
+
+  std::uint32_t seen = generation_.load(std::memory_order_acquire) - 1; // force first frame
+  auto nextFrame = clock::now();
+  core::SystemState drawnState{};
+  bool drawnAny = false;
+
+  for (;;) {
+    // idle: sleep until somebody publishes (or stop() wakes us)
+    generation_.wait(seen, std::memory_order_acquire);
+    const bool keepGoing = running_.load(std::memory_order_acquire);
+
+    // cap the frame rate; everything published meanwhile coalesces into one frame
+    if (keepGoing)
+      std::this_thread::sleep_until(nextFrame);
+    seen = generation_.load(std::memory_order_acquire);
+
+    const bool newReadout = readout_.consume();
+    const bool newTrace = trace_.consume();
+    const bool newSummary = summary_.consume();
+    const auto state = state_.load(std::memory_order_acquire);
+    if (newReadout || newTrace || newSummary || !drawnAny || state != drawnState) {
+      render(state, readout_.front(), trace_.front(), summary_.front());
+      drawnState = state;
+      drawnAny = true;
+      nextFrame = clock::now() + framePeriod_;
+    }
+
+    if (!keepGoing)
+      return;
+  }
+}
+
+void UIController::render(core::SystemState state, const Readout& readout,
+                          const core::StreamView& trace, const RunSummary& summary) {
+  auto& d = *display_;
+  d.clear();
+  d.drawText(0, 0, core::toString(state));
+
+  if (state == core::SystemState::FINISHED && summary.count > 0) {
+    for (std::uint8_t i = 0; i < summary.count; ++i)
+      d.drawText(0, 12 + 10 * i, summary.lines[i]);
+    d.flush();
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  if (readout.valid) {
+    d.drawText(0, 20, core::toString(readout.param));
+    d.drawNumber(0, 32, readout.value, 2);
+  }
+
+  if (trace.filled > 0) {
+    // channel name top right, trace in the bottom rows: one column per bucket
+    constexpr int kTop = 42, kBottom = io::OLEDDisplay::kHeight - 1;
+    constexpr std::size_t kNameChars = 12;
+    const std::string name(trace.key,
+                           std::min(std::char_traits<char>::length(trace.key), kNameChars));
+    d.drawText(io::OLEDDisplay::kWidth - io::OLEDDisplay::textWidth(name), 0, name);
+
+    core::MinMax range;
+    for (std::uint32_t i = 0; i < trace.filled; ++i)
+      if (!trace.buckets[i].empty()) {
+        range.add(trace.buckets[i].min);
+        range.add(trace.buckets[i].max);
+      }
+    const float span = range.max > range.min ? range.max - range.min : 1.0f;
+    const auto row = [&](float v) {
+      return kBottom - static_cast<int>((v - range.min) / span * (kBottom - kTop) + 0.5f);
+    };
+    // newest bucket at the right edge
+    const int x0 = io::OLEDDisplay::kWidth - static_cast<int>(trace.filled);
+    for (std::uint32_t i = 0; i < trace.filled; ++i) {
+      const auto& b = trace.buckets[i];
+      if (b.empty())
+        continue;
+      for (int y = row(b.max); y <= row(b.min); ++y)
+        d.setPixel(x0 + static_cast<int>(i), y, true);
+    }
+  }
+
+  d.flush();
+  frames_.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,149 @@
+#include "core/ConfigLoader.hpp"
+#include "core/DeviceRegistry.hpp"
+#include "core/Logger.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/Sweep.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include <sched.h>
+
+TEST(config_loader, runtime_block_overrides_only_what_it_names) {
+  using milo::core::ThreadRole;
+  const auto cfg = milo::core::runtimeConfig(nlohmann::json::parse(R"({
+    "runtime": { "realtime": false, "stackPrefaultKiB": 64,
+                 "threads": { "protocol": { "policy": "rr", "priority": 60 } },
+                 "jitter": { "samples": 10 } } })"));
+  EXPECT_FALSE(cfg.realtime);
+  EXPECT_TRUE(cfg.lockMemory);
+  EXPECT_EQ(cfg.stackPrefault, 64u * 1024);
+  EXPECT_EQ(cfg[ThreadRole::Protocol].policy, SCHED_RR);
+  EXPECT_EQ(cfg[ThreadRole::Protocol].priority, 60);
+  EXPECT_EQ(cfg[ThreadRole::Protocol].cpu, 1);
+  EXPECT_EQ(cfg[ThreadRole::Serial].priority, 70);
+  EXPECT_EQ(cfg.jitterSamples, 10u);
+
+  EXPECT_THROW(milo::core::runtimeConfig(nlohmann::json::parse(
+                   R"({ "runtime": { "threads": { "ui": { "policy": "realtime" } } } })")),
+               std::runtime_error);
+  EXPECT_TRUE(milo::core::runtimeConfig(nlohmann::json::object()).realtime);
+}
+
+TEST(config_loader, sweep_block_maps_ranges_lists_and_defaults) {
+  using milo::core::Parameter;
+  const auto plan = milo::core::sweepPlan(nlohmann::json::parse(R"({
+    "sweep": { "protocol": "lysis", "repeats": 2, "settleMs": 500, "stopOnError": true,
+               "axes": [ { "param": "Voltage", "from": 10, "to": 20, "step": 2.5 },
+                         { "param": "Temp", "values": [ 30, 37 ] } ] } })"));
+  ASSERT_TRUE(plan.has_value());
+  EXPECT_EQ(plan->protocol, "lysis");
+  EXPECT_EQ(plan->repeats, 2u);
+  EXPECT_EQ(plan->settle, std::chrono::milliseconds(500));
+  EXPECT_TRUE(plan->stopOnError);
+  ASSERT_EQ(plan->axes.size(), 2u);
+  EXPECT_EQ(plan->axes[0].param, Parameter::Voltage);
+  EXPECT_EQ(plan->axes[0].values, (std::vector<float>{ 10.0f, 12.5f, 15.0f, 17.5f, 20.0f }));
+  EXPECT_EQ(plan->axes[1].param, Parameter::Temp);
+  EXPECT_EQ(plan->axes[1].values, (std::vector<float>{ 30.0f, 37.0f }));
+  EXPECT_EQ(plan->size(), 5u * 2u * 2u);
+
+  const auto bare = milo::core::sweepPlan(nlohmann::json::parse(R"({
+    "sweep": { "protocol": "pcr" } })"));
+  ASSERT_TRUE(bare.has_value());
+  EXPECT_EQ(bare->repeats, 1u);
+  EXPECT_EQ(bare->settle.count(), 0);
+  EXPECT_FALSE(bare->stopOnError);
+  EXPECT_TRUE(bare->axes.empty());
+
+  EXPECT_FALSE(milo::core::sweepPlan(nlohmann::json::object()).has_value());
+}
+
+TEST(config_loader, sweep_block_rejects_what_it_cannot_run) {
+  for (const char* bad : {
+           R"({ "sweep": { "repeats": 2 } })",
+           R"({ "sweep": { "protocol": "lysis", "repeats": 0 } })",
+           R"({ "sweep": { "protocol": "lysis", "axes": [ { "param": "Psi", "values": [1] } ] } })",
+           R"({ "sweep": { "protocol": "lysis", "axes": [ { "param": "Temp", "from": 30 } ] } })",
+           R"({ "sweep": { "protocol": "lysis",
+                           "axes": [ { "param": "Temp", "from": 30, "to": 40, "step": 0 } ] } })",
+           R"({ "sweep": { "protocol": "lysis", "axes": [ { "param": "Temp", "values": 30 } ] } })",
+           R"({ "sweep": { "protocol": "lysis", "settleMs": "2s" } })" })
+    EXPECT_THROW(milo::core::sweepPlan(nlohmann::json::parse(bad)), std::runtime_error) << bad;
+}
+
+TEST(config_loader, logging_block_sets_quota_and_compression) {
+  const auto retention = milo::core::logRetention(nlohmann::json::parse(R"({
+    "logging": { "quotaMiB": 1.5, "compress": false } })"));
+  EXPECT_EQ(retention.quotaBytes, 1536u * 1024);
+  EXPECT_FALSE(retention.compress);
+
+  const auto defaults = milo::core::logRetention(nlohmann::json::object());
+  EXPECT_EQ(defaults.quotaBytes, milo::core::LogRetention{}.quotaBytes);
+  EXPECT_TRUE(defaults.compress);
+
+  for (const char* bad : { R"({ "logging": { "quotaMiB": 0 } })",
+                           R"({ "logging": { "quotaMiB": "1G" } })",
+                           R"({ "logging": { "compress": "yes" } })" })
+    EXPECT_THROW(milo::core::logRetention(nlohmann::json::parse(bad)), std::runtime_error) << bad;
+}
+
+TEST(config_loader, devices_block_builds_the_registry_in_order) {
+  using milo::core::Codec;
+  const auto registry = milo::core::deviceRegistry(nlohmann::json::parse(R"({
+    "devices": [ { "name": "PG", "path": "/dev/pg1", "serial": { "baud": 115200 } },
+                 { "name": "Pump2", "path": "/dev/pump2", "serial": { "baud": 250000 },
+                   "codec": "ascii-lf" },
+                 { "name": "Loop" } ] })"));
+  ASSERT_EQ(registry.size(), 3u);
+  const auto pump = registry.at("Pump2");
+  EXPECT_EQ(pump.index, 1u);
+  EXPECT_EQ(registry.spec(pump).path, "/dev/pump2");
+  EXPECT_EQ(registry.spec(pump).serial.baud, 250000u);
+  EXPECT_EQ(registry.spec(pump).codec, Codec::AsciiLf);
+  EXPECT_EQ(registry.spec(registry.at("PG")).codec, Codec::AsciiCrlf);
+  const auto& loop = registry.spec(registry.at("Loop"));
+  EXPECT_TRUE(loop.path.empty());
+  EXPECT_EQ(loop.serial, milo::io::SerialSettings{});
+
+  EXPECT_EQ(milo::core::deviceRegistry(nlohmann::json::object()).size(),
+            milo::core::DeviceRegistry::defaults().size());
+}
+
+TEST(config_loader, devices_block_rejects_bad_baud_codec_and_duplicates) {
+  for (const char* bad : {
+           R"({ "devices": [ { "name": "PG", "serial": { "baud": 0 } } ] })",
+           R"({ "devices": [ { "name": "PG", "serial": { "baud": 50000000 } } ] })",
+           R"({ "devices": [ { "name": "PG", "serial": { "baud": "fast" } } ] })",
+           R"({ "devices": [ { "name": "PG", "codec": "binary" } ] })",
+           R"({ "devices": [ { "name": "PG" }, { "name": "PG", "path": "/dev/pg2" } ] })",
+           R"({ "devices": [ { "name": "" } ] })",
+           R"({ "devices": [ { "path": "/dev/pg1" } ] })",
+           R"({ "devices": { "name": "PG" } })" })
+    EXPECT_THROW(milo::core::deviceRegistry(nlohmann::json::parse(bad)), std::runtime_error)
+        << bad;
+}
+
+TEST(config_loader, devices_serial_object_sets_the_line_settings) {
+  const auto registry = milo::core::deviceRegistry(nlohmann::json::parse(R"({
+    "devices": [ { "name": "PSU", "path": "/dev/psu1",
+                   "serial": { "baud": 1000000, "lowLatency": false, "vmin": 4, "vtime": 2 } },
+                 { "name": "PG", "serial": { "vmin": 3 } } ] })"));
+  EXPECT_EQ(registry.spec(registry.at("PSU")).serial,
+            (milo::io::SerialSettings{ .baud = 1'000'000, .lowLatency = false, .vmin = 4,
+                                       .vtime = 2 }));
+  EXPECT_EQ(registry.spec(registry.at("PG")).serial,
+            (milo::io::SerialSettings{ .vmin = 3 }));
+
+  for (const char* bad : {
+           R"({ "devices": [ { "name": "PSU", "serial": { "vmin": 256 } } ] })",
+           R"({ "devices": [ { "name": "PSU", "serial": { "vtime": -1 } } ] })",
+           R"({ "devices": [ { "name": "PSU", "serial": { "lowLatency": "on" } } ] })",
+           R"({ "devices": [ { "name": "PSU", "serial": 115200 } ] })" })
+    EXPECT_THROW(milo::core::deviceRegistry(nlohmann::json::parse(bad)), std::runtime_error)
+        << bad;
+}
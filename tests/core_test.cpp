@@ -1,3 +1,1404 @@
+#include "core/AllocationGuard.hpp"
+#include "core/BroadcastRing.hpp"
+#include "core/Checkpoint.hpp"
+#include "core/ControlServer.hpp"
+#include "core/ErrorMonitor.hpp"
+#include "core/Logger.hpp"
+#include "core/ParameterStore.hpp"
+#include "core/ProtocolFactory.hpp"
+#include "core/RPCManager.hpp"
+#include "core/RingBuffer.hpp"
+#include "core/RunArena.hpp"
+#include "core/RunStats.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/SampleStream.hpp"
+#include "core/Sweep.hpp"
+#include "core/SystemCoordinator.hpp"
+#include "core/SystemEvent.hpp"
+#include "core/Telemetry.hpp"
+#include "core/TimerWheel.hpp"
+#include "protocols/ExperimentProtocol.hpp"
+
+#include "FakeSerialChannel.hpp"
+
 #include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
 TEST(rpc_tests, passes) {}
 
+TEST(ring_buffer, rejects_push_when_full_and_preserves_order) {
+  milo::core::RingBuffer<int> rb(3); // rounded up to 4
+  ASSERT_EQ(rb.capacity(), 4u);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(rb.push(i));
+  EXPECT_FALSE(rb.push(99));
+
+  int v = -1;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(rb.pop(v));
+    EXPECT_EQ(v, i);
+  }
+  EXPECT_FALSE(rb.pop(v));
+}
+
+TEST(ring_buffer, spsc_transfers_every_item_across_threads) {
+  milo::core::RingBuffer<std::uint32_t> rb(64);
+  constexpr std::uint32_t kItems = 200000;
+
+  std::thread producer([&] {
+    for (std::uint32_t i = 0; i < kItems;)
+      if (rb.push(i))
+        ++i;
+      else
+        std::this_thread::yield(); // full: let the consumer run (single-core runners)
+  });
+
+  std::uint32_t expected = 0, v = 0;
+  while (expected < kItems) {
+    if (rb.pop(v))
+      ASSERT_EQ(v, expected++);
+    else
+      std::this_thread::yield();
+  }
+  producer.join();
+}
+
+namespace {
+  using namespace std::chrono_literals;
+  using milo::core::Timer;
+  using milo::core::TimerWheel;
+} // namespace
+
+TEST(timer_wheel, fires_in_deadline_order_and_never_early) {
+  TimerWheel wheel(1ms, false, std::chrono::nanoseconds{ 0 });
+  std::vector<int> order;
+  Timer a([&] { order.push_back(1); }), b([&] { order.push_back(2); }), c([&] { order.push_back(3); });
+  wheel.arm(c, 30ms);
+  wheel.arm(a, 10ms);
+  wheel.arm(b, 20ms);
+  ASSERT_EQ(wheel.nextDeadline(), std::chrono::nanoseconds{ 10ms });
+
+  EXPECT_EQ(wheel.advance(9ms), 0u);
+  EXPECT_EQ(wheel.advance(25ms), 2u);
+  EXPECT_EQ(order, (std::vector<int>{ 1, 2 }));
+  EXPECT_EQ(wheel.advance(30ms), 1u);
+  EXPECT_EQ(wheel.size(), 0u);
+  EXPECT_FALSE(wheel.nextDeadline().has_value());
+}
+
+TEST(timer_wheel, cancel_and_rearm) {
+  TimerWheel wheel(1ms, false, std::chrono::nanoseconds{ 0 });
+  int fired = 0;
+  Timer t([&] { ++fired; });
+  wheel.arm(t, 5ms);
+  t.cancel();
+  EXPECT_FALSE(t.armed());
+  EXPECT_EQ(wheel.advance(10ms), 0u);
+
+  wheel.armAfter(t, 5ms);
+  wheel.arm(t, 50ms); // re-arm moves it, does not duplicate
+  EXPECT_EQ(wheel.size(), 1u);
+  wheel.advance(49ms);
+  EXPECT_EQ(fired, 0);
+  wheel.advance(50ms);
+  EXPECT_EQ(fired, 1);
+
+  {
+    Timer scoped([&] { ++fired; });
+    wheel.armAfter(scoped, 1ms);
+  } // destructor unlinks
+  EXPECT_EQ(wheel.size(), 0u);
+  wheel.advance(100ms);
+  EXPECT_EQ(fired, 1);
+}
+
+TEST(timer_wheel, long_delays_cascade_to_exact_tick) {
+  TimerWheel wheel(1ms, false, std::chrono::nanoseconds{ 0 });
+  std::vector<std::chrono::nanoseconds> at;
+  const std::chrono::milliseconds delays[] = { 63ms, 64ms, 4095ms, 4096ms, 300'000ms, 90'000'000ms };
+  std::vector<std::unique_ptr<Timer>> timers;
+  for (auto d : delays) {
+    timers.push_back(std::make_unique<Timer>([&] { at.push_back(wheel.now()); }));
+    wheel.arm(*timers.back(), d);
+  }
+
+  // stepping to each next deadline must land on the exact expiry, cascades included
+  while (auto next = wheel.nextDeadline())
+    wheel.advance(*next);
+
+  ASSERT_EQ(at.size(), std::size(delays));
+  for (std::size_t i = 0; i < at.size(); ++i)
+    EXPECT_EQ(at[i], std::chrono::nanoseconds{ delays[i] });
+}
+
+TEST(timer_wheel, service_next_jumps_a_virtual_clock) {
+  milo::core::VirtualClock clock;
+  TimerWheel wheel(1ms, false, clock.now());
+  wheel.setClock(clock);
+  std::vector<std::chrono::nanoseconds> at;
+  Timer debounce([&] { at.push_back(clock.now()); }), hold([&] { at.push_back(clock.now()); });
+  wheel.arm(debounce, 20ms);
+  wheel.arm(hold, 45'000ms); // cascades from an outer level
+
+  const auto wall0 = std::chrono::steady_clock::now();
+  EXPECT_EQ(wheel.serviceNext(), 1u);
+  EXPECT_EQ(wheel.serviceNext(), 1u);
+  EXPECT_EQ(wheel.serviceNext(), 0u); // nothing armed: returns without waiting
+  EXPECT_LT(std::chrono::steady_clock::now() - wall0, 1s);
+  EXPECT_EQ(at, (std::vector<std::chrono::nanoseconds>{ 20ms, 45'000ms }));
+}
+
+TEST(timer_wheel, thousands_of_random_timers_fire_once_in_order) {
+  TimerWheel wheel(1ms, false, std::chrono::nanoseconds{ 0 });
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> dist(1, 600'000);
+
+  constexpr std::size_t kTimers = 5000;
+  std::vector<std::unique_ptr<Timer>> timers;
+  std::vector<std::chrono::milliseconds> deadline(kTimers);
+  std::vector<int> fired(kTimers, 0);
+  std::chrono::nanoseconds last{ 0 };
+  bool ordered = true;
+  for (std::size_t i = 0; i < kTimers; ++i) {
+    deadline[i] = std::chrono::milliseconds{ dist(rng) };
+    timers.push_back(std::make_unique<Timer>([&, i] {
+      ++fired[i];
+      ordered = ordered && wheel.now() >= last && wheel.now() == deadline[i];
+      last = wheel.now();
+    }));
+    wheel.arm(*timers[i], deadline[i]);
+  }
+  for (std::size_t i = 0; i < kTimers; i += 3) // cancel a third of them
+    timers[i]->cancel();
+
+  // coarse, irregular advances, like a late-scheduled owner thread
+  for (auto now = 0ms; now <= 600'000ms; now += 777ms)
+    wheel.advance(now);
+  wheel.advance(601'000ms);
+
+  EXPECT_TRUE(ordered); // each fired on its own tick, in deadline order
+  for (std::size_t i = 0; i < kTimers; ++i)
+    EXPECT_EQ(fired[i], i % 3 == 0 ? 0 : 1) << "timer " << i;
+  EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(timer_wheel, callback_can_rearm_itself) {
+  TimerWheel wheel(1ms, false, std::chrono::nanoseconds{ 0 });
+  int ticks = 0;
+  Timer periodic;
+  periodic.setCallback([&] {
+    if (++ticks < 5)
+      wheel.armAfter(periodic, 10ms);
+  });
+  wheel.armAfter(periodic, 10ms);
+  EXPECT_EQ(wheel.advance(1000ms), 5u);
+  EXPECT_EQ(ticks, 5);
+}
+
+TEST(runtime_profile, default_priorities_follow_thread_roles) {
+  using milo::core::ThreadRole;
+  milo::core::RuntimeConfig cfg;
+  EXPECT_GT(cfg[ThreadRole::Protocol].priority, cfg[ThreadRole::Serial].priority);
+  EXPECT_GT(cfg[ThreadRole::Serial].priority, cfg[ThreadRole::UI].priority);
+  EXPECT_EQ(cfg[ThreadRole::Logger].policy, SCHED_OTHER);
+  EXPECT_EQ(cfg[ThreadRole::Protocol].cpu, 1);
+
+  EXPECT_EQ(milo::core::RuntimeProfile::parsePolicy("fifo"), SCHED_FIFO);
+  EXPECT_EQ(milo::core::RuntimeProfile::parsePolicy("idle"), SCHED_IDLE);
+  EXPECT_FALSE(milo::core::RuntimeProfile::parsePolicy("realtime").has_value());
+
+  EXPECT_EQ(milo::core::RuntimeProfile(cfg).describe(),
+            "protocol=fifo/80@cpu1 serial=fifo/70@cpu1 ui=fifo/50@cpu0 logger=other@cpu0 "
+            "control=other@cpu0 mlock=on");
+}
+
+namespace {
+  struct DummyProtocol : milo::protocols::ExperimentProtocol {
+    static inline int alive = 0;
+    std::pmr::vector<int> steps;
+    explicit DummyProtocol(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : steps(mr) {
+      ++alive;
+    }
+    ~DummyProtocol() override { --alive; }
+    void run(milo::core::RPCManager&, milo::core::Logger&,
+             const milo::core::ParameterStore&) override {}
+  };
+} // namespace
+
+TEST(run_arena, serves_pmr_containers_from_buffer_and_resets) {
+  milo::core::RunArena arena; // 256 KiB
+  {
+    std::pmr::vector<int> v(arena.resource());
+    for (int i = 0; i < 1000; ++i)
+      v.push_back(i);
+    std::pmr::string s("a command string longer than SSO", arena.resource());
+    EXPECT_GT(arena.used(), 4000u);
+  }
+  EXPECT_EQ(arena.spills(), 0u);
+  arena.reset();
+  EXPECT_EQ(arena.used(), 0u);
+  EXPECT_GT(arena.peak(), 4000u);
+
+  // overflow still works, but is counted
+  std::pmr::vector<char> big(512 * 1024, 'x', arena.resource());
+  EXPECT_GT(arena.spills(), 0u);
+}
+
+TEST(run_arena, protocol_factory_builds_in_arena) {
+  milo::core::RunArena arena;
+  milo::core::ProtocolFactory factory;
+  EXPECT_TRUE(factory.registerProtocol("dummy", milo::core::ProtocolFactory::creatorFor<DummyProtocol>()));
+  EXPECT_FALSE(factory.registerProtocol("dummy", milo::core::ProtocolFactory::creatorFor<DummyProtocol>()));
+  EXPECT_THROW(factory.create("nope", arena), std::out_of_range);
+
+  auto p = factory.create("dummy", arena);
+  EXPECT_EQ(DummyProtocol::alive, 1);
+  EXPECT_GT(arena.used(), 0u);
+  p.reset();
+  EXPECT_EQ(DummyProtocol::alive, 0);
+}
+
+TEST(allocation_guard, counts_sites_while_armed_and_honours_exempt) {
+  if (!milo::core::AllocationGuard::kCompiledIn)
+    GTEST_SKIP() << "built without MILO_ALLOC_GUARD";
+  using milo::core::AllocationGuard;
+
+  milo::core::RunArena arena;
+  AllocationGuard::arm(AllocationGuard::Mode::Count);
+  {
+    std::pmr::vector<int> inArena(100, 0, arena.resource()); // arena: not counted
+    auto leak = std::make_unique<int[]>(100);                // heap: counted
+    AllocationGuard::Exempt exempt;
+    auto allowed = std::make_unique<int>(1);                 // exempt: not counted
+  }
+  AllocationGuard::disarm();
+  (void)std::make_unique<int>(2); // disarmed
+
+  EXPECT_EQ(AllocationGuard::count(), 1u);
+  EXPECT_EQ(AllocationGuard::bytes(), 400u);
+  const auto sites = AllocationGuard::sites();
+  ASSERT_EQ(sites.size(), 1u);
+  EXPECT_GT(sites[0].depth, 0u);
+  EXPECT_NE(AllocationGuard::report().find("1 allocation(s), 400 bytes"), std::string::npos);
+}
+
+TEST(allocation_guard, abort_mode_stops_at_first_allocation) {
+  if (!milo::core::AllocationGuard::kCompiledIn)
+    GTEST_SKIP() << "built without MILO_ALLOC_GUARD";
+  using milo::core::AllocationGuard;
+  GTEST_FLAG_SET(death_test_style, "threadsafe");
+  EXPECT_DEATH(
+      {
+        AllocationGuard::arm(AllocationGuard::Mode::Abort);
+        auto p = std::make_unique<long>(7);
+        AllocationGuard::disarm();
+      },
+      "heap allocation while RUNNING");
+}
+
+TEST(sweep_plan, expands_cartesian_product_last_axis_fastest) {
+  using milo::core::Parameter;
+  milo::core::SweepPlan plan;
+  plan.axes = { milo::core::SweepAxis::range(Parameter::Voltage, 10.0f, 11.0f, 0.1f),
+                milo::core::SweepAxis::list(Parameter::Temp, { 30.0f, 37.0f }) };
+  ASSERT_EQ(plan.axes[0].values.size(), 11u); // end point survives float accumulation
+  EXPECT_FLOAT_EQ(plan.axes[0].values.back(), 11.0f);
+  EXPECT_EQ(plan.size(), 22u);
+
+  const auto p3 = plan.point(3);
+  EXPECT_EQ(milo::core::SweepPlan::label(p3), "Voltage=10.1 Temp=37");
+  plan.repeats = 2;
+  EXPECT_EQ(plan.size(), 44u);
+  EXPECT_EQ(plan.point(6), p3);
+  EXPECT_THROW(plan.point(44), std::out_of_range);
+
+  EXPECT_EQ(milo::core::SweepAxis::range(Parameter::Temp, 5, 1, 2).values,
+            (std::vector<float>{ 5, 3, 1 }));
+  EXPECT_THROW(milo::core::SweepAxis::range(Parameter::Temp, 0, 1, 0), std::invalid_argument);
+  EXPECT_EQ(milo::core::parseParameter("FlowRate"), Parameter::FlowRate);
+  EXPECT_FALSE(milo::core::parseParameter("flow"));
+}
+
+TEST(system_coordinator, running_is_policed_and_finished_resets_arena) {
+  milo::core::SystemCoordinator sc;
+  sc.initialize();
+  EXPECT_EQ(sc.state(), milo::core::SystemState::IDLE);
+
+  sc.handleStart();
+  EXPECT_EQ(sc.state(), milo::core::SystemState::RUNNING);
+  {
+    std::pmr::string cmd("PULSE 10 WIDTH 250 DELAY 1000", sc.runArena().resource());
+    EXPECT_GT(sc.runArena().used(), 0u);
+  }
+  sc.handleAbort();
+  EXPECT_EQ(sc.state(), milo::core::SystemState::FINISHED);
+  EXPECT_EQ(sc.runArena().used(), 0u);
+  EXPECT_TRUE(sc.lastAllocationReport().empty()) << sc.lastAllocationReport();
+
+  if (milo::core::AllocationGuard::kCompiledIn) {
+    sc.handleStart();
+    auto regression = std::make_unique<std::string>("built on the heap mid-run");
+    sc.handleAbort();
+    EXPECT_NE(sc.lastAllocationReport().find("heap allocation(s) while RUNNING"), std::string::npos);
+  }
+  EXPECT_THROW(sc.initialize(), std::logic_error);
+}
+
+TEST(system_coordinator, a_run_ending_in_error_resets_arena_too) {
+  milo::core::SystemCoordinator sc;
+  sc.initialize();
+  sc.handleStart();
+  void *leftover = sc.runArena().resource()->allocate(512); // a run that failed mid-way
+  ASSERT_NE(leftover, nullptr);
+  EXPECT_GE(sc.runArena().used(), 512u);
+  sc.handleError("pump stalled");
+  EXPECT_EQ(sc.state(), milo::core::SystemState::ERROR);
+  EXPECT_EQ(sc.runArena().used(), 0u);
+}
+
+namespace {
+  /// Records the setpoints it ran with; fails on request. Builds its command in the arena.
+  struct SweepProbe : milo::protocols::ExperimentProtocol {
+    static inline int constructed = 0;
+    static inline std::atomic<int> runs = 0;
+    static inline int failOn = -1;
+    static inline float seen[16][2]{};
+    static inline std::pmr::memory_resource* memory = nullptr;
+
+    SweepProbe() { ++constructed; }
+    void useMemory(std::pmr::memory_resource& mr) override { memory = &mr; }
+    void run(milo::core::RPCManager&, milo::core::Logger&,
+             const milo::core::ParameterStore& store) override {
+      const milo::protocols::Command cmd{ std::pmr::string("PULSE 10 WIDTH 250 DELAY 1000",
+                                                           memory) };
+      seen[runs][0] = store.get(milo::core::Parameter::Voltage);
+      seen[runs][1] = store.get(milo::core::Parameter::Temp);
+      if (runs++ == failOn)
+        throw std::runtime_error("probe failure, as requested");
+    }
+  };
+
+  struct SweepFixture {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() /
+                                ("milo_sweep_" + std::to_string(::getpid()));
+    milo::core::RPCManager rpc{ std::make_shared<milo::core::ErrorMonitor>() };
+    milo::core::Logger log{ dir.string(), 64 };
+    milo::core::ParameterStore params;
+    milo::core::ProtocolFactory factory;
+    milo::core::SystemCoordinator sc;
+
+    SweepFixture() {
+      SweepProbe::constructed = SweepProbe::runs = 0;
+      log.setRetention({ .compress = false }); // run logs are read back as plain CSV below
+      factory.registerProtocol("probe", milo::core::ProtocolFactory::creatorFor<SweepProbe>());
+      sc.attachRunContext(rpc, log, params, factory);
+      sc.initialize();
+    }
+    ~SweepFixture() { std::filesystem::remove_all(dir); }
+  };
+} // namespace
+
+TEST(system_coordinator, sweep_runs_every_point_back_to_back) {
+  using milo::core::Parameter;
+  SweepFixture f;
+  SweepProbe::failOn = 2;
+  milo::core::SweepPlan plan;
+  plan.protocol = "probe";
+  plan.axes = { milo::core::SweepAxis::list(Parameter::Voltage, { 10, 20 }),
+                milo::core::SweepAxis::range(Parameter::Temp, 30, 34, 2) };
+  plan.settle = std::chrono::milliseconds{ 1 };
+
+  const auto summary = f.sc.runSweep(plan);
+
+  EXPECT_EQ(f.sc.state(), milo::core::SystemState::IDLE);
+  EXPECT_EQ(SweepProbe::constructed, 6); // rebuilt in the run arena for every run
+  EXPECT_EQ(SweepProbe::memory, f.sc.runArena().resource());
+  EXPECT_EQ(f.sc.runArena().used(), 0u);
+  ASSERT_EQ(summary.runs.size(), 6u);
+  EXPECT_EQ(summary.failed, 1u);
+  EXPECT_FALSE(summary.aborted);
+  EXPECT_FALSE(summary.runs[2].ok);
+  EXPECT_FLOAT_EQ(SweepProbe::seen[4][0], 20.0f);
+  EXPECT_FLOAT_EQ(SweepProbe::seen[4][1], 32.0f);
+  EXPECT_TRUE(f.sc.lastAllocationReport().empty()) << f.sc.lastAllocationReport();
+
+  // one log per run, its header naming the point; one summary row per run
+  EXPECT_NE(summary.runs[0].logPath, summary.runs[1].logPath);
+  std::ifstream run4(summary.runs[4].logPath);
+  const std::string head((std::istreambuf_iterator<char>(run4)), {});
+  EXPECT_NE(head.find("# sweep_run: 5/6"), std::string::npos);
+  EXPECT_NE(head.find("# sweep_point: Voltage=20 Temp=32"), std::string::npos);
+
+  std::ifstream csv(summary.path);
+  std::vector<std::string> rows;
+  for (std::string line; std::getline(csv, line);)
+    rows.push_back(line);
+  ASSERT_EQ(rows.size(), 9u);
+  EXPECT_EQ(rows[2], "run,Voltage,Temp,ok,duration_ms,error,log");
+  EXPECT_EQ(rows[5].rfind("3,10,34,0,", 0), 0u) << rows[5];
+}
+
+TEST(system_coordinator, sweep_stops_on_error_or_abort) {
+  SweepFixture f;
+  milo::core::SweepPlan plan;
+  plan.protocol = "probe";
+  plan.axes = { milo::core::SweepAxis::range(milo::core::Parameter::Voltage, 1, 5, 1) };
+
+  SweepProbe::failOn = 1;
+  plan.stopOnError = true;
+  auto summary = f.sc.runSweep(plan);
+  EXPECT_EQ(summary.runs.size(), 2u);
+  EXPECT_TRUE(summary.aborted);
+  EXPECT_EQ(f.sc.state(), milo::core::SystemState::ERROR);
+  EXPECT_THROW(f.sc.runSweep(plan), std::logic_error);
+
+  // abort during the settle wait: the current run completes, no further run starts
+  SweepFixture g;
+  SweepProbe::failOn = -1;
+  plan.stopOnError = false;
+  plan.settle = std::chrono::seconds{ 10 };
+  std::thread ui([&] {
+    while (SweepProbe::runs == 0)
+      std::this_thread::yield();
+    g.sc.handleAbort();
+  });
+  const auto t0 = std::chrono::steady_clock::now();
+  summary = g.sc.runSweep(plan);
+  ui.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - t0, std::chrono::seconds{ 5 });
+  EXPECT_EQ(summary.runs.size(), 1u);
+  EXPECT_TRUE(summary.aborted);
+  EXPECT_EQ(g.sc.state(), milo::core::SystemState::IDLE);
+
+  plan.protocol = "unknown";
+  EXPECT_THROW(g.sc.runSweep(plan), std::out_of_range);
+}
+
+TEST(system_coordinator, every_run_log_starts_with_the_timing_conditions) {
+  using namespace milo::core;
+  RuntimeConfig cfg;
+  cfg.realtime = false; // unprivileged test host
+  cfg.jitterPeriod = std::chrono::microseconds{ 200 };
+  cfg.jitterSamples = 20;
+  const RuntimeProfile profile(cfg);
+  SweepFixture f; // the Logger is attached before the conditions are known, as in the daemon
+  f.sc.setRunConditions(profile, profile.measureJitter());
+
+  SweepPlan plan;
+  plan.protocol = "probe";
+  plan.axes = { SweepAxis::list(Parameter::Voltage, { 10, 20 }) };
+  const auto summary = f.sc.runSweep(plan);
+  ASSERT_EQ(summary.runs.size(), 2u);
+  for (const auto &run : summary.runs) {
+    std::ifstream in(run.logPath);
+    const std::string head((std::istreambuf_iterator<char>(in)), {});
+    EXPECT_EQ(head.rfind("# jitter: period=200us n=20 ", 0), 0u) << head.substr(0, 80);
+    EXPECT_NE(head.find("\n# runtime: " + profile.describe() + "\n"), std::string::npos);
+  }
+}
+
+namespace {
+  /// A run that measures: 100 voltage readings around the swept setpoint.
+  struct MeasuringProbe : milo::protocols::ExperimentProtocol {
+    void run(milo::core::RPCManager& rpc, milo::core::Logger&,
+             const milo::core::ParameterStore& store) override {
+      const double v = store.get(milo::core::Parameter::Voltage);
+      for (int i = 0; i < 100; ++i)
+        rpc.stats()->add(milo::core::Device{ 0 }, "PSU", "VOLT", v + (i % 2 ? 0.1 : -0.1));
+    }
+  };
+} // namespace
+
+TEST(system_coordinator, run_statistics_reach_summary_log_manifest_and_display) {
+  using namespace milo::core;
+  SweepFixture f;
+  RunStats stats;
+  f.rpc.attachStats(stats);
+  f.factory.registerProtocol("measure", ProtocolFactory::creatorFor<MeasuringProbe>());
+  std::vector<std::string> shown;
+  f.sc.onRunStats([&](std::span<const ChannelSummary> s) {
+    for (const auto& c : s)
+      shown.push_back(c.key + " " + c.toString());
+  });
+  SweepPlan plan;
+  plan.protocol = "measure";
+  plan.axes = { SweepAxis::list(Parameter::Voltage, { 10, 20 }) };
+
+  const auto summary = f.sc.runSweep(plan);
+
+  ASSERT_EQ(summary.runs.size(), 2u);
+  EXPECT_TRUE(f.sc.lastAllocationReport().empty()) << f.sc.lastAllocationReport();
+  ASSERT_EQ(shown.size(), 2u); // reset between runs: one channel each
+  const auto& s = summary.runs[1].stats;
+  ASSERT_EQ(s.size(), 1u);
+  EXPECT_EQ(s[0].key, "PSU.VOLT");
+  EXPECT_EQ(s[0].count, 100u);
+  EXPECT_NEAR(s[0].mean, 20.0, 1e-9);
+  EXPECT_NEAR(s[0].max, 20.1, 1e-9);
+
+  std::ifstream run(summary.runs[1].logPath);
+  const std::string text((std::istreambuf_iterator<char>(run)), {});
+  EXPECT_NE(text.find("# stats: " + shown[1] + "\n"), std::string::npos) << text;
+
+  // persisted: a fresh manifest of the directory reads it back
+  const RunManifest manifest(f.dir.string());
+  const auto rec =
+      manifest.find(std::filesystem::path(summary.runs[1].logPath).filename().string());
+  ASSERT_TRUE(rec.has_value());
+  EXPECT_EQ(rec->stats, shown[1]);
+}
+
+namespace {
+  /// Ten steps per run, reported to the checkpointer; "crashes" on request.
+  struct SteppingProbe : milo::protocols::ExperimentProtocol {
+    struct Crash {}; ///< not a std::exception: escapes runSweep() like a reset would
+    static constexpr std::uint32_t kSteps = 10;
+    static inline int runs = 0;
+    static inline int crashRun = -1;
+    static inline std::uint32_t crashStep = 0;
+    static inline std::uint32_t firstStep[8]{};
+    milo::core::Checkpointer *cp = nullptr;
+
+    void useCheckpoints(milo::core::Checkpointer &c) override { cp = &c; }
+    void run(milo::core::RPCManager &, milo::core::Logger &,
+             const milo::core::ParameterStore &) override {
+      const auto first = cp ? cp->firstStep() : 0;
+      firstStep[runs] = first;
+      for (auto step = first; step < kSteps; ++step) {
+        if (runs == crashRun && step == crashStep)
+          throw Crash{};
+        if (cp)
+          cp->reached(step + 1);
+      }
+      ++runs;
+    }
+  };
+} // namespace
+
+TEST(system_coordinator, interrupted_sweep_resumes_from_its_last_checkpoint) {
+  using namespace milo::core;
+  SweepFixture f;
+  for (auto dev : f.rpc.devices().all()) { // the MCUs answer the handshake PING
+    auto fake = std::make_unique<milo::test::FakeSerialChannel>();
+    fake->next_read_line = "OK";
+    f.rpc.attachChannel(dev, std::move(fake));
+  }
+  f.factory.registerProtocol("stepping", ProtocolFactory::creatorFor<SteppingProbe>());
+  CheckpointStore store(f.dir.string());
+  f.sc.attachCheckpoints(store, Clock::Duration{ 0 }); // every step is persisted
+  SteppingProbe::runs = 0;
+  SteppingProbe::crashRun = 1;
+  SteppingProbe::crashStep = 4;
+
+  SweepPlan plan;
+  plan.protocol = "stepping";
+  plan.axes = { SweepAxis::list(Parameter::Voltage, { 10, 20, 30 }) };
+  f.params.set(Parameter::FlowRate, 2.5f); // not swept: only the snapshot restores it
+  EXPECT_THROW(f.sc.runSweep(plan), SteppingProbe::Crash);
+  AllocationGuard::disarm(); // the "reset" left it armed
+  SteppingProbe::crashRun = -1;
+
+  // next boot: same log directory, fresh coordinator and parameters
+  ParameterStore params;
+  SystemCoordinator sc;
+  sc.attachCheckpoints(store);
+  sc.attachRunContext(f.rpc, f.log, params, f.factory);
+  sc.initialize();
+  const auto &cp = sc.interruptedRun();
+  ASSERT_TRUE(cp.has_value());
+  EXPECT_STREQ(cp->protocol, "stepping");
+  EXPECT_EQ(cp->sweepRun, 1u);
+  EXPECT_EQ(cp->step, 4u); // steps 0 … 3 were done
+  EXPECT_NE(std::string(cp->run).find("_run"), std::string::npos);
+
+  SweepPlan other = plan;
+  other.protocol = "probe";
+  EXPECT_THROW(sc.resumeSweep(other), std::invalid_argument);
+
+  const std::string interruptedLog = cp->run;
+  const auto summary = sc.resumeSweep(plan);
+  EXPECT_TRUE(summary.allOk());
+  ASSERT_EQ(summary.runs.size(), 2u); // runs 2 and 3 of 3
+  EXPECT_EQ(summary.runs[0].index, 1u);
+  EXPECT_EQ(SteppingProbe::firstStep[1], 4u);
+  EXPECT_EQ(SteppingProbe::firstStep[2], 0u);
+  EXPECT_FLOAT_EQ(params.get(Parameter::FlowRate), 2.5f);
+  EXPECT_FLOAT_EQ(params.get(Parameter::Voltage), 30.0f);
+  EXPECT_LT(sc.lastResumeLatency(), std::chrono::milliseconds{ 100 });
+  EXPECT_TRUE(sc.lastAllocationReport().empty()) << sc.lastAllocationReport(); // saves included
+  EXPECT_FALSE(sc.interruptedRun());
+  EXPECT_FALSE(store.load()); // done: nothing left to resume
+
+  std::ifstream resumed(summary.runs[0].logPath);
+  const std::string head((std::istreambuf_iterator<char>(resumed)), {});
+  EXPECT_NE(head.find("# resumed_from: " + interruptedLog + " step 4\n"), std::string::npos);
+  std::ifstream next(summary.runs[1].logPath);
+  const std::string nextHead((std::istreambuf_iterator<char>(next)), {});
+  EXPECT_EQ(nextHead.find("resumed_from"), std::string::npos);
+}
+
+TEST(system_coordinator, resume_needs_every_mcu_to_answer_the_handshake) {
+  using namespace milo::core;
+  SweepFixture f;
+  std::vector<milo::test::FakeSerialChannel *> fakes;
+  for (auto dev : f.rpc.devices().all()) {
+    auto fake = std::make_unique<milo::test::FakeSerialChannel>();
+    fake->next_read_line = "OK";
+    fakes.push_back(fake.get());
+    f.rpc.attachChannel(dev, std::move(fake));
+  }
+  fakes.back()->next_read_line = std::nullopt; // the pump stays silent
+  CheckpointStore store(f.dir.string());
+  Checkpoint cp;
+  std::snprintf(cp.protocol, sizeof(cp.protocol), "probe");
+  cp.sweepTotal = 2;
+  ASSERT_TRUE(store.save(cp));
+
+  SystemCoordinator sc;
+  sc.attachCheckpoints(store);
+  sc.attachRunContext(f.rpc, f.log, f.params, f.factory);
+  sc.initialize();
+  ASSERT_TRUE(sc.interruptedRun());
+
+  SweepPlan plan;
+  plan.protocol = "probe";
+  plan.axes = { SweepAxis::list(Parameter::Temp, { 30, 37 }) };
+  EXPECT_THROW(sc.resumeSweep(plan), std::runtime_error); // timed out, not rejected
+  EXPECT_EQ(sc.state(), SystemState::IDLE);
+  for (auto *fake : fakes)
+    EXPECT_EQ(fake->getLastWritten(), "PING"); // all pinged before waiting on any
+  EXPECT_TRUE(sc.interruptedRun()); // still on offer
+
+  sc.discardInterruptedRun();
+  EXPECT_FALSE(sc.interruptedRun());
+  EXPECT_FALSE(store.load());
+}
+
+TEST(telemetry, seqlock_reader_never_sees_torn_record) {
+  struct Pair {
+    std::uint64_t a, b;
+  };
+  milo::core::Seqlocked<Pair> rec;
+  rec.data = { 0, ~std::uint64_t{ 0 } };
+  std::atomic<bool> done{ false };
+
+  std::thread writer([&] {
+    for (std::uint64_t i = 1; i <= 200000; ++i)
+      rec.update([i](Pair& p) {
+        p.a = i;
+        p.b = ~i;
+      });
+    done = true;
+  });
+
+  std::size_t reads = 0;
+  while (!done) {
+    Pair p{};
+    if (rec.read(p)) {
+      ASSERT_EQ(p.b, ~p.a);
+      ++reads;
+    }
+  }
+  writer.join();
+  EXPECT_GT(reads, 0u);
+}
+
+TEST(telemetry, reader_sees_published_counters_through_shared_memory) {
+  using namespace milo::core;
+  const std::string name = "/milo-telemetry-test-" + std::to_string(::getpid());
+  {
+    auto pub = TelemetryPublisher::create(name);
+    ASSERT_NE(pub, nullptr);
+    const int psu = pub->addDevice("PSU");
+    const int q = pub->addQueue("log-queue", 4096);
+    const int t = pub->addThread("logger");
+    pub->commandSent(psu);
+    pub->replyReceived(psu, std::chrono::microseconds{ 800 });
+    pub->commandSent(psu);
+    pub->replyReceived(psu, std::chrono::microseconds{ 1600 });
+    pub->deviceError(psu);
+    pub->deviceError(99); // unclaimed slot: ignored
+    pub->queueLevel(q, 12, 3);
+    pub->queueLevel(q, 5, 3);
+    pub->heartbeat(t);
+    pub->publishState(SystemState::RUNNING);
+
+    auto reader = TelemetryReader::open(name);
+    ASSERT_NE(reader, nullptr);
+    TelemetrySnapshot s;
+    ASSERT_TRUE(reader->snapshot(s));
+    EXPECT_EQ(s.pid, ::getpid());
+    EXPECT_EQ(s.fsm.state, SystemState::RUNNING);
+    ASSERT_EQ(s.deviceCount, 1u);
+    EXPECT_STREQ(s.devices[0].name, "PSU");
+    EXPECT_EQ(s.devices[0].commands, 2u);
+    EXPECT_EQ(s.devices[0].replies, 2u);
+    EXPECT_EQ(s.devices[0].errors, 1u);
+    EXPECT_EQ(s.devices[0].minRttUs, 800u);
+    EXPECT_EQ(s.devices[0].maxRttUs, 1600u);
+    EXPECT_EQ(s.devices[0].avgRttUs, 900u); // 800 + (1600 - 800) / 8
+    ASSERT_EQ(s.queueCount, 1u);
+    EXPECT_EQ(s.queues[0].fill, 5u);
+    EXPECT_EQ(s.queues[0].peak, 12u);
+    EXPECT_EQ(s.queues[0].capacity, 4096u);
+    ASSERT_EQ(s.threadCount, 1u);
+    EXPECT_EQ(s.threads[0].beats, 1u);
+    EXPECT_TRUE(reader->alive());
+
+    pub.reset(); // daemon exits: still-mapped readers see it
+    EXPECT_FALSE(reader->alive());
+  }
+  EXPECT_EQ(TelemetryReader::open(name), nullptr);
+}
+
+TEST(broadcast_ring, every_subscriber_sees_every_item_in_order) {
+  milo::core::BroadcastRing<int> ring(8);
+  auto a = ring.subscribe("a");
+  auto b = ring.subscribe("b");
+  for (int i = 0; i < 5; ++i)
+    ring.publish(i);
+
+  int v = -1;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(a.poll(v));
+    EXPECT_EQ(v, i);
+  }
+  EXPECT_FALSE(a.poll(v));
+  EXPECT_EQ(ring.stats(0).lag, 0u);
+  EXPECT_EQ(ring.stats(1).lag, 5u); // b has not read anything yet
+  EXPECT_STREQ(ring.stats(1).name, "b");
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(b.poll(v));
+    EXPECT_EQ(v, i);
+  }
+  EXPECT_EQ(a.lost() + b.lost(), 0u);
+}
+
+TEST(broadcast_ring, lapped_reader_skips_to_oldest_and_counts_lost) {
+  milo::core::BroadcastRing<int> ring(5); // rounded up to 8
+  ASSERT_EQ(ring.capacity(), 8u);
+  auto slow = ring.subscribe("slow");
+  for (int i = 0; i < 20; ++i)
+    ring.publish(i);
+
+  EXPECT_EQ(ring.stats(0).lag, 20u);
+  int v = -1;
+  for (int i = 12; i < 20; ++i) {
+    ASSERT_TRUE(slow.poll(v));
+    EXPECT_EQ(v, i);
+  }
+  EXPECT_FALSE(slow.poll(v));
+  EXPECT_EQ(slow.lost(), 12u);
+  EXPECT_EQ(ring.stats(0).lost, 12u);
+  EXPECT_EQ(ring.stats(0).lag, 0u);
+
+  for (std::size_t i = 1; i < decltype(ring)::kMaxSubscribers; ++i)
+    ring.subscribe("x");
+  EXPECT_THROW(ring.subscribe("one too many"), std::logic_error);
+}
+
+TEST(broadcast_ring, concurrent_readers_never_see_torn_items) {
+  struct Item {
+    std::uint64_t n;
+    std::uint64_t check[7];
+  };
+  constexpr std::uint64_t kItems = 200'000;
+  milo::core::BroadcastRing<Item> ring(64);
+
+  struct Result {
+    std::uint64_t delivered{ 0 }, torn{ 0 }, disorder{ 0 }, lost{ 0 };
+  };
+  std::vector<Result> results(3);
+  std::vector<std::thread> readers;
+  std::atomic<bool> done{ false };
+  for (auto& r : results)
+    readers.emplace_back([&ring, &done, &r, cursor = ring.subscribe("reader")]() mutable {
+      Item it{};
+      std::uint64_t last = 0;
+      bool first = true;
+      for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        while (cursor.poll(it)) {
+          ++r.delivered;
+          for (auto c : it.check)
+            r.torn += c != it.n * 31;
+          r.disorder += !first && it.n <= last;
+          last = it.n;
+          first = false;
+        }
+        if (finished)
+          break;
+      }
+      r.lost = cursor.lost();
+    });
+
+  for (std::uint64_t n = 0; n < kItems; ++n) {
+    Item it{ n, {} };
+    std::fill(std::begin(it.check), std::end(it.check), n * 31);
+    ring.publish(it);
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& t : readers)
+    t.join();
+
+  for (const auto& r : results) {
+    EXPECT_EQ(r.torn, 0u);
+    EXPECT_EQ(r.disorder, 0u);
+    EXPECT_EQ(r.delivered + r.lost, kItems);
+  }
+}
+
+TEST(broadcast_ring, coordinator_publishes_transitions_to_listeners) {
+  using milo::core::SystemState;
+  milo::core::EventBus bus(64);
+  std::mutex m;
+  std::vector<std::pair<SystemState, SystemState>> seen;
+  std::vector<std::string> errors;
+  {
+    milo::core::BroadcastListener<milo::core::SystemEvent> listener(
+        bus, "test", [&](const milo::core::SystemEvent& e) {
+          std::lock_guard lock(m);
+          if (e.kind == milo::core::SystemEvent::Kind::StateChanged)
+            seen.emplace_back(e.from, e.to);
+          else
+            errors.emplace_back(e.text);
+        });
+    milo::core::SystemCoordinator sc;
+    sc.attachEventBus(bus);
+    sc.initialize();
+    sc.handleStart();
+    sc.handleError("PSU overcurrent");
+    listener.stop(); // delivers everything published so far
+    EXPECT_EQ(listener.lost(), 0u);
+  }
+  ASSERT_EQ(seen.size(), 4u);
+  EXPECT_EQ(seen[0], std::make_pair(SystemState::BOOT, SystemState::INIT));
+  EXPECT_EQ(seen[2], std::make_pair(SystemState::IDLE, SystemState::RUNNING));
+  EXPECT_EQ(seen[3], std::make_pair(SystemState::RUNNING, SystemState::ERROR));
+  ASSERT_EQ(errors.size(), 1u);
+  EXPECT_EQ(errors[0], "PSU overcurrent");
+}
+
+namespace {
+  using namespace milo::core::control;
+
+  struct ControlFixture {
+    std::string path = ::testing::TempDir() + "milo_ctl_" + std::to_string(::getpid()) + ".sock";
+    milo::core::ParameterStore params;
+    std::vector<std::string> calls;
+    std::unique_ptr<milo::core::ControlServer> server = milo::core::ControlServer::create(
+        path, params,
+        { [this](const std::string& name) {
+           if (name != "lysis")
+             throw std::invalid_argument("unknown protocol: " + name);
+           calls.push_back("select " + name);
+         },
+          [this] { calls.push_back("start"); }, [this] { calls.push_back("abort"); },
+          [this] { calls.push_back("resume"); }, [this] { calls.push_back("discard"); } });
+
+    int connect() {
+      const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      sockaddr_un addr{};
+      addr.sun_family = AF_UNIX;
+      std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+      EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+      server->service(); // accept
+      return fd;
+    }
+
+    static void send(int fd, const Frame& f) {
+      std::byte buf[kMaxFrame];
+      const auto n = f.encode(buf);
+      ASSERT_EQ(::send(fd, buf, n, MSG_NOSIGNAL), static_cast<ssize_t>(n));
+    }
+
+    /// Next frame from the server, servicing it until one arrives (nullopt on EOF).
+    std::optional<Frame> receive(int fd) {
+      std::byte buf[kMaxFrame];
+      std::size_t have = 0;
+      for (int spins = 0; spins < 1000; ++spins) {
+        server->service();
+        const std::size_t want =
+            have < kLengthBytes ? kLengthBytes : kLengthBytes + Frame::peekLength(buf);
+        const auto n = ::recv(fd, buf + have, want - have, MSG_DONTWAIT);
+        if (n == 0)
+          return std::nullopt;
+        if (n > 0)
+          have += static_cast<std::size_t>(n);
+        if (have > kLengthBytes && have == kLengthBytes + Frame::peekLength(buf))
+          return Frame::decode(std::span<const std::byte>(buf + kLengthBytes, have - kLengthBytes));
+      }
+      ADD_FAILURE() << "no frame from the control server";
+      return std::nullopt;
+    }
+
+    Frame request(int fd, const Frame& f) {
+      send(fd, f);
+      auto reply = receive(fd);
+      return reply ? *reply : Frame(MsgType::Error);
+    }
+
+    ~ControlFixture() { server.reset(); }
+  };
+} // namespace
+
+TEST(control_server, answers_parameter_and_run_requests) {
+  ControlFixture fx;
+  ASSERT_NE(fx.server, nullptr);
+  const int fd = fx.connect();
+  EXPECT_EQ(fx.server->clients(), 1u);
+
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::Ping)).type(), MsgType::Ok);
+
+  Frame set(MsgType::SetParam);
+  set.putU8(static_cast<std::uint8_t>(milo::core::Parameter::Voltage)).putF32(14.5f);
+  EXPECT_EQ(fx.request(fd, set).type(), MsgType::Ok);
+  EXPECT_FLOAT_EQ(fx.params.get(milo::core::Parameter::Voltage), 14.5f);
+
+  Frame get(MsgType::GetParam);
+  get.putU8(static_cast<std::uint8_t>(milo::core::Parameter::Voltage));
+  auto value = fx.request(fd, get);
+  ASSERT_EQ(value.type(), MsgType::Ok);
+  EXPECT_FLOAT_EQ(value.getF32().value_or(0.0f), 14.5f);
+
+  Frame bogus(MsgType::GetParam);
+  bogus.putU8(200);
+  auto err = fx.request(fd, bogus);
+  ASSERT_EQ(err.type(), MsgType::Error);
+  EXPECT_EQ(err.getText(), "[ControlServer] unknown parameter");
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::SetParam)).type(), MsgType::Error); // no body
+
+  Frame select(MsgType::SelectProtocol);
+  select.putText("lysis");
+  EXPECT_EQ(fx.request(fd, select).type(), MsgType::Ok);
+  Frame unknown(MsgType::SelectProtocol);
+  unknown.putText("pcr");
+  auto rejected = fx.request(fd, unknown);
+  ASSERT_EQ(rejected.type(), MsgType::Error);
+  EXPECT_EQ(rejected.getText(), "unknown protocol: pcr"); // the action's exception, verbatim
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::Start)).type(), MsgType::Ok);
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::Abort)).type(), MsgType::Ok);
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::Resume)).type(), MsgType::Ok);
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::Discard)).type(), MsgType::Ok);
+  EXPECT_EQ(fx.calls, (std::vector<std::string>{ "select lysis", "start", "abort", "resume",
+                                                 "discard" }));
+
+  // a length no frame can have ends the connection
+  const std::byte junk[] = { std::byte{ 0xff }, std::byte{ 0xff }, std::byte{ 0 }, std::byte{ 0 } };
+  ASSERT_EQ(::send(fd, junk, sizeof(junk), MSG_NOSIGNAL), 4);
+  auto last = fx.receive(fd);
+  ASSERT_TRUE(last.has_value());
+  EXPECT_EQ(last->type(), MsgType::Error);
+  EXPECT_FALSE(fx.receive(fd).has_value());
+  EXPECT_EQ(fx.server->clients(), 0u);
+  ::close(fd);
+}
+
+TEST(control_server, resume_without_a_run_context_is_an_error_and_discard_clears_the_offer) {
+  using namespace milo::core;
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("milo_ctl_resume_" + std::to_string(::getpid()));
+  CheckpointStore store(dir.string());
+  Checkpoint cp;
+  std::snprintf(cp.protocol, sizeof(cp.protocol), "probe");
+  cp.sweepTotal = 2;
+  ASSERT_TRUE(store.save(cp));
+
+  // wired as the daemon does: no devices, Logger or protocols attached
+  SystemCoordinator sc;
+  sc.attachCheckpoints(store);
+  sc.initialize();
+  ASSERT_TRUE(sc.interruptedRun());
+  SweepPlan plan;
+  plan.protocol = "probe";
+  plan.axes = { SweepAxis::list(Parameter::Temp, { 30, 37 }) };
+
+  ControlFixture fx;
+  fx.server.reset(); // frees the socket path for this server
+  fx.server = ControlServer::create(fx.path, fx.params,
+                                    { {}, {}, {}, [&] { sc.resumeSweep(plan); },
+                                      [&] { sc.discardInterruptedRun(); } });
+  ASSERT_NE(fx.server, nullptr);
+  const int fd = fx.connect();
+
+  auto refused = fx.request(fd, Frame(MsgType::Resume));
+  ASSERT_EQ(refused.type(), MsgType::Error);
+  EXPECT_EQ(refused.getText(), "[SystemCoordinator] runSweep() without attachRunContext()");
+  EXPECT_TRUE(sc.interruptedRun()); // still on offer
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::Start)).type(), MsgType::Error);
+
+  EXPECT_EQ(fx.request(fd, Frame(MsgType::Discard)).type(), MsgType::Ok);
+  EXPECT_FALSE(sc.interruptedRun());
+  EXPECT_FALSE(store.load());
+  auto nothing = fx.request(fd, Frame(MsgType::Resume));
+  ASSERT_EQ(nothing.type(), MsgType::Error);
+  EXPECT_EQ(nothing.getText(), "[SystemCoordinator] no interrupted sweep to resume");
+  ::close(fd);
+  std::filesystem::remove_all(dir);
+}
+
+TEST(control_server, socket_is_owner_and_group_only_and_strangers_are_refused) {
+  ControlFixture fx;
+  ASSERT_NE(fx.server, nullptr);
+  struct stat st {};
+  ASSERT_EQ(::stat(fx.path.c_str(), &st), 0);
+  EXPECT_EQ(st.st_mode & 0777, milo::core::ControlServer::kSocketMode);
+  EXPECT_EQ(fx.server->refused(), 0u);
+
+  if (::geteuid() != 0)
+    GTEST_SKIP() << "needs root to connect as another user";
+  // a client as nobody:nogroup (a relaxed mode would have let it through the file check)
+  ASSERT_EQ(::chmod(fx.path.c_str(), 0666), 0);
+  const pid_t child = ::fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    if (::setgid(65534) != 0 || ::setuid(65534) != 0)
+      ::_exit(2);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, fx.path.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+      ::_exit(3);
+    char b;
+    ::_exit(::recv(fd, &b, 1, 0) == 0 ? 0 : 4); // EOF: the server hung up on us
+  }
+  int status = 0;
+  while (::waitpid(child, &status, WNOHANG) == 0) {
+    fx.server->service();
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+  }
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_EQ(fx.server->refused(), 1u);
+  EXPECT_EQ(fx.server->clients(), 0u);
+}
+
+TEST(control_server, streams_events_and_a_stalled_client_only_loses_its_own_frames) {
+  ControlFixture fx;
+  ASSERT_NE(fx.server, nullptr);
+  milo::core::EventBus events(64);
+  milo::core::MeasurementBus measurements(1 << 14);
+  fx.server->attachEventBus(events);
+  fx.server->attachMeasurementBus(measurements);
+
+  const int live = fx.connect();
+  const int stalled = fx.connect();
+  Frame sub(MsgType::Subscribe);
+  sub.putU8(kEvents | kMeasurements);
+  EXPECT_EQ(fx.request(live, sub).type(), MsgType::Ok);
+  EXPECT_EQ(fx.request(stalled, sub).type(), MsgType::Ok);
+
+  events.publish(milo::core::SystemEvent::stateChanged(milo::core::SystemState::IDLE,
+                                                       milo::core::SystemState::RUNNING));
+  auto state = fx.receive(live);
+  ASSERT_TRUE(state.has_value());
+  ASSERT_EQ(state->type(), MsgType::StateChanged);
+  state->getI64();
+  EXPECT_EQ(state->getU8(), static_cast<std::uint8_t>(milo::core::SystemState::IDLE));
+  EXPECT_EQ(state->getU8(), static_cast<std::uint8_t>(milo::core::SystemState::RUNNING));
+
+  // the protocol thread publishes far more than the stalled client's buffer holds; the live
+  // client keeps up, the stalled one never reads
+  constexpr int kSamples = 4000;
+  int received = 0;
+  for (int i = 0; i < kSamples; ++i) {
+    measurements.publish(
+        milo::core::LogEvent::make(milo::core::LogEvent::Type::Sample, "PSU.V", i));
+    if (i % 64 == 63 || i + 1 == kSamples) {
+      fx.server->service();
+      for (;;) {
+        std::byte buf[64];
+        if (::recv(live, buf, kLengthBytes, MSG_DONTWAIT | MSG_PEEK) != kLengthBytes)
+          break;
+        auto f = fx.receive(live);
+        ASSERT_TRUE(f.has_value());
+        ASSERT_EQ(f->type(), MsgType::Measurement);
+        f->getI64();
+        f->getU8();
+        EXPECT_EQ(f->getF64(), static_cast<double>(received));
+        EXPECT_EQ(f->getText(), "PSU.V");
+        ++received;
+      }
+    }
+  }
+  EXPECT_EQ(received, kSamples);
+  EXPECT_GT(fx.server->dropped(), 0u);
+
+  // a request from the stalled client is still answered once it reads: stream frames never
+  // take the room kept for a reply, and the backlog ends with a Lost report
+  Frame ping(MsgType::Ping);
+  fx.send(stalled, ping);
+  std::size_t measured = 0;
+  for (;;) {
+    auto f = fx.receive(stalled);
+    ASSERT_TRUE(f.has_value());
+    if (f->type() == MsgType::Ok)
+      break;
+    if (f->type() == MsgType::Measurement)
+      ++measured;
+  }
+  EXPECT_LT(measured, static_cast<std::size_t>(kSamples));
+  measurements.publish(milo::core::LogEvent::make(milo::core::LogEvent::Type::Sample, "PSU.V", 0));
+  auto lost = fx.receive(stalled);
+  ASSERT_TRUE(lost.has_value());
+  ASSERT_EQ(lost->type(), MsgType::Lost);
+  EXPECT_EQ(lost->getU32().value_or(0) + measured, static_cast<std::size_t>(kSamples));
+  ::close(live);
+  ::close(stalled);
+}
+
+TEST(sample_streams, stream_line_format) {
+  using milo::core::stream::parse;
+  const auto s = parse("#FLOW 2.51\r\n");
+  ASSERT_TRUE(s.has_value());
+  EXPECT_EQ(s->channel, "FLOW");
+  EXPECT_FLOAT_EQ(s->value, 2.51f);
+  EXPECT_FALSE(parse("OK 2.51"));
+  EXPECT_FALSE(parse("#FLOW"));
+  EXPECT_FALSE(parse("# 2.5"));
+  EXPECT_FALSE(parse("#FLOW 2.5x"));
+}
+
+TEST(sample_streams, columns_wrap_into_contiguous_slices) {
+  milo::core::SampleColumns cols(100); // rounded up to 128
+  ASSERT_EQ(cols.capacity(), 128u);
+  for (int i = 0; i < 200; ++i)
+    cols.push(i, static_cast<float>(i));
+  EXPECT_EQ(cols.size(), 128u);
+  EXPECT_EQ(cols.oldest(), 72u);
+
+  // 72 … 127 sit at the end of the storage, 128 … 199 wrapped to the front
+  const auto tail = cols.values(72, 1000);
+  ASSERT_EQ(tail.size(), 56u);
+  EXPECT_FLOAT_EQ(tail.front(), 72.0f);
+  const auto head = cols.times(128, 1000);
+  ASSERT_EQ(head.size(), 72u);
+  EXPECT_EQ(head.back(), 199);
+}
+
+TEST(sample_streams, view_updates_at_bucket_rate_whatever_the_sample_rate) {
+  using namespace std::chrono_literals;
+  milo::core::Device pump{ 2 };
+  for (const int hz : { 10, 1000 }) {
+    milo::core::SampleStreams streams({ .samplesPerChannel = 256, .bucket = 100ms });
+    std::vector<milo::core::StreamView> shown;
+    streams.onDisplay([&](const milo::core::StreamView& v) { shown.push_back(v); });
+    const auto period = std::chrono::nanoseconds{ 1s } / hz;
+    for (int i = 0; i < 2 * hz; ++i) // two seconds, a triangle between 0 and 10
+      streams.add(pump, "Pump", "FLOW", i * period, static_cast<float>(std::abs(i % 20 - 10)));
+
+    EXPECT_EQ(shown.size(), 19u) << hz << " Hz"; // one per completed bucket
+    const auto& v = shown.back();
+    EXPECT_STREQ(v.key, "Pump.FLOW");
+    EXPECT_EQ(v.filled, 20u);
+    EXPECT_EQ(v.samples, static_cast<std::uint64_t>(2 * hz - hz / 10 + 1));
+    if (hz == 1000) { // every 100 ms bucket spans the whole triangle
+      EXPECT_FLOAT_EQ(v.buckets[0].min, 0.0f);
+      EXPECT_FLOAT_EQ(v.buckets[0].max, 10.0f);
+    }
+    EXPECT_TRUE(v.buckets[v.filled].empty());
+  }
+}
+
+TEST(sample_streams, completed_buckets_reach_the_telemetry_segment) {
+  using namespace milo::core;
+  const std::string name = "/milo-telemetry-streams-" + std::to_string(::getpid());
+  auto pub = TelemetryPublisher::create(name);
+  ASSERT_NE(pub, nullptr);
+  SampleStreams streams({ .samplesPerChannel = 64, .bucket = std::chrono::milliseconds{ 10 } });
+  streams.attachTelemetry(*pub);
+  for (int i = 0; i < 50; ++i)
+    streams.add(Device{ 1 }, "PSU", "V1", std::chrono::milliseconds{ i },
+                12.0f + 0.01f * static_cast<float>(i));
+
+  auto reader = TelemetryReader::open(name);
+  ASSERT_NE(reader, nullptr);
+  TelemetrySnapshot s;
+  ASSERT_TRUE(reader->snapshot(s));
+  ASSERT_EQ(s.streamCount, 1u);
+  EXPECT_STREQ(s.streams[0].key, "PSU.V1");
+  EXPECT_EQ(s.streams[0].filled, 5u); // published when the 40 ms sample opened bucket 5
+  EXPECT_EQ(s.streams[0].samples, 41u);
+  EXPECT_FLOAT_EQ(s.streams[0].buckets[1].min, 12.1f);
+  EXPECT_FLOAT_EQ(s.streams[0].buckets[1].max, 12.19f);
+}
+
+TEST(run_stats, welford_matches_two_pass_moments) {
+  std::mt19937 rng(7);
+  std::normal_distribution<double> dist(1e6, 0.5); // large offset, small spread
+  std::vector<double> xs(10000);
+  milo::core::RunningStats s;
+  for (auto& x : xs) {
+    x = dist(rng);
+    s.add(x);
+  }
+  double mean = 0.0, m2 = 0.0;
+  for (const auto x : xs)
+    mean += x / static_cast<double>(xs.size());
+  for (const auto x : xs)
+    m2 += (x - mean) * (x - mean);
+
+  EXPECT_EQ(s.count(), xs.size());
+  EXPECT_NEAR(s.mean(), mean, 1e-6);
+  EXPECT_NEAR(s.variance(), m2 / static_cast<double>(xs.size() - 1), 1e-6);
+  EXPECT_EQ(s.min(), *std::min_element(xs.begin(), xs.end()));
+  EXPECT_EQ(s.max(), *std::max_element(xs.begin(), xs.end()));
+}
+
+TEST(run_stats, sketch_quantiles_within_relative_error) {
+  std::mt19937 rng(11);
+  std::lognormal_distribution<double> dist(0.0, 2.0); // spans several decades
+  std::vector<double> xs(50000);
+  milo::core::QuantileSketch sketch;
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    xs[i] = (i % 4 == 0 ? -1.0 : 1.0) * dist(rng);
+    sketch.add(xs[i]);
+  }
+  std::sort(xs.begin(), xs.end());
+  for (const double q : { 0.01, 0.25, 0.5, 0.95, 0.99 }) {
+    const auto exact = xs[static_cast<std::size_t>(q * static_cast<double>(xs.size() - 1))];
+    EXPECT_NEAR(sketch.quantile(q), exact,
+                std::abs(exact) * milo::core::QuantileSketch::kRelativeError + 1e-3)
+        << "q=" << q;
+  }
+}
+
+TEST(run_stats, channels_are_claimed_once_and_summarised_in_order) {
+  using namespace milo::core;
+  RunStats stats;
+  for (int i = 0; i < 100; ++i) {
+    stats.add(Device{ 2 }, "Pump", "FLOW", 2.0 + 0.01 * i);
+    stats.add(Device{ 1 }, "PSU", "VOLT", 12.0);
+  }
+  EXPECT_EQ(stats.channels(), 2u);
+  for (std::size_t i = stats.channels(); i < RunStats::kMaxChannels; ++i)
+    stats.add(Device{ 3 }, "Dev", "C" + std::to_string(i), 1.0);
+  EXPECT_FALSE(stats.add(Device{ 3 }, "Dev", "ONE_TOO_MANY", 1.0));
+  EXPECT_EQ(stats.dropped(), 1u);
+
+  const auto summary = stats.summary();
+  ASSERT_EQ(summary.size(), RunStats::kMaxChannels);
+  EXPECT_EQ(summary[0].key, "Pump.FLOW");
+  EXPECT_EQ(summary[0].count, 100u);
+  EXPECT_NEAR(summary[0].mean, 2.495, 1e-9);
+  EXPECT_DOUBLE_EQ(summary[0].min, 2.0);
+  EXPECT_NEAR(summary[0].p50, 2.495, 0.03);
+  EXPECT_LE(summary[0].p99, summary[0].max);
+  EXPECT_EQ(summary[1].key, "PSU.VOLT");
+  EXPECT_DOUBLE_EQ(summary[1].stddev, 0.0);
+  EXPECT_DOUBLE_EQ(summary[1].p95, 12.0); // clamped to what was seen
+  EXPECT_EQ(summary[1].toString(),
+            "n=100 mean=12 sd=0 min=12 max=12 p50=12 p95=12 p99=12");
+
+  stats.reset();
+  EXPECT_EQ(stats.channels(), 0u);
+  EXPECT_TRUE(stats.summary().empty());
+}
+
+TEST(run_stats, a_long_device_name_leaves_its_channels_apart) {
+  using namespace milo::core;
+  RunStats stats;
+  const std::string longName(40, 'D'); // would fill the whole key on its own
+  stats.add(Device{ 1 }, longName, "FLOW", 1.0);
+  stats.add(Device{ 1 }, longName, "PRESSURE_INLET", 2.0);
+  stats.add(Device{ 1 }, longName, "PRESSURE_OUTLET", 3.0); // same first 8 characters
+  ASSERT_EQ(stats.channels(), 2u);
+
+  const auto summary = stats.summary();
+  EXPECT_EQ(summary[0].key, std::string(ChannelKey::kDeviceLen, 'D') + ".FLOW");
+  EXPECT_EQ(summary[1].key, std::string(ChannelKey::kDeviceLen, 'D') + ".PRESSURE");
+  EXPECT_EQ(summary[1].count, 2u);
+}
+
+TEST(checkpoint_store, round_trips_atomically_and_rejects_damage) {
+  using namespace milo::core;
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("milo_checkpoint_" + std::to_string(::getpid()));
+  CheckpointStore store(dir.string());
+  EXPECT_FALSE(store.load()); // nothing there yet
+
+  Checkpoint cp;
+  std::snprintf(cp.run, sizeof(cp.run), "20250101T000000Z_run007.csv");
+  std::snprintf(cp.protocol, sizeof(cp.protocol), "lysis");
+  cp.sweepRun = 2;
+  cp.sweepTotal = 6;
+  cp.step = 17;
+  cp.elapsed = std::chrono::milliseconds{ 123456 };
+  cp.params = { 37.5f, 2.25f, 12.001f };
+  ASSERT_TRUE(store.save(cp));
+  EXPECT_FALSE(std::filesystem::exists(store.path() + ".tmp"));
+
+  const auto back = store.load();
+  ASSERT_TRUE(back.has_value());
+  EXPECT_STREQ(back->run, cp.run);
+  EXPECT_STREQ(back->protocol, "lysis");
+  EXPECT_EQ(back->sweepRun, 2u);
+  EXPECT_EQ(back->sweepTotal, 6u);
+  EXPECT_EQ(back->step, 17u);
+  EXPECT_EQ(back->elapsed, cp.elapsed);
+  EXPECT_EQ(back->params, cp.params); // exact, not just close
+  EXPECT_LT(std::filesystem::file_size(store.path()), 512u);
+
+  // one flipped digit fails the CRC
+  std::string text;
+  {
+    std::ifstream in(store.path());
+    text.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  text[text.find("step=17") + 5] = '9';
+  std::ofstream(store.path(), std::ios::trunc) << text;
+  EXPECT_FALSE(store.load());
+
+  store.clear();
+  EXPECT_FALSE(std::filesystem::exists(store.path()));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(checkpoint_store, checkpointer_saves_at_most_once_per_period) {
+  using namespace milo::core;
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("milo_checkpointer_" + std::to_string(::getpid()));
+  CheckpointStore store(dir.string());
+  VirtualClock clock;
+  Checkpointer cp(store, clock, std::chrono::seconds{ 1 });
+
+  Checkpoint start;
+  std::snprintf(start.protocol, sizeof(start.protocol), "probe");
+  start.step = 3;
+  start.elapsed = std::chrono::seconds{ 10 }; // a resumed run keeps its elapsed time
+  cp.begin(start);
+  EXPECT_EQ(cp.firstStep(), 3u);
+  EXPECT_EQ(cp.saves(), 1u);
+
+  for (std::uint32_t step = 4; step <= 100; ++step) { // 97 steps of 50 ms
+    clock.advance(std::chrono::milliseconds{ 50 });
+    cp.reached(step);
+    cp.flush(); // one hand-over at a time: none are coalesced
+  }
+  EXPECT_EQ(cp.saves(), 5u); // at 1 s, 2 s, 3 s, 4 s
+  const auto saved = store.load();
+  ASSERT_TRUE(saved.has_value());
+  EXPECT_EQ(saved->step, 83u);
+  EXPECT_EQ(saved->elapsed, std::chrono::milliseconds{ 14000 });
+  EXPECT_EQ(cp.current().step, 100u); // not yet persisted: redone after a reset
+
+  cp.end();
+  EXPECT_FALSE(store.load());
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,63 @@
+#pragma once
+/** @file  FakeEdgeEventSource.hpp
+ *  @brief Scripted EdgeEventSource: tests queue edges with explicit kernel timestamps.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include "io/EdgeEventSource.hpp"
+
+#include <deque>
+#include <map>
+
+namespace milo {
+  namespace test {
+
+    /**
+ * @class FakeEdgeEventSource
+ * @brief Returns queued events on `read()`; `fd()` is -1 (no epoll needed in tests).
+ */
+    class FakeEdgeEventSource : public milo::io::EdgeEventSource {
+    public:
+      using Kind = milo::io::EdgeEvent::Kind;
+
+      std::map<unsigned int, bool> levels; ///< initial levels reported by level()
+      std::size_t reads = 0;
+
+      /// Queue an edge on \p line at \p ms (+ \p us) since the monotonic epoch.
+      void push(unsigned int line, Kind kind, long ms, long us = 0) {
+        milo::io::EdgeEvent ev;
+        ev.line = line;
+        ev.kind = kind;
+        ev.timestamp = std::chrono::milliseconds{ ms } + std::chrono::microseconds{ us };
+        ev.seqno = ++seq_;
+        pending_.push_back(ev);
+      }
+
+      /// Simulate kernel FIFO overflow: the next pushed event skips \p n sequence numbers.
+      void loseEvents(std::uint32_t n) { seq_ += n; }
+
+      int fd() const override { return -1; }
+
+      std::size_t read(std::span<milo::io::EdgeEvent> out) override {
+        ++reads;
+        std::size_t n = 0;
+        while (n < out.size() && !pending_.empty()) {
+          out[n++] = pending_.front();
+          pending_.pop_front();
+        }
+        return n;
+      }
+
+      bool level(unsigned int line) const override {
+        auto it = levels.find(line);
+        return it != levels.end() && it->second;
+      }
+
+    private:
+      std::deque<milo::io::EdgeEvent> pending_;
+      std::uint32_t seq_ = 0;
+    };
+
+  } // namespace test
+} // namespace milo
@@ -7,6 +7,9 @@
 
 #include "io/SerialChannel.hpp"
 
+#include <deque>
+#include <thread>
+
 namespace milo {
   namespace test {
 
@@ -19,18 +22,44 @@ namespace milo {
       bool open_called = false;
       bool write_sucess = true;
       std::optional<std::string> next_read_line = "OK\r\n";
+      std::chrono::microseconds write_delay{ 0 }; ///< simulate a slow tty write
+      int write_count = 0;
+      int reply_after_polls = 0; ///< readLine() comes up empty this often after each write
+      /// Instrument turnaround on the channel’s clock: the reply is readable this long after
+      /// the write (a simulated MCU under a VirtualClock).
+      milo::core::Clock::Duration reply_latency{ 0 };
+      /// Lines the device sends on its own (streamed samples); read before any reply.
+      std::deque<std::string> unsolicited;
+
+      FakeSerialChannel() { last_written.reserve(258); } // recording must not allocate mid-run
 
-      bool open(const std::string&, speed_t) override {
+      bool open(const std::string&, const milo::io::SerialSettings&) override {
         open_called = true;
         return true;
       }
 
-      bool writeLine(const std::string& line) override {
+      bool writeLine(std::string_view line) override {
+        if (write_delay.count() > 0)
+          std::this_thread::sleep_for(write_delay);
+        ++write_count;
+        polls_left = reply_after_polls;
+        reply_due = clock().now() + reply_latency;
         last_written = line;
         return write_sucess;
       }
 
       std::optional<std::string> readLine(std::chrono::milliseconds) override {
+        if (!unsolicited.empty()) {
+          std::string line = std::move(unsolicited.front());
+          unsolicited.pop_front();
+          return line;
+        }
+        if (polls_left > 0) {
+          --polls_left;
+          return std::nullopt;
+        }
+        if (clock().now() < reply_due)
+          return std::nullopt;
         return next_read_line;
       }
 
@@ -38,6 +67,8 @@ namespace milo {
 
     private:
       std::string last_written;
+      int polls_left = 0;
+      milo::core::Clock::Duration reply_due{ 0 };
     };
 
   } // namespace test
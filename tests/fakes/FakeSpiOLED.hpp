@@ -0,0 +1,42 @@
+#pragma once
+/** @file  FakeSpiOLED.hpp
+ *  @brief OLEDDisplay derivative that captures SPI_IOC_MESSAGE batches instead of hitting spidev.
+ *
+ *  © 2025 Milo Medical — MIT-licensed.
+ */
+
+#include "io/OLEDDisplay.hpp"
+
+#include <linux/spi/spidev.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace milo {
+  namespace test {
+
+    /**
+ * @class FakeSpiOLED
+ * @brief Records every ioctl batch as decoded 9-bit words.
+ */
+    class FakeSpiOLED : public milo::io::OLEDDisplay {
+    public:
+      using Transfer = std::vector<std::uint16_t>;
+
+      std::vector<std::vector<Transfer>> messages; ///< one entry per SPI_IOC_MESSAGE
+      bool submit_success = true;
+
+    protected:
+      bool submit(const spi_ioc_transfer* xfers, std::size_t count) override {
+        std::vector<Transfer> msg;
+        for (std::size_t i = 0; i < count; ++i) {
+          const auto* words = reinterpret_cast<const std::uint16_t*>(xfers[i].tx_buf);
+          msg.emplace_back(words, words + xfers[i].len / sizeof(std::uint16_t));
+        }
+        messages.push_back(std::move(msg));
+        return submit_success;
+      }
+    };
+
+  } // namespace test
+} // namespace milo
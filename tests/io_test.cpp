@@ -1,6 +1,26 @@
+#include "io/ButtonGPIO.hpp"
+#include "io/FileLogger.hpp"
+#include "io/Font5x7.hpp"
+#include "io/LatencyProbe.hpp"
+#include "io/LogJournal.hpp"
+#include "io/ReplaySerialChannel.hpp"
+#include "io/RotaryEncoderGPIO.hpp"
+#include "io/SerialCapture.hpp"
 #include "io/SerialChannel.hpp"
+
+#include "FakeEdgeEventSource.hpp"
+#include "FakeSpiOLED.hpp"
+
 #include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 #include <pty.h> // openpty
+#include <sys/wait.h>
 #include <unistd.h>
 
 TEST(serial_channel, opens_writes_closes) {
@@ -11,7 +31,7 @@ TEST(serial_channel, opens_writes_closes) {
 
   // check that we can open a serial channel to slave dev
   milo::io::SerialChannel chan;
-  ASSERT_TRUE(chan.open(slaveName, B115200));
+  ASSERT_TRUE(chan.open(slaveName, {}));
 
   // Writer on master side
   const char* msg = "PING\r\n";
@@ -27,3 +47,667 @@ TEST(serial_channel, opens_writes_closes) {
   EXPECT_STREQ(buf, "PONG\r\n");
 }
 
+TEST(serial_channel, lf_terminator_frames_both_directions) {
+  int masterFd, slaveFd;
+  char slaveName[64];
+  ASSERT_EQ(0, openpty(&masterFd, &slaveFd, slaveName, nullptr, nullptr));
+
+  milo::io::SerialChannel chan;
+  ASSERT_TRUE(chan.open(slaveName, {}));
+  chan.setTerminator("\n");
+
+  const char* msg = "OK 1\nOK 2\n";
+  write(masterFd, msg, strlen(msg));
+  EXPECT_EQ(chan.readLine(std::chrono::milliseconds{ 100 }), "OK 1");
+  EXPECT_EQ(chan.readLine(std::chrono::milliseconds{ 100 }), "OK 2"); // already buffered
+
+  chan.writeLine("FLOW 2.5");
+  char buf[16] = { 0 };
+  read(masterFd, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "FLOW 2.5\n");
+  ::close(masterFd);
+  ::close(slaveFd);
+}
+
+TEST(serial_channel, custom_baud_and_read_threshold_reach_the_tty) {
+  int masterFd, slaveFd;
+  char slaveName[64];
+  ASSERT_EQ(0, openpty(&masterFd, &slaveFd, slaveName, nullptr, nullptr));
+
+  milo::io::SerialChannel chan;
+  EXPECT_FALSE(chan.open(slaveName, { .baud = 0 }));
+  ASSERT_TRUE(chan.open(slaveName, { .baud = 250000, .lowLatency = true, .vmin = 4 }));
+  EXPECT_EQ(chan.settings().baud, 250000u); // not a B* constant: termios2/BOTHER
+  EXPECT_FALSE(chan.settings().lowLatency); // a pty has no TIOCSSERIAL; open still succeeds
+
+  termios tty{};
+  ASSERT_EQ(0, tcgetattr(slaveFd, &tty));
+  EXPECT_EQ(tty.c_cc[VMIN], 4);
+  EXPECT_EQ(tty.c_cc[VTIME], 0);
+  EXPECT_EQ(tty.c_lflag & ICANON, 0u); // raw
+
+  write(masterFd, "OK 1\r\n", 6);
+  EXPECT_EQ(chan.readLine(std::chrono::milliseconds{ 100 }), "OK 1");
+  ::close(masterFd);
+  ::close(slaveFd);
+}
+
+TEST(latency_probe, times_every_round_trip_and_picks_the_fastest_stable_setting) {
+  int masterFd, slaveFd;
+  char slaveName[64];
+  ASSERT_EQ(0, openpty(&masterFd, &slaveFd, slaveName, nullptr, nullptr));
+
+  // instrument on the master side: one "OK" per line received, until the test closes it
+  std::thread instrument([masterFd] {
+    char buf[64];
+    ssize_t n;
+    while ((n = read(masterFd, buf, sizeof(buf))) > 0)
+      for (ssize_t i = 0; i < n; ++i)
+        if (buf[i] == '\n')
+          write(masterFd, "OK\r\n", 4);
+  });
+
+  const milo::io::SerialSettings candidates[] = { { .baud = 115200 },
+                                                   { .baud = 1'000'000, .vmin = 4 } };
+  milo::io::LatencyProbe::Options options{ .command = "*IDN?", .rounds = 20,
+                                           .timeout = std::chrono::milliseconds{ 200 } };
+  const auto reports = milo::io::LatencyProbe::sweep(slaveName, candidates, options);
+  ::close(slaveFd);
+  ::close(masterFd); // ends the instrument's read
+  instrument.join();
+
+  ASSERT_EQ(reports.size(), 2u);
+  for (const auto& r : reports) {
+    EXPECT_TRUE(r.stable());
+    EXPECT_EQ(r.replies, 20u);
+    EXPECT_LE(r.min, r.p50);
+    EXPECT_LE(r.p50, r.p99);
+    EXPECT_LE(r.p99, r.max);
+  }
+  EXPECT_EQ(reports[1].effective.baud, 1'000'000u);
+  EXPECT_EQ(reports[1].requested.vmin, 4);
+  EXPECT_TRUE(milo::io::LatencyProbe::fastest(reports).has_value());
+
+  // quickest on paper, but it dropped a reply: the stable runner-up wins
+  std::vector<milo::io::LatencyReport> ranked(3);
+  for (auto& r : ranked) {
+    r.opened = true;
+    r.rounds = 100;
+  }
+  ranked[0].p99 = std::chrono::microseconds{ 300 };
+  ranked[0].timeouts = 1;
+  ranked[1].p99 = std::chrono::microseconds{ 900 };
+  ranked[2].p99 = std::chrono::microseconds{ 650 };
+  EXPECT_EQ(milo::io::LatencyProbe::fastest(ranked), 2u);
+  ranked[2].timeouts = 3;
+  ranked[1].opened = false;
+  EXPECT_FALSE(milo::io::LatencyProbe::fastest(ranked).has_value());
+}
+
+TEST(oled_display, first_flush_sends_every_page_in_one_message) {
+  milo::test::FakeSpiOLED oled;
+  oled.clear();
+  ASSERT_TRUE(oled.flush());
+
+  ASSERT_EQ(oled.messages.size(), 1u);
+  EXPECT_EQ(oled.messages[0].size(), 8u); // one transfer per page
+  EXPECT_EQ(oled.lastFlush().words, 8u * (3 + 128));
+  EXPECT_EQ(oled.messages[0][3][0], 0xB3); // page 3 address command, D/C low
+}
+
+TEST(oled_display, flush_only_sends_changed_column_range) {
+  milo::test::FakeSpiOLED oled;
+  oled.clear();
+  oled.flush();
+  oled.messages.clear();
+
+  oled.setPixel(40, 20, true); // page 2, column 40
+  oled.setPixel(42, 21, true);
+  ASSERT_TRUE(oled.flush());
+
+  ASSERT_EQ(oled.messages.size(), 1u);
+  ASSERT_EQ(oled.messages[0].size(), 1u);
+  const auto& t = oled.messages[0][0];
+  ASSERT_EQ(t.size(), 3u + 3u);
+  EXPECT_EQ(t[0], 0xB2);                // page 2
+  EXPECT_EQ(t[1], 40 & 0x0F);           // column low nibble
+  EXPECT_EQ(t[2], 0x10 | (40 >> 4));    // column high nibble
+  EXPECT_EQ(t[3], 0x100 | (1 << 4));    // data word, D/C high
+  EXPECT_EQ(t[5], 0x100 | (1 << 5));
+  EXPECT_EQ(oled.lastFlush().words, 6u);
+}
+
+TEST(oled_display, unchanged_frame_and_failed_submit) {
+  milo::test::FakeSpiOLED oled;
+  oled.flush();
+  oled.messages.clear();
+
+  oled.setPixel(1, 1, true);
+  oled.setPixel(1, 1, false); // net no change against the panel
+  ASSERT_TRUE(oled.flush());
+  EXPECT_TRUE(oled.messages.empty());
+
+  oled.setPixel(5, 60, true);
+  oled.submit_success = false;
+  EXPECT_FALSE(oled.flush());
+  oled.submit_success = true;
+  ASSERT_TRUE(oled.flush()); // region is retried after the failure
+  EXPECT_EQ(oled.lastFlush().regions, 1u);
+}
+
+namespace {
+  // true if every pixel of the 6×8 cell at (x, y) matches the atlas glyph for ch
+  bool cellMatches(const milo::io::OLEDDisplay& oled, int x, int y, char ch) {
+    const auto* cols = milo::io::font::glyph(ch);
+    for (int c = 0; c < milo::io::font::kAdvance; ++c)
+      for (int r = 0; r < milo::io::font::kCellH; ++r)
+        if (oled.pixel(x + c, y + r) != (((cols[c] >> r) & 1) != 0))
+          return false;
+    return true;
+  }
+} // namespace
+
+TEST(oled_display, draw_text_handles_unaligned_rows_and_overwrites_cell) {
+  milo::test::FakeSpiOLED oled;
+  oled.drawText(0, 0, "########");
+  oled.drawText(2, 3, "Volt"); // straddles pages 0 and 1
+
+  EXPECT_TRUE(cellMatches(oled, 2, 3, 'V'));
+  EXPECT_TRUE(cellMatches(oled, 20, 3, 't'));
+  EXPECT_TRUE(oled.pixel(1, 0));   // left of the label, untouched
+  EXPECT_FALSE(oled.pixel(7, 10)); // blank row of 'V' cell cleared the '#' beneath
+}
+
+TEST(oled_display, static_labels_come_from_glyph_run_cache) {
+  milo::test::FakeSpiOLED oled;
+  for (int i = 0; i < 3; ++i) {
+    oled.drawText(0, 0, "Voltage");
+    oled.drawText(0, 16, "FlowRate");
+  }
+  EXPECT_EQ(oled.glyphCache().misses(), 2u);
+  EXPECT_EQ(oled.glyphCache().hits(), 4u);
+}
+
+TEST(oled_display, draw_number_matches_text_rendering) {
+  milo::test::FakeSpiOLED a, b;
+  int end = a.drawNumber(10, 21, 12.5f, 2);
+  b.drawText(10, 21, "12.50");
+
+  EXPECT_EQ(end, 10 + milo::io::OLEDDisplay::textWidth("12.50"));
+  for (int x = 0; x < milo::io::OLEDDisplay::kWidth; ++x)
+    for (int y = 0; y < milo::io::OLEDDisplay::kHeight; ++y)
+      ASSERT_EQ(a.pixel(x, y), b.pixel(x, y)) << x << "," << y;
+}
+
+TEST(oled_display, draw_bitmap_masks_partial_last_page) {
+  milo::test::FakeSpiOLED oled;
+  oled.setPixel(0, 13, true);                      // below a 5-row bitmap at y=8
+  oled.drawBitmap(0, 8, 2, 5, { 0x1F, 0x01 });
+
+  EXPECT_TRUE(oled.pixel(0, 12));
+  EXPECT_TRUE(oled.pixel(0, 13)); // outside the bitmap's 5 rows, preserved
+  EXPECT_TRUE(oled.pixel(1, 8));
+  EXPECT_FALSE(oled.pixel(1, 9));
+}
+
+namespace {
+  using Kind = milo::io::EdgeEvent::Kind;
+  using Press = milo::io::ButtonGPIO::Event;
+
+  struct ButtonHarness {
+    milo::io::ButtonGPIO button;
+    milo::test::FakeEdgeEventSource* fake;
+    std::vector<Press> presses;
+
+    ButtonHarness() {
+      auto src = std::make_unique<milo::test::FakeEdgeEventSource>();
+      fake = src.get();
+      button.attach(std::move(src), 7);
+      button.registerCallback([this](Press p) { presses.push_back(p); });
+    }
+  };
+} // namespace
+
+TEST(gpio_input, bouncy_short_press_uses_kernel_timestamps) {
+  ButtonHarness h;
+  // contact bounce on press and release, all inside the 20 ms window
+  h.fake->push(7, Kind::Rising, 1000);
+  h.fake->push(7, Kind::Falling, 1001);
+  h.fake->push(7, Kind::Rising, 1003);
+  h.fake->push(7, Kind::Falling, 1200);
+  h.fake->push(7, Kind::Rising, 1202);
+  h.fake->push(7, Kind::Falling, 1205);
+  h.button.service(); // one service call, however late, still sees the true timing
+
+  ASSERT_EQ(h.presses.size(), 1u);
+  EXPECT_EQ(h.presses[0], Press::ShortPress);
+}
+
+TEST(gpio_input, long_press_reported_while_held_and_not_again_on_release) {
+  ButtonHarness h;
+  h.fake->push(7, Kind::Rising, 5000);
+  h.button.service();
+
+  h.button.poll(std::chrono::milliseconds{ 5500 });
+  EXPECT_TRUE(h.presses.empty());
+  h.button.poll(std::chrono::milliseconds{ 6000 });
+  ASSERT_EQ(h.presses.size(), 1u);
+  EXPECT_EQ(h.presses[0], Press::LongPress);
+
+  h.fake->push(7, Kind::Falling, 6300);
+  h.button.service();
+  EXPECT_EQ(h.presses.size(), 1u);
+}
+
+TEST(gpio_input, long_press_classified_on_release_without_polling) {
+  ButtonHarness h;
+  h.fake->push(7, Kind::Rising, 100);
+  h.fake->push(7, Kind::Falling, 1400);
+  h.button.service();
+
+  ASSERT_EQ(h.presses.size(), 1u);
+  EXPECT_EQ(h.presses[0], Press::LongPress);
+}
+
+TEST(gpio_input, bounce_ending_in_other_level_is_settled_by_poll) {
+  milo::io::GPIOInput line;
+  auto src = std::make_unique<milo::test::FakeEdgeEventSource>();
+  auto* fake = src.get();
+  line.attach(std::move(src), 3);
+  std::vector<milo::io::GPIOInput::Edge> edges;
+  line.registerCallback([&](auto e) { edges.push_back(e); });
+
+  fake->push(3, Kind::Rising, 100);
+  fake->push(3, Kind::Falling, 105); // glitch: line actually went back low
+  fake->push(4, Kind::Rising, 106);  // other line on a shared request, ignored
+  line.service();
+  ASSERT_EQ(edges.size(), 1u);
+
+  line.poll(std::chrono::milliseconds{ 110 }); // still inside the window
+  EXPECT_EQ(edges.size(), 1u);
+  line.poll(std::chrono::milliseconds{ 130 });
+  ASSERT_EQ(edges.size(), 2u);
+  EXPECT_EQ(edges[1], milo::io::GPIOInput::Edge::Falling);
+}
+
+TEST(gpio_input, wheel_timers_replace_polling) {
+  milo::core::TimerWheel wheel(std::chrono::milliseconds{ 1 }, false, std::chrono::nanoseconds{ 0 });
+  ButtonHarness h;
+  h.button.attachTimers(wheel);
+
+  h.fake->push(7, Kind::Rising, 5000);
+  h.button.service();
+  EXPECT_EQ(wheel.size(), 1u); // hold timer armed at press + threshold
+
+  wheel.advance(std::chrono::milliseconds{ 5999 });
+  EXPECT_TRUE(h.presses.empty());
+  wheel.advance(std::chrono::milliseconds{ 6000 });
+  ASSERT_EQ(h.presses.size(), 1u);
+  EXPECT_EQ(h.presses[0], Press::LongPress);
+
+  // short press cancels its hold timer on release
+  h.fake->push(7, Kind::Falling, 6300);
+  h.fake->push(7, Kind::Rising, 7000);
+  h.fake->push(7, Kind::Falling, 7100);
+  h.button.service();
+  EXPECT_EQ(wheel.size(), 0u);
+  ASSERT_EQ(h.presses.size(), 2u);
+  EXPECT_EQ(h.presses[1], Press::ShortPress);
+}
+
+TEST(gpio_input, bounce_ending_in_other_level_is_settled_by_wheel) {
+  milo::core::TimerWheel wheel(std::chrono::milliseconds{ 1 }, false, std::chrono::nanoseconds{ 0 });
+  milo::io::GPIOInput line;
+  auto src = std::make_unique<milo::test::FakeEdgeEventSource>();
+  auto* fake = src.get();
+  line.attach(std::move(src), 3);
+  line.attachTimers(wheel);
+  std::vector<milo::io::GPIOInput::Edge> edges;
+  line.registerCallback([&](auto e) { edges.push_back(e); });
+
+  fake->push(3, Kind::Rising, 100);
+  fake->push(3, Kind::Falling, 105);
+  line.service();
+  ASSERT_EQ(edges.size(), 1u);
+
+  wheel.advance(std::chrono::milliseconds{ 124 });
+  EXPECT_EQ(edges.size(), 1u);
+  wheel.advance(std::chrono::milliseconds{ 125 });
+  ASSERT_EQ(edges.size(), 2u);
+  EXPECT_EQ(edges[1], milo::io::GPIOInput::Edge::Falling);
+}
+
+namespace {
+  constexpr unsigned kA = 20, kB = 21;
+
+  // one full CW detent (00 → 01 → 11 → 10 → 00) starting at t ms, edges 1 ms apart
+  void cwDetent(milo::test::FakeEdgeEventSource& f, long t) {
+    f.push(kB, Kind::Rising, t);
+    f.push(kA, Kind::Rising, t + 1);
+    f.push(kB, Kind::Falling, t + 2);
+    f.push(kA, Kind::Falling, t + 3);
+  }
+
+  struct EncoderHarness {
+    milo::io::RotaryEncoderGPIO enc;
+    milo::test::FakeEdgeEventSource* fake;
+    EncoderHarness() {
+      auto src = std::make_unique<milo::test::FakeEdgeEventSource>();
+      fake = src.get();
+      enc.attach(std::move(src), kA, kB);
+    }
+  };
+} // namespace
+
+TEST(rotary_encoder, full_quadrature_cycle_is_one_detent_each_way) {
+  EncoderHarness h;
+  cwDetent(*h.fake, 1000);
+  // CCW: 00 → 10 → 11 → 01 → 00
+  h.fake->push(kA, Kind::Rising, 2000);
+  h.fake->push(kB, Kind::Rising, 2001);
+  h.fake->push(kA, Kind::Falling, 2002);
+  h.fake->push(kB, Kind::Falling, 2003);
+  h.enc.service();
+
+  milo::io::RotaryEncoderGPIO::Event ev;
+  ASSERT_TRUE(h.enc.nextEvent(ev));
+  EXPECT_EQ(ev.dir, milo::io::RotaryEncoderGPIO::Direction::CW);
+  EXPECT_EQ(ev.steps, 1);
+  ASSERT_TRUE(h.enc.nextEvent(ev));
+  EXPECT_EQ(ev.dir, milo::io::RotaryEncoderGPIO::Direction::CCW);
+  EXPECT_EQ(ev.steps, 1); // direction change resets acceleration
+  EXPECT_FALSE(h.enc.nextEvent(ev));
+}
+
+TEST(rotary_encoder, chatter_on_one_channel_cancels_out) {
+  EncoderHarness h;
+  for (int i = 0; i < 5; ++i) { // B chatters without A ever moving
+    h.fake->push(kB, Kind::Rising, 100 + 2 * i);
+    h.fake->push(kB, Kind::Falling, 101 + 2 * i);
+  }
+  h.enc.service();
+
+  milo::io::RotaryEncoderGPIO::Event ev;
+  EXPECT_FALSE(h.enc.nextEvent(ev));
+}
+
+TEST(rotary_encoder, skipped_state_and_lost_events_count_as_bounce) {
+  EncoderHarness h;
+  h.fake->push(kA, Kind::Rising, 10); // A and B flip in the same instant: 00 → 11
+  h.fake->push(kB, Kind::Rising, 10);
+  h.enc.service();
+  EXPECT_EQ(h.enc.bounceCount(), 1u);
+
+  h.fake->push(kB, Kind::Falling, 20); // 11 → 10, a legal quarter step
+  h.fake->loseEvents(3);
+  h.fake->push(kA, Kind::Falling, 30); // seqno gap: partial detent discarded
+  h.enc.service();
+  EXPECT_EQ(h.enc.bounceCount(), 2u);
+
+  milo::io::RotaryEncoderGPIO::Event ev;
+  EXPECT_FALSE(h.enc.nextEvent(ev));
+}
+
+TEST(rotary_encoder, fast_flick_is_accelerated) {
+  EncoderHarness h;
+  for (int d = 0; d < 10; ++d)
+    cwDetent(*h.fake, 1000 + d * 200); // slow: 200 ms per detent
+  for (int d = 0; d < 10; ++d)
+    cwDetent(*h.fake, 5000 + d * 8); // flick: 8 ms per detent
+  h.enc.service();
+
+  std::int32_t slow = 0, fast = 0;
+  milo::io::RotaryEncoderGPIO::Event ev;
+  for (int i = 0; i < 10 && h.enc.nextEvent(ev); ++i)
+    slow += ev.steps;
+  for (int i = 0; i < 10 && h.enc.nextEvent(ev); ++i)
+    fast += ev.steps;
+
+  EXPECT_EQ(slow, 10);
+  EXPECT_GT(fast, 200); // one flick covers hundreds of raw detents
+}
+
+// ─── serial capture / replay ────────────────────────────────────────────────
+
+TEST(serial_capture, records_both_directions_and_loads_back) {
+  int masterFd, slaveFd;
+  char slaveName[64];
+  ASSERT_EQ(0, openpty(&masterFd, &slaveFd, slaveName, nullptr, nullptr));
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("milo_capture_" + std::to_string(getpid()) + ".cap");
+  {
+    auto writer = milo::io::CaptureWriter::create(path);
+    ASSERT_TRUE(writer);
+    const auto id = writer->addChannel("PSU");
+    ASSERT_TRUE(id);
+    ASSERT_EQ(writer->addChannel("Pump2", "\n"), 1);
+
+    milo::io::SerialChannel chan;
+    ASSERT_TRUE(chan.open(slaveName, {}));
+    chan.attachCapture(writer, *id);
+
+    ASSERT_TRUE(chan.writeLine("EN 1"));
+    const char* reply = "OK EN\r\n";
+    write(masterFd, reply, strlen(reply));
+    auto line = chan.readLine(std::chrono::milliseconds{ 100 });
+    ASSERT_TRUE(line);
+    EXPECT_EQ(*line, "OK EN");
+  }
+  close(masterFd);
+
+  auto cap = milo::io::Capture::load(path);
+  ASSERT_TRUE(cap);
+  ASSERT_EQ(cap->channels.size(), 2u);
+  EXPECT_EQ(cap->channels[0], "PSU");
+  ASSERT_EQ(cap->terminators.size(), 2u);
+  EXPECT_EQ(cap->terminators[0], "\r\n");
+  EXPECT_EQ(cap->terminators[1], "\n");
+  ASSERT_EQ(cap->records.size(), 2u);
+  EXPECT_EQ(cap->records[0].dir, milo::io::Capture::Direction::Tx);
+  EXPECT_EQ(cap->records[0].bytes, "EN 1\r\n");
+  EXPECT_EQ(cap->records[1].dir, milo::io::Capture::Direction::Rx);
+  EXPECT_EQ(cap->records[1].bytes, "OK EN\r\n");
+  EXPECT_LE(cap->records[0].t, cap->records[1].t);
+
+  // a crash mid-record leaves a torn tail: everything before it still loads
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+  cap = milo::io::Capture::load(path);
+  ASSERT_TRUE(cap);
+  EXPECT_EQ(cap->records.size(), 1u);
+
+  // a channel id no DeviceRegistry can have is a foreign/corrupt file, not a table size
+  const unsigned char bogus[] = { 'M', 'I', 'L', 'O', 'C', 'A', 'P', 1, 0, 0, 0, 0, 0, 0, 0, 0,
+                                  0xFF, 0xC8, 0x01, 1, 'X' };
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bogus), sizeof(bogus));
+  }
+  EXPECT_FALSE(milo::io::Capture::load(path));
+  std::filesystem::remove(path);
+}
+
+namespace {
+  using milo::io::Capture;
+  using milo::io::ReplaySerialChannel;
+
+  /// PSU channel: "EN 1" answered after 30 ms in two chunks, then "READ" answered after 300 ms.
+  std::shared_ptr<const Capture> scriptedCapture() {
+    using namespace std::chrono_literals;
+    auto cap = std::make_shared<Capture>();
+    cap->channels = { "PSU" };
+    cap->records = { { 0ms, 0, Capture::Direction::Tx, "EN 1\r\n" },
+                     { 20ms, 0, Capture::Direction::Rx, "OK " },
+                     { 30ms, 0, Capture::Direction::Rx, "EN\r\n" },
+                     { 100ms, 0, Capture::Direction::Tx, "READ\r\n" },
+                     { 400ms, 0, Capture::Direction::Rx, "V 12.0\r\n" } };
+    return cap;
+  }
+} // namespace
+
+TEST(replay_serial_channel, recorded_pacing_reproduces_reply_latency) {
+  using namespace std::chrono_literals;
+  auto ch = ReplaySerialChannel::forChannel(scriptedCapture(), "PSU");
+  ASSERT_TRUE(ch);
+
+  ASSERT_TRUE(ch->writeLine("EN 1"));
+  const auto t0 = std::chrono::steady_clock::now();
+  auto line = ch->readLine(200ms);
+  const auto took = std::chrono::steady_clock::now() - t0;
+  ASSERT_TRUE(line);
+  EXPECT_EQ(*line, "OK EN");
+  EXPECT_GE(took, 29ms);
+
+  // the device took 300 ms to answer: a 50 ms read times out just like in the field
+  ASSERT_TRUE(ch->writeLine("READ\r\n"));
+  EXPECT_FALSE(ch->readLine(50ms));
+  line = ch->readLine(400ms);
+  ASSERT_TRUE(line);
+  EXPECT_EQ(*line, "V 12.0");
+  EXPECT_TRUE(ch->finished());
+  EXPECT_EQ(ch->divergences(), 0u);
+}
+
+TEST(replay_serial_channel, recorded_pacing_waits_on_the_channel_clock) {
+  using namespace std::chrono_literals;
+  auto ch = ReplaySerialChannel::forChannel(scriptedCapture(), "PSU");
+  ASSERT_TRUE(ch);
+  milo::core::VirtualClock clock;
+  ch->setClock(clock);
+
+  const auto t0 = std::chrono::steady_clock::now();
+  ASSERT_TRUE(ch->writeLine("EN 1"));
+  EXPECT_EQ(ch->readLine(200ms).value_or(""), "OK EN");
+  EXPECT_EQ(clock.now(), 30ms);
+  ASSERT_TRUE(ch->writeLine("READ"));
+  EXPECT_FALSE(ch->readLine(50ms)); // still a field timeout, in simulated time
+  EXPECT_EQ(ch->readLine(400ms).value_or(""), "V 12.0");
+  EXPECT_EQ(clock.now(), 30ms + 300ms); // due 300 ms after READ, however it was polled
+  EXPECT_LT(std::chrono::steady_clock::now() - t0, 100ms);
+}
+
+TEST(replay_serial_channel, frames_lines_with_the_recorded_terminator) {
+  using namespace std::chrono_literals;
+  auto cap = std::make_shared<Capture>();
+  cap->channels = { "Pump2" };
+  cap->terminators = { "\n" };
+  cap->records = { { 0ms, 0, Capture::Direction::Tx, "RATE 5\n" },
+                   { 1ms, 0, Capture::Direction::Rx, "OK\nV 1.5\n" } };
+  auto ch = ReplaySerialChannel::forChannel(cap, "Pump2",
+                                            ReplaySerialChannel::Pacing::AsFastAsPossible);
+  ASSERT_TRUE(ch);
+  EXPECT_EQ(ch->terminator(), "\n");
+
+  ASSERT_TRUE(ch->writeLine("RATE 5"));
+  EXPECT_EQ(ch->readLine(10ms).value_or(""), "OK");
+  EXPECT_EQ(ch->readLine(10ms).value_or(""), "V 1.5");
+  EXPECT_EQ(ch->divergences(), 0u);
+  EXPECT_TRUE(ch->finished());
+}
+
+TEST(replay_serial_channel, fast_pacing_never_sleeps_and_counts_divergence) {
+  using namespace std::chrono_literals;
+  auto ch = ReplaySerialChannel::forChannel(scriptedCapture(), "PSU",
+                                            ReplaySerialChannel::Pacing::AsFastAsPossible);
+  ASSERT_TRUE(ch);
+  EXPECT_FALSE(ReplaySerialChannel::forChannel(scriptedCapture(), "PG"));
+
+  const auto t0 = std::chrono::steady_clock::now();
+  ASSERT_TRUE(ch->writeLine("EN 0")); // host changed: different command
+  EXPECT_EQ(ch->readLine(1s).value_or(""), "OK EN");
+  ASSERT_TRUE(ch->writeLine("READ"));
+  EXPECT_EQ(ch->readLine(1s).value_or(""), "V 12.0");
+  EXPECT_LT(std::chrono::steady_clock::now() - t0, 100ms);
+  EXPECT_EQ(ch->divergences(), 1u);
+
+  // nothing recorded after the last reply: a timeout, and one more divergence on extra writes
+  EXPECT_FALSE(ch->readLine(10ms));
+  ch->writeLine("EXTRA");
+  EXPECT_EQ(ch->divergences(), 2u);
+
+  ASSERT_TRUE(ch->open({}, {})); // rewinds
+  EXPECT_EQ(ch->divergences(), 0u);
+  EXPECT_FALSE(ch->finished());
+}
+
+// ─── crash-consistent run log ───────────────────────────────────────────────
+
+namespace {
+  std::string readAll(const std::filesystem::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
+
+  std::string eventLine(int i) { return "1700000000" + std::to_string(i) + ",sample,PSU.V,12.5\n"; }
+} // namespace
+
+TEST(log_journal, recovers_committed_chunks_and_drops_torn_tail) {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("milo_journal_" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  const auto log = (dir / "run.csv").string();
+  const auto jnl = milo::io::FileLogger::journalPath(log);
+
+  std::string committed;
+  for (int i = 0; i < 300; ++i)
+    committed += eventLine(i);
+
+  // the "daemon": writes, commits, then dies without closing (watchdog reset)
+  const pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    milo::io::FileLogger f;
+    if (!f.open(log, true))
+      _exit(1);
+    for (int i = 0; i < 300; ++i)
+      f.write(eventLine(i));
+    f.sync();
+    f.write("never,flushed\n");
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  ASSERT_TRUE(std::filesystem::exists(jnl));
+
+  // the card lost the log's last writes, and the journal ends in half a block
+  std::filesystem::resize_file(log, committed.size() / 3);
+  { std::ofstream(jnl, std::ios::app | std::ios::binary) << "MLJ1 torn"; }
+
+  const auto rec = milo::io::LogJournal::recover(log, jnl);
+  ASSERT_TRUE(rec);
+  EXPECT_GT(rec->blocks, 0u);
+  EXPECT_EQ(rec->discarded, 9u);
+  EXPECT_EQ(rec->logBytes, committed.size());
+  EXPECT_EQ(readAll(log), committed);
+  EXPECT_FALSE(std::filesystem::exists(jnl));
+  EXPECT_FALSE(milo::io::LogJournal::recover(log, jnl)); // nothing left to do
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(log_journal, clean_close_removes_journal_and_checkpoints_bound_it) {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("milo_journal_ck_" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  const auto log = (dir / "run.csv").string();
+  const auto jnl = milo::io::FileLogger::journalPath(log);
+
+  milo::io::FileLogger f;
+  ASSERT_TRUE(f.open(log, true));
+  std::string expected;
+  for (int i = 0; i < 20'000; ++i) { // ≈ 0.7 MB, several checkpoints
+    f.write(eventLine(i));
+    expected += eventLine(i);
+    if (i % 500 == 0) {
+      ASSERT_TRUE(f.sync());
+    }
+    ASSERT_LT(std::filesystem::file_size(jnl),
+              milo::io::LogJournal::kCheckpointBytes + 64 * 1024);
+  }
+  f.close();
+  EXPECT_FALSE(std::filesystem::exists(jnl));
+  EXPECT_EQ(readAll(log), expected);
+  std::filesystem::remove_all(dir);
+}
@@ -1,3 +1,459 @@
+#include "core/LogCompressor.hpp"
+#include "core/LogEvent.hpp"
+#include "core/Logger.hpp"
+#include "core/Lz.hpp"
+#include "core/RunIndex.hpp"
+#include "core/RunManifest.hpp"
+#include "core/RuntimeProfile.hpp"
+#include "core/SampleStream.hpp"
+#include "core/SystemEvent.hpp"
+
 #include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
 TEST(logger_tests, passes) {}
 
+namespace {
+  namespace fs = std::filesystem;
+
+  struct TempDir {
+    fs::path path = fs::temp_directory_path() / ("milo_logger_" + std::to_string(::getpid()));
+    TempDir() { fs::remove_all(path); }
+    ~TempDir() { fs::remove_all(path); }
+  };
+
+  std::string slurp(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
+
+  void logSomeEvents(milo::core::Logger& logger, int n) {
+    logger.startNewRun();
+    for (int i = 0; i < n; ++i)
+      logger.log(milo::core::LogEvent::make(milo::core::LogEvent::Type::Sample, "PSU.V", i * 0.5));
+    logger.finishRun();
+  }
+} // namespace
+
+TEST(logger_tests, run_file_has_headers_events_and_notes) {
+  TempDir dir;
+  milo::core::Logger logger(dir.path.string(), 64);
+  logger.setRunHeader("jitter", "period=1000us n=10");
+  logger.setRunHeader("jitter", "period=1000us n=20"); // replaces, not appends
+
+  logger.startNewRun();
+  using Type = milo::core::LogEvent::Type;
+  logger.log(milo::core::LogEvent::make(Type::Sample, "PSU.V", 12.5));
+  logger.log(milo::core::LogEvent::make(Type::Command, "a_key_longer_than_the_fixed_field", 1));
+  logger.note("jitter", "recheck");
+  const auto path = logger.currentRunPath();
+  logger.finishRun();
+
+  EXPECT_NE(path.find("_run001.csv"), std::string::npos);
+  const auto text = slurp(path);
+  EXPECT_EQ(text.find("# jitter: period=1000us n=20\ntimestamp_ns,type,key,value\n"), 0u);
+  EXPECT_NE(text.find(",sample,PSU.V,12.5\n"), std::string::npos);
+  EXPECT_NE(text.find(",command,a_key_longer_than_the_f,1\n"), std::string::npos);
+  EXPECT_NE(text.find("# jitter: recheck\n"), std::string::npos);
+  EXPECT_EQ(logger.dropped(), 0u);
+
+  logger.startNewRun(); // numbering continues from what is on disk
+  EXPECT_NE(logger.currentRunPath().find("_run002.csv"), std::string::npos);
+}
+
+TEST(logger_tests, full_queue_drops_and_counts_instead_of_blocking) {
+  TempDir dir;
+  milo::core::Logger logger(dir.path.string(), 4);
+  for (int i = 0; i < 10; ++i) // no run open: nobody drains
+    logger.log(milo::core::LogEvent::make(milo::core::LogEvent::Type::Sample, "x", i));
+  EXPECT_EQ(logger.dropped(), 6u);
+}
+
+TEST(logger_tests, jitter_self_check_lands_in_run_header) {
+  TempDir dir;
+  milo::core::RuntimeConfig cfg;
+  cfg.realtime = false; // unprivileged test host
+  cfg.jitterPeriod = std::chrono::microseconds{ 200 };
+  cfg.jitterSamples = 50;
+  milo::core::RuntimeProfile profile(cfg);
+
+  const auto report = profile.measureJitter();
+  EXPECT_EQ(report.samples, 50u);
+  EXPECT_LE(report.min, report.p99);
+  EXPECT_LE(report.p99, report.max);
+  EXPECT_GE(report.min.count(), 0);
+
+  milo::core::Logger logger(dir.path.string());
+  logger.setRunHeader("runtime", profile.describe());
+  logger.setRunHeader("jitter", report.toString());
+  logger.startNewRun();
+  const auto path = logger.currentRunPath();
+  logger.finishRun();
+
+  const auto text = slurp(path);
+  EXPECT_NE(text.find("# runtime: protocol=other@cpu1"), std::string::npos);
+  EXPECT_NE(text.find("# jitter: period=200us n=50 "), std::string::npos);
+  EXPECT_NE(text.find("thread=protocol"), std::string::npos);
+}
+
+TEST(logger_tests, finished_runs_are_archived_and_listed_in_manifest) {
+  TempDir dir;
+  std::string firstRun;
+  {
+    milo::core::Logger logger(dir.path.string(), 256);
+    for (int run = 0; run < 3; ++run) {
+      logSomeEvents(logger, 200);
+      if (run == 0)
+        firstRun = logger.currentRunPath();
+    }
+    logger.waitForCompression();
+
+    const auto runs = logger.manifest().runs();
+    ASSERT_EQ(runs.size(), 3u);
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_TRUE(runs[i].compressed()) << runs[i].name;
+      EXPECT_EQ(runs[i].status, milo::core::RunRecord::Status::Closed);
+      EXPECT_LT(runs[i].storedBytes * 2, runs[i].rawBytes);
+    }
+    EXPECT_FALSE(runs[2].compressed()); // newest stays plain
+    EXPECT_EQ(runs[2].storedBytes, runs[2].rawBytes);
+    EXPECT_FALSE(fs::exists(firstRun));
+
+    const auto text = milo::core::LogCompressor::readFile(firstRun + ".mlz");
+    ASSERT_TRUE(text);
+    EXPECT_EQ(text->size(), runs[0].rawBytes);
+    EXPECT_NE(text->find(",sample,PSU.V,99.5\n"), std::string::npos);
+  }
+
+  // a new process reads the same manifest and keeps numbering past archived runs
+  milo::core::Logger logger(dir.path.string());
+  EXPECT_EQ(logger.manifest().runs().size(), 3u);
+  logger.startNewRun();
+  EXPECT_NE(logger.currentRunPath().find("_run004.csv"), std::string::npos);
+}
+
+TEST(logger_tests, quota_rotation_counts_on_disk_bytes) {
+  TempDir dir;
+  milo::core::Logger logger(dir.path.string(), 256);
+  logger.setRetention({ .quotaBytes = 20'000, .compress = false });
+  for (int run = 0; run < 3; ++run)
+    logSomeEvents(logger, 250); // ≈ 8 kB each
+  ASSERT_GT(logger.manifest().storedBytes(), 20'000u);
+
+  logger.startNewRun(); // makes room first: the oldest run goes
+  auto runs = logger.manifest().runs();
+  ASSERT_EQ(runs.size(), 3u);
+  EXPECT_NE(runs[0].name.find("_run002.csv"), std::string::npos);
+  EXPECT_FALSE(fs::exists(dir.path / "_run001.csv"));
+  logger.finishRun();
+
+  // compressed sizes count: with archives the same quota holds every run
+  logger.setRetention({ .quotaBytes = 20'000, .compress = true });
+  logger.waitForCompression();
+  for (int run = 0; run < 3; ++run) {
+    logSomeEvents(logger, 250);
+    logger.waitForCompression();
+  }
+  logger.startNewRun();
+  runs = logger.manifest().runs();
+  EXPECT_EQ(runs.size(), 7u);
+  EXPECT_LE(logger.manifest().storedBytes(), 20'000u);
+}
+
+TEST(logger_tests, run_cut_short_by_reset_is_repaired_and_marked_interrupted) {
+  TempDir dir;
+  const pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    milo::core::Logger logger(dir.path.string(), 256);
+    logger.startNewRun();
+    for (int i = 0; i < 100; ++i)
+      logger.log(milo::core::LogEvent::make(milo::core::LogEvent::Type::Sample, "PSU.V", i));
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1300 }); // one group commit
+    _exit(0); // no finishRun(): the run is still open on disk
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  milo::core::Logger logger(dir.path.string());
+  ASSERT_EQ(logger.recoveredRuns().size(), 1u);
+  const auto runs = logger.manifest().runs();
+  ASSERT_EQ(runs.size(), 1u);
+  EXPECT_EQ(runs[0].status, milo::core::RunRecord::Status::Interrupted);
+
+  const auto path = dir.path / runs[0].name;
+  EXPECT_FALSE(fs::exists(path.string() + ".jnl"));
+  const auto text = slurp(path.string());
+  EXPECT_NE(text.find(",sample,PSU.V,99\n"), std::string::npos);
+  EXPECT_NE(text.find("# interrupted: recovered "), std::string::npos);
+  EXPECT_EQ(runs[0].rawBytes, text.size());
+
+  milo::core::Logger again(dir.path.string()); // recovery runs once
+  EXPECT_TRUE(again.recoveredRuns().empty());
+}
+
+TEST(logger_tests, event_bus_transitions_land_in_the_run_file) {
+  TempDir dir;
+  milo::core::EventBus bus(16);
+  milo::core::Logger logger(dir.path.string(), 64);
+  logger.attachEventBus(bus);
+
+  using milo::core::SystemEvent;
+  using milo::core::SystemState;
+  bus.publish(SystemEvent::stateChanged(SystemState::INIT, SystemState::IDLE)); // before the run
+  logger.startNewRun();
+  bus.publish(SystemEvent::stateChanged(SystemState::IDLE, SystemState::RUNNING));
+  bus.publish(SystemEvent::error(SystemState::RUNNING, "pump stalled, retry\nfailed"));
+  const auto path = logger.currentRunPath();
+  logger.finishRun();
+
+  const auto text = slurp(path);
+  EXPECT_EQ(text.find(",state,IDLE,"), std::string::npos);
+  EXPECT_NE(text.find(",state,RUNNING,3\n"), std::string::npos);
+  EXPECT_NE(text.find(",error,pump stalled; retry;fai,3\n"), std::string::npos); // key is 23 chars
+}
+
+TEST(logger_tests, streamed_samples_arrive_in_blocks_as_sample_lines) {
+  TempDir dir;
+  milo::core::Logger logger(dir.path.string(), 64);
+  milo::core::SampleStreams streams;
+  streams.attachLogger(logger);
+
+  logger.startNewRun();
+  const milo::core::Device psu{ 1 };
+  for (int i = 0; i < 150; ++i) // two full blocks, the rest goes at flush()
+    streams.add(psu, "PSU", "V1", std::chrono::microseconds{ 2500 } * i, 12.25f);
+  streams.add(psu, "PSU", "V1", std::chrono::seconds{ 1 }, 2.51f);
+  streams.flush();
+  const auto path = logger.currentRunPath();
+  logger.finishRun();
+
+  const auto text = slurp(path);
+  std::size_t lines = 0;
+  for (auto pos = text.find(",sample,PSU.V1,"); pos != std::string::npos;
+       pos = text.find(",sample,PSU.V1,", pos + 1))
+    ++lines;
+  EXPECT_EQ(lines, 151u);
+  EXPECT_NE(text.find("\n2500000,sample,PSU.V1,12.25\n"), std::string::npos);
+  EXPECT_NE(text.find("\n1000000000,sample,PSU.V1,2.51\n"), std::string::npos); // as a float
+  EXPECT_EQ(logger.dropped(), 0u);
+}
+
+namespace {
+  std::string roundTrip(const std::string& in, std::size_t* packedSize = nullptr) {
+    std::vector<char> packed(milo::core::lz::maxCompressedSize(in.size()));
+    const auto m = milo::core::lz::compress(in, packed);
+    if (packedSize)
+      *packedSize = m;
+    std::string out(in.size(), '\0');
+    const auto n = milo::core::lz::decompress({ packed.data(), m }, out);
+    return n == in.size() ? out : std::string("<decode failed>");
+  }
+
+  std::string csvLines(int n) {
+    std::string s;
+    for (int i = 0; i < n; ++i)
+      s += std::to_string(1'700'000'000'000'000'000ll + i * 997) + ",sample,PSU.V," +
+           std::to_string(12.0 + (i % 50) * 0.01) + "\n";
+    return s;
+  }
+} // namespace
+
+TEST(lz_codec, round_trips_and_compresses_csv) {
+  EXPECT_EQ(roundTrip(""), "");
+  EXPECT_EQ(roundTrip("abc"), "abc");
+  const std::string runs(100'000, 'x'); // one very long match
+  EXPECT_EQ(roundTrip(runs), runs);
+
+  std::size_t packed = 0;
+  const auto csv = csvLines(2000);
+  EXPECT_EQ(roundTrip(csv, &packed), csv);
+  EXPECT_LT(packed * 3, csv.size());
+
+  std::mt19937 rng(7);
+  std::string noise(70'000, '\0');
+  for (auto& c : noise)
+    c = static_cast<char>(rng());
+  EXPECT_EQ(roundTrip(noise, &packed), noise);
+  EXPECT_LE(packed, milo::core::lz::maxCompressedSize(noise.size()));
+}
+
+TEST(lz_codec, rejects_malformed_input) {
+  const auto csv = csvLines(100);
+  std::vector<char> packed(milo::core::lz::maxCompressedSize(csv.size()));
+  const auto m = milo::core::lz::compress(csv, packed);
+  std::string out(csv.size(), '\0');
+
+  EXPECT_FALSE(milo::core::lz::decompress({ packed.data(), m }, { out.data(), 10 })); // too small
+  const char badOffset[] = { 0x10, 'a', 0x05, 0x00 }; // match 5 back after one byte
+  EXPECT_FALSE(milo::core::lz::decompress(badOffset, out));
+  const char truncated[] = { static_cast<char>(0xF0) }; // 15+ literals, length byte missing
+  EXPECT_FALSE(milo::core::lz::decompress(truncated, out));
+}
+
+TEST(log_compressor, archive_round_trips_and_detects_corruption) {
+  TempDir dir;
+  fs::create_directories(dir.path);
+  const auto src = (dir.path / "run.csv").string();
+  const auto text = csvLines(10'000); // several 64 KiB blocks
+  std::ofstream(src) << text;
+
+  ASSERT_TRUE(milo::core::LogCompressor::compressFile(src, src + ".mlz"));
+  EXPECT_LT(fs::file_size(src + ".mlz") * 3, text.size());
+  EXPECT_EQ(milo::core::LogCompressor::readFile(src + ".mlz"), text);
+  EXPECT_EQ(milo::core::LogCompressor::readFile(src), text); // plain CSV passes through
+
+  {
+    std::fstream f(src + ".mlz", std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(200);
+    f.put('\x7f');
+  }
+  EXPECT_FALSE(milo::core::LogCompressor::readFile(src + ".mlz"));
+  EXPECT_FALSE(milo::core::LogCompressor::compressFile(src, src + ".mlz", [] { return false; }));
+  EXPECT_FALSE(fs::exists(src + ".mlz.tmp"));
+}
+
+TEST(log_compressor, waits_while_paused) {
+  TempDir dir;
+  fs::create_directories(dir.path);
+  const auto src = (dir.path / "run.csv").string();
+  std::ofstream(src) << csvLines(1000);
+
+  std::atomic<int> done{ 0 };
+  milo::core::LogCompressor compressor([&](const std::string&, std::uint64_t raw,
+                                           std::uint64_t packed, bool ok) {
+    EXPECT_TRUE(ok);
+    EXPECT_LT(packed, raw);
+    ++done;
+  });
+  compressor.pause();
+  compressor.enqueue(src);
+  compressor.enqueue(src); // de-duplicated
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+  EXPECT_EQ(done, 0);
+  EXPECT_EQ(compressor.pending(), 1u);
+
+  compressor.resume();
+  compressor.waitIdle();
+  EXPECT_EQ(done, 1);
+  EXPECT_TRUE(fs::exists(src + ".mlz"));
+}
+
+namespace {
+  using Type = milo::core::LogEvent::Type;
+
+  /// 3000 events 5 ms apart; every 97th is an error.
+  void logTimedRun(milo::core::Logger& logger) {
+    logger.startNewRun();
+    for (int i = 0; i < 3000; ++i) {
+      auto e = milo::core::LogEvent::make(i % 97 == 0 ? Type::Error : Type::Sample, "PSU.V", i);
+      e.timestamp = std::chrono::milliseconds{ 5 * i } + std::chrono::seconds{ 100 };
+      logger.log(e);
+      if (i == 1500)
+        logger.note("operator", "mid-run note");
+      if (i % 1000 == 999) // let the worker drain the queue
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+    }
+    logger.finishRun();
+  }
+
+  /// Reference answer: filter every line of the whole log.
+  std::vector<std::string> scan(const std::string& text, auto&& pred) {
+    std::vector<std::string> out;
+    std::istringstream in(text);
+    for (std::string line; std::getline(in, line);) {
+      if (line.empty() || line[0] == '#' || line[0] == 't')
+        continue;
+      const auto ts = std::stoll(line.substr(0, line.find(',')));
+      const auto c1 = line.find(',');
+      const auto type = line.substr(c1 + 1, line.find(',', c1 + 1) - c1 - 1);
+      if (pred(ts, type))
+        out.push_back(line);
+    }
+    return out;
+  }
+} // namespace
+
+TEST(run_index, window_and_type_queries_match_a_full_scan) {
+  TempDir dir;
+  milo::core::Logger logger(dir.path.string(), 4096);
+  logTimedRun(logger);
+  ASSERT_EQ(logger.dropped(), 0u);
+
+  const auto run = logger.manifest().runs().at(0);
+  ASSERT_FALSE(run.index.empty());
+  const auto idx = milo::core::RunIndex::forRun(dir.path.string(), run);
+  ASSERT_TRUE(idx);
+  EXPECT_GT(idx->entries().size(), 10u); // ≤ 256 events or 1 s per block
+  for (const auto& e : idx->entries())
+    EXPECT_LE(e.lastNs - e.firstNs, 1'000'000'000);
+
+  const auto logPath = (dir.path / run.stored).string();
+  const auto text = slurp(logPath);
+  const std::int64_t lo = 107'000'000'000, hi = 109'500'000'000; // 2.5 s around t=108 s
+  const auto window = idx->window(logPath, std::chrono::nanoseconds{ lo }, std::chrono::nanoseconds{ hi });
+  EXPECT_EQ(window, scan(text, [&](std::int64_t ts, const std::string&) { return ts >= lo && ts <= hi; }));
+  EXPECT_EQ(window.size(), 501u);
+
+  const auto errors = idx->ofType(logPath, Type::Error);
+  EXPECT_EQ(errors, scan(text, [](std::int64_t, const std::string& t) { return t == "error"; }));
+  EXPECT_EQ(errors.size(), 31u);
+  EXPECT_TRUE(idx->window(logPath, std::chrono::seconds{ 1 }, std::chrono::seconds{ 2 }).empty());
+
+  // the same queries work once the run is archived, and on an index cut short by a crash
+  logTimedRun(logger); // run 1 becomes the non-newest and is compressed
+  logger.waitForCompression();
+  const auto archived = logger.manifest().runs().at(0);
+  ASSERT_TRUE(archived.compressed());
+  const auto mlz = (dir.path / archived.stored).string();
+  EXPECT_EQ(idx->window(mlz, std::chrono::nanoseconds{ lo }, std::chrono::nanoseconds{ hi }), window);
+  EXPECT_EQ(idx->ofType(mlz, Type::Error), errors);
+
+  fs::resize_file(dir.path / archived.index, fs::file_size(dir.path / archived.index) / 2 + 5);
+  const auto torn = milo::core::RunIndex::forRun(dir.path.string(), archived);
+  ASSERT_TRUE(torn);
+  EXPECT_LT(torn->entries().size(), idx->entries().size());
+  EXPECT_EQ(torn->window(mlz, std::chrono::nanoseconds{ lo }, std::chrono::nanoseconds{ hi }), window);
+  EXPECT_EQ(torn->ofType(mlz, Type::Error), errors);
+}
+
+TEST(run_index, window_reads_every_block_a_late_sample_landed_in) {
+  TempDir dir;
+  milo::core::Logger logger(dir.path.string(), 4096);
+  logger.startNewRun();
+  for (int i = 0; i < 2000; ++i) { // every 300th sample is logged 2 s after it was taken
+    auto e = milo::core::LogEvent::make(Type::Sample, "PSU.V", i);
+    e.timestamp = std::chrono::milliseconds{ 5 * i - (i % 300 == 0 ? 2000 : 0) } +
+                  std::chrono::seconds{ 100 };
+    logger.log(e);
+    if (i % 1000 == 999)
+      std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+  }
+  logger.finishRun();
+  ASSERT_EQ(logger.dropped(), 0u);
+
+  const auto run = logger.manifest().runs().at(0);
+  const auto idx = milo::core::RunIndex::forRun(dir.path.string(), run);
+  ASSERT_TRUE(idx);
+  const auto& entries = idx->entries();
+  ASSERT_GT(entries.size(), 2u);
+  EXPECT_LT(entries[2].firstNs, entries[1].lastNs); // ranges overlap
+
+  const auto logPath = (dir.path / run.stored).string();
+  const auto text = slurp(logPath);
+  const std::int64_t lo = 103'000'000'000, hi = 104'000'000'000;
+  const auto window = idx->window(logPath, std::chrono::nanoseconds{ lo }, std::chrono::nanoseconds{ hi });
+  EXPECT_EQ(window, scan(text, [&](std::int64_t ts, const std::string&) { return ts >= lo && ts <= hi; }));
+  EXPECT_EQ(window.size(), 201u);
+}
@@ -1,8 +1,18 @@
 // MILO-Prod headers
+#include "core/AllocationGuard.hpp"
 #include "core/ErrorMonitor.hpp"
+#include "core/Logger.hpp"
+#include "core/ParameterStore.hpp"
+#include "core/ProtocolExecutor.hpp"
 #include "core/RPCManager.hpp"
+#include "core/RunArena.hpp"
+#include "core/RunStats.hpp"
+#include "core/SampleStream.hpp"
+#include "io/ReplaySerialChannel.hpp"
 #include "io/SerialChannel.hpp"
 #include "protocols/Command.hpp"
+#include "protocols/CoroutineProtocol.hpp"
+#include "protocols/DeviceCommands.hpp"
 
 // MILO-Fake headers
 #include "FakeSerialChannel.hpp"
@@ -11,6 +21,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+// Linux headers
+#include <unistd.h>
+
 namespace milo::test {
 
   using milo::core::Device;
@@ -35,10 +48,10 @@ namespace milo::test {
       manager = std::make_unique<RPCManager>(std::static_pointer_cast<ErrorMonitor>(errorMonitor));
 
       // Inject fakes
-      for (auto dev : { Device::PG, Device::PSU, Device::Pump }) {
+      for (auto dev : manager->devices().all()) {
         auto fake = std::make_unique<FakeSerialChannel>();
-        fakeChannels[dev] = fake.get();            // raw ptr for assertions
-        manager->channels_[dev] = std::move(fake); // move into manager
+        fakeChannels.push_back(fake.get());              // raw ptr for assertions
+        manager->channels_[dev.index] = std::move(fake); // move into manager
       }
 
       manager->connected_ = true; // bypass connect logic
@@ -46,19 +59,596 @@ namespace milo::test {
 
     std::shared_ptr<testing::NiceMock<MockErrorMonitor>> errorMonitor;
     std::unique_ptr<RPCManager> manager;
-    std::unordered_map<Device, FakeSerialChannel*> fakeChannels;
+    std::vector<FakeSerialChannel*> fakeChannels; ///< by Device::index
+
+    // default registry: PG, PSU, Pump
+    const Device PG{ 0 }, PSU{ 1 }, Pump{ 2 };
   };
 
   TEST_F(RPCManagerTest, sendCommand_WritesWireFormatToCorrectChannel) {
     Command dummyCmd;
     dummyCmd.payload = "TEST123";
 
-    manager->sendCommand(Device::PG, dummyCmd);
+    manager->sendCommand(PG, dummyCmd);
 
-    FakeSerialChannel* fakePG = fakeChannels[Device::PG];
-    ASSERT_TRUE(fakePG->open("/dev/dummy", B115200));
+    FakeSerialChannel* fakePG = fakeChannels[PG.index];
+    ASSERT_TRUE(fakePG->open("/dev/dummy", {}));
     ASSERT_EQ(fakePG->getLastWritten(), "TEST123\r\n");
   }
 
 } // namespace milo::test
 
+
+namespace milo::test {
+
+  using milo::core::BatchRequest;
+
+  TEST_F(RPCManagerTest, scatterGather_WritesEveryDeviceAndCollectsReplies) {
+    std::vector<BatchRequest> batch{ { PSU, Command{ "EN 1" } },
+                                     { PG, Command{ "PULSE 10" } },
+                                     { Pump, Command{ "FLOW 2.5" } } };
+
+    auto report = manager->scatterGather(batch, std::chrono::milliseconds{ 50 });
+
+    ASSERT_EQ(report.results.size(), 3u);
+    EXPECT_TRUE(report.allOk());
+    EXPECT_EQ(report.results[0].dev, PSU);
+    EXPECT_EQ(fakeChannels[PSU.index]->getLastWritten(), "EN 1\r\n");
+    EXPECT_EQ(fakeChannels[PG.index]->getLastWritten(), "PULSE 10\r\n");
+    EXPECT_EQ(fakeChannels[Pump.index]->getLastWritten(), "FLOW 2.5\r\n");
+  }
+
+  TEST_F(RPCManagerTest, scatterGather_ReportsPerDeviceTimeoutWithoutThrowing) {
+    fakeChannels[PG.index]->next_read_line = std::nullopt;
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::HasSubstr("PG"))).Times(1);
+
+    std::vector<BatchRequest> batch{ { PSU, Command{ "EN 1" } },
+                                     { PG, Command{ "PULSE 10" } } };
+    auto report = manager->scatterGather(batch, std::chrono::milliseconds{ 10 });
+
+    EXPECT_FALSE(report.allOk());
+    EXPECT_TRUE(report.results[0].response.has_value());
+    EXPECT_TRUE(report.results[1].sent);
+    EXPECT_FALSE(report.results[1].response.has_value());
+  }
+
+  TEST_F(RPCManagerTest, scatterGather_RejectsDuplicateDeviceBeforeWriting) {
+    std::vector<BatchRequest> batch{ { PSU, Command{ "EN 1" } },
+                                     { PSU, Command{ "EN 0" } } };
+
+    EXPECT_THROW(manager->scatterGather(batch, std::chrono::milliseconds{ 10 }),
+                 std::invalid_argument);
+    EXPECT_EQ(fakeChannels[PSU.index]->write_count, 0);
+  }
+
+  TEST_F(RPCManagerTest, scatterGather_FlagsSynchronizedStartOutsideSkewWindow) {
+    fakeChannels[PG.index]->write_delay = std::chrono::milliseconds{ 5 };
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::HasSubstr("skew"))).Times(1);
+
+    std::vector<BatchRequest> batch{ { PG, Command{ "ARM" } },
+                                     { PSU, Command{ "ARM" } } };
+    auto report = manager->scatterGather(batch, std::chrono::milliseconds{ 10 },
+                                         std::chrono::microseconds{ 500 });
+
+    EXPECT_TRUE(report.skewExceeded);
+    EXPECT_GE(report.writeSkew, std::chrono::microseconds{ 5000 });
+    EXPECT_FALSE(report.allOk());
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  TEST_F(RPCManagerTest, inFlightTimer_EscalatesUncollectedReplyOnly) {
+    milo::core::TimerWheel wheel(std::chrono::milliseconds{ 1 }, false,
+                                 std::chrono::nanoseconds{ 0 });
+    manager->attachTimers(wheel, std::chrono::milliseconds{ 200 });
+
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::HasSubstr("PSU"))).Times(1);
+
+    manager->sendCommand(PSU, Command{ "EN 1" });
+    manager->sendCommand(PG, Command{ "PULSE 10" });
+    manager->awaitResponse(PG, std::chrono::milliseconds{ 10 }); // collected in time
+    EXPECT_EQ(wheel.size(), 1u);
+
+    wheel.advance(std::chrono::milliseconds{ 199 });
+    wheel.advance(std::chrono::milliseconds{ 200 });
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  TEST_F(RPCManagerTest, arenaCommands_SendAndBatchWithoutHeapAllocation) {
+    using milo::core::AllocationGuard;
+    if (!AllocationGuard::kCompiledIn)
+      GTEST_SKIP() << "built without MILO_ALLOC_GUARD";
+
+    milo::core::RunArena arena;
+    auto* mr = arena.resource();
+    std::pmr::vector<milo::core::BatchRequest> batch(mr);
+    batch.push_back({ PSU, Command{ std::pmr::string("VOLT 12.000 CH1 RAMP 50", mr) } });
+    batch.push_back({ PG, Command{ std::pmr::string("PULSE 10 WIDTH 250 DELAY 100", mr) } });
+
+    AllocationGuard::arm(AllocationGuard::Mode::Count);
+    manager->sendCommand(PSU, batch[0].cmd);
+    auto report = manager->scatterGather(batch, std::chrono::milliseconds{ 10 }, std::nullopt, mr);
+    AllocationGuard::disarm();
+
+    EXPECT_TRUE(report.allOk());
+    EXPECT_EQ(AllocationGuard::count(), 0u) << AllocationGuard::report();
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  TEST_F(RPCManagerTest, telemetry_CountsCommandsRepliesAndErrorsPerDevice) {
+    auto pub = milo::core::TelemetryPublisher::create("/milo-rpc-test-" + std::to_string(::getpid()));
+    ASSERT_NE(pub, nullptr);
+    manager->attachTelemetry(*pub);
+
+    manager->sendCommand(PSU, Command{ "EN 1" });
+    manager->awaitResponse(PSU, std::chrono::milliseconds{ 10 });
+    fakeChannels[PG.index]->next_read_line = std::nullopt;
+    manager->sendCommand(PG, Command{ "PULSE 10" });
+    EXPECT_THROW(manager->awaitResponse(PG, std::chrono::milliseconds{ 1 }), std::runtime_error);
+
+    const auto& seg = pub->segment();
+    ASSERT_EQ(seg.deviceCount.load(), 3u);
+    for (std::uint32_t i = 0; i < 3; ++i) {
+      const auto& d = seg.devices[i].data;
+      if (std::string_view(d.name) == "PSU") {
+        EXPECT_EQ(d.commands, 1u);
+        EXPECT_EQ(d.replies, 1u);
+        EXPECT_EQ(d.errors, 0u);
+      } else if (std::string_view(d.name) == "PG") {
+        EXPECT_EQ(d.commands, 1u);
+        EXPECT_EQ(d.replies, 0u);
+        EXPECT_EQ(d.errors, 1u);
+      }
+    }
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  using milo::io::Capture;
+  using milo::io::ReplaySerialChannel;
+
+  TEST_F(RPCManagerTest, replayedCapture_DrivesSendAndAwaitWithoutHardware) {
+    using namespace std::chrono_literals;
+    auto cap = std::make_shared<Capture>();
+    cap->channels = { "PG", "Pump" };
+    cap->records = { { 0ms, 0, Capture::Direction::Tx, "PULSE 10\r\n" },
+                     { 1ms, 1, Capture::Direction::Tx, "FLOW 2.5\r\n" },
+                     { 2ms, 1, Capture::Direction::Rx, "OK FLOW\r\n" },
+                     { 3ms, 0, Capture::Direction::Rx, "OK PULSE\r\n" } };
+
+    auto pgReplay = ReplaySerialChannel::forChannel(cap, "PG",
+                                                    ReplaySerialChannel::Pacing::AsFastAsPossible);
+    auto pumpReplay = ReplaySerialChannel::forChannel(
+        cap, "Pump", ReplaySerialChannel::Pacing::AsFastAsPossible);
+    auto* pg = pgReplay.get();
+    auto* pump = pumpReplay.get();
+    manager->attachChannel(PG, std::move(pgReplay));
+    manager->attachChannel(Pump, std::move(pumpReplay));
+
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::_)).Times(0);
+    manager->sendCommand(PG, Command{ "PULSE 10" });
+    manager->sendCommand(Pump, Command{ "FLOW 2.5" });
+    manager->awaitResponse(Pump, 50ms);
+    manager->awaitResponse(PG, 50ms);
+
+    EXPECT_TRUE(pg->finished());
+    EXPECT_TRUE(pump->finished());
+    EXPECT_EQ(pg->divergences() + pump->divergences(), 0u);
+  }
+
+  TEST_F(RPCManagerTest, startCapture_FailsOnUnwritablePath) {
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::HasSubstr("capture")));
+    EXPECT_FALSE(manager->startCapture("/nonexistent-dir/milo.cap"));
+    manager->stopCapture();
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  using milo::core::Codec;
+  using milo::core::DeviceRegistry;
+  using milo::core::DeviceSpec;
+
+  TEST(DeviceRegistryTest, resolvesNamesToDenseIndicesAndRejectsBadConfig) {
+    DeviceRegistry reg({ { "PG", "/dev/pg1" },
+                         { "Pump1", "/dev/pump1", { .baud = 57600 } },
+                         { "Pump2", "/dev/pump2", { .baud = 250000 }, Codec::AsciiLf } });
+    ASSERT_EQ(reg.size(), 3u);
+    EXPECT_EQ(reg.at("Pump2").index, 2u);
+    EXPECT_EQ(reg.spec(reg.at("Pump1")).serial.baud, 57600u);
+    EXPECT_TRUE(reg.spec(reg.at("Pump1")).serial.lowLatency);
+    EXPECT_FALSE(reg.find("PSU"));
+    EXPECT_THROW(reg.at("PSU"), std::invalid_argument);
+    EXPECT_THROW(reg.add({ "Pump1", "/dev/pump3" }), std::invalid_argument);
+    EXPECT_THROW(reg.add({ "", "/dev/x" }), std::invalid_argument);
+
+    for (std::size_t i = reg.size(); i < DeviceRegistry::kMaxDevices; ++i)
+      reg.add({ "Dev" + std::to_string(i), "" });
+    EXPECT_THROW(reg.add({ "OneTooMany", "" }), std::invalid_argument);
+
+    EXPECT_EQ(DeviceRegistry::parseBaud(921600), 921600u);
+    EXPECT_EQ(DeviceRegistry::parseBaud(3'000'000), 3'000'000u); // no B* constant needed
+    EXPECT_FALSE(DeviceRegistry::parseBaud(0));
+    EXPECT_FALSE(DeviceRegistry::parseBaud(50'000'000));
+    EXPECT_EQ(DeviceRegistry::parseCodec("ascii-lf"), Codec::AsciiLf);
+    EXPECT_FALSE(DeviceRegistry::parseCodec("binary"));
+  }
+
+  TEST(DeviceRegistryTest, sixteenDevicesRouteByIndexAndKeepTheirCodec) {
+    DeviceRegistry reg;
+    for (int i = 0; i < 16; ++i)
+      reg.add({ "Pump" + std::to_string(i), "", {}, i % 2 ? Codec::AsciiLf : Codec::AsciiCrlf });
+    auto errors = std::make_shared<testing::NiceMock<MockErrorMonitor>>();
+    RPCManager rpc(errors, reg);
+
+    std::vector<FakeSerialChannel*> fakes;
+    for (auto d : reg.all()) {
+      auto fake = std::make_unique<FakeSerialChannel>();
+      fakes.push_back(fake.get());
+      rpc.attachChannel(d, std::move(fake));
+    }
+    EXPECT_THROW(rpc.attachChannel(Device{ 16 }, std::make_unique<FakeSerialChannel>()),
+                 std::invalid_argument);
+    EXPECT_THROW(rpc.sendCommand(Device{ 16 }, Command{ "FLOW 1" }), std::invalid_argument);
+
+    for (auto d : reg.all())
+      rpc.sendCommand(d, Command{ std::pmr::string("FLOW " + std::to_string(d.index)) });
+    for (std::size_t i = 0; i < fakes.size(); ++i) {
+      EXPECT_EQ(fakes[i]->write_count, 1);
+      // LF devices get the bare payload; the channel appends its own terminator
+      EXPECT_EQ(fakes[i]->getLastWritten(), "FLOW " + std::to_string(i) + (i % 2 ? "" : "\r\n"));
+      EXPECT_EQ(fakes[i]->terminator(), i % 2 ? "\n" : "\r\n");
+    }
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  namespace psu = milo::protocols::psu;
+  namespace pg = milo::protocols::pg;
+  namespace pump = milo::protocols::pump;
+
+  static_assert(psu::SetVoltage::kMaxWire == sizeof("VOLT -30.000 CH1 RAMP 1000") - 2);
+  static_assert(pg::Pulse::kMaxWire == sizeof("PULSE 10000 WIDTH 1000000 DELAY 1000000") - 1);
+  static_assert(psu::SetVoltage::valid(12.0, 1, 50) && !psu::SetVoltage::valid(30.5, 1, 50));
+
+  TEST(CommandSchemaTest, encodesWithFixedPrecisionAndRejectsOutOfRange) {
+    EXPECT_EQ(psu::SetVoltage::encode(12.0, 1, 50)->view(), "VOLT 12.000 CH1 RAMP 50");
+    EXPECT_EQ(psu::SetVoltage::encode(29.99996, 2, 0)->view(), "VOLT 30.000 CH2 RAMP 0");
+    EXPECT_EQ(pump::SetFlow::encode(2.54)->view(), "FLOW 2.5");
+    EXPECT_EQ(psu::Enable::make<true>().view(), "EN 1");
+    EXPECT_EQ(pg::Arm::make<>().view(), "ARM");
+    EXPECT_EQ((pg::Pulse::make<10, 250, 100>().view()), "PULSE 10 WIDTH 250 DELAY 100");
+
+    EXPECT_FALSE(psu::SetVoltage::encode(30.001, 1, 0));
+    EXPECT_FALSE(psu::SetVoltage::encode(12.0, 3, 0)); // no channel 3
+    EXPECT_FALSE(pump::SetFlow::encode(std::numeric_limits<double>::quiet_NaN()));
+    EXPECT_FALSE(pg::Pulse::encode(0, 250, 100));
+  }
+
+  TEST(CommandSchemaTest, replyShapesParseOnlyWhatTheyExpect) {
+    using milo::protocols::schema::Ack;
+    using milo::protocols::schema::Reading;
+    EXPECT_TRUE(Ack::parse("OK"));
+    EXPECT_TRUE(Ack::parse("OK FLOW"));
+    EXPECT_FALSE(Ack::parse("ERR 3"));
+    EXPECT_FALSE(Ack::parse("OKAY"));
+    EXPECT_EQ(Reading<double>::parse("OK 11.998"), 11.998);
+    EXPECT_FALSE(Reading<double>::parse("OK 11.9x"));
+    EXPECT_FALSE(Reading<int>::parse("OK"));
+  }
+
+  TEST_F(RPCManagerTest, schemaCommands_SendEncodedWireAndParseTypedReplies) {
+    using milo::core::AllocationGuard;
+    const auto volt = psu::SetVoltage::encode(12.0, 1, 50);
+    ASSERT_TRUE(volt);
+
+    fakeChannels[PSU.index]->next_read_line = "OK";
+    AllocationGuard::arm(AllocationGuard::Mode::Count);
+    manager->sendCommand(PSU, *volt);
+    AllocationGuard::disarm();
+    if (AllocationGuard::kCompiledIn) {
+      EXPECT_EQ(AllocationGuard::count(), 0u) << AllocationGuard::report();
+    }
+    EXPECT_EQ(fakeChannels[PSU.index]->getLastWritten(), "VOLT 12.000 CH1 RAMP 50");
+    manager->awaitReply<psu::SetVoltage>(PSU, std::chrono::milliseconds{ 10 });
+
+    fakeChannels[Pump.index]->next_read_line = "OK 2.5";
+    manager->sendCommand(Pump, pump::MeasureFlow::make<>());
+    EXPECT_DOUBLE_EQ(manager->awaitReply<pump::MeasureFlow>(Pump, std::chrono::milliseconds{ 10 }),
+                     2.5);
+
+    fakeChannels[PG.index]->next_read_line = "ERR 7 not armed";
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::HasSubstr("PG rejected PULSE"))).Times(1);
+    manager->sendCommand(PG, pg::Pulse::make<10, 250, 100>());
+    EXPECT_THROW(manager->awaitReply<pg::Pulse>(PG, std::chrono::milliseconds{ 10 }),
+                 std::runtime_error);
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  using milo::core::ProtocolExecutor;
+  using milo::core::Task;
+
+  namespace {
+    /// PSU, PG and pump set up concurrently; records which sub-sequence finished when.
+    struct SetupProtocol : milo::protocols::CoroutineProtocol {
+      Device psuDev{ 1 }, pgDev{ 0 }, pumpDev{ 2 };
+      std::array<char, 3> order{};
+      std::size_t finished = 0;
+
+      Task<void> psuUp(ProtocolExecutor& exec, RPCManager& rpc) {
+        rpc.sendCommand(psuDev, psu::SetVoltage::make<12.0, 1, 0>());
+        co_await exec.reply<psu::SetVoltage>(rpc, psuDev, std::chrono::milliseconds{ 100 });
+        rpc.sendCommand(psuDev, psu::Enable::make<true>());
+        co_await exec.reply<psu::Enable>(rpc, psuDev, std::chrono::milliseconds{ 100 });
+        order[finished++] = 'V';
+      }
+      Task<void> pgArm(ProtocolExecutor& exec, RPCManager& rpc) {
+        rpc.sendCommand(pgDev, pg::Arm::make<>());
+        co_await exec.reply<pg::Arm>(rpc, pgDev, std::chrono::milliseconds{ 100 });
+        order[finished++] = 'A';
+      }
+      Task<double> flow(ProtocolExecutor& exec, RPCManager& rpc) {
+        rpc.sendCommand(pumpDev, pump::MeasureFlow::make<>());
+        co_return co_await exec.reply<pump::MeasureFlow>(rpc, pumpDev,
+                                                         std::chrono::milliseconds{ 100 });
+      }
+      Task<void> pumpPrime(ProtocolExecutor& exec, RPCManager& rpc) {
+        rpc.sendCommand(pumpDev, pump::SetFlow::make<2.5>());
+        co_await exec.reply<pump::SetFlow>(rpc, pumpDev, std::chrono::milliseconds{ 100 });
+        co_await exec.sleepFor(std::chrono::milliseconds{ 2 });
+        const double primed = co_await flow(exec, rpc);
+        if (primed < 2.0)
+          throw std::runtime_error("pump did not prime");
+        order[finished++] = 'F';
+      }
+
+      Task<void> execute(ProtocolExecutor& exec, RPCManager& rpc, milo::core::Logger&,
+                         const milo::core::ParameterStore&) override {
+        co_await exec.whenAll(psuUp(exec, rpc), pgArm(exec, rpc), pumpPrime(exec, rpc));
+      }
+    };
+
+    /// Half an hour of one-minute voltage steps; records the (virtual) time of each reply.
+    struct RampProtocol : milo::protocols::CoroutineProtocol {
+      static constexpr int kSteps = 30;
+      Device psuDev{ 1 };
+      std::array<milo::core::Clock::Duration, kSteps> replyAt{};
+
+      Task<void> execute(ProtocolExecutor& exec, RPCManager& rpc, milo::core::Logger&,
+                         const milo::core::ParameterStore&) override {
+        for (int i = 0; i < kSteps; ++i) {
+          rpc.sendCommand(psuDev, psu::SetVoltage::make<12.0, 1, 0>());
+          co_await exec.reply<psu::SetVoltage>(rpc, psuDev, std::chrono::milliseconds{ 500 });
+          replyAt[static_cast<std::size_t>(i)] = exec.now();
+          co_await exec.sleepFor(std::chrono::minutes{ 1 });
+        }
+      }
+    };
+
+    /// Driven directly (no fixture protocol): parameters, delays and nested results.
+    Task<float> waitForVoltage(ProtocolExecutor& exec, const milo::core::ParameterStore& store) {
+      co_return co_await exec.changed(store, milo::core::Parameter::Voltage);
+    }
+    Task<void> turnKnob(ProtocolExecutor& exec, milo::core::ParameterStore& store) {
+      co_await exec.sleepFor(std::chrono::milliseconds{ 3 });
+      store.set(milo::core::Parameter::Temp, 37.0f); // unrelated parameter: no wake-up
+      co_await exec.sleepFor(std::chrono::milliseconds{ 1 });
+      store.set(milo::core::Parameter::Voltage, 14.5f);
+    }
+  } // namespace
+
+  TEST_F(RPCManagerTest, coroutineProtocol_RunsDeviceSequencesConcurrentlyWithoutHeap) {
+    using milo::core::AllocationGuard;
+    fakeChannels[PSU.index]->next_read_line = "OK";
+    fakeChannels[PSU.index]->reply_after_polls = 6;
+    fakeChannels[PG.index]->next_read_line = "OK";
+    fakeChannels[PG.index]->reply_after_polls = 1;
+    fakeChannels[Pump.index]->next_read_line = "OK 2.5";
+    fakeChannels[Pump.index]->reply_after_polls = 3;
+
+    milo::core::Logger log{ ::testing::TempDir() + "milo_coroutine", 16 }; // never started
+    milo::core::ParameterStore store;
+    auto protocol = std::make_unique<SetupProtocol>();
+    AllocationGuard::arm(AllocationGuard::Mode::Count);
+    protocol->run(*manager, log, store);
+    AllocationGuard::disarm();
+    if (AllocationGuard::kCompiledIn) {
+      EXPECT_EQ(AllocationGuard::count(), 0u) << AllocationGuard::report();
+    }
+
+    ASSERT_EQ(protocol->finished, 3u);
+    EXPECT_EQ(protocol->order[0], 'A'); // the quick PG does not wait behind the slow PSU
+    EXPECT_EQ(fakeChannels[PSU.index]->getLastWritten(), "EN 1");
+    EXPECT_EQ(fakeChannels[Pump.index]->getLastWritten(), "FLOW?");
+  }
+
+  TEST_F(RPCManagerTest, coroutineProtocol_TimeoutAndRejectionThrowFromRun) {
+    fakeChannels[PSU.index]->next_read_line = "OK";
+    fakeChannels[Pump.index]->next_read_line = "OK 2.5";
+    fakeChannels[PG.index]->next_read_line = std::nullopt;
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::HasSubstr("PG"))).Times(1);
+
+    milo::core::Logger log{ ::testing::TempDir() + "milo_coroutine", 16 };
+    milo::core::ParameterStore store;
+    auto protocol = std::make_unique<SetupProtocol>();
+    const auto t0 = std::chrono::steady_clock::now();
+    EXPECT_THROW(protocol->run(*manager, log, store), std::runtime_error);
+    EXPECT_GE(std::chrono::steady_clock::now() - t0, std::chrono::milliseconds{ 100 });
+    EXPECT_EQ(protocol->finished, 2u); // the others still ran to completion
+
+    fakeChannels[PG.index]->next_read_line = "ERR 3 interlock open";
+    EXPECT_CALL(*errorMonitor, notifyFailure(testing::HasSubstr("PG rejected ARM"))).Times(1);
+    protocol = std::make_unique<SetupProtocol>();
+    EXPECT_THROW(protocol->run(*manager, log, store), std::runtime_error);
+  }
+
+  TEST_F(RPCManagerTest, coroutineProtocol_VirtualClockRunsHalfAnHourInstantly) {
+    using namespace std::chrono_literals;
+    fakeChannels[PSU.index]->next_read_line = "OK";
+    fakeChannels[PSU.index]->reply_latency = 40ms; // simulated MCU turnaround
+
+    milo::core::Logger log{ ::testing::TempDir() + "milo_coroutine", 16 };
+    milo::core::ParameterStore store;
+    std::array<std::array<milo::core::Clock::Duration, RampProtocol::kSteps>, 2> traces{};
+    const auto wall0 = std::chrono::steady_clock::now();
+    for (auto& trace : traces) {
+      milo::core::VirtualClock clock;
+      manager->setClock(clock);
+      auto protocol = std::make_unique<RampProtocol>();
+      protocol->useClock(clock);
+      protocol->run(*manager, log, store);
+      trace = protocol->replyAt;
+      EXPECT_EQ(clock.now(), RampProtocol::kSteps * (40ms + 1min));
+      manager->setClock(milo::core::Clock::steady());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - wall0, 1s);
+    EXPECT_EQ(traces[0], traces[1]); // deterministic, step for step
+    EXPECT_EQ(traces[0][1], 40ms + 1min + 40ms);
+  }
+
+  TEST(protocol_executor, awaits_parameter_changes_and_delays) {
+    alignas(std::max_align_t) std::array<std::byte, 4096> frames{};
+    milo::core::ParameterStore store;
+    store.set(milo::core::Parameter::Voltage, 12.0f);
+
+    ProtocolExecutor exec(frames);
+    float seen = 0.0f;
+    auto both = [&]() -> Task<void> {
+      auto watch = [&]() -> Task<void> { seen = co_await waitForVoltage(exec, store); };
+      co_await exec.whenAll(watch(), turnKnob(exec, store));
+    };
+    const auto t0 = std::chrono::steady_clock::now();
+    exec.run(both());
+    EXPECT_GE(std::chrono::steady_clock::now() - t0, std::chrono::milliseconds{ 4 });
+    EXPECT_FLOAT_EQ(seen, 14.5f);
+
+    auto stuck = [&]() -> Task<int> {
+      milo::core::detail::JoinGroup never{ 1, {} };
+      co_await std::suspend_always{}; // nobody will ever resume this
+      co_return never.pending;
+    };
+    EXPECT_THROW(exec.run(stuck()), std::logic_error);
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  namespace {
+    /// Sits out one long step; whatever the pump streams meanwhile must still be read.
+    struct LongStepProtocol : milo::protocols::CoroutineProtocol {
+      Task<void> execute(ProtocolExecutor& exec, RPCManager&, milo::core::Logger&,
+                         const milo::core::ParameterStore&) override {
+        co_await exec.sleepFor(std::chrono::seconds{ 30 });
+      }
+    };
+  } // namespace
+
+  TEST_F(RPCManagerTest, streamLines_AreRoutedToChannelsAndNeverTakenForReplies) {
+    milo::core::SampleStreams streams;
+    manager->attachStreams(streams);
+
+    // samples arrive ahead of, and around, the reply to a query
+    auto* pump = fakeChannels[Pump.index];
+    pump->unsolicited = { "#FLOW 2.5", "#FLOW 2.75", "#PRES 101.5", "#garbage" };
+    pump->next_read_line = "OK 2.5";
+    manager->sendCommand(Pump, pump::MeasureFlow::make<>());
+    EXPECT_DOUBLE_EQ(manager->awaitReply<pump::MeasureFlow>(Pump, std::chrono::milliseconds{ 10 }),
+                     2.5);
+    EXPECT_EQ(manager->streamLines(), 4u); // the malformed one is dropped, not a reply
+
+    ASSERT_EQ(streams.channels(), 2u);
+    const auto flow = streams.find("Pump.FLOW");
+    ASSERT_TRUE(flow.has_value());
+    const auto& cols = streams.columns(*flow);
+    ASSERT_EQ(cols.written(), 2u);
+    const auto values = cols.values(0, 8);
+    ASSERT_EQ(values.size(), 2u);
+    EXPECT_FLOAT_EQ(values[1], 2.75f);
+    EXPECT_LE(cols.times(0, 8)[0], cols.times(0, 8)[1]);
+    EXPECT_TRUE(streams.find("Pump.PRES").has_value());
+
+    // pumping between commands keeps a reply it runs into for the next reader
+    pump->unsolicited = { "#FLOW 3" };
+    pump->next_read_line = "OK 3";
+    manager->pumpStreams();
+    pump->next_read_line = "OK 9";
+    EXPECT_DOUBLE_EQ(manager->awaitReply<pump::MeasureFlow>(Pump, std::chrono::milliseconds{ 10 }),
+                     3.0);
+    EXPECT_EQ(cols.written(), 3u);
+  }
+
+  TEST_F(RPCManagerTest, coroutineProtocol_ReadsStreamedSamplesDuringLongSteps) {
+    milo::core::SampleStreams streams;
+    manager->attachStreams(streams);
+    for (int i = 0; i < 200; ++i)
+      fakeChannels[PSU.index]->unsolicited.push_back("#V1 " + std::to_string(12 + i % 3));
+    fakeChannels[PSU.index]->next_read_line = std::nullopt;
+
+    milo::core::VirtualClock clock;
+    manager->setClock(clock);
+    milo::core::Logger log{ ::testing::TempDir() + "milo_coroutine", 16 };
+    milo::core::ParameterStore store;
+    auto protocol = std::make_unique<LongStepProtocol>();
+    protocol->useClock(clock);
+    protocol->run(*manager, log, store);
+    manager->setClock(milo::core::Clock::steady());
+
+    const auto v1 = streams.find("PSU.V1");
+    ASSERT_TRUE(v1.has_value());
+    EXPECT_EQ(streams.columns(*v1).written(), 200u);
+    EXPECT_EQ(clock.now(), std::chrono::seconds{ 30 });
+  }
+
+} // namespace milo::test
+
+namespace milo::test {
+
+  TEST_F(RPCManagerTest, readingsAndStreamedSamples_FeedRunStats) {
+    milo::core::RunStats stats;
+    manager->attachStats(stats);
+
+    // a Reading reply counts under the query's name; an Ack never does
+    fakeChannels[PSU.index]->next_read_line = "OK";
+    manager->sendCommand(PSU, psu::SetVoltage::make<12.0, 1, 50>());
+    manager->awaitReply<psu::SetVoltage>(PSU, std::chrono::milliseconds{ 10 });
+    EXPECT_EQ(stats.channels(), 0u);
+    for (const char* reply : { "OK 2.5", "OK 3.5" }) {
+      fakeChannels[Pump.index]->next_read_line = reply;
+      manager->sendCommand(Pump, pump::MeasureFlow::make<>());
+      manager->awaitReply<pump::MeasureFlow>(Pump, std::chrono::milliseconds{ 10 });
+    }
+
+    // stream lines count without SampleStreams attached
+    fakeChannels[Pump.index]->unsolicited = { "#PRES 101", "#PRES 103" };
+    fakeChannels[Pump.index]->next_read_line = "OK 4.5";
+    manager->sendCommand(Pump, pump::MeasureFlow::make<>());
+    EXPECT_EQ(manager->pollReply<pump::MeasureFlow>(Pump), 4.5);
+
+    const auto summary = stats.summary();
+    ASSERT_EQ(summary.size(), 2u);
+    EXPECT_EQ(summary[0].key, "Pump.FLOW");
+    EXPECT_EQ(summary[0].count, 3u);
+    EXPECT_DOUBLE_EQ(summary[0].mean, 3.5);
+    EXPECT_DOUBLE_EQ(summary[0].stddev, 1.0);
+    EXPECT_EQ(summary[1].key, "Pump.PRES");
+    EXPECT_DOUBLE_EQ(summary[1].mean, 102.0);
+  }
+
+} // namespace milo::test
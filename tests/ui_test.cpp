@@ -1,3 +1,145 @@
+// MILO-Prod headers
+#include "core/ParameterStore.hpp"
+#include "core/RunStats.hpp"
+#include "core/StreamView.hpp"
+#include "core/SystemState.hpp"
+#include "core/TripleBuffer.hpp"
+#include "ui/UIController.hpp"
+
+// MILO-Fake headers
+#include "FakeSpiOLED.hpp"
+
+// GTest headers
 #include <gtest/gtest.h>
-TEST(ui_tests, passes) {}
 
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using milo::core::Parameter;
+using milo::core::SystemState;
+
+TEST(triple_buffer, reader_sees_only_latest_publish) {
+  milo::core::TripleBuffer<int> tb;
+  EXPECT_FALSE(tb.consume());
+
+  tb.publish(1);
+  tb.publish(2);
+  tb.publish(3);
+  ASSERT_TRUE(tb.consume());
+  EXPECT_EQ(tb.front(), 3);
+  EXPECT_FALSE(tb.consume()); // nothing new since
+  EXPECT_EQ(tb.front(), 3);
+}
+
+TEST(ui_controller, fast_knob_updates_are_coalesced_into_capped_frames) {
+  auto display = std::make_unique<milo::test::FakeSpiOLED>();
+  auto* fake = display.get();
+  milo::ui::UIController ui(std::move(display), std::chrono::milliseconds{ 20 });
+
+  ui.start();
+  ui.setDisplayState(SystemState::IDLE);
+  for (int detent = 0; detent < 500; ++detent)
+    ui.showParameterValue(Parameter::Voltage, static_cast<float>(detent) * 0.1f);
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 60 });
+  ui.stop();
+
+  EXPECT_LT(ui.framesRendered(), 10u);       // not one flush per detent
+  EXPECT_LE(fake->messages.size(), ui.framesRendered());
+
+  // the final frame shows the last published value
+  milo::test::FakeSpiOLED expected;
+  expected.drawNumber(0, 32, 49.9f, 2);
+  for (int x = 0; x < 60; ++x)
+    for (int y = 32; y < 40; ++y)
+      ASSERT_EQ(fake->pixel(x, y), expected.pixel(x, y)) << x << "," << y;
+}
+
+TEST(ui_controller, idle_renderer_does_not_redraw) {
+  milo::ui::UIController ui(std::make_unique<milo::test::FakeSpiOLED>(),
+                            std::chrono::milliseconds{ 5 });
+  ui.start();
+  ui.setDisplayState(SystemState::RUNNING);
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+  const auto settled = ui.framesRendered();
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+  EXPECT_EQ(ui.framesRendered(), settled);
+
+  ui.setDisplayState(SystemState::RUNNING); // same screen → no new frame
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+  ui.stop();
+  EXPECT_EQ(ui.framesRendered(), settled);
+}
+
+TEST(ui_controller, stream_trace_is_drawn_one_column_per_bucket) {
+  auto display = std::make_unique<milo::test::FakeSpiOLED>();
+  auto* fake = display.get();
+  milo::ui::UIController ui(std::move(display), std::chrono::milliseconds{ 5 });
+
+  milo::core::StreamView view;
+  std::snprintf(view.key, sizeof(view.key), "Pump.FLOW");
+  view.filled = 40;
+  for (std::uint32_t i = 0; i < view.filled; ++i) {
+    view.buckets[i].add(static_cast<float>(i));
+    view.buckets[i].add(static_cast<float>(i) + 0.5f);
+  }
+  view.buckets[10] = {}; // a gap in the stream
+
+  ui.start();
+  ui.setDisplayState(SystemState::RUNNING);
+  ui.showStream(view);
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+  ui.stop();
+
+  auto litIn = [&](int x) {
+    int n = 0;
+    for (int y = 42; y < 64; ++y)
+      n += fake->pixel(x, y) ? 1 : 0;
+    return n;
+  };
+  EXPECT_EQ(litIn(127 - 40), 0);    // left of the oldest bucket
+  EXPECT_GT(litIn(128 - 40), 0);    // oldest bucket …
+  EXPECT_EQ(litIn(128 - 40 + 10), 0); // … the gap …
+  EXPECT_GT(litIn(127), 0);         // … newest at the right edge
+  EXPECT_TRUE(fake->pixel(127, 42)); // the newest bucket holds the maximum
+  EXPECT_TRUE(fake->pixel(128 - 40, 63)); // and the oldest the minimum
+}
+
+TEST(ui_controller, finished_screen_shows_the_run_statistics) {
+  auto display = std::make_unique<milo::test::FakeSpiOLED>();
+  auto* fake = display.get();
+  milo::ui::UIController ui(std::move(display), std::chrono::milliseconds{ 5 });
+
+  milo::core::StreamView view;
+  std::snprintf(view.key, sizeof(view.key), "Pump.FLOW");
+  view.filled = 1;
+  view.buckets[0].add(1.0f);
+  const std::vector<milo::core::ChannelSummary> stats{
+    { .key = "PSU.VOLT", .count = 10, .mean = 12.0, .stddev = 0.02 },
+    { .key = "A.VERY_LONG_CHANNEL_NAME", .count = 10, .mean = 2.5, .stddev = 0.1 },
+  };
+
+  auto rowsLit = [&](int y0, int y1) {
+    int n = 0;
+    for (int y = y0; y < y1; ++y)
+      for (int x = 0; x < 128; ++x)
+        n += fake->pixel(x, y) ? 1 : 0;
+    return n;
+  };
+
+  ui.start();
+  ui.showStream(view);
+  ui.showRunStats(stats);
+  ui.setDisplayState(SystemState::FINISHED);
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+  EXPECT_GT(rowsLit(12, 20), 0); // one line per channel …
+  EXPECT_GT(rowsLit(22, 30), 0);
+  EXPECT_EQ(rowsLit(32, 40), 0);
+  EXPECT_FALSE(fake->pixel(127, 63)); // … in place of the trace
+
+  ui.setDisplayState(SystemState::RUNNING); // the next run brings the trace back
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+  ui.stop();
+  EXPECT_EQ(rowsLit(12, 20), 0);
+  EXPECT_TRUE(fake->pixel(127, 63));
+}